@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AseFormat.h"
+#include "ColorObject.h"
+#include "ColorList.h"
+#include "ErrorCode.h"
+#include "common/Scoped.h"
+#include "common/Result.h"
+#include "math/Algorithms.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/endian/conversion.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+const uint32_t Version = 0x00010000u;
+const uint16_t ColorEntry = 0x0001u;
+const uint16_t GroupStart = 0xc001u;
+const uint16_t GroupEnd = 0xc002u;
+const uint16_t MaxNameUnits = 0xffffu;
+const size_t MinColorBlockSize = 16;
+const size_t WriteBufferSize = 1024 * 1024;
+// Bounds checked big endian reader of ASE blocks. Reads return views into the underlying data instead of copies.
+struct BlockCursor {
+	BlockCursor(const uint8_t *data, size_t size):
+		m_position(data),
+		m_end(data + size) {
+	}
+	size_t remaining() const {
+		return static_cast<size_t>(m_end - m_position);
+	}
+	bool skip(size_t size) {
+		if (size > remaining())
+			return false;
+		m_position += size;
+		return true;
+	}
+	bool read(const uint8_t *&data, size_t size) {
+		if (size > remaining())
+			return false;
+		data = m_position;
+		m_position += size;
+		return true;
+	}
+	bool read(BlockCursor &block, size_t size) {
+		const uint8_t *data;
+		if (!read(data, size))
+			return false;
+		block = BlockCursor(data, size);
+		return true;
+	}
+	bool read(uint16_t &value) {
+		if (remaining() < sizeof(value))
+			return false;
+		std::memcpy(&value, m_position, sizeof(value));
+		m_position += sizeof(value);
+		value = boost::endian::big_to_native<uint16_t>(value);
+		return true;
+	}
+	bool read(uint32_t &value) {
+		if (remaining() < sizeof(value))
+			return false;
+		std::memcpy(&value, m_position, sizeof(value));
+		m_position += sizeof(value);
+		value = boost::endian::big_to_native<uint32_t>(value);
+		return true;
+	}
+	// Non finite values are read as zero, so damaged files can not put NaN into colors.
+	bool read(float &value) {
+		uint32_t bits;
+		if (!read(bits))
+			return false;
+		std::memcpy(&value, &bits, sizeof(value));
+		if (!std::isfinite(value))
+			value = 0.0f;
+		return true;
+	}
+	// Reads length prefixed UTF-16 name. Returned unit count stops at the first zero terminator.
+	bool readName(const uint8_t *&name, size_t &units) {
+		uint16_t length;
+		if (!read(length) || !read(name, length * size_t(2)))
+			return false;
+		units = 0;
+		while (units < length && (name[units * 2] | name[units * 2 + 1]) != 0)
+			units++;
+		return true;
+	}
+private:
+	const uint8_t *m_position, *m_end;
+};
+static void appendUtf8(uint32_t codePoint, std::string &out) {
+	if (codePoint < 0x80) {
+		out.push_back(static_cast<char>(codePoint));
+	} else if (codePoint < 0x800) {
+		out.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+		out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	} else if (codePoint < 0x10000) {
+		out.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+		out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+		out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	} else {
+		out.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+		out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+		out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+		out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	}
+}
+// Appends big endian UTF-16 text as UTF-8. Unpaired surrogates are replaced with U+FFFD.
+static void appendUtf16AsUtf8(const uint8_t *data, size_t units, std::string &out) {
+	for (size_t i = 0; i < units; i++) {
+		uint32_t unit = (static_cast<uint32_t>(data[i * 2]) << 8) | data[i * 2 + 1];
+		if (unit < 0x80) {
+			out.push_back(static_cast<char>(unit));
+			continue;
+		}
+		if (unit >= 0xd800 && unit < 0xe000) {
+			uint32_t next = i + 1 < units ? (static_cast<uint32_t>(data[i * 2 + 2]) << 8) | data[i * 2 + 3] : 0;
+			if (unit < 0xdc00 && next >= 0xdc00 && next < 0xe000) {
+				unit = 0x10000 + ((unit - 0xd800) << 10) + (next - 0xdc00);
+				i++;
+			} else {
+				unit = 0xfffd;
+			}
+		}
+		appendUtf8(unit, out);
+	}
+}
+// Decodes one code point from UTF-8 text. Invalid, overlong or truncated sequences consume one byte and decode as U+FFFD.
+static uint32_t nextCodePoint(std::string_view text, size_t &position) {
+	auto byte = [&text](size_t index) {
+		return static_cast<uint32_t>(static_cast<uint8_t>(text[index]));
+	};
+	uint32_t first = byte(position);
+	if (first < 0x80) {
+		position++;
+		return first;
+	}
+	size_t length;
+	uint32_t codePoint, minimum;
+	if ((first & 0xe0) == 0xc0) {
+		length = 2, codePoint = first & 0x1f, minimum = 0x80;
+	} else if ((first & 0xf0) == 0xe0) {
+		length = 3, codePoint = first & 0x0f, minimum = 0x800;
+	} else if ((first & 0xf8) == 0xf0) {
+		length = 4, codePoint = first & 0x07, minimum = 0x10000;
+	} else {
+		position++;
+		return 0xfffd;
+	}
+	if (position + length > text.length()) {
+		position++;
+		return 0xfffd;
+	}
+	for (size_t i = 1; i < length; i++) {
+		uint32_t next = byte(position + i);
+		if ((next & 0xc0) != 0x80) {
+			position++;
+			return 0xfffd;
+		}
+		codePoint = (codePoint << 6) | (next & 0x3f);
+	}
+	if (codePoint < minimum || codePoint > 0x10ffff || (codePoint >= 0xd800 && codePoint < 0xe000)) {
+		position++;
+		return 0xfffd;
+	}
+	position += length;
+	return codePoint;
+}
+static void append(std::string &buffer, uint16_t value) {
+	value = boost::endian::native_to_big<uint16_t>(value);
+	buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+static void append(std::string &buffer, uint32_t value) {
+	value = boost::endian::native_to_big<uint32_t>(value);
+	buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+static void append(std::string &buffer, float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	append(buffer, bits);
+}
+static void patch(std::string &buffer, size_t position, uint16_t value) {
+	value = boost::endian::native_to_big<uint16_t>(value);
+	std::memcpy(&buffer[position], &value, sizeof(value));
+}
+static void patch(std::string &buffer, size_t position, uint32_t value) {
+	value = boost::endian::native_to_big<uint32_t>(value);
+	std::memcpy(&buffer[position], &value, sizeof(value));
+}
+// Appends UTF-8 text as big endian UTF-16 units, stopping before surrogate pair or unit which would exceed the limit. Returns number of units written.
+static size_t appendUtf8AsUtf16(std::string_view text, size_t maxUnits, std::string &buffer) {
+	size_t units = 0, position = 0;
+	while (position < text.length()) {
+		uint32_t codePoint = nextCodePoint(text, position);
+		if (codePoint < 0x10000) {
+			if (units + 1 > maxUnits)
+				break;
+			append(buffer, static_cast<uint16_t>(codePoint));
+			units++;
+		} else {
+			if (units + 2 > maxUnits)
+				break;
+			codePoint -= 0x10000;
+			append(buffer, static_cast<uint16_t>(0xd800 + (codePoint >> 10)));
+			append(buffer, static_cast<uint16_t>(0xdc00 + (codePoint & 0x3ff)));
+			units += 2;
+		}
+	}
+	return units;
+}
+struct Swatch {
+	size_t nameOffset, nameLength;
+	Color color;
+};
+// Reads color entry block. Returns false when block is malformed, unknown color models leave supported set to false.
+static bool readColorEntry(BlockCursor block, std::string &names, Swatch &swatch, bool &supported) {
+	const uint8_t *name, *model;
+	size_t units;
+	if (!block.readName(name, units) || !block.read(model, 4))
+		return false;
+	supported = false;
+	Color color;
+	if (std::memcmp(model, "RGB ", 4) == 0) {
+		if (!block.read(color.red) || !block.read(color.green) || !block.read(color.blue))
+			return false;
+		supported = true;
+	} else if (std::memcmp(model, "CMYK", 4) == 0) {
+		Color cmyk;
+		if (!block.read(cmyk.cmyk.c) || !block.read(cmyk.cmyk.m) || !block.read(cmyk.cmyk.y) || !block.read(cmyk.cmyk.k))
+			return false;
+		color = cmyk.cmykToRgb();
+		supported = true;
+	} else if (std::memcmp(model, "Gray", 4) == 0) {
+		float gray;
+		if (!block.read(gray))
+			return false;
+		color.red = color.green = color.blue = gray;
+		supported = true;
+	} else if (std::memcmp(model, "LAB ", 4) == 0) {
+		Color lab;
+		if (!block.read(lab.lab.L) || !block.read(lab.lab.a) || !block.read(lab.lab.b))
+			return false;
+		lab.lab.L *= 100;
+		color = lab.labToRgbD50();
+		color.red = math::clamp(color.red, 0.0f, 1.0f);
+		color.green = math::clamp(color.green, 0.0f, 1.0f);
+		color.blue = math::clamp(color.blue, 0.0f, 1.0f);
+		supported = true;
+	}
+	if (!supported)
+		return true;
+	color.alpha = 1.0f;
+	swatch.color = color;
+	swatch.nameOffset = names.length();
+	appendUtf16AsUtf8(name, units, names);
+	swatch.nameLength = names.length() - swatch.nameOffset;
+	return true;
+}
+common::ResultVoid<ErrorCode> aseBufferLoad(const uint8_t *data, size_t size, ColorList &colorList) {
+	using Result = common::ResultVoid<ErrorCode>;
+	BlockCursor cursor(data, size);
+	const uint8_t *magic;
+	uint32_t version, blockCount;
+	if (!cursor.read(magic, 4) || !cursor.read(version) || !cursor.read(blockCount))
+		return Result(ErrorCode::readFailed);
+	if (std::memcmp(magic, "ASEF", 4) != 0)
+		return Result(ErrorCode::badHeader);
+	if ((version >> 16) != (Version >> 16))
+		return Result(ErrorCode::badVersion);
+	// Names of all swatches are decoded into one string, so loading does not allocate per color until color objects are created.
+	std::string names;
+	names.reserve(cursor.remaining() / 2);
+	std::vector<Swatch> swatches;
+	swatches.reserve(std::min<size_t>(blockCount, cursor.remaining() / MinColorBlockSize));
+	for (uint32_t i = 0; i < blockCount; i++) {
+		uint16_t blockType;
+		uint32_t blockSize;
+		BlockCursor block(nullptr, 0);
+		if (!cursor.read(blockType) || !cursor.read(blockSize) || !cursor.read(block, blockSize))
+			return Result(ErrorCode::readFailed);
+		switch (blockType) {
+		case ColorEntry: {
+			Swatch swatch;
+			bool supported;
+			if (!readColorEntry(block, names, swatch, supported))
+				return Result(ErrorCode::badFile);
+			if (supported)
+				swatches.push_back(swatch);
+		} break;
+		case GroupStart: {
+			const uint8_t *name;
+			size_t units;
+			if (!block.readName(name, units))
+				return Result(ErrorCode::badFile);
+		} break;
+		case GroupEnd:
+		default:
+			break;
+		}
+	}
+	std::string_view allNames(names);
+	std::vector<ColorObject *> colorObjects;
+	common::Scoped releaseColorObjects([&colorObjects]() {
+		for (auto colorObject: colorObjects)
+			colorObject->release();
+	});
+	colorObjects.reserve(swatches.size());
+	for (const auto &swatch: swatches)
+		colorObjects.push_back(new ColorObject(allNames.substr(swatch.nameOffset, swatch.nameLength), swatch.color));
+	colorList.add(colorObjects);
+	return Result();
+}
+common::ResultVoid<ErrorCode> aseFileLoad(const char *filename, ColorList &colorList) {
+	using Result = common::ResultVoid<ErrorCode>;
+	if (!filename)
+		return Result(ErrorCode::invalidArguments);
+	boost::interprocess::file_mapping file;
+	try {
+		file = boost::interprocess::file_mapping(filename, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		return Result(ErrorCode::fileCouldNotBeOpened);
+	}
+	boost::interprocess::mapped_region region;
+	try {
+		region = boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		return Result(ErrorCode::readFailed);
+	}
+	return aseBufferLoad(static_cast<const uint8_t *>(region.get_address()), region.get_size(), colorList);
+}
+common::ResultVoid<ErrorCode> aseStreamSave(std::ostream &stream, ColorList &colorList) {
+	using Result = common::ResultVoid<ErrorCode>;
+	if (colorList.size() > UINT32_MAX)
+		return Result(ErrorCode::invalidArguments);
+	std::string buffer;
+	buffer.reserve(WriteBufferSize + 4 * (MaxNameUnits + 16));
+	buffer.append("ASEF", 4);
+	append(buffer, Version);
+	append(buffer, static_cast<uint32_t>(colorList.size()));
+	for (auto *colorObject: colorList) {
+		const auto &color = colorObject->getColor();
+		append(buffer, ColorEntry);
+		size_t blockSizePosition = buffer.length();
+		append(buffer, static_cast<uint32_t>(0));
+		size_t nameLengthPosition = buffer.length();
+		append(buffer, static_cast<uint16_t>(0));
+		size_t units = appendUtf8AsUtf16(colorObject->getName(), MaxNameUnits - 1, buffer);
+		append(buffer, static_cast<uint16_t>(0)); // name terminator
+		buffer.append("RGB ", 4);
+		append(buffer, color.red);
+		append(buffer, color.green);
+		append(buffer, color.blue);
+		append(buffer, static_cast<uint16_t>(0)); // global color type
+		patch(buffer, nameLengthPosition, static_cast<uint16_t>(units + 1));
+		patch(buffer, blockSizePosition, static_cast<uint32_t>(buffer.length() - blockSizePosition - 4));
+		if (buffer.length() >= WriteBufferSize) {
+			if (!stream.write(buffer.data(), buffer.length()))
+				return Result(ErrorCode::writeFailed);
+			buffer.clear();
+		}
+	}
+	if (!stream.write(buffer.data(), buffer.length()))
+		return Result(ErrorCode::writeFailed);
+	return Result();
+}
+common::ResultVoid<ErrorCode> aseFileSave(const char *filename, ColorList &colorList) {
+	using Result = common::ResultVoid<ErrorCode>;
+	if (!filename)
+		return Result(ErrorCode::invalidArguments);
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+		return Result(ErrorCode::fileCouldNotBeOpened);
+	auto result = aseStreamSave(file, colorList);
+	if (!result)
+		return result;
+	file.close();
+	return file.good() ? Result() : Result(ErrorCode::writeFailed);
+}
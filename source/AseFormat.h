@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_ASE_FORMAT_H_
+#define GPICK_ASE_FORMAT_H_
+#include "common/Result.h"
+#include "ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+struct ColorList;
+// Adobe Swatch Exchange palettes. Color entries inside group blocks are loaded in file order, group nesting itself is not kept as color lists are flat.
+common::ResultVoid<ErrorCode> aseFileLoad(const char *filename, ColorList &colorList);
+common::ResultVoid<ErrorCode> aseBufferLoad(const uint8_t *data, size_t size, ColorList &colorList);
+common::ResultVoid<ErrorCode> aseFileSave(const char *filename, ColorList &colorList);
+common::ResultVoid<ErrorCode> aseStreamSave(std::ostream &stream, ColorList &colorList);
+#endif /* GPICK_ASE_FORMAT_H_ */
@@ -18,30 +18,51 @@
 
 #include "AutoSave.h"
 #include "Paths.h"
-#include "FileFormat.h"
-#include <boost/interprocess/sync/named_mutex.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
-#include <filesystem>
+#include "GlobalState.h"
+#include "PaletteJournal.h"
+#include <glib.h>
 #include <iostream>
-void autoSave(ColorList &colorList) {
-	using namespace boost::interprocess;
-	using namespace std::filesystem;
-	try {
-		named_mutex mutex(open_or_create, "gpick.autosave");
-		scoped_lock<named_mutex> lock(mutex);
-		auto fileName = buildConfigPath("autosave.gpa");
-		auto fileNameTmp = buildConfigPath("autosave.gpa.tmp");
-		auto result = paletteFileSave(fileNameTmp.c_str(), colorList);
-		if (!result) {
-			std::cerr << "failed to save palette to \"" << fileNameTmp << "\": " << result.error() << std::endl;
-		} else {
-			std::error_code ec;
-			rename(path(fileNameTmp), path(fileName), ec);
-			if (ec) {
-				std::cerr << "failed to move palette file \"" << fileNameTmp << "\" to \"" << fileName << "\": " << ec << std::endl;
-			}
-		}
-	} catch (const interprocess_exception &e) {
-		std::cerr << "failed to acquire interprocess lock: " << e.what() << std::endl;
+AutoSave::AutoSave(GlobalState &gs):
+	m_gs(gs),
+	m_journal(std::make_unique<PaletteJournal>(buildConfigPath("autosave.gpa"), buildConfigPath("autosave.journal"), "gpick.autosave")),
+	m_timeoutId(0) {
+}
+AutoSave::~AutoSave() {
+	if (m_timeoutId == 0)
+		return;
+	g_source_remove(m_timeoutId);
+	m_gs.eventBus().unsubscribe(*this);
+	m_journal->update(m_gs.colorList());
+	m_journal->flush();
+}
+bool AutoSave::restore(ColorList &colorList) {
+	auto result = m_journal->restore(colorList);
+	if (!result) {
+		std::cerr << "failed to restore autosaved palette: " << result.error() << std::endl;
+		return false;
+	}
+	return true;
+}
+void AutoSave::start() {
+	if (m_timeoutId != 0)
+		return;
+	m_journal->reset(m_gs.colorList());
+	m_gs.eventBus().subscribe(EventType::paletteChanged, *this);
+	m_timeoutId = g_timeout_add_seconds(2, (GSourceFunc)onTimeout, this);
+}
+void AutoSave::onEvent(EventType eventType) {
+	switch (eventType) {
+	case EventType::paletteChanged:
+		m_journal->update(m_gs.colorList());
+		break;
+	case EventType::optionsUpdate:
+	case EventType::convertersUpdate:
+	case EventType::displayFiltersUpdate:
+	case EventType::colorDictionaryUpdate:
+		break;
 	}
 }
+int AutoSave::onTimeout(AutoSave *autoSave) {
+	autoSave->m_journal->update(autoSave->m_gs.colorList());
+	return true;
+}
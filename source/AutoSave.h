@@ -18,6 +18,33 @@
 
 #ifndef GPICK_AUTO_SAVE_H_
 #define GPICK_AUTO_SAVE_H_
+#include "EventBus.h"
+#include <memory>
 struct ColorList;
-void autoSave(ColorList &colorList);
+struct GlobalState;
+struct PaletteJournal;
+/** \struct AutoSave
+ * \brief Keeps main palette saved in configuration directory while program is running.
+ *
+ * Palette changes are journaled when palette changed event is triggered and periodically, to catch changes made without that event.
+ */
+struct AutoSave: public IEventHandler {
+	AutoSave(GlobalState &gs);
+	/** Journal remaining changes of main palette and wait until they are written. */
+	virtual ~AutoSave();
+	/**
+	 * Load saved palette.
+	 * @param[out] colorList Destination color list.
+	 * @return True on success.
+	 */
+	bool restore(ColorList &colorList);
+	/** Start journaling changes of main palette. Current main palette contents are used as the initial state. */
+	void start();
+	virtual void onEvent(EventType eventType) override;
+private:
+	GlobalState &m_gs;
+	std::unique_ptr<PaletteJournal> m_journal;
+	unsigned int m_timeoutId;
+	static int onTimeout(AutoSave *autoSave);
+};
 #endif /* GPICK_AUTO_SAVE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ChannelKeys.h"
+#include "Channels.h"
+#include "ColorSpaces.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "common/Parallel.h"
+#include <functional>
+namespace {
+const size_t minChunkSize = 1 << 14;
+}
+ChannelKeys::ChannelKeys(const ColorList &colorList) {
+	m_colors.reserve(colorList.size());
+	for (auto *colorObject: colorList)
+		m_colors.push_back(colorObject->getColor());
+}
+size_t ChannelKeys::size() const {
+	return m_colors.size();
+}
+common::Span<const float> ChannelKeys::get(const ChannelDescription &channel) {
+	auto i = m_values.find(&channel);
+	if (i != m_values.end())
+		return common::Span<const float>(i->second.data(), i->second.size());
+	const size_t count = m_colors.size();
+	if (channel.useConvertTo()) {
+		auto &values = m_values[&channel];
+		values.resize(count);
+		common::parallelFor(count, minChunkSize, [this, &channel, &values](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				values[i] = channel.convertTo(m_colors[i]);
+		});
+		return common::Span<const float>(values.data(), count);
+	}
+	std::vector<const ChannelDescription *> spaceChannels;
+	std::vector<float *> spaceValues;
+	for (const auto &description: channels()) {
+		if (description.useConvertTo() || description.colorSpace != channel.colorSpace)
+			continue;
+		auto &values = m_values[&description];
+		values.resize(count);
+		spaceChannels.push_back(&description);
+		spaceValues.push_back(values.data());
+	}
+	if (m_values.count(&channel) == 0) {
+		auto &values = m_values[&channel];
+		values.resize(count);
+		spaceChannels.push_back(&channel);
+		spaceValues.push_back(values.data());
+	}
+	auto convertTo = colorSpace(channel.colorSpace).convertTo;
+	common::parallelFor(count, minChunkSize, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			Color color = std::invoke(convertTo, m_colors[i]);
+			for (size_t j = 0; j < spaceChannels.size(); j++) {
+				const auto &description = *spaceChannels[j];
+				spaceValues[j][i] = (color.data[description.index] - description.min) / (description.max - description.min);
+			}
+		}
+	});
+	const auto &values = m_values[&channel];
+	return common::Span<const float>(values.data(), count);
+}
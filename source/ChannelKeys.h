@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "common/Span.h"
+#include <unordered_map>
+#include <vector>
+struct ChannelDescription;
+struct ColorList;
+/** \struct ChannelKeys
+ * \brief Normalized channel values of a fixed set of colors, stored as one array per channel.
+ *
+ * Colors are converted to each color space only once, when the first channel of that color space is requested. All channels of the color space are stored at the same time,
+ * so later requests, for example while updating sort preview, only return stored values.
+ */
+struct ChannelKeys {
+	/**
+	 * Copy colors of all color objects in a color list.
+	 * @param[in] colorList Color list.
+	 */
+	explicit ChannelKeys(const ColorList &colorList);
+	size_t size() const;
+	/**
+	 * Get channel values of all colors. Values are normalized using channel minimum and maximum values.
+	 * @param[in] channel Channel description. Must stay valid while channel keys exist.
+	 * @return Channel values in color list order. Valid while channel keys exist.
+	 */
+	common::Span<const float> get(const ChannelDescription &channel);
+private:
+	std::vector<Color> m_colors;
+	std::unordered_map<const ChannelDescription *, std::vector<float>> m_values;
+};
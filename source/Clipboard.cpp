@@ -59,26 +59,16 @@ static void setData(GtkClipboard *, GtkSelectionData *selectionData, Target targ
 		return;
 	switch (targetType) {
 	case Target::string: {
-		std::stringstream text;
-		std::string textLine;
-		ConverterSerializePosition position(args->colors.size());
-		if (position.count() > 0) {
-			for (auto *color: args->colors) {
-				if (position.index() + 1 == position.count())
-					position.last(true);
-				textLine = args->converter->serialize(*color, position);
-				if (position.first()) {
-					text << textLine;
-					position.first(false);
-				} else {
-					text << "\n" << textLine;
-				}
-				position.incrementIndex();
-			}
+		std::vector<const ColorObject *> colorObjects(args->colors.begin(), args->colors.end());
+		auto textLines = args->converter->serialize(common::Span<const ColorObject *const>(colorObjects.data(), colorObjects.size()));
+		std::string text;
+		for (size_t i = 0; i < textLines.size(); i++) {
+			if (i != 0)
+				text += '\n';
+			text += textLines[i];
 		}
-		textLine = text.str();
-		if (textLine.length() > 0)
-			gtk_selection_data_set_text(selectionData, textLine.c_str(), textLine.length());
+		if (text.length() > 0)
+			gtk_selection_data_set_text(selectionData, text.c_str(), text.length());
 	} break;
 	case Target::color: {
 		auto &colorObject = args->colors.front();
@@ -326,10 +316,15 @@ bool colorObjectAvailable() {
 		case Target::string: {
 			auto data = gtk_selection_data_get_data(selectionData);
 			auto text = std::string(reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + gtk_selection_data_get_length(selectionData));
-			ColorObject colorObject;
-			//TODO: multiple colors should be extracted from string, but converters do not support this right now
-			if (gs.converters().deserialize(text.c_str(), colorObject)) {
-				colorList->add(colorObject);
+			auto colorObjects = gs.converters().deserializeLines(text, true);
+			if (colorObjects.empty()) {
+				ColorObject colorObject;
+				if (gs.converters().deserialize(text.c_str(), colorObject))
+					colorObjects.push_back(colorObject);
+			}
+			if (!colorObjects.empty()) {
+				for (const auto &colorObject: colorObjects)
+					colorList->add(colorObject);
 				success = true;
 				return VisitResult::stop;
 			}
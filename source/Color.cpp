@@ -17,6 +17,7 @@
  */
 
 #include "Color.h"
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <tuple>
@@ -36,6 +37,12 @@ const Color::Matrix3d &Color::sRGBMatrix = sRGBTransformation;
 const Color::Matrix3d &Color::sRGBInvertedMatrix = sRGBTransformationInverted;
 const Color::Matrix3d &Color::d65d50AdaptationMatrix = d65d50AdaptationMatrixValue;
 const Color::Matrix3d &Color::d50d65AdaptationMatrix = d50d65AdaptationMatrixValue;
+static std::array<float, 256> linearRgbTableValue;
+// Values of the power part of linear to non-linear RGB transformation at squared positions, so that steep beginning of the curve gets more
+// table entries. Linear part is not stored, otherwise interpolation would smooth out the place where both parts meet.
+static const int nonLinearRgbTableSize = 1024;
+static std::array<float, nonLinearRgbTableSize + 1> nonLinearRgbTable;
+const std::array<float, 256> &Color::linearRgbTable = linearRgbTableValue;
 static Color::Vector3f references[][2] = {
 	{ { 109.850f, 100.000f, 35.585f }, { 111.144f, 100.000f, 35.200f } },
 	{ { 98.074f, 100.000f, 118.232f }, { 97.285f, 100.000f, 116.145f } },
@@ -53,6 +60,14 @@ void Color::initialize() {
 	sRGBTransformationInverted = sRGBTransformation.inverse().value();
 	d65d50AdaptationMatrixValue = getChromaticAdaptationMatrix(getReference(ReferenceIlluminant::D65, ReferenceObserver::_2), getReference(ReferenceIlluminant::D50, ReferenceObserver::_2));
 	d50d65AdaptationMatrixValue = getChromaticAdaptationMatrix(getReference(ReferenceIlluminant::D50, ReferenceObserver::_2), getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
+	for (int i = 0; i < 256; i++) {
+		linearRgbTableValue[i] = Color(i / 255.0f).linearRgb().red;
+	}
+	for (int i = 0; i <= nonLinearRgbTableSize; i++) {
+		double position = static_cast<double>(i) / nonLinearRgbTableSize;
+		position *= position;
+		nonLinearRgbTable[i] = static_cast<float>(1.055 * std::pow(position, 1 / 2.4) - 0.055);
+	}
 }
 namespace util {
 template<typename T>
@@ -366,6 +381,30 @@ Color Color::nonLinearRgb() const {
 	result.alpha = alpha;
 	return result;
 }
+static float nonLinearRgbFastValue(float value) {
+	if (!(value > 0.0031308f))
+		return value * 12.92f;
+	if (value > 1.0f)
+		return (1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f;
+	float position = std::sqrt(value) * nonLinearRgbTableSize;
+	int index = std::min(static_cast<int>(position), nonLinearRgbTableSize - 1);
+	float fraction = position - static_cast<float>(index);
+	return nonLinearRgbTable[index] + (nonLinearRgbTable[index + 1] - nonLinearRgbTable[index]) * fraction;
+}
+Color &Color::nonLinearRgbFastInplace() {
+	rgb.red = nonLinearRgbFastValue(rgb.red);
+	rgb.green = nonLinearRgbFastValue(rgb.green);
+	rgb.blue = nonLinearRgbFastValue(rgb.blue);
+	return *this;
+}
+Color Color::nonLinearRgbFast() const {
+	Color result;
+	result.red = nonLinearRgbFastValue(rgb.red);
+	result.green = nonLinearRgbFastValue(rgb.green);
+	result.blue = nonLinearRgbFastValue(rgb.blue);
+	result.alpha = alpha;
+	return result;
+}
 Color &Color::nonLinearRgbInplace() {
 	if (rgb.red > 0.0031308f)
 		rgb.red = (1.055f * std::pow(rgb.red, 1.0f / 2.4f)) - 0.055f;
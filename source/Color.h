@@ -21,6 +21,7 @@
 
 #include "math/Matrix.h"
 #include "math/Vector.h"
+#include <array>
 #include <string>
 #include <cstdint>
 
@@ -77,6 +78,10 @@ struct Color {
 	 * D50 to D65 chromatic adaptation matrix.
 	 */
 	static const Matrix3d &d50d65AdaptationMatrix;
+	/**
+	 * Lookup table for 8-bit RGB value conversion into linear RGB value.
+	 */
+	static const std::array<float, 256> &linearRgbTable;
 	/**
 	 * Initialize things needed for color conversion functions. Must be called before using any other functions.
 	 */
@@ -185,6 +190,33 @@ struct Color {
 	 * @return Color in RGB color space.
 	 */
 	Color nonLinearRgb() const;
+	/**
+	 * Transform linear RGB color to RGB color using lookup table with linear interpolation.
+	 * Maximum error is below 1e-6 for values in [0, 1] range, other values are transformed precisely.
+	 * @return Color in RGB color space.
+	 */
+	Color &nonLinearRgbFastInplace();
+	/**
+	 * Transform linear RGB color to RGB color using lookup table with linear interpolation.
+	 * Maximum error is below 1e-6 for values in [0, 1] range, other values are transformed precisely.
+	 * @return Color in RGB color space.
+	 */
+	Color nonLinearRgbFast() const;
+	/**
+	 * Transform 8-bit RGB value to linear RGB value using lookup table.
+	 * @param[in] value RGB value.
+	 * @return Linear RGB value.
+	 */
+	static float linearRgbFromUint8(uint8_t value);
+	/**
+	 * Create linear RGB color from 8-bit RGB values using lookup table.
+	 * @param[in] red Red value.
+	 * @param[in] green Green value.
+	 * @param[in] blue Blue value.
+	 * @param[in] alpha Alpha value.
+	 * @return Linear color in RGB color space.
+	 */
+	static Color linearRgbFromUint8(uint8_t red, uint8_t green, uint8_t blue, float alpha = 1.0f);
 	/**
 	 * Set all color values to absolute values.
 	 * @return Color with absolute values.
@@ -489,4 +521,10 @@ struct Color {
 		float data[MemberCount]; /**< General data access array */
 	};
 };
+inline float Color::linearRgbFromUint8(uint8_t value) {
+	return linearRgbTable[value];
+}
+inline Color Color::linearRgbFromUint8(uint8_t red, uint8_t green, uint8_t blue, float alpha) {
+	return Color(linearRgbTable[red], linearRgbTable[green], linearRgbTable[blue], alpha);
+}
 #endif /* GPICK_COLOR_H_ */
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorBatch.h"
+#include "ColorBatchKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+namespace color_batch {
+namespace {
+struct Scalar {
+	using F = float;
+	using M = bool;
+	static const size_t width = 1;
+	static F load(const float *values) {
+		return *values;
+	}
+	static void store(float *values, F value) {
+		*values = value;
+	}
+	static F set1(float value) {
+		return value;
+	}
+	static F add(F a, F b) {
+		return a + b;
+	}
+	static F sub(F a, F b) {
+		return a - b;
+	}
+	static F mul(F a, F b) {
+		return a * b;
+	}
+	static F div(F a, F b) {
+		return a / b;
+	}
+	static F fmadd(F a, F b, F c) {
+		return a * b + c;
+	}
+	static F min(F a, F b) {
+		return std::min(a, b);
+	}
+	static F max(F a, F b) {
+		return std::max(a, b);
+	}
+	static F floor(F a) {
+		return std::floor(a);
+	}
+	static F sqrt(F a) {
+		return std::sqrt(a);
+	}
+	static M gt(F a, F b) {
+		return a > b;
+	}
+	static F select(M mask, F a, F b) {
+		return mask ? a : b;
+	}
+	static F pow(F x, F y) {
+		return std::pow(x, y);
+	}
+	static F cbrt(F x) {
+		return std::cbrt(x);
+	}
+	static F atan2Degrees(F y, F x) {
+		if (x == 0 && y == 0)
+			return 0;
+		F degrees = std::atan2(y, x) * (180.0f / pi);
+		if (degrees < 0)
+			degrees += 360;
+		if (degrees >= 360)
+			degrees -= 360;
+		return degrees;
+	}
+	static void sinCosDegrees(F degrees, F &sine, F &cosine) {
+		sine = std::sin(degrees * (pi / 180.0f));
+		cosine = std::cos(degrees * (pi / 180.0f));
+	}
+};
+bool cpuSupportsSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;
+#elif defined(__GNUC__) && defined(__i386__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER) && defined(_M_IX86)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return false;
+#endif
+}
+bool cpuSupportsAvx2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	const int fma = 1 << 12, osxsave = 1 << 27, avx = 1 << 28;
+	if ((info[2] & (fma | osxsave | avx)) != (fma | osxsave | avx))
+		return false;
+	if ((_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+Instructions detectInstructions() {
+	if (avx2::enabled && cpuSupportsAvx2())
+		return Instructions::avx2;
+	if (sse2::enabled && cpuSupportsSse2())
+		return Instructions::sse2;
+	return Instructions::scalar;
+}
+const Instructions bestInstructions = detectInstructions();
+std::atomic<Instructions> currentInstructions(bestInstructions);
+void convert(Operation operation, const Parameters &parameters, const Channels &channels) {
+	switch (currentInstructions.load(std::memory_order_relaxed)) {
+	case Instructions::avx2:
+		avx2::convert(operation, parameters, channels.data[0], channels.data[1], channels.data[2], channels.size);
+		break;
+	case Instructions::sse2:
+		sse2::convert(operation, parameters, channels.data[0], channels.data[1], channels.data[2], channels.size);
+		break;
+	case Instructions::scalar:
+		Kernels<Scalar>::convert(operation, parameters, channels.data[0], channels.data[1], channels.data[2], channels.size);
+		break;
+	}
+}
+void convert(Operation operation, const Channels &channels) {
+	Parameters parameters {};
+	convert(operation, parameters, channels);
+}
+Parameters makeParameters(const Color::Matrix3d &transformation, const Color::Matrix3d &adaptation) {
+	Parameters parameters {};
+	for (int column = 0; column < 3; column++) {
+		Color::Vector3d unit(column == 0 ? 1 : 0, column == 1 ? 1 : 0, column == 2 ? 1 : 0);
+		auto result = adaptation * (transformation * unit);
+		for (int row = 0; row < 3; row++)
+			parameters.matrix[row * 3 + column] = static_cast<float>(result[row]);
+	}
+	return parameters;
+}
+Parameters makeParameters(const Color::Vector3f &referenceWhite) {
+	Parameters parameters {};
+	for (int i = 0; i < 3; i++)
+		parameters.referenceWhite[i] = referenceWhite[i];
+	return parameters;
+}
+Parameters makeParameters(const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformation, const Color::Matrix3d &adaptation) {
+	Parameters parameters = makeParameters(transformation, adaptation);
+	for (int i = 0; i < 3; i++)
+		parameters.referenceWhite[i] = referenceWhite[i];
+	return parameters;
+}
+const Color::Vector3f &d50() {
+	return Color::getReference(ReferenceIlluminant::D50, ReferenceObserver::_2);
+}
+}
+Instructions supportedInstructions() {
+	return bestInstructions;
+}
+Instructions activeInstructions() {
+	return currentInstructions.load(std::memory_order_relaxed);
+}
+Instructions setInstructions(Instructions instructions) {
+	instructions = std::min(instructions, bestInstructions);
+	currentInstructions.store(instructions, std::memory_order_relaxed);
+	return instructions;
+}
+Channels::Channels(float *first, float *second, float *third, size_t size):
+	data { first, second, third },
+	size(size) {
+}
+Channels::Channels(common::Span<float> first, common::Span<float> second, common::Span<float> third):
+	data { first.data(), second.data(), third.data() },
+	size(first.size()) {
+	if (second.size() != size || third.size() != size)
+		throw std::invalid_argument("channel sizes do not match");
+}
+void split(common::Span<const Color> colors, const Channels &channels) {
+	if (colors.size() != channels.size)
+		throw std::invalid_argument("color count does not match channel size");
+	for (size_t i = 0; i < channels.size; i++) {
+		channels.data[0][i] = colors[i].data[0];
+		channels.data[1][i] = colors[i].data[1];
+		channels.data[2][i] = colors[i].data[2];
+	}
+}
+void join(const Channels &channels, common::Span<Color> colors) {
+	if (colors.size() != channels.size)
+		throw std::invalid_argument("color count does not match channel size");
+	for (size_t i = 0; i < channels.size; i++) {
+		colors[i].data[0] = channels.data[0][i];
+		colors[i].data[1] = channels.data[1][i];
+		colors[i].data[2] = channels.data[2][i];
+	}
+}
+void linearRgb(const Channels &channels) {
+	convert(Operation::linearRgb, channels);
+}
+void nonLinearRgb(const Channels &channels) {
+	convert(Operation::nonLinearRgb, channels);
+}
+void rgbToXyz(const Channels &channels, const Color::Matrix3d &transformation) {
+	convert(Operation::rgbToXyz, makeParameters(transformation, Color::Matrix3d()), channels);
+}
+void xyzToRgb(const Channels &channels, const Color::Matrix3d &transformationInverted) {
+	convert(Operation::xyzToRgb, makeParameters(transformationInverted, Color::Matrix3d()), channels);
+}
+void xyzToLab(const Channels &channels, const Color::Vector3f &referenceWhite) {
+	convert(Operation::xyzToLab, makeParameters(referenceWhite), channels);
+}
+void labToXyz(const Channels &channels, const Color::Vector3f &referenceWhite) {
+	convert(Operation::labToXyz, makeParameters(referenceWhite), channels);
+}
+void labToLch(const Channels &channels) {
+	convert(Operation::labToLch, channels);
+}
+void lchToLab(const Channels &channels) {
+	convert(Operation::lchToLab, channels);
+}
+void rgbToLab(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformation, const Color::Matrix3d &adaptationMatrix) {
+	convert(Operation::rgbToLab, makeParameters(referenceWhite, transformation, adaptationMatrix), channels);
+}
+void labToRgb(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformationInverted, const Color::Matrix3d &adaptationMatrixInverted) {
+	convert(Operation::labToRgb, makeParameters(referenceWhite, adaptationMatrixInverted, transformationInverted), channels);
+}
+void rgbToLch(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformation, const Color::Matrix3d &adaptationMatrix) {
+	convert(Operation::rgbToLch, makeParameters(referenceWhite, transformation, adaptationMatrix), channels);
+}
+void lchToRgb(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformationInverted, const Color::Matrix3d &adaptationMatrixInverted) {
+	convert(Operation::lchToRgb, makeParameters(referenceWhite, adaptationMatrixInverted, transformationInverted), channels);
+}
+void rgbToLabD50(const Channels &channels) {
+	rgbToLab(channels, d50(), Color::sRGBMatrix, Color::d65d50AdaptationMatrix);
+}
+void labToRgbD50(const Channels &channels) {
+	labToRgb(channels, d50(), Color::sRGBInvertedMatrix, Color::d50d65AdaptationMatrix);
+}
+void rgbToLchD50(const Channels &channels) {
+	rgbToLch(channels, d50(), Color::sRGBMatrix, Color::d65d50AdaptationMatrix);
+}
+void lchToRgbD50(const Channels &channels) {
+	lchToRgb(channels, d50(), Color::sRGBInvertedMatrix, Color::d50d65AdaptationMatrix);
+}
+void hsvToRgb(const Channels &channels) {
+	convert(Operation::hsvToRgb, channels);
+}
+void hslToRgb(const Channels &channels) {
+	convert(Operation::hslToRgb, channels);
+}
+void rgbToArgb32(const Channels &channels, uint32_t *pixels) {
+	const float *red = channels.data[0], *green = channels.data[1], *blue = channels.data[2];
+	for (size_t i = 0; i < channels.size; i++) {
+		auto r = static_cast<uint32_t>(std::min(std::max(red[i], 0.0f), 1.0f) * 255);
+		auto g = static_cast<uint32_t>(std::min(std::max(green[i], 0.0f), 1.0f) * 255);
+		auto b = static_cast<uint32_t>(std::min(std::max(blue[i], 0.0f), 1.0f) * 255);
+		pixels[i] = 0xff000000u | (r << 16) | (g << 8) | b;
+	}
+}
+}
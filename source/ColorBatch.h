@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "common/Span.h"
+#include <cstdint>
+/** \file source/ColorBatch.h
+ * \brief Batch color space conversions on structure-of-arrays float buffers.
+ */
+namespace color_batch {
+/** \enum Instructions
+ * \brief Instruction set used by conversion kernels.
+ */
+enum class Instructions : uint8_t {
+	scalar = 0,
+	sse2 = 1,
+	avx2 = 2,
+};
+/**
+ * Get best instruction set supported by both the build and the CPU.
+ * @return Instruction set.
+ */
+Instructions supportedInstructions();
+/**
+ * Get instruction set currently used by conversion kernels.
+ * @return Instruction set.
+ */
+Instructions activeInstructions();
+/**
+ * Select instruction set used by conversion kernels. Instruction sets which are not supported are replaced with best supported instruction set.
+ * @param[in] instructions Instruction set.
+ * @return Selected instruction set.
+ */
+Instructions setInstructions(Instructions instructions);
+/** \struct Channels
+ * \brief Three equally sized channel buffers, for example red, green and blue or L, a and b.
+ * All conversions are done in place.
+ */
+struct Channels {
+	Channels(float *first, float *second, float *third, size_t size);
+	Channels(common::Span<float> first, common::Span<float> second, common::Span<float> third);
+	float *data[3];
+	size_t size;
+};
+/**
+ * Copy first three channels of each color into channel buffers.
+ * @param[in] colors Source colors.
+ * @param[out] channels Destination channels. Must have the same size as colors.
+ */
+void split(common::Span<const Color> colors, const Channels &channels);
+/**
+ * Copy channel buffers into first three channels of each color. Alpha channel is not changed.
+ * @param[in] channels Source channels.
+ * @param[out] colors Destination colors. Must have the same size as channels.
+ */
+void join(const Channels &channels, common::Span<Color> colors);
+/**
+ * Conversions below have the same meaning and parameters as Color methods with matching names, but are calculated in single precision
+ * for all values in channel buffers at once.
+ * @param[in,out] channels Channel buffers.
+ */
+void linearRgb(const Channels &channels);
+void nonLinearRgb(const Channels &channels);
+void rgbToXyz(const Channels &channels, const Color::Matrix3d &transformation);
+void xyzToRgb(const Channels &channels, const Color::Matrix3d &transformationInverted);
+void xyzToLab(const Channels &channels, const Color::Vector3f &referenceWhite);
+void labToXyz(const Channels &channels, const Color::Vector3f &referenceWhite);
+void labToLch(const Channels &channels);
+void lchToLab(const Channels &channels);
+void rgbToLab(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformation, const Color::Matrix3d &adaptationMatrix);
+void labToRgb(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformationInverted, const Color::Matrix3d &adaptationMatrixInverted);
+void rgbToLch(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformation, const Color::Matrix3d &adaptationMatrix);
+void lchToRgb(const Channels &channels, const Color::Vector3f &referenceWhite, const Color::Matrix3d &transformationInverted, const Color::Matrix3d &adaptationMatrixInverted);
+void rgbToLabD50(const Channels &channels);
+void labToRgbD50(const Channels &channels);
+void rgbToLchD50(const Channels &channels);
+void lchToRgbD50(const Channels &channels);
+void hsvToRgb(const Channels &channels);
+void hslToRgb(const Channels &channels);
+/**
+ * Convert RGB channel buffers into opaque 8-bit per channel pixels with CAIRO_FORMAT_ARGB32 layout. Values are clamped into [0, 1] range.
+ * @param[in] channels Source RGB channels.
+ * @param[out] pixels Destination pixels. Must have the same size as channels.
+ */
+void rgbToArgb32(const Channels &channels, uint32_t *pixels);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorBatchKernels.h"
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+namespace color_batch {
+namespace {
+struct Avx2 {
+	using F = __m256;
+	using I = __m256i;
+	using M = __m256;
+	static const size_t width = 8;
+	static F load(const float *values) {
+		return _mm256_loadu_ps(values);
+	}
+	static void store(float *values, F value) {
+		_mm256_storeu_ps(values, value);
+	}
+	static F set1(float value) {
+		return _mm256_set1_ps(value);
+	}
+	static F add(F a, F b) {
+		return _mm256_add_ps(a, b);
+	}
+	static F sub(F a, F b) {
+		return _mm256_sub_ps(a, b);
+	}
+	static F mul(F a, F b) {
+		return _mm256_mul_ps(a, b);
+	}
+	static F div(F a, F b) {
+		return _mm256_div_ps(a, b);
+	}
+	static F fmadd(F a, F b, F c) {
+		return _mm256_fmadd_ps(a, b, c);
+	}
+	static F min(F a, F b) {
+		return _mm256_min_ps(a, b);
+	}
+	static F max(F a, F b) {
+		return _mm256_max_ps(a, b);
+	}
+	static F sqrt(F a) {
+		return _mm256_sqrt_ps(a);
+	}
+	static F abs(F a) {
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+	}
+	static M gt(F a, F b) {
+		return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+	}
+	static M lt(F a, F b) {
+		return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+	}
+	static F select(M mask, F a, F b) {
+		return _mm256_blendv_ps(b, a, mask);
+	}
+	static I toBits(F a) {
+		return _mm256_castps_si256(a);
+	}
+	static F fromBits(I a) {
+		return _mm256_castsi256_ps(a);
+	}
+	static I setInt(int32_t value) {
+		return _mm256_set1_epi32(value);
+	}
+	static I addInt(I a, I b) {
+		return _mm256_add_epi32(a, b);
+	}
+	static I subInt(I a, I b) {
+		return _mm256_sub_epi32(a, b);
+	}
+	static I andInt(I a, I b) {
+		return _mm256_and_si256(a, b);
+	}
+	static I orInt(I a, I b) {
+		return _mm256_or_si256(a, b);
+	}
+	static M equalInt(I a, I b) {
+		return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b));
+	}
+	template<int bits>
+	static I shiftLeft(I a) {
+		return _mm256_slli_epi32(a, bits);
+	}
+	template<int bits>
+	static I shiftRight(I a) {
+		return _mm256_srli_epi32(a, bits);
+	}
+	static F xorBits(F a, I b) {
+		return _mm256_xor_ps(a, _mm256_castsi256_ps(b));
+	}
+	static F toFloat(I a) {
+		return _mm256_cvtepi32_ps(a);
+	}
+	static I roundToInt(F a) {
+		return _mm256_cvtps_epi32(a);
+	}
+	static F floor(F a) {
+		return _mm256_floor_ps(a);
+	}
+	static F pow(F x, F y) {
+		return vectorPow<Avx2>(x, y);
+	}
+	static F cbrt(F x) {
+		return vectorPow<Avx2>(x, set1(1.0f / 3.0f));
+	}
+	static F atan2Degrees(F y, F x) {
+		return vectorAtan2Degrees<Avx2>(y, x);
+	}
+	static void sinCosDegrees(F degrees, F &sine, F &cosine) {
+		vectorSinCosDegrees<Avx2>(degrees, sine, cosine);
+	}
+};
+}
+namespace avx2 {
+extern const bool enabled = true;
+void convert(Operation operation, const Parameters &parameters, float *x, float *y, float *z, size_t size) {
+	Kernels<Avx2>::convert(operation, parameters, x, y, z, size);
+}
+}
+}
+#else
+namespace color_batch {
+namespace avx2 {
+extern const bool enabled = false;
+void convert(Operation, const Parameters &, float *, float *, float *, size_t) {
+}
+}
+}
+#endif
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+/** \file source/ColorBatchKernels.h
+ * \brief Color conversion kernels shared by instruction set specific translation units.
+ *
+ * This header is included into translation units compiled with different instruction set flags, so everything except the entry
+ * points has internal linkage and only compiler intrinsics are used. Otherwise linker could pick a function instance containing
+ * instructions not supported by the CPU.
+ */
+namespace color_batch {
+enum class Operation : uint8_t {
+	linearRgb,
+	nonLinearRgb,
+	rgbToXyz,
+	xyzToRgb,
+	xyzToLab,
+	labToXyz,
+	labToLch,
+	lchToLab,
+	rgbToLab,
+	labToRgb,
+	rgbToLch,
+	lchToRgb,
+	hsvToRgb,
+	hslToRgb,
+};
+struct Parameters {
+	/** Row major transformation matrix, already combined with chromatic adaptation matrix. */
+	float matrix[9];
+	float referenceWhite[3];
+};
+namespace sse2 {
+/** True when kernels were compiled with SSE2 support. */
+extern const bool enabled;
+void convert(Operation operation, const Parameters &parameters, float *x, float *y, float *z, size_t size);
+}
+namespace avx2 {
+/** True when kernels were compiled with AVX2 and FMA support. */
+extern const bool enabled;
+void convert(Operation operation, const Parameters &parameters, float *x, float *y, float *z, size_t size);
+}
+namespace {
+const float epsilon = 216.0f / 24389.0f;
+const float kk = 24389.0f / 27.0f;
+const float pi = 3.14159265358979323846f;
+// Vector versions of logarithm, exponent and trigonometric functions use polynomial approximations from Cephes library.
+template<typename T>
+typename T::F vectorLog2(typename T::F x) {
+	using F = typename T::F;
+	using I = typename T::I;
+	I bits = T::toBits(x);
+	F exponent = T::toFloat(T::subInt(T::template shiftRight<23>(bits), T::setInt(126)));
+	F mantissa = T::fromBits(T::orInt(T::andInt(bits, T::setInt(0x007fffff)), T::setInt(0x3f000000)));
+	auto small = T::lt(mantissa, T::set1(0.707106781186547524f));
+	exponent = T::select(small, T::sub(exponent, T::set1(1.0f)), exponent);
+	mantissa = T::select(small, T::add(mantissa, mantissa), mantissa);
+	F t = T::sub(mantissa, T::set1(1.0f));
+	F t2 = T::mul(t, t);
+	F y = T::set1(7.0376836292e-2f);
+	y = T::fmadd(y, t, T::set1(-1.1514610310e-1f));
+	y = T::fmadd(y, t, T::set1(1.1676998740e-1f));
+	y = T::fmadd(y, t, T::set1(-1.2420140846e-1f));
+	y = T::fmadd(y, t, T::set1(1.4249322787e-1f));
+	y = T::fmadd(y, t, T::set1(-1.6668057665e-1f));
+	y = T::fmadd(y, t, T::set1(2.0000714765e-1f));
+	y = T::fmadd(y, t, T::set1(-2.4999993993e-1f));
+	y = T::fmadd(y, t, T::set1(3.3333331174e-1f));
+	y = T::mul(T::mul(y, t), t2);
+	y = T::fmadd(t2, T::set1(-0.5f), y);
+	return T::fmadd(T::add(t, y), T::set1(1.44269504088896341f), exponent);
+}
+template<typename T>
+typename T::F vectorExp2(typename T::F x) {
+	using F = typename T::F;
+	using I = typename T::I;
+	x = T::min(T::max(x, T::set1(-126.0f)), T::set1(126.0f));
+	I n = T::roundToInt(x);
+	F f = T::sub(x, T::toFloat(n));
+	F y = T::set1(1.535336188319500e-4f);
+	y = T::fmadd(y, f, T::set1(1.339887440266574e-3f));
+	y = T::fmadd(y, f, T::set1(9.618437357674640e-3f));
+	y = T::fmadd(y, f, T::set1(5.550332471162809e-2f));
+	y = T::fmadd(y, f, T::set1(2.402264791363012e-1f));
+	y = T::fmadd(y, f, T::set1(6.931472028550421e-1f));
+	y = T::fmadd(y, f, T::set1(1.0f));
+	return T::mul(y, T::fromBits(T::template shiftLeft<23>(T::addInt(n, T::setInt(127)))));
+}
+template<typename T>
+typename T::F vectorFloor(typename T::F x) {
+	typename T::F rounded = T::toFloat(T::roundToInt(x));
+	return T::select(T::gt(rounded, x), T::sub(rounded, T::set1(1.0f)), rounded);
+}
+template<typename T>
+typename T::F vectorPow(typename T::F x, typename T::F y) {
+	return vectorExp2<T>(T::mul(y, vectorLog2<T>(x)));
+}
+template<typename T>
+typename T::F vectorAtan2Degrees(typename T::F y, typename T::F x) {
+	using F = typename T::F;
+	F ax = T::abs(x), ay = T::abs(y);
+	F high = T::max(ax, ay), low = T::min(ax, ay);
+	F t = T::div(low, T::select(T::gt(high, T::set1(0.0f)), high, T::set1(1.0f)));
+	auto reduce = T::gt(t, T::set1(0.414213562373095f));
+	F z = T::select(reduce, T::div(T::sub(t, T::set1(1.0f)), T::add(t, T::set1(1.0f))), t);
+	F z2 = T::mul(z, z);
+	F p = T::set1(8.05374449538e-2f);
+	p = T::fmadd(p, z2, T::set1(-1.38776856032e-1f));
+	p = T::fmadd(p, z2, T::set1(1.99777106478e-1f));
+	p = T::fmadd(p, z2, T::set1(-3.33329491539e-1f));
+	F angle = T::add(T::fmadd(T::mul(p, z2), z, z), T::select(reduce, T::set1(pi / 4), T::set1(0.0f)));
+	angle = T::select(T::gt(ay, ax), T::sub(T::set1(pi / 2), angle), angle);
+	angle = T::select(T::lt(x, T::set1(0.0f)), T::sub(T::set1(pi), angle), angle);
+	F degrees = T::mul(angle, T::set1(180.0f / pi));
+	degrees = T::select(T::lt(y, T::set1(0.0f)), T::sub(T::set1(360.0f), degrees), degrees);
+	return T::select(T::lt(degrees, T::set1(360.0f)), degrees, T::sub(degrees, T::set1(360.0f)));
+}
+template<typename T>
+void vectorSinCosDegrees(typename T::F degrees, typename T::F &sine, typename T::F &cosine) {
+	using F = typename T::F;
+	using I = typename T::I;
+	F x = T::mul(degrees, T::set1(pi / 180.0f));
+	I quadrant = T::roundToInt(T::mul(x, T::set1(2.0f / pi)));
+	F j = T::toFloat(quadrant);
+	x = T::fmadd(j, T::set1(-1.5703125f), x);
+	x = T::fmadd(j, T::set1(-4.837512969970703125e-4f), x);
+	x = T::fmadd(j, T::set1(-7.54978995489188216e-8f), x);
+	F z = T::mul(x, x);
+	F s = T::set1(-1.9515295891e-4f);
+	s = T::fmadd(s, z, T::set1(8.3321608736e-3f));
+	s = T::fmadd(s, z, T::set1(-1.6666654611e-1f));
+	s = T::fmadd(T::mul(s, z), x, x);
+	F c = T::set1(2.443315711809948e-5f);
+	c = T::fmadd(c, z, T::set1(-1.388731625493765e-3f));
+	c = T::fmadd(c, z, T::set1(4.166664568298827e-2f));
+	c = T::fmadd(T::mul(c, z), z, T::fmadd(z, T::set1(-0.5f), T::set1(1.0f)));
+	auto swap = T::equalInt(T::andInt(quadrant, T::setInt(1)), T::setInt(1));
+	sine = T::xorBits(T::select(swap, c, s), T::template shiftLeft<30>(T::andInt(quadrant, T::setInt(2))));
+	cosine = T::xorBits(T::select(swap, s, c), T::template shiftLeft<30>(T::andInt(T::addInt(quadrant, T::setInt(1)), T::setInt(2))));
+}
+/** Conversion kernels for instruction set traits T. Traits provide vector type F and basic arithmetic, comparison and math functions. */
+template<typename T>
+struct Kernels {
+	using F = typename T::F;
+	static F linearize(F value) {
+		F curve = T::pow(T::mul(T::add(value, T::set1(0.055f)), T::set1(1 / 1.055f)), T::set1(2.4f));
+		return T::select(T::gt(value, T::set1(0.04045f)), curve, T::mul(value, T::set1(1 / 12.92f)));
+	}
+	static F delinearize(F value) {
+		F curve = T::fmadd(T::set1(1.055f), T::pow(value, T::set1(1 / 2.4f)), T::set1(-0.055f));
+		return T::select(T::gt(value, T::set1(0.0031308f)), curve, T::mul(value, T::set1(12.92f)));
+	}
+	static void transform(F &x, F &y, F &z, const float *matrix) {
+		F rx = T::fmadd(T::set1(matrix[0]), x, T::fmadd(T::set1(matrix[1]), y, T::mul(T::set1(matrix[2]), z)));
+		F ry = T::fmadd(T::set1(matrix[3]), x, T::fmadd(T::set1(matrix[4]), y, T::mul(T::set1(matrix[5]), z)));
+		F rz = T::fmadd(T::set1(matrix[6]), x, T::fmadd(T::set1(matrix[7]), y, T::mul(T::set1(matrix[8]), z)));
+		x = rx;
+		y = ry;
+		z = rz;
+	}
+	static F labCompand(F value) {
+		return T::select(T::gt(value, T::set1(epsilon)), T::cbrt(value), T::fmadd(value, T::set1(kk / 116.0f), T::set1(16.0f / 116.0f)));
+	}
+	static F labExpand(F value) {
+		F cube = T::mul(T::mul(value, value), value);
+		return T::select(T::gt(cube, T::set1(epsilon)), cube, T::fmadd(value, T::set1(116.0f / kk), T::set1(-16.0f / kk)));
+	}
+	static void xyzToLab(F &x, F &y, F &z, const float *referenceWhite) {
+		F fx = labCompand(T::mul(x, T::set1(1 / referenceWhite[0])));
+		F fy = labCompand(T::mul(y, T::set1(1 / referenceWhite[1])));
+		F fz = labCompand(T::mul(z, T::set1(1 / referenceWhite[2])));
+		x = T::fmadd(fy, T::set1(116.0f), T::set1(-16.0f));
+		y = T::mul(T::sub(fx, fy), T::set1(500.0f));
+		z = T::mul(T::sub(fy, fz), T::set1(200.0f));
+	}
+	static void labToXyz(F &l, F &a, F &b, const float *referenceWhite) {
+		F fy = T::mul(T::add(l, T::set1(16.0f)), T::set1(1 / 116.0f));
+		F fx = T::fmadd(a, T::set1(1 / 500.0f), fy);
+		F fz = T::fmadd(b, T::set1(-1 / 200.0f), fy);
+		F y = T::select(T::gt(l, T::set1(kk * epsilon)), T::mul(T::mul(fy, fy), fy), T::mul(l, T::set1(1 / kk)));
+		l = T::mul(labExpand(fx), T::set1(referenceWhite[0]));
+		a = T::mul(y, T::set1(referenceWhite[1]));
+		b = T::mul(labExpand(fz), T::set1(referenceWhite[2]));
+	}
+	static void labToLch(F &, F &a, F &b) {
+		F c = T::sqrt(T::fmadd(a, a, T::mul(b, b)));
+		b = T::atan2Degrees(b, a);
+		a = c;
+	}
+	static void lchToLab(F &, F &c, F &h) {
+		F sine, cosine;
+		T::sinCosDegrees(h, sine, cosine);
+		h = T::mul(c, sine);
+		c = T::mul(c, cosine);
+	}
+	/** Wrap hue into [0, 1) range and scale it into [0, period) range. */
+	static F hueSector(F hue, float period) {
+		return T::mul(T::sub(hue, T::floor(hue)), T::set1(period));
+	}
+	static F wrapSector(F value, float period) {
+		return T::select(T::gt(T::set1(period), value), value, T::sub(value, T::set1(period)));
+	}
+	static void hsvToRgb(F &h, F &s, F &v) {
+		F sector = hueSector(h, 6.0f);
+		F chroma = T::mul(v, s);
+		auto channel = [&sector, &chroma, &v](float offset) {
+			F k = wrapSector(T::add(sector, T::set1(offset)), 6.0f);
+			F amount = T::max(T::min(T::min(k, T::sub(T::set1(4.0f), k)), T::set1(1.0f)), T::set1(0.0f));
+			return T::sub(v, T::mul(chroma, amount));
+		};
+		F r = channel(5.0f), g = channel(3.0f), b = channel(1.0f);
+		h = r;
+		s = g;
+		v = b;
+	}
+	static void hslToRgb(F &h, F &s, F &l) {
+		F sector = hueSector(h, 12.0f);
+		F chroma = T::mul(s, T::min(l, T::sub(T::set1(1.0f), l)));
+		auto channel = [&sector, &chroma, &l](float offset) {
+			F k = wrapSector(T::add(sector, T::set1(offset)), 12.0f);
+			F amount = T::max(T::min(T::min(T::sub(k, T::set1(3.0f)), T::sub(T::set1(9.0f), k)), T::set1(1.0f)), T::set1(-1.0f));
+			return T::sub(l, T::mul(chroma, amount));
+		};
+		F r = channel(0.0f), g = channel(8.0f), b = channel(4.0f);
+		h = r;
+		s = g;
+		l = b;
+	}
+	template<typename Callback>
+	static void run(float *x, float *y, float *z, size_t size, Callback callback) {
+		size_t i = 0;
+		for (; i + T::width <= size; i += T::width) {
+			F a = T::load(x + i), b = T::load(y + i), c = T::load(z + i);
+			callback(a, b, c);
+			T::store(x + i, a);
+			T::store(y + i, b);
+			T::store(z + i, c);
+		}
+		if (i == size)
+			return;
+		float bufferX[T::width] = {}, bufferY[T::width] = {}, bufferZ[T::width] = {};
+		size_t count = size - i;
+		for (size_t j = 0; j < count; j++) {
+			bufferX[j] = x[i + j];
+			bufferY[j] = y[i + j];
+			bufferZ[j] = z[i + j];
+		}
+		run(bufferX, bufferY, bufferZ, T::width, callback);
+		for (size_t j = 0; j < count; j++) {
+			x[i + j] = bufferX[j];
+			y[i + j] = bufferY[j];
+			z[i + j] = bufferZ[j];
+		}
+	}
+	static void convert(Operation operation, const Parameters &parameters, float *x, float *y, float *z, size_t size) {
+		const float *matrix = parameters.matrix;
+		const float *white = parameters.referenceWhite;
+		switch (operation) {
+		case Operation::linearRgb:
+			run(x, y, z, size, [](F &r, F &g, F &b) {
+				r = linearize(r);
+				g = linearize(g);
+				b = linearize(b);
+			});
+			break;
+		case Operation::nonLinearRgb:
+			run(x, y, z, size, [](F &r, F &g, F &b) {
+				r = delinearize(r);
+				g = delinearize(g);
+				b = delinearize(b);
+			});
+			break;
+		case Operation::rgbToXyz:
+			run(x, y, z, size, [matrix](F &r, F &g, F &b) {
+				r = linearize(r);
+				g = linearize(g);
+				b = linearize(b);
+				transform(r, g, b, matrix);
+			});
+			break;
+		case Operation::xyzToRgb:
+			run(x, y, z, size, [matrix](F &r, F &g, F &b) {
+				transform(r, g, b, matrix);
+				r = delinearize(r);
+				g = delinearize(g);
+				b = delinearize(b);
+			});
+			break;
+		case Operation::xyzToLab:
+			run(x, y, z, size, [white](F &a, F &b, F &c) {
+				xyzToLab(a, b, c, white);
+			});
+			break;
+		case Operation::labToXyz:
+			run(x, y, z, size, [white](F &a, F &b, F &c) {
+				labToXyz(a, b, c, white);
+			});
+			break;
+		case Operation::labToLch:
+			run(x, y, z, size, [](F &a, F &b, F &c) {
+				labToLch(a, b, c);
+			});
+			break;
+		case Operation::lchToLab:
+			run(x, y, z, size, [](F &a, F &b, F &c) {
+				lchToLab(a, b, c);
+			});
+			break;
+		case Operation::rgbToLab:
+		case Operation::rgbToLch:
+			run(x, y, z, size, [matrix, white, operation](F &r, F &g, F &b) {
+				r = linearize(r);
+				g = linearize(g);
+				b = linearize(b);
+				transform(r, g, b, matrix);
+				xyzToLab(r, g, b, white);
+				if (operation == Operation::rgbToLch)
+					labToLch(r, g, b);
+			});
+			break;
+		case Operation::labToRgb:
+		case Operation::lchToRgb:
+			run(x, y, z, size, [matrix, white, operation](F &l, F &a, F &b) {
+				if (operation == Operation::lchToRgb)
+					lchToLab(l, a, b);
+				labToXyz(l, a, b, white);
+				transform(l, a, b, matrix);
+				l = delinearize(l);
+				a = delinearize(a);
+				b = delinearize(b);
+			});
+			break;
+		case Operation::hsvToRgb:
+			run(x, y, z, size, [](F &h, F &s, F &v) {
+				hsvToRgb(h, s, v);
+			});
+			break;
+		case Operation::hslToRgb:
+			run(x, y, z, size, [](F &h, F &s, F &l) {
+				hslToRgb(h, s, l);
+			});
+			break;
+		}
+	}
+};
+}
+}
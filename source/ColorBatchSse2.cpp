@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorBatchKernels.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+namespace color_batch {
+namespace {
+struct Sse2 {
+	using F = __m128;
+	using I = __m128i;
+	using M = __m128;
+	static const size_t width = 4;
+	static F load(const float *values) {
+		return _mm_loadu_ps(values);
+	}
+	static void store(float *values, F value) {
+		_mm_storeu_ps(values, value);
+	}
+	static F set1(float value) {
+		return _mm_set1_ps(value);
+	}
+	static F add(F a, F b) {
+		return _mm_add_ps(a, b);
+	}
+	static F sub(F a, F b) {
+		return _mm_sub_ps(a, b);
+	}
+	static F mul(F a, F b) {
+		return _mm_mul_ps(a, b);
+	}
+	static F div(F a, F b) {
+		return _mm_div_ps(a, b);
+	}
+	static F fmadd(F a, F b, F c) {
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+	}
+	static F min(F a, F b) {
+		return _mm_min_ps(a, b);
+	}
+	static F max(F a, F b) {
+		return _mm_max_ps(a, b);
+	}
+	static F sqrt(F a) {
+		return _mm_sqrt_ps(a);
+	}
+	static F abs(F a) {
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+	}
+	static M gt(F a, F b) {
+		return _mm_cmpgt_ps(a, b);
+	}
+	static M lt(F a, F b) {
+		return _mm_cmplt_ps(a, b);
+	}
+	static F select(M mask, F a, F b) {
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+	static I toBits(F a) {
+		return _mm_castps_si128(a);
+	}
+	static F fromBits(I a) {
+		return _mm_castsi128_ps(a);
+	}
+	static I setInt(int32_t value) {
+		return _mm_set1_epi32(value);
+	}
+	static I addInt(I a, I b) {
+		return _mm_add_epi32(a, b);
+	}
+	static I subInt(I a, I b) {
+		return _mm_sub_epi32(a, b);
+	}
+	static I andInt(I a, I b) {
+		return _mm_and_si128(a, b);
+	}
+	static I orInt(I a, I b) {
+		return _mm_or_si128(a, b);
+	}
+	static M equalInt(I a, I b) {
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b));
+	}
+	template<int bits>
+	static I shiftLeft(I a) {
+		return _mm_slli_epi32(a, bits);
+	}
+	template<int bits>
+	static I shiftRight(I a) {
+		return _mm_srli_epi32(a, bits);
+	}
+	static F xorBits(F a, I b) {
+		return _mm_xor_ps(a, _mm_castsi128_ps(b));
+	}
+	static F toFloat(I a) {
+		return _mm_cvtepi32_ps(a);
+	}
+	static I roundToInt(F a) {
+		return _mm_cvtps_epi32(a);
+	}
+	static F floor(F a) {
+		return vectorFloor<Sse2>(a);
+	}
+	static F pow(F x, F y) {
+		return vectorPow<Sse2>(x, y);
+	}
+	static F cbrt(F x) {
+		return vectorPow<Sse2>(x, set1(1.0f / 3.0f));
+	}
+	static F atan2Degrees(F y, F x) {
+		return vectorAtan2Degrees<Sse2>(y, x);
+	}
+	static void sinCosDegrees(F degrees, F &sine, F &cosine) {
+		vectorSinCosDegrees<Sse2>(degrees, sine, cosine);
+	}
+};
+}
+namespace sse2 {
+extern const bool enabled = true;
+void convert(Operation operation, const Parameters &parameters, float *x, float *y, float *z, size_t size) {
+	Kernels<Sse2>::convert(operation, parameters, x, y, z, size);
+}
+}
+}
+#else
+namespace color_batch {
+namespace sse2 {
+extern const bool enabled = false;
+void convert(Operation, const Parameters &, float *, float *, float *, size_t) {
+}
+}
+}
+#endif
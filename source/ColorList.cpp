@@ -28,6 +28,10 @@ struct NullPalette: public IPalette {
 	}
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 	}
+	virtual void addRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+	}
+	virtual void removeRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 	}
 	virtual void clear(ColorList &colorList) override {
@@ -84,12 +88,28 @@ void ColorList::add(const ColorObject &colorObject) {
 	m_changed = true;
 }
 void ColorList::add(ColorList &colorList) {
+	if (colorList.empty())
+		return;
 	auto guard = changeGuard();
-	for (auto *colorObject: colorList) {
+	size_t first = m_colors.size();
+	m_colors.reserve(first + colorList.size());
+	for (auto *colorObject: colorList)
 		m_colors.push_back(colorObject->reference());
-		m_palette.add(*this, colorObject);
-		m_changed = true;
-	}
+	addToPalette(first);
+}
+void ColorList::add(const std::vector<ColorObject *> &colorObjects) {
+	if (colorObjects.empty())
+		return;
+	auto guard = changeGuard();
+	size_t first = m_colors.size();
+	m_colors.reserve(first + colorObjects.size());
+	for (auto *colorObject: colorObjects)
+		m_colors.push_back(colorObject->reference());
+	addToPalette(first);
+}
+void ColorList::addToPalette(size_t first) {
+	m_palette.addRange(*this, common::Span<ColorObject *const>(m_colors.data() + first, m_colors.size() - first));
+	m_changed = true;
 }
 bool ColorList::startChanges() {
 	if (m_blocked)
@@ -160,12 +180,13 @@ ColorList::Guard ColorList::changeGuard() {
 void ColorList::onEndChanges(ColorList *colorList) {
 	colorList->endChanges();
 }
-void ColorList::releaseItem(ColorObject *colorObject) {
-	colorObject->release();
-}
-void ColorList::paletteRemoveSelected() {
-	m_palette.removeSelected(*this);
-}
-void ColorList::paletteRemove(ColorObject *colorObject) {
-	m_palette.remove(*this, colorObject);
+void ColorList::paletteRemove(const std::vector<ColorObject *> &removed, bool selected, bool updatePalette) {
+	if (updatePalette) {
+		if (selected)
+			m_palette.removeSelected(*this);
+		else if (!removed.empty())
+			m_palette.removeRange(*this, common::Span<ColorObject *const>(removed.data(), removed.size()));
+	}
+	for (auto *colorObject: removed)
+		colorObject->release();
 }
@@ -20,6 +20,7 @@
 #include "Color.h"
 #include "common/Ref.h"
 #include "common/Guard.h"
+#include <algorithm>
 #include <vector>
 #include <cstddef>
 struct ColorObject;
@@ -39,21 +40,24 @@ struct ColorList: public common::Ref<ColorList>::Counter {
 	void add(ColorObject *colorObject);
 	void add(ColorObject *colorObject, size_t position, bool updatePalette = false);
 	void add(ColorList &colorList);
+	void add(const std::vector<ColorObject *> &colorObjects);
+	/**
+	 * Remove all color objects matching callback. Palette is notified once about all removed color objects.
+	 * @param[in] callback Callable with (ColorObject *colorObject) parameter, returning true if color object should be removed.
+	 * @param[in] selected True if palette should remove selected rows instead of matched color objects.
+	 * @param[in] updatePalette True if palette should be notified.
+	 */
 	template<typename Callback>
 	void remove(Callback &&callback, bool selected, bool updatePalette) {
-		auto i = m_colors.begin();
-		while (i != m_colors.end()) {
-			if (callback(*i)) {
-				if (updatePalette && !selected) {
-					paletteRemove(*i);
-				}
-				releaseItem(*i);
-				i = m_colors.erase(i);
-			} else
-				++i;
-		}
-		if (updatePalette && selected)
-			paletteRemoveSelected();
+		std::vector<ColorObject *> removed;
+		auto end = std::remove_if(m_colors.begin(), m_colors.end(), [&](ColorObject *colorObject) {
+			if (!callback(colorObject))
+				return false;
+			removed.push_back(colorObject);
+			return true;
+		});
+		m_colors.erase(end, m_colors.end());
+		paletteRemove(removed, selected, updatePalette);
 		m_changed = true;
 	}
 	void removeAll();
@@ -80,7 +84,6 @@ private:
 	IPalette &m_palette;
 	bool m_blocked, m_changed;
 	static void onEndChanges(ColorList *colorList);
-	void releaseItem(ColorObject *colorObject);
-	void paletteRemoveSelected();
-	void paletteRemove(ColorObject *colorObject);
+	void addToPalette(size_t first);
+	void paletteRemove(const std::vector<ColorObject *> &removed, bool selected, bool updatePalette);
 };
@@ -17,6 +17,14 @@
  */
 
 #include "ColorObject.h"
+#include "common/ObjectPool.h"
+namespace {
+// Never destroyed, as color objects can outlive static objects.
+common::ObjectPool &pool() {
+	static common::ObjectPool *pool = new common::ObjectPool(sizeof(ColorObject), alignof(ColorObject));
+	return *pool;
+}
+}
 ColorObject::ColorObject():
 	m_name(),
 	m_color() {
@@ -44,11 +52,29 @@ void ColorObject::setColor(const Color &color) {
 	m_color = color;
 }
 const std::string &ColorObject::getName() const {
+	return m_name.str();
+}
+const common::InternedString &ColorObject::getInternedName() const {
 	return m_name;
 }
 void ColorObject::setName(const std::string &name) {
-	m_name = name;
+	m_name = common::InternedString(name);
 }
 [[nodiscard]] common::Ref<ColorObject> ColorObject::copy() const {
 	return common::Ref(new ColorObject(*this));
 }
+void *ColorObject::operator new(size_t size) {
+	if (size != sizeof(ColorObject))
+		return ::operator new(size);
+	return pool().allocate();
+}
+void ColorObject::operator delete(void *pointer, size_t size) {
+	if (size != sizeof(ColorObject))
+		return ::operator delete(pointer);
+	pool().deallocate(pointer);
+}
+void ColorObject::poolStatistics(size_t &objects, size_t &bytes) {
+	size_t blocks;
+	pool().statistics(objects, blocks);
+	bytes = blocks * common::ObjectPool::blockSize;
+}
@@ -19,6 +19,8 @@
 #pragma once
 #include "Color.h"
 #include "common/Ref.h"
+#include "common/InternedString.h"
+#include <cstddef>
 #include <string>
 #include <string_view>
 struct ColorObject: public common::Ref<ColorObject>::Counter {
@@ -30,9 +32,21 @@ struct ColorObject: public common::Ref<ColorObject>::Counter {
 	const Color &getColor() const;
 	void setColor(const Color &color);
 	const std::string &getName() const;
+	const common::InternedString &getInternedName() const;
 	void setName(const std::string &name);
 	[[nodiscard]] common::Ref<ColorObject> copy() const;
+	/**
+	 * Heap allocated color objects are stored in a shared pool, so that color objects created one after another are placed next to each other in memory.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *pointer, size_t size);
+	/**
+	 * Get heap allocated color object statistics.
+	 * @param[out] objects Number of heap allocated color objects.
+	 * @param[out] bytes Number of bytes used by heap allocated color objects, including unused space of partially filled blocks.
+	 */
+	static void poolStatistics(size_t &objects, size_t &bytes);
 private:
-	std::string m_name;
+	common::InternedString m_name;
 	Color m_color;
 };
@@ -27,6 +27,7 @@
 #include "ColorRYB.h"
 #include "ColorWheelType.h"
 #include "ColorSpaces.h"
+#include "ComponentText.h"
 #include "gtk/Swatch.h"
 #include "gtk/Zoomed.h"
 #include "gtk/ColorComponent.h"
@@ -50,6 +51,8 @@
 #include <iomanip>
 #include <cmath>
 #include <optional>
+// Read every time color under the cursor changes.
+static const dynv::Path imprecisionPostfixPath("gpick.color_names.imprecision_postfix");
 struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 	GtkWidget *main;
 	GtkWidget *expanderRGB;
@@ -279,20 +282,20 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 	ColorObject *getActive() {
 		Color color;
 		gtk_swatch_get_active_color(GTK_SWATCH(swatch_display), &color);
-		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		return new ColorObject(name, color);
 	}
 	void getActive(ColorObject &colorObject) {
 		Color color;
 		gtk_swatch_get_active_color(GTK_SWATCH(swatch_display), &color);
-		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		colorObject.setName(name);
 		colorObject.setColor(color);
 	}
 	void getColor(int index, ColorObject &colorObject) {
 		Color color;
 		gtk_swatch_get_color(GTK_SWATCH(swatch_display), index, &color);
-		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		colorObject.setName(name);
 		colorObject.setColor(color);
 	}
@@ -300,13 +303,13 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		gs.colorList().add(colorObject);
 	}
 	void addToPalette(const Color &color) {
-		auto name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		auto name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		auto colorObject = new ColorObject(name, color);
 		addToPalette(colorObject);
 		colorObject->release();
 	}
 	void copy(const Color &color) {
-		auto name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		auto name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		auto colorObject = new ColorObject(name, color);
 		clipboard::set(colorObject, gs, Converters::Type::copy);
 		colorObject->release();
@@ -339,7 +342,7 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		Color color;
 		gtk_swatch_get_active_color(GTK_SWATCH(swatch_display), &color);
 		colorObject.setColor(color);
-		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		colorObject.setName(name);
 		return colorObject;
 	}
@@ -349,7 +352,7 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		Color color;
 		gtk_swatch_get_color(GTK_SWATCH(swatch_display), index + 1, &color);
 		colorObject.setColor(color);
-		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false));
+		std::string name = color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false));
 		colorObject.setName(name);
 		return colorObject;
 	}
@@ -376,7 +379,7 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		Color transformedColor;
 		gtk_color_component_get_transformed_color(colorComponent, transformedColor);
 		float alpha = gtk_color_component_get_alpha(colorComponent);
-		std::vector<std::string> str = toTexts(gtk_color_component_get_color_space(colorComponent), transformedColor, alpha, gs);
+		const auto &str = toTexts(gtk_color_component_get_color_space(colorComponent), transformedColor, alpha, gs);
 		int j = 0;
 		const char *texts[5] = {0};
 		for (auto i = str.begin(); i != str.end(); i++) {
@@ -448,7 +451,7 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		if (options->getBool("sampler.add_to_palette", true)) {
 			Color color;
 			gtk_swatch_get_active_color(GTK_SWATCH(swatch_display), &color);
-			ColorObject colorObject(color_names_get(gs.getColorNames(), &color, gs.settings().getBool("gpick.color_names.imprecision_postfix", false)), color);
+			ColorObject colorObject(color_names_get(gs.getColorNames(), &color, gs.settings().getBool(imprecisionPostfixPath, false)), color);
 			gs.colorList().add(colorObject);
 		}
 		if (options->getBool("sampler.copy_to_clipboard", true)) {
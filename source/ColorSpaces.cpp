@@ -19,12 +19,8 @@
 #include "ColorSpaces.h"
 #include "Color.h"
 #include "I18N.h"
-#include "GlobalState.h"
-#include "lua/Color.h"
-#include "lua/Script.h"
-#include "lua/Callbacks.h"
-#include "lua/Lua.h"
-#include <iostream>
+#include <charconv>
+#include <cmath>
 #include <stdexcept>
 static const ColorSpaceDescription colorSpaceDescriptions[] = {
 	{ "rgb", "RGB", ColorSpace::rgb, ColorSpaceFlags::none, &Color::linearRgb, &Color::nonLinearRgb, 4, {
@@ -78,36 +74,39 @@ const ColorSpaceDescription &colorSpace(ColorSpace colorSpace) {
 bool ColorSpaceDescription::externalAlpha() const {
 	return (flags & ColorSpaceFlags::externalAlpha) == ColorSpaceFlags::externalAlpha;
 }
-std::vector<std::string> toTexts(ColorSpace colorSpace, const Color &color, float alpha, GlobalState &gs) {
-	std::vector<std::string> result;
-	if (!gs.callbacks().componentToText().valid())
-		return result;
-	lua_State *L = gs.script();
-	int stackTop = lua_gettop(L);
-	gs.callbacks().componentToText().get();
-	lua_pushstring(L, ::colorSpace(colorSpace).id);
-	lua::pushColor(L, color);
-	lua_pushnumber(L, alpha);
-	int status = lua_pcall(L, 3, 1, 0);
-	if (status == 0) {
-		if (lua_type(L, -1) == LUA_TTABLE) {
-			for (size_t i = 0; i < ColorSpaceDescription::maxChannels; i++) {
-				lua_pushinteger(L, i + 1);
-				lua_gettable(L, -2);
-				if (lua_type(L, -1) == LUA_TSTRING) {
-					const char *converted = lua_tostring(L, -1);
-					result.push_back(std::string(converted));
-				}
-				lua_pop(L, 1);
-			}
-			lua_settop(L, stackTop);
-			return result;
-		} else {
-			std::cerr << "componentToText: returned not a table value, type is \"" << ::colorSpace(colorSpace).id << "\"" << '\n';
-		}
-	} else {
-		std::cerr << "componentToText: " << lua_tostring(L, -1) << '\n';
+ComponentTexts::ComponentTexts() {
+	for (auto &entry: m_entries) {
+		entry.alpha = 0;
+		entry.revision = 0;
+		entry.valid = false;
+	}
+}
+size_t ComponentTexts::index(ColorSpace colorSpace) {
+	size_t index = static_cast<size_t>(colorSpace) - static_cast<size_t>(ColorSpace::rgb);
+	if (index >= std::tuple_size<decltype(m_entries)>::value)
+		throw std::invalid_argument("colorSpace");
+	return index;
+}
+bool ComponentTexts::Entry::matches(const Color &color, float alpha) const {
+	if (this->alpha != alpha)
+		return false;
+	for (int i = 0; i < Color::MemberCount; i++) {
+		if (this->color.data[i] != color.data[i])
+			return false;
+	}
+	return true;
+}
+void ComponentTexts::format(ColorSpace colorSpace, const Color &color, float alpha, std::vector<std::string> &texts) {
+	const auto &description = ::colorSpace(colorSpace);
+	texts.resize(description.channelCount);
+	for (int i = 0; i < description.channelCount; i++) {
+		const auto &channel = description.channels[i];
+		double value = (channel.type == Channel::alpha ? alpha : color.data[i]) * channel.rawScale;
+		double rounded = std::floor(value);
+		if (value - rounded >= 0.5)
+			rounded = std::ceil(value);
+		char buffer[24];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), std::isfinite(rounded) ? static_cast<long long>(rounded) : 0LL);
+		texts[i].assign(buffer, result.ptr);
 	}
-	lua_settop(L, stackTop);
-	return result;
 }
@@ -21,10 +21,11 @@
 #include "Channel.h"
 #include "common/Bitmask.h"
 #include "common/Span.h"
+#include "Color.h"
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
-struct Color;
-struct GlobalState;
 enum struct ColorSpaceFlags {
 	none = 0,
 	externalAlpha = 1,
@@ -51,4 +52,52 @@ struct ColorSpaceDescription {
 };
 common::Span<const ColorSpaceDescription> colorSpaces();
 const ColorSpaceDescription &colorSpace(ColorSpace colorSpace);
-std::vector<std::string> toTexts(ColorSpace colorSpace, const Color &color, float alpha, GlobalState &gs);
+/** \struct ComponentTexts
+ * \brief Texts of color channel values, kept in reusable buffers, one per color space.
+ *
+ * Texts are formatted again only when color, alpha or formatter revision differ from the previous call with the same color space.
+ */
+struct ComponentTexts {
+	ComponentTexts();
+	/**
+	 * Get channel value texts.
+	 * @param[in] colorSpace Color space.
+	 * @param[in] color Color in color space.
+	 * @param[in] alpha Alpha value.
+	 * @param[in] revision Formatter revision. Texts formatted with different revision are discarded.
+	 * @param[in] format Callable with (std::vector<std::string> &texts) parameter, called when texts are not cached. Texts contain previous values.
+	 * @return Texts, valid until next call with the same color space.
+	 */
+	template<typename Format>
+	const std::vector<std::string> &get(ColorSpace colorSpace, const Color &color, float alpha, uint32_t revision, Format &&format) {
+		auto &entry = m_entries[index(colorSpace)];
+		if (!entry.valid || entry.revision != revision || !entry.matches(color, alpha)) {
+			entry.valid = false;
+			format(entry.texts);
+			entry.color = color;
+			entry.alpha = alpha;
+			entry.revision = revision;
+			entry.valid = true;
+		}
+		return entry.texts;
+	}
+	/**
+	 * Format each channel value multiplied by channel raw scale and rounded to the nearest integer, halves rounded up.
+	 * @param[in] colorSpace Color space.
+	 * @param[in] color Color in color space.
+	 * @param[in] alpha Alpha value.
+	 * @param[out] texts Channel value texts. Existing strings are reused.
+	 */
+	static void format(ColorSpace colorSpace, const Color &color, float alpha, std::vector<std::string> &texts);
+private:
+	struct Entry {
+		Color color;
+		float alpha;
+		uint32_t revision;
+		bool valid;
+		std::vector<std::string> texts;
+		bool matches(const Color &color, float alpha) const;
+	};
+	std::array<Entry, 6> m_entries;
+	static size_t index(ColorSpace colorSpace);
+};
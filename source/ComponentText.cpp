@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ComponentText.h"
+#include "ColorSpaces.h"
+#include "GlobalState.h"
+#include "lua/Color.h"
+#include "lua/Script.h"
+#include "lua/Callbacks.h"
+#include "lua/Lua.h"
+#include <iostream>
+static void callComponentToText(ColorSpace colorSpace, const Color &color, float alpha, GlobalState &gs, std::vector<std::string> &texts) {
+	texts.clear();
+	lua_State *L = gs.script();
+	int stackTop = lua_gettop(L);
+	gs.callbacks().componentToText().get();
+	lua_pushstring(L, ::colorSpace(colorSpace).id);
+	lua::pushColor(L, color);
+	lua_pushnumber(L, alpha);
+	int status = lua_pcall(L, 3, 1, 0);
+	if (status == 0) {
+		if (lua_type(L, -1) == LUA_TTABLE) {
+			for (size_t i = 0; i < ColorSpaceDescription::maxChannels; i++) {
+				lua_pushinteger(L, i + 1);
+				lua_gettable(L, -2);
+				if (lua_type(L, -1) == LUA_TSTRING) {
+					const char *converted = lua_tostring(L, -1);
+					texts.push_back(std::string(converted));
+				}
+				lua_pop(L, 1);
+			}
+		} else {
+			std::cerr << "componentToText: returned not a table value, type is \"" << ::colorSpace(colorSpace).id << "\"" << '\n';
+		}
+	} else {
+		std::cerr << "componentToText: " << lua_tostring(L, -1) << '\n';
+	}
+	lua_settop(L, stackTop);
+}
+const std::vector<std::string> &toTexts(ColorSpace colorSpace, const Color &color, float alpha, GlobalState &gs) {
+	auto &callbacks = gs.callbacks();
+	return gs.componentTexts().get(colorSpace, color, alpha, callbacks.componentToTextRevision(), [&](std::vector<std::string> &texts) {
+		if (callbacks.componentToText().valid())
+			callComponentToText(colorSpace, color, alpha, gs, texts);
+		else
+			ComponentTexts::format(colorSpace, color, alpha, texts);
+	});
+}
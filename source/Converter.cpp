@@ -23,6 +23,8 @@
 #include "lua/ColorObject.h"
 #include "lua/Script.h"
 #include "lua/Lua.h"
+#include "common/MatchPattern.h"
+#include <algorithm>
 #include <string>
 #include <iostream>
 Converter::Options Converter::emptyOptions = {};
@@ -32,7 +34,8 @@ Converter::Converter(const char *name, const char *label, lua::Ref &&serialize,
 	m_serialize(std::move(serialize)),
 	m_deserialize(std::move(deserialize)),
 	m_copy(false),
-	m_paste(false) {
+	m_paste(false),
+	m_requiredInput(ConverterInput::none) {
 }
 Converter::Converter(const char *name, const char *label, Callback<Serialize> serialize, Callback<Deserialize> deserialize):
 	m_name(name),
@@ -40,7 +43,8 @@ Converter::Converter(const char *name, const char *label, Callback<Serialize> se
 	m_serializeCallback(serialize),
 	m_deserializeCallback(deserialize),
 	m_copy(false),
-	m_paste(false) {
+	m_paste(false),
+	m_requiredInput(ConverterInput::none) {
 }
 std::string Converter::serialize(const ColorObject &colorObject, const ConverterSerializePosition &position) {
 	if (m_serializeCallback)
@@ -101,6 +105,95 @@ bool Converter::deserialize(const char *value, ColorObject &colorObject, float &
 	lua_settop(L, stackTop);
 	return false;
 }
+// Calls serialize function for each color object inside a single protected call, so that the number of calls from C++ into Lua
+// does not depend on the number of colors. Errors of individual calls are collected separately, as each color is still serialized on its own.
+static const char *serializeBatchSource = R"(
+return function(serialize, colorObjects, count)
+	local results, errors = {}, {}
+	for i = 1, count do
+		local ok, text = pcall(serialize, colorObjects[i], { first = i == 1, last = i == count, index = i - 1, count = count })
+		if ok then
+			results[i] = text
+		else
+			errors[i] = text
+		end
+	end
+	return results, errors
+end
+)";
+static const char *serializeBatchKey = "gpick.converter.serializeBatch";
+static bool pushSerializeBatch(lua_State *L) {
+	lua_getfield(L, LUA_REGISTRYINDEX, serializeBatchKey);
+	if (lua_type(L, -1) == LUA_TFUNCTION)
+		return true;
+	lua_pop(L, 1);
+	if (luaL_loadstring(L, serializeBatchSource) != 0 || lua_pcall(L, 0, 1, 0) != 0) {
+		std::cerr << "serialize: " << lua_tostring(L, -1) << '\n';
+		lua_pop(L, 1);
+		return false;
+	}
+	lua_pushvalue(L, -1);
+	lua_setfield(L, LUA_REGISTRYINDEX, serializeBatchKey);
+	return true;
+}
+std::vector<std::string> Converter::serializeLua(common::Span<const ColorObject *const> colorObjects) {
+	std::vector<std::string> results(colorObjects.size());
+	if (!m_serialize.valid() || colorObjects.size() == 0)
+		return results;
+	lua_State *L = m_serialize.script();
+	int stackTop = lua_gettop(L);
+	if (!pushSerializeBatch(L))
+		return results;
+	m_serialize.get();
+	// Lua receives copies, so that scripts can not modify palette colors.
+	std::vector<ColorObject> copies;
+	copies.reserve(colorObjects.size());
+	lua_createtable(L, static_cast<int>(colorObjects.size()), 0);
+	for (size_t i = 0; i < colorObjects.size(); i++) {
+		copies.emplace_back(*colorObjects[i]);
+		lua::pushColorObject(L, &copies.back());
+		lua_rawseti(L, -2, static_cast<int>(i + 1));
+	}
+	lua_pushinteger(L, colorObjects.size());
+	if (lua_pcall(L, 3, 2, 0) != 0) {
+		std::cerr << "serialize: " << lua_tostring(L, -1) << '\n';
+		lua_settop(L, stackTop);
+		return results;
+	}
+	for (size_t i = 0; i < colorObjects.size(); i++) {
+		lua_rawgeti(L, -2, static_cast<int>(i + 1));
+		if (lua_type(L, -1) == LUA_TSTRING) {
+			size_t length;
+			const char *text = lua_tolstring(L, -1, &length);
+			results[i].assign(text, length);
+		} else {
+			lua_rawgeti(L, -2, static_cast<int>(i + 1));
+			if (lua_type(L, -1) == LUA_TSTRING)
+				std::cerr << "serialize: " << lua_tostring(L, -1) << '\n';
+			else
+				std::cerr << "serialize: returned not a string value \"" << m_name << "\"\n";
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+	}
+	lua_settop(L, stackTop);
+	return results;
+}
+std::vector<std::string> Converter::serialize(common::Span<const ColorObject *const> colorObjects) {
+	if (!m_serializeCallback)
+		return serializeLua(colorObjects);
+	std::vector<std::string> results;
+	results.reserve(colorObjects.size());
+	ConverterSerializePosition position(colorObjects.size());
+	for (size_t i = 0; i < colorObjects.size(); i++) {
+		if (i + 1 == colorObjects.size())
+			position.last(true);
+		results.emplace_back(m_serializeCallback(*colorObjects[i], position));
+		position.first(false);
+		position.incrementIndex();
+	}
+	return results;
+}
 std::string Converter::serialize(const ColorObject &colorObject) {
 	ConverterSerializePosition position;
 	return serialize(colorObject, position);
@@ -128,6 +221,60 @@ void Converter::copy(bool value) {
 void Converter::paste(bool value) {
 	m_paste = value;
 }
+void Converter::requiredInput(ConverterInput requiredInput) {
+	m_requiredInput = requiredInput;
+}
+ConverterInput Converter::requiredInput() const {
+	return m_requiredInput;
+}
+bool Converter::accepts(ConverterInput input) const {
+	return (input & m_requiredInput) == m_requiredInput;
+}
+ConverterInput Converter::classifyInput(std::string_view value) {
+	using namespace std::string_view_literals;
+	using namespace common::ops;
+	ConverterInput result = ConverterInput::none;
+	auto found = [&result](ConverterInput input) {
+		return [&result, input](std::string_view, size_t &) {
+			result = result | input;
+			return true;
+		};
+	};
+	size_t hexStart = 0, hexEnd = 0;
+	auto hexRun = [&result, &hexStart, &hexEnd](std::string_view value, size_t &) {
+		size_t length = hexEnd - hexStart;
+		if (std::any_of(value.begin() + hexStart, value.begin() + hexEnd, [](char c) { return c >= '0' && c <= '9'; }))
+			result = result | ConverterInput::digit;
+		if (length >= 3)
+			result = result | ConverterInput::hex3;
+		if (length >= 4)
+			result = result | ConverterInput::hex4;
+		if (length >= 6)
+			result = result | ConverterInput::hex6;
+		if (length >= 8)
+			result = result | ConverterInput::hex8;
+		return true;
+	};
+	auto anyCharacter = [](std::string_view value, size_t &position) {
+		if (position >= value.length())
+			return false;
+		position++;
+		return true;
+	};
+	common::matchPattern(value, zeroOrMore(opOr(
+		sequence("rgba("sv, found(ConverterInput::rgbaFunction)),
+		sequence("rgb("sv, found(ConverterInput::rgbFunction)),
+		sequence("hsla("sv, found(ConverterInput::hslaFunction)),
+		sequence("hsl("sv, found(ConverterInput::hslFunction)),
+		sequence(single('#'), found(ConverterInput::hash)),
+		sequence(single(','), found(ConverterInput::comma | ConverterInput::separator)),
+		sequence(single(';'), found(ConverterInput::semicolon | ConverterInput::separator)),
+		sequence(single('\t'), found(ConverterInput::tab | ConverterInput::separator)),
+		sequence(single(' '), found(ConverterInput::space | ConverterInput::separator)),
+		sequence(save(oneOrMore(hex), hexStart, hexEnd), hexRun),
+		anyCharacter)));
+	return result;
+}
 bool Converter::copy() const {
 	return m_copy;
 }
@@ -19,9 +19,12 @@
 #ifndef GPICK_CONVERTER_H_
 #define GPICK_CONVERTER_H_
 #include "lua/Ref.h"
-#include "common/Scoped.h"
+#include "common/Span.h"
+#include "common/Bitmask.h"
+#include <cstdint>
 #include <string>
-#include <clocale>
+#include <string_view>
+#include <vector>
 struct ColorObject;
 struct Color;
 struct ConverterSerializePosition {
@@ -38,6 +41,26 @@ private:
 	bool m_first, m_last;
 	size_t m_index, m_count;
 };
+/** Text properties, which are detected in a single pass before deserialization. Converter is only tried on text having all properties it requires. */
+enum class ConverterInput : uint32_t {
+	none = 0,
+	hash = 1 << 0, ///< '#' character.
+	hex3 = 1 << 1, ///< At least 3 consecutive hex digits.
+	hex4 = 1 << 2, ///< At least 4 consecutive hex digits.
+	hex6 = 1 << 3, ///< At least 6 consecutive hex digits.
+	hex8 = 1 << 4, ///< At least 8 consecutive hex digits.
+	digit = 1 << 5,
+	comma = 1 << 6,
+	semicolon = 1 << 7,
+	tab = 1 << 8,
+	space = 1 << 9,
+	rgbFunction = 1 << 10, ///< "rgb(" text.
+	rgbaFunction = 1 << 11, ///< "rgba(" text.
+	hslFunction = 1 << 12, ///< "hsl(" text.
+	hslaFunction = 1 << 13, ///< "hsla(" text.
+	separator = 1 << 14, ///< Any of comma, semicolon, tab or space characters.
+};
+ENABLE_BITMASK_OPERATORS(ConverterInput);
 struct Converter {
 	struct Options {
 		bool upperCaseHex;
@@ -57,8 +80,6 @@ struct Converter {
 		}
 		template<typename... Args>
 		auto operator()(Args &... args) const {
-			auto locale = std::setlocale(LC_NUMERIC, "C");
-			common::Scoped resetLocale(std::setlocale, LC_NUMERIC, locale);
 			return m_callback(args..., m_options);
 		}
 		explicit operator bool() const {
@@ -83,13 +104,40 @@ struct Converter {
 	std::string serialize(const ColorObject &colorObject, const ConverterSerializePosition &position);
 	std::string serialize(const ColorObject &colorObject);
 	std::string serialize(const Color &color);
+	/**
+	 * Serialize all color objects as consecutive items of one list.
+	 * Lua converters are called once for the whole list instead of once for each color object.
+	 * @param[in] colorObjects Color objects.
+	 * @return Serialized text of each color object. Text is empty if serialization failed.
+	 */
+	std::vector<std::string> serialize(common::Span<const ColorObject *const> colorObjects);
 	bool deserialize(const char *value, ColorObject &colorObject, float &quality);
+	/**
+	 * Set text properties required for successful deserialization. Converters without requirements are tried on any text.
+	 * @param[in] requiredInput Required text properties.
+	 */
+	void requiredInput(ConverterInput requiredInput);
+	ConverterInput requiredInput() const;
+	/**
+	 * Check if converter can deserialize text with given properties.
+	 * @param[in] input Text properties returned by classifyInput().
+	 * @return True if text has all properties required by converter.
+	 */
+	bool accepts(ConverterInput input) const;
+	/**
+	 * Detect text properties.
+	 * @param[in] value Text.
+	 * @return Properties found in text.
+	 */
+	static ConverterInput classifyInput(std::string_view value);
 private:
 	std::string m_name;
 	std::string m_label;
 	lua::Ref m_serialize, m_deserialize;
+	std::vector<std::string> serializeLua(common::Span<const ColorObject *const> colorObjects);
 	Callback<Serialize> m_serializeCallback;
 	Callback<Deserialize> m_deserializeCallback;
 	bool m_copy, m_paste;
+	ConverterInput m_requiredInput;
 };
 #endif /* GPICK_CONVERTER_H_ */
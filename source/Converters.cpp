@@ -21,7 +21,9 @@
 #include "ColorObject.h"
 #include "common/First.h"
 #include <unordered_set>
-Converters::Converters() {
+Converters::Converters():
+	m_displayConverter(nullptr),
+	m_colorListConverter(nullptr) {
 }
 Converters::~Converters() {
 	for (auto converter: m_allConverters) {
@@ -40,11 +42,13 @@ void Converters::add(Converter *converter) {
 		m_pasteConverters.push_back(converter);
 	m_converters[converter->name()] = converter;
 }
-void Converters::add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize) {
-	add(new Converter(name, label, serialize, deserialize));
+void Converters::add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInput requiredInput) {
+	auto converter = new Converter(name, label, serialize, deserialize);
+	converter->requiredInput(requiredInput);
+	add(converter);
 }
-void Converters::add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize) {
-	add(new Converter(name, label.c_str(), serialize, deserialize));
+void Converters::add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInput requiredInput) {
+	add(name, label.c_str(), serialize, deserialize, requiredInput);
 }
 void Converters::rebuildCopyPasteArrays() {
 	m_copyConverters.clear();
@@ -162,13 +166,16 @@ std::string Converters::serialize(const Color &color, Type type) {
 	return serialize(colorObject, type);
 }
 bool Converters::deserialize(const std::string &value, ColorObject &outputColorObject) {
+	return deserialize(value.c_str(), Converter::classifyInput(value), true, outputColorObject);
+}
+bool Converters::deserialize(const char *value, ConverterInput input, bool useDisplayConverter, ColorObject &outputColorObject) {
 	common::First<float, std::greater<float>, ColorObject> bestConversion;
 	ColorObject colorObject;
 	float quality;
-	if (m_displayConverter) {
+	if (useDisplayConverter && m_displayConverter) {
 		Converter *converter = m_displayConverter;
-		if (converter->hasDeserialize()) {
-			if (converter->deserialize(value.c_str(), colorObject, quality)) {
+		if (converter->hasDeserialize() && converter->accepts(input)) {
+			if (converter->deserialize(value, colorObject, quality)) {
 				if (quality > 0) {
 					bestConversion(quality, colorObject);
 				}
@@ -176,9 +183,9 @@ bool Converters::deserialize(const std::string &value, ColorObject &outputColorO
 		}
 	}
 	for (auto &converter: m_pasteConverters) {
-		if (converter == m_displayConverter || !converter->hasDeserialize())
+		if ((useDisplayConverter && converter == m_displayConverter) || !converter->hasDeserialize() || !converter->accepts(input))
 			continue;
-		if (converter->deserialize(value.c_str(), colorObject, quality)) {
+		if (converter->deserialize(value, colorObject, quality)) {
 			if (quality > 0) {
 				bestConversion(quality, colorObject);
 			}
@@ -189,6 +196,26 @@ bool Converters::deserialize(const std::string &value, ColorObject &outputColorO
 	outputColorObject = bestConversion.data<ColorObject>();
 	return true;
 }
+std::vector<ColorObject> Converters::deserializeLines(std::string_view text, bool useDisplayConverter) {
+	std::vector<ColorObject> result;
+	std::string line;
+	ColorObject colorObject;
+	const std::string_view whitespace = " \t\r";
+	while (!text.empty()) {
+		auto lineEnd = text.find('\n');
+		auto value = text.substr(0, lineEnd);
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.length() : lineEnd + 1);
+		auto first = value.find_first_not_of(whitespace);
+		if (first == std::string_view::npos)
+			continue;
+		value = value.substr(first, value.find_last_not_of(whitespace) - first + 1);
+		// Converters expect null terminated strings, so line is copied into reused buffer.
+		line.assign(value);
+		if (deserialize(line.c_str(), Converter::classifyInput(line), useDisplayConverter, colorObject))
+			result.push_back(colorObject);
+	}
+	return result;
+}
 void Converters::reorder(const char **names, size_t count) {
 	std::unordered_set<Converter *> used;
 	std::vector<Converter *> converters;
@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
 struct ColorObject;
 struct Color;
 struct Converters {
@@ -33,8 +34,8 @@ struct Converters {
 	Converters();
 	~Converters();
 	void add(Converter *converter);
-	void add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize);
-	void add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize);
+	void add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInput requiredInput = ConverterInput::none);
+	void add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInput requiredInput = ConverterInput::none);
 	const std::vector<Converter *> &all() const;
 	const std::vector<Converter *> &allCopy() const;
 	const std::vector<Converter *> &allPaste() const;
@@ -55,11 +56,20 @@ struct Converters {
 	std::string serialize(const ColorObject &colorObject, Type type);
 	std::string serialize(const Color &color, Type type);
 	bool deserialize(const std::string &value, ColorObject &outputColorObject);
+	/**
+	 * Deserialize each line of text with the best matching converter.
+	 * Text properties of each line are detected once and only converters accepting them are tried.
+	 * @param[in] text Text with one color per line. Empty and whitespace-only lines are skipped.
+	 * @param[in] useDisplayConverter Try display converter first even if it is not a paste converter, as deserialize() does. Otherwise only paste converters are tried in their order.
+	 * @return Deserialized color objects in line order. Lines which could not be deserialized are omitted.
+	 */
+	std::vector<ColorObject> deserializeLines(std::string_view text, bool useDisplayConverter);
 	void rebuildCopyPasteArrays();
 	void reorder(const char **names, size_t count);
 	void reorder(const std::vector<std::string> &names);
 	bool hasCopy() const;
 private:
+	bool deserialize(const char *value, ConverterInput input, bool useDisplayConverter, ColorObject &outputColorObject);
 	std::unordered_map<std::string, Converter *> m_converters;
 	std::vector<Converter *> m_allConverters, m_copyConverters, m_pasteConverters;
 	Converter *m_displayConverter;
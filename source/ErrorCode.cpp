@@ -28,6 +28,7 @@ std::ostream &operator<<(std::ostream &stream, const ErrorCode &errorCode) {
 	E(badHeader, "bad header")
 	E(badVersion, "bad version")
 	E(badFile, "bad file")
+	E(unsupportedFormat, "unsupported format")
 	}
 	return stream;
 }
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ExportFormats.h"
+#include "ColorObject.h"
+#include "Color.h"
+#include "HtmlUtils.h"
+#include "common/TextWriter.h"
+#include <boost/math/special_functions/round.hpp>
+void writeGpl(common::TextWriter &writer, std::string_view paletteName, common::Span<const ColorObject *const> colorObjects) {
+	writer << "GIMP Palette\n"
+		<< "Name: " << paletteName << '\n'
+		<< "Columns: 1\n"
+		<< "#\n";
+	writer.writeParallel(colorObjects.size(), [&colorObjects](common::TextWriter &writer, size_t index) {
+		using boost::math::iround;
+		auto *colorObject = colorObjects[index];
+		const Color &color = colorObject->getColor();
+		writer << iround(color.red * 255) << '\t'
+			<< iround(color.green * 255) << '\t'
+			<< iround(color.blue * 255) << '\t' << colorObject->getName() << '\n';
+	});
+}
+void writeCss(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects) {
+	writer.writeParallel(colorObjects.size(), [&colorObjects](common::TextWriter &writer, size_t index) {
+		auto *colorObject = colorObjects[index];
+		const Color &color = colorObject->getColor();
+		writer << " * " << colorObject->getName()
+			<< ": " << HtmlHEX { color }
+			<< ", " << HtmlRGBA { color }
+			<< ", " << HtmlHSLA { color }
+			<< '\n';
+	});
+}
+void writeMtl(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects) {
+	writer.writeParallel(colorObjects.size(), [&colorObjects](common::TextWriter &writer, size_t index) {
+		auto *colorObject = colorObjects[index];
+		const Color &color = colorObject->getColor();
+		writer << "newmtl " << colorObject->getName() << '\n'
+			<< "Ns 90.000000\n"
+			<< "Ka 0.000000 0.000000 0.000000\n"
+			<< "Kd " << color.red << ' ' << color.green << ' ' << color.blue << '\n'
+			<< "Ks 0.500000 0.500000 0.500000\n"
+			<< '\n';
+	});
+}
+void writeTxt(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects, const std::vector<std::string> &texts, bool includeColorNames) {
+	writer.writeParallel(colorObjects.size(), [&colorObjects, &texts, includeColorNames](common::TextWriter &writer, size_t index) {
+		writer << texts[index];
+		if (includeColorNames)
+			writer << ' ' << colorObjects[index]->getName();
+		writer << '\n';
+	});
+}
+void writeHtmlColors(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects, const std::vector<std::string> &texts, bool includeColorNames) {
+	writer.writeParallel(colorObjects.size(), [&colorObjects, &texts, includeColorNames](common::TextWriter &writer, size_t index) {
+		auto *colorObject = colorObjects[index];
+		const Color &color = colorObject->getColor();
+		writer << "<div style=\"background-color:" << HtmlRGBA { color } << "; color:" << HtmlRGB { color.getContrasting() } << "\">";
+		if (includeColorNames && !colorObject->getName().empty())
+			writer << HtmlEscape { colorObject->getName() } << ":<br/>";
+		if (!texts.empty())
+			writer << "<span>" << texts[index] << "</span></div>";
+		else
+			writer << "<span>" << HtmlRGB { color } << "</span></div>";
+	});
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_EXPORT_FORMATS_H_
+#define GPICK_EXPORT_FORMATS_H_
+#include "common/Span.h"
+#include <string>
+#include <string_view>
+#include <vector>
+struct ColorObject;
+namespace common {
+struct TextWriter;
+}
+/** \file source/ExportFormats.h
+ * \brief Text palette formats written through common::TextWriter.
+ *
+ * Color objects are formatted in parallel, so only thread safe code is used. Lua converter output has to be prepared by the caller.
+ */
+void writeGpl(common::TextWriter &writer, std::string_view paletteName, common::Span<const ColorObject *const> colorObjects);
+void writeCss(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects);
+void writeMtl(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects);
+/**
+ * Write one line for each color object.
+ * @param[in] writer Output writer.
+ * @param[in] colorObjects Color objects.
+ * @param[in] texts Converter output for each color object.
+ * @param[in] includeColorNames Append color object name to each line.
+ */
+void writeTxt(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects, const std::vector<std::string> &texts, bool includeColorNames);
+/**
+ * Write HTML element for each color object.
+ * @param[in] writer Output writer.
+ * @param[in] colorObjects Color objects.
+ * @param[in] texts Converter output for each color object. CSS rgb() text is used if empty.
+ * @param[in] includeColorNames Include color object names.
+ */
+void writeHtmlColors(common::TextWriter &writer, common::Span<const ColorObject *const> colorObjects, const std::vector<std::string> &texts, bool includeColorNames);
+#endif /* GPICK_EXPORT_FORMATS_H_ */
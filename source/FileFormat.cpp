@@ -25,11 +25,16 @@
 #include "common/Result.h"
 #include "version/Version.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <fstream>
+#include <optional>
+#include <string_view>
 #include <vector>
 #include <boost/endian/conversion.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #define CHUNK_TYPE_VERSION "GPA version"
 #define CHUNK_TYPE_HANDLER_MAP "handler_map"
@@ -72,48 +77,159 @@ private:
 	char m_type[16];
 	uint64_t m_size;
 };
-static bool read(std::istream &stream, ChunkHeader &header) {
-	stream.read(reinterpret_cast<char *>(&header), sizeof(header));
-	header.prepareRead();
-	return stream.good();
-}
-static bool read(std::istream &stream, uint32_t &value) {
-	stream.read(reinterpret_cast<char *>(&value), sizeof(value));
-	value = boost::endian::little_to_native<uint32_t>(value);
-	return stream.good();
-}
-static bool read(std::istream &stream, std::string &value) {
-	uint32_t length;
-	if (!read(stream, length))
-		return false;
-	value.resize(length);
-	if (length == 0)
+// Bounds checked little endian reader of memory mapped file contents.
+struct MappedReader {
+	MappedReader(const uint8_t *data, size_t size):
+		m_position(data),
+		m_end(data + size) {
+	}
+	size_t remaining() const {
+		return static_cast<size_t>(m_end - m_position);
+	}
+	bool skip(uint64_t size) {
+		if (size > remaining())
+			return false;
+		m_position += size;
 		return true;
-	stream.read(reinterpret_cast<char *>(&value.front()), length);
-	return stream.good();
+	}
+	MappedReader subReader(uint64_t size) const {
+		return MappedReader(m_position, static_cast<size_t>(std::min<uint64_t>(size, remaining())));
+	}
+	bool read(ChunkHeader &header) {
+		if (remaining() < sizeof(header))
+			return false;
+		std::memcpy(&header, m_position, sizeof(header));
+		m_position += sizeof(header);
+		header.prepareRead();
+		return true;
+	}
+	bool read(uint8_t &value) {
+		if (remaining() < 1)
+			return false;
+		value = *m_position++;
+		return true;
+	}
+	bool read(uint32_t &value) {
+		if (remaining() < sizeof(value))
+			return false;
+		std::memcpy(&value, m_position, sizeof(value));
+		m_position += sizeof(value);
+		value = boost::endian::little_to_native<uint32_t>(value);
+		return true;
+	}
+	bool read(float &value) {
+		uint32_t bits;
+		if (!read(bits))
+			return false;
+		std::memcpy(&value, &bits, sizeof(value));
+		return true;
+	}
+	bool read(std::string_view &value) {
+		uint32_t length;
+		if (!read(length) || length > remaining())
+			return false;
+		value = std::string_view(reinterpret_cast<const char *>(m_position), length);
+		m_position += length;
+		return true;
+	}
+	bool read(Color &value) {
+		uint32_t storeLength;
+		if (!read(storeLength) || storeLength > remaining())
+			return false;
+		MappedReader data = subReader(storeLength);
+		value = Color();
+		for (int i = 0; i < 4 && data.read(value[i]); i++) {
+		}
+		m_position += storeLength;
+		return true;
+	}
+private:
+	const uint8_t *m_position, *m_end;
+};
+// Decodes color list entries straight from mapped file, without building intermediate dynv::Map for each color.
+static bool readColorList(MappedReader reader, const std::array<std::optional<dynv::types::ValueType>, 256> &types, bool noAlphaChannel, std::vector<ColorObject *> &colorObjects) {
+	using ValueType = dynv::types::ValueType;
+	while (reader.remaining() > 0) {
+		uint32_t count;
+		if (!reader.read(count))
+			return false;
+		Color color;
+		std::string_view name;
+		for (uint32_t i = 0; i < count; i++) {
+			uint8_t handlerId;
+			std::string_view key;
+			if (!reader.read(handlerId) || !reader.read(key))
+				return false;
+			const auto &type = types[handlerId];
+			if (!type) {
+				uint32_t skip;
+				if (!reader.read(skip) || !reader.skip(skip))
+					return false;
+				continue;
+			}
+			switch (*type) {
+			case ValueType::basicBool:
+				if (!reader.skip(1))
+					return false;
+				break;
+			case ValueType::basicFloat:
+			case ValueType::basicInt32:
+				if (!reader.skip(4))
+					return false;
+				break;
+			case ValueType::string: {
+				std::string_view value;
+				if (!reader.read(value))
+					return false;
+				if (key == "name")
+					name = value;
+			} break;
+			case ValueType::color: {
+				Color value;
+				if (!reader.read(value))
+					return false;
+				if (key == "color")
+					color = value;
+			} break;
+			case ValueType::map:
+			case ValueType::unknown:
+				return false;
+			}
+		}
+		if (noAlphaChannel)
+			color.alpha = 1.0f;
+		colorObjects.push_back(new ColorObject(name, color));
+	}
+	return true;
 }
 common::ResultVoid<ErrorCode> paletteFileLoad(const char* filename, ColorList &colorList) {
 	using Result = common::ResultVoid<ErrorCode>;
-	std::ifstream file(filename, std::ios::binary);
-	if (!file.is_open())
+	boost::interprocess::file_mapping file;
+	try {
+		file = boost::interprocess::file_mapping(filename, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
 		return Result(ErrorCode::fileCouldNotBeOpened);
+	}
+	boost::interprocess::mapped_region region;
+	try {
+		region = boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		return Result(ErrorCode::readFailed);
+	}
+	MappedReader reader(static_cast<const uint8_t *>(region.get_address()), region.get_size());
 	ChunkHeader header;
-	if (!read(file, header) || !header.valid() || !header.startsWith(CHUNK_TYPE_VERSION))
+	if (!reader.read(header) || !header.valid() || !header.startsWith(CHUNK_TYPE_VERSION))
 		return Result(ErrorCode::readFailed);
 	if (header.size() < 4)
 		return Result(ErrorCode::badHeader);
 	uint32_t version;
-	if (!read(file, version))
+	if (!reader.read(version))
 		return Result(ErrorCode::readFailed);
 	if (!(version >= MinSupportedVersion && version <= MaxSupportedVersion))
 		return Result(ErrorCode::badVersion);
 	bool noAlphaChannel = version < 0x20000u;
-	file.seekg(header.size() - 4, std::ios::cur);
-	if (!file.good())
+	if (!reader.skip(header.size() - 4))
 		return Result(ErrorCode::readFailed);
-	if (!read(file, header) || !header.valid()) {
-		return file.eof() ? Result() : Result(ErrorCode::readFailed);
-	}
 	std::vector<ColorObject *> colorObjects;
 	common::Scoped releaseColorObjects([&colorObjects]() {
 		for (auto colorObject: colorObjects)
@@ -121,58 +237,42 @@ common::ResultVoid<ErrorCode> paletteFileLoad(const char* filename, ColorList &c
 				colorObject->release();
 	});
 	std::vector<uint32_t> positions;
-	std::unordered_map<uint8_t, dynv::types::ValueType> typeMap;
-	std::vector<std::string> handlers;
+	std::array<std::optional<dynv::types::ValueType>, 256> types;
+	size_t handlerCount = 0;
 	bool hasPositions = false;
-	for (;;) {
+	while (reader.remaining() >= sizeof(ChunkHeader)) {
+		if (!reader.read(header) || !header.valid())
+			return Result(ErrorCode::readFailed);
+		MappedReader chunk = reader.subReader(header.size());
 		if (header.is(CHUNK_TYPE_HANDLER_MAP)) {
-			uint32_t handlerCount;
-			if (!read(file, handlerCount))
+			uint32_t count;
+			if (!chunk.read(count))
 				return Result(ErrorCode::readFailed);
-			if (handlerCount > 255)
+			if (count > 255 || handlerCount + count > types.size())
 				return Result(ErrorCode::badFile);
-			for (size_t i = 0; i < handlerCount; i++) {
-				std::string typeName;
-				if (!read(file, typeName))
+			for (size_t i = 0; i < count; i++) {
+				std::string_view typeName;
+				if (!chunk.read(typeName))
 					return Result(ErrorCode::readFailed);
-				typeMap[static_cast<uint8_t>(handlers.size())] = dynv::types::stringToType(typeName);
-				handlers.push_back(typeName);
+				types[handlerCount++] = dynv::types::stringToType(std::string(typeName));
 			}
 		} else if (header.is(CHUNK_TYPE_COLOR_LIST)) {
-			std::streamoff end = file.tellg() + static_cast<std::streamoff>(header.size());
-			while (file.tellg() < end) {
-				dynv::Map options;
-				if (!options.deserialize(file, typeMap))
-					return file.good() ? Result(ErrorCode::badFile) : Result(ErrorCode::readFailed);
-				auto color = options.getColor("color", Color());
-				auto name = options.getString("name", "");
-				if (noAlphaChannel)
-					color.alpha = 1.0f;
-				colorObjects.push_back(new ColorObject(name, color));
-			}
+			if (header.size() > reader.remaining())
+				return Result(ErrorCode::readFailed);
+			// Each entry takes at least 50 bytes: entry count, two values with names and color data.
+			colorObjects.reserve(colorObjects.size() + header.size() / 50);
+			if (!readColorList(chunk, types, noAlphaChannel, colorObjects))
+				return Result(ErrorCode::badFile);
 		} else if (header.is(CHUNK_TYPE_COLOR_POSITIONS)) {
+			if (header.size() > reader.remaining())
+				return Result(ErrorCode::readFailed);
 			hasPositions = true;
 			positions.resize(header.size() / sizeof(uint32_t));
-			if (!positions.empty())
-				file.read(reinterpret_cast<char *>(&positions.front()), positions.size() * sizeof(uint32_t));
-			if (!file.good())
-				return Result(ErrorCode::readFailed);
-			for (auto &position: positions) {
-				position = boost::endian::little_to_native<uint32_t>(position);
-			}
-		} else {
-			file.seekg(header.size(), std::ios::cur);
-			if (file.eof())
-				break;
-			if (!file.good())
-				return Result(ErrorCode::readFailed);
-		}
-		if (!read(file, header) || !header.valid()) {
-			if (file.eof())
-				break;
-			else
-				return Result(ErrorCode::readFailed);
+			for (auto &position: positions)
+				chunk.read(position);
 		}
+		if (!reader.skip(header.size()))
+			break;
 	}
 	if (hasPositions) {
 		std::vector<std::pair<ColorObject *, size_t>> colorObjectsWithPositions;
@@ -183,16 +283,16 @@ common::ResultVoid<ErrorCode> paletteFileLoad(const char* filename, ColorList &c
 		std::stable_sort(colorObjectsWithPositions.begin(), colorObjectsWithPositions.end(), [](const std::pair<ColorObject *, size_t> &a, const std::pair<ColorObject *, size_t> &b) {
 			return a.second < b.second;
 		});
+		std::vector<ColorObject *> sortedColorObjects;
+		sortedColorObjects.reserve(colorObjectsWithPositions.size());
 		for (auto colorObjectWithPosition: colorObjectsWithPositions) {
-			colorList.add(colorObjectWithPosition.first);
+			sortedColorObjects.push_back(colorObjectWithPosition.first);
 		}
+		colorList.add(sortedColorObjects);
 	} else {
-		for (auto colorObject: colorObjects) {
-			colorList.add(colorObject);
-		}
+		colorList.add(colorObjects);
 	}
-	file.close();
-	return (file.good() || file.eof()) ? Result() : Result(ErrorCode::readFailed);
+	return Result();
 }
 static bool write(std::ostream &stream, uint32_t value) {
 	auto data = boost::endian::native_to_little<uint32_t>(value);
@@ -196,6 +196,10 @@ static void finish_picking(FloatingPickerArgs *args)
 	if (args->custom_done_action)
 		args->custom_done_action(args);
 }
+static const dynv::Path copyOnReleasePath("gpick.picker.sampler.copy_on_release");
+static const dynv::Path addOnReleasePath("gpick.picker.sampler.add_on_release");
+static const dynv::Path addToSwatchOnReleasePath("gpick.picker.sampler.add_to_swatch_on_release");
+static const dynv::Path rotateSwatchOnReleasePath("gpick.picker.sampler.rotate_swatch_on_release");
 static void complete_picking(FloatingPickerArgs *args)
 {
 	if (args->release_mode || args->click_mode){
@@ -209,18 +213,18 @@ static void complete_picking(FloatingPickerArgs *args)
 			if (args->single_pick_mode){
 				clipboard::set(colorObject, *args->gs, args->converter);
 			}else{
-				if (args->gs->settings().getBool("gpick.picker.sampler.copy_on_release", true)){
+				if (args->gs->settings().getBool(copyOnReleasePath, true)){
 					clipboard::set(colorObject, *args->gs, args->converter);
 				}
-				if (args->gs->settings().getBool("gpick.picker.sampler.add_on_release", true)){
+				if (args->gs->settings().getBool(addOnReleasePath, true)){
 					PickerColorNameAssigner nameAssigner(*args->gs);
 					nameAssigner.assign(colorObject);
 					args->gs->colorList().add(colorObject);
 				}
-				if (args->gs->settings().getBool("gpick.picker.sampler.add_to_swatch_on_release", true)){
+				if (args->gs->settings().getBool(addToSwatchOnReleasePath, true)){
 					args->colorPicker->setCurrentColor();
 				}
-				if (args->gs->settings().getBool("gpick.picker.sampler.rotate_swatch_on_release", true)){
+				if (args->gs->settings().getBool(rotateSwatchOnReleasePath, true)){
 					args->colorPicker->rotateSwatch();
 				}
 			}
@@ -26,6 +26,7 @@
 #include "color_names/ColorNames.h"
 #include "Sampler.h"
 #include "ColorList.h"
+#include "ColorSpaces.h"
 #include "EventBus.h"
 #include "layout/Layout.h"
 #include "layout/Layouts.h"
@@ -91,6 +92,7 @@ struct GlobalState::Impl {
 	Converters m_converters;
 	layout::Layouts m_layouts;
 	lua::Callbacks m_callbacks;
+	ComponentTexts m_componentTexts;
 	transformation::Chain *m_transformationChain;
 	GtkWidget *m_statusBar;
 	IColorSource *m_colorSource;
@@ -106,6 +108,7 @@ struct GlobalState::Impl {
 		m_statusBar(nullptr),
 		m_colorSource(nullptr),
 		m_converterOptions(m_settings) {
+		m_settings.setIndexed(true);
 	}
 	virtual ~Impl() {
 		m_eventBus.unsubscribe(m_converterOptions);
@@ -318,6 +321,9 @@ Random *GlobalState::getRandom() {
 Converters &GlobalState::converters() {
 	return m_impl->m_converters;
 }
+ComponentTexts &GlobalState::componentTexts() {
+	return m_impl->m_componentTexts;
+}
 layout::Layouts &GlobalState::layouts() {
 	return m_impl->m_layouts;
 }
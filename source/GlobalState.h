@@ -31,6 +31,7 @@ struct Converters;
 struct IColorSource;
 struct EventBus;
 struct IPalette;
+struct ComponentTexts;
 typedef struct _GtkWidget GtkWidget;
 namespace layout {
 struct Layouts;
@@ -57,6 +58,7 @@ struct GlobalState {
 	lua::Script &script();
 	lua::Callbacks &callbacks();
 	Converters &converters();
+	ComponentTexts &componentTexts();
 	Random *getRandom();
 	layout::Layouts &layouts();
 	transformation::Chain *getTransformationChain();
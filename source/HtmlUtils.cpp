@@ -18,6 +18,7 @@
 
 #include "HtmlUtils.h"
 #include "Color.h"
+#include "common/TextWriter.h"
 #include <algorithm>
 #include <iterator>
 #include <boost/math/special_functions/round.hpp>
@@ -59,6 +60,9 @@ HtmlHSL::HtmlHSL(const Color &color):
 HtmlHSLA::HtmlHSLA(const Color &color):
 	color(color) {
 }
+HtmlEscape::HtmlEscape(std::string_view text):
+	text(text) {
+}
 std::string &escapeHtmlInplace(std::string &str) {
 	std::string result;
 	result.reserve(str.size());
@@ -128,3 +132,56 @@ std::ostream& operator<<(std::ostream& os, const HtmlHSLA color) {
 	os.setf(flags);
 	return os;
 }
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlRGB color) {
+	using boost::math::iround;
+	return writer << "rgb(" << iround(color.color.rgb.red * 255) << ", " << iround(color.color.rgb.green * 255) << ", " << iround(color.color.rgb.blue * 255) << ")";
+}
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlRGBA color) {
+	using boost::math::iround;
+	writer << "rgba(" << iround(color.color.rgb.red * 255) << ", " << iround(color.color.rgb.green * 255) << ", " << iround(color.color.rgb.blue * 255) << ", ";
+	return writer.write(color.color.alpha, 3) << ")";
+}
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHEX color) {
+	using boost::math::iround;
+	writer << "#";
+	writer.writeHex(iround(color.color.rgb.red * 255), 2);
+	writer.writeHex(iround(color.color.rgb.green * 255), 2);
+	return writer.writeHex(iround(color.color.rgb.blue * 255), 2);
+}
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHSL color) {
+	using boost::math::iround;
+	return writer << "hsl(" << iround(color.color.hsl.hue * 360) << ", " << iround(color.color.hsl.saturation * 100) << "%, " << iround(color.color.hsl.lightness * 100) << "%)";
+}
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHSLA color) {
+	using boost::math::iround;
+	writer << "hsla(" << iround(color.color.hsl.hue * 360) << ", " << iround(color.color.hsl.saturation * 100) << "%, " << iround(color.color.hsl.lightness * 100) << "%, ";
+	return writer.write(color.color.alpha, 3) << ")";
+}
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlEscape text) {
+	size_t start = 0;
+	for (size_t i = 0; i < text.text.length(); ++i) {
+		const char *replacement;
+		switch (text.text[i]) {
+		case '&':
+			replacement = "&amp;";
+			break;
+		case '"':
+			replacement = "&quot;";
+			break;
+		case '\'':
+			replacement = "&apos;";
+			break;
+		case '<':
+			replacement = "&lt;";
+			break;
+		case '>':
+			replacement = "&gt;";
+			break;
+		default:
+			continue;
+		}
+		writer << text.text.substr(start, i - start) << replacement;
+		start = i + 1;
+	}
+	return writer << text.text.substr(start);
+}
@@ -19,7 +19,11 @@
 #ifndef GPICK_HTML_UTILS_H_
 #define GPICK_HTML_UTILS_H_
 #include <string>
+#include <string_view>
 #include <iosfwd>
+namespace common {
+struct TextWriter;
+}
 std::string &escapeHtmlInplace(std::string &str);
 std::string escapeHtml(const std::string &str);
 struct Color;
@@ -43,9 +47,20 @@ struct HtmlHSLA {
 	HtmlHSLA(const Color &color);
 	const Color &color;
 };
+/** Text with HTML special characters replaced by entities when written. */
+struct HtmlEscape {
+	HtmlEscape(std::string_view text);
+	std::string_view text;
+};
 std::ostream& operator<<(std::ostream& os, const HtmlRGB color);
 std::ostream& operator<<(std::ostream& os, const HtmlRGBA color);
 std::ostream& operator<<(std::ostream& os, const HtmlHEX color);
 std::ostream& operator<<(std::ostream& os, const HtmlHSL color);
 std::ostream& operator<<(std::ostream& os, const HtmlHSLA color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlRGB color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlRGBA color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHEX color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHSL color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlHSLA color);
+common::TextWriter &operator<<(common::TextWriter &writer, const HtmlEscape text);
 #endif /* GPICK_HTML_UTILS_H_ */
@@ -17,12 +17,33 @@
  */
 
 #pragma once
+#include "common/Span.h"
 struct ColorList;
 struct ColorObject;
 struct IPalette {
 	virtual ~IPalette() = default;
 	virtual void add(ColorList &colorList, ColorObject *colorObject) = 0;
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) = 0;
+	/**
+	 * Add color objects appended to the color list in one step.
+	 * Default implementation adds color objects one by one.
+	 * @param[in] colorList Color list.
+	 * @param[in] colorObjects Appended color objects.
+	 */
+	virtual void addRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) {
+		for (auto *colorObject: colorObjects)
+			add(colorList, colorObject);
+	}
+	/**
+	 * Remove color objects removed from the color list in one step.
+	 * Default implementation removes color objects one by one.
+	 * @param[in] colorList Color list.
+	 * @param[in] colorObjects Removed color objects, one entry for each removed row.
+	 */
+	virtual void removeRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) {
+		for (auto *colorObject: colorObjects)
+			remove(colorList, colorObject);
+	}
 	virtual void removeSelected(ColorList &colorList) = 0;
 	virtual void clear(ColorList &colorList) = 0;
 	virtual void update(ColorList &colorList) = 0;
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ImageRows.h"
+#include <png.h>
+#include <cstdio>
+#include <jpeglib.h>
+#include <algorithm>
+#include <condition_variable>
+#include <csetjmp>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace {
+using Result = common::ResultVoid<ErrorCode>;
+// Decoded rows are collected into two bands, one is filled by the decoder while the other one is passed to the callback.
+struct Bands {
+	static constexpr size_t bandSize = 4 * 1024 * 1024;
+	Bands(int step, const ImageRowsCallback &callback):
+		m_step(std::max(step, 1)),
+		m_callback(callback) {
+	}
+	~Bands() {
+		stop();
+	}
+	void start(int width, int channels) {
+		m_channels = channels;
+		m_columns = (width + m_step - 1) / m_step;
+		m_stride = m_columns * channels;
+		m_bandRows = std::max<int>(1, static_cast<int>(bandSize / m_stride));
+		for (auto &band: m_bands)
+			band.resize(static_cast<size_t>(m_stride) * m_bandRows);
+		if (m_step > 1)
+			m_row.resize(static_cast<size_t>(width) * channels);
+		m_worker = std::thread(&Bands::work, this);
+	}
+	// Buffer for the decoder to write the next image row into.
+	uint8_t *row() {
+		if (m_step == 1)
+			return &m_bands[m_current][static_cast<size_t>(m_stride) * m_rows];
+		return m_row.data();
+	}
+	void rowDecoded(int y) {
+		if (y % m_step != 0)
+			return;
+		if (m_step > 1) {
+			const uint8_t *source = m_row.data();
+			uint8_t *destination = &m_bands[m_current][static_cast<size_t>(m_stride) * m_rows];
+			const size_t pixelStep = static_cast<size_t>(m_channels) * m_step;
+			for (int x = 0; x < m_columns; x++, source += pixelStep, destination += m_channels)
+				std::memcpy(destination, source, m_channels);
+		}
+		if (++m_rows == m_bandRows)
+			flush();
+	}
+	void finish() {
+		if (m_rows > 0)
+			flush();
+		stop();
+	}
+private:
+	int m_step;
+	const ImageRowsCallback &m_callback;
+	int m_channels = 0, m_columns = 0, m_stride = 0, m_bandRows = 0;
+	std::vector<uint8_t> m_bands[2], m_row;
+	int m_current = 0, m_rows = 0;
+	std::thread m_worker;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	int m_pendingRows = 0;
+	bool m_stop = false;
+	void flush() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() {
+			return m_pendingRows == 0;
+		});
+		m_pendingRows = m_rows;
+		m_current ^= 1;
+		m_rows = 0;
+		lock.unlock();
+		m_condition.notify_all();
+	}
+	void work() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_condition.wait(lock, [this]() {
+				return m_stop || m_pendingRows > 0;
+			});
+			if (m_pendingRows == 0)
+				return;
+			// Decoder has already switched to the other band.
+			const uint8_t *data = m_bands[m_current ^ 1].data();
+			int rows = m_pendingRows;
+			lock.unlock();
+			m_callback(data, m_columns, rows, m_stride, m_channels);
+			lock.lock();
+			m_pendingRows = 0;
+			m_condition.notify_all();
+		}
+	}
+	void stop() {
+		if (!m_worker.joinable())
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_all();
+		m_worker.join();
+	}
+};
+// Decoder functions use setjmp, so all objects with destructors are kept outside of them.
+Result readPng(FILE *file, Bands &bands) {
+	png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, [](png_structp png, png_const_charp) {
+		png_longjmp(png, 1);
+	}, [](png_structp, png_const_charp) {
+	});
+	if (!png)
+		return Result(ErrorCode::readFailed);
+	png_infop info = png_create_info_struct(png);
+	if (!info) {
+		png_destroy_read_struct(&png, nullptr, nullptr);
+		return Result(ErrorCode::readFailed);
+	}
+	if (setjmp(png_jmpbuf(png))) {
+		png_destroy_read_struct(&png, &info, nullptr);
+		return Result(ErrorCode::badFile);
+	}
+	png_init_io(png, file);
+	png_read_info(png, info);
+	png_uint_32 width, height;
+	int bitDepth, colorType, interlaceType;
+	png_get_IHDR(png, info, &width, &height, &bitDepth, &colorType, &interlaceType, nullptr, nullptr);
+	// Interlaced images are only complete after the last pass.
+	if (interlaceType != PNG_INTERLACE_NONE) {
+		png_destroy_read_struct(&png, &info, nullptr);
+		return Result(ErrorCode::unsupportedFormat);
+	}
+	if (colorType == PNG_COLOR_TYPE_PALETTE)
+		png_set_palette_to_rgb(png);
+	if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+		png_set_expand_gray_1_2_4_to_8(png);
+	if (bitDepth == 16)
+		png_set_strip_16(png);
+	png_read_update_info(png, info);
+	bands.start(static_cast<int>(width), png_get_channels(png, info));
+	for (png_uint_32 y = 0; y < height; y++) {
+		png_read_row(png, bands.row(), nullptr);
+		bands.rowDecoded(static_cast<int>(y));
+	}
+	png_destroy_read_struct(&png, &info, nullptr);
+	return Result();
+}
+struct JpegErrorManager {
+	jpeg_error_mgr manager;
+	jmp_buf jump;
+};
+Result readJpeg(FILE *file, Bands &bands) {
+	jpeg_decompress_struct decompress;
+	JpegErrorManager error;
+	decompress.err = jpeg_std_error(&error.manager);
+	error.manager.error_exit = [](j_common_ptr common) {
+		longjmp(reinterpret_cast<JpegErrorManager *>(common->err)->jump, 1);
+	};
+	error.manager.output_message = [](j_common_ptr) {
+	};
+	if (setjmp(error.jump)) {
+		jpeg_destroy_decompress(&decompress);
+		return Result(ErrorCode::badFile);
+	}
+	jpeg_create_decompress(&decompress);
+	jpeg_stdio_src(&decompress, file);
+	jpeg_read_header(&decompress, TRUE);
+	// Adobe CMYK files store inverted values, GdkPixbuf handles them.
+	if (decompress.jpeg_color_space == JCS_CMYK || decompress.jpeg_color_space == JCS_YCCK) {
+		jpeg_destroy_decompress(&decompress);
+		return Result(ErrorCode::unsupportedFormat);
+	}
+	decompress.out_color_space = decompress.num_components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+	jpeg_start_decompress(&decompress);
+	bands.start(static_cast<int>(decompress.output_width), decompress.output_components);
+	while (decompress.output_scanline < decompress.output_height) {
+		int y = static_cast<int>(decompress.output_scanline);
+		JSAMPROW row = bands.row();
+		jpeg_read_scanlines(&decompress, &row, 1);
+		bands.rowDecoded(y);
+	}
+	jpeg_finish_decompress(&decompress);
+	jpeg_destroy_decompress(&decompress);
+	return Result();
+}
+}
+common::ResultVoid<ErrorCode> imageFileReadRows(const char *filename, int step, const ImageRowsCallback &callback) {
+	FILE *file = std::fopen(filename, "rb");
+	if (!file)
+		return Result(ErrorCode::fileCouldNotBeOpened);
+	uint8_t signature[8];
+	size_t signatureSize = std::fread(signature, 1, sizeof(signature), file);
+	std::rewind(file);
+	Bands bands(step, callback);
+	Result result = [&]() {
+		if (signatureSize == 8 && png_sig_cmp(signature, 0, 8) == 0)
+			return readPng(file, bands);
+		if (signatureSize >= 3 && signature[0] == 0xff && signature[1] == 0xd8 && signature[2] == 0xff)
+			return readJpeg(file, bands);
+		return Result(ErrorCode::unsupportedFormat);
+	}();
+	std::fclose(file);
+	if (!result)
+		return result;
+	bands.finish();
+	return Result();
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef GPICK_IMAGE_ROWS_H_
+#define GPICK_IMAGE_ROWS_H_
+#include "common/Result.h"
+#include "ErrorCode.h"
+#include <cstdint>
+#include <functional>
+/**
+ * Callback receiving decoded rows.
+ * @param[in] data First row of the band.
+ * @param[in] width Row width in pixels.
+ * @param[in] height Number of rows in the band.
+ * @param[in] stride Distance between rows in bytes.
+ * @param[in] channels Number of channels, 1 or 2 for grayscale and 3 or 4 for RGB images.
+ */
+using ImageRowsCallback = std::function<void(const uint8_t *data, int width, int height, int stride, int channels)>;
+/**
+ * Decode PNG or JPEG file row by row, keeping only a small band of rows in memory.
+ * Full bands are passed to the callback on a separate thread while the next band is being decoded.
+ * @param[in] filename Image file name.
+ * @param[in] step Subsampling step. Only every step-th pixel of every step-th row, starting with the first row and column, is passed to the callback.
+ * @param[in] callback Band callback.
+ * @return ErrorCode::unsupportedFormat for files which can not be decoded row by row: other image formats, interlaced PNG and CMYK JPEG files.
+ */
+common::ResultVoid<ErrorCode> imageFileReadRows(const char *filename, int step, const ImageRowsCallback &callback);
+#endif /* GPICK_IMAGE_ROWS_H_ */
@@ -20,16 +20,18 @@
 #include "ColorObject.h"
 #include "ColorList.h"
 #include "FileFormat.h"
+#include "AseFormat.h"
 #include "Converters.h"
 #include "Converter.h"
 #include "I18N.h"
 #include "StringUtils.h"
 #include "HtmlUtils.h"
+#include "ExportFormats.h"
 #include "GlobalState.h"
 #include "dynv/Map.h"
 #include "version/Version.h"
 #include "parser/TextFile.h"
-#include "common/First.h"
+#include "common/TextWriter.h"
 #include <glib.h>
 #include <fstream>
 #include <string>
@@ -38,7 +40,8 @@
 #include <filesystem>
 #include <boost/math/special_functions/round.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/endian/conversion.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 ImportExport::ImportExport(ColorList &colorList, const char *filename, GlobalState &gs):
 	m_colorList(colorList),
@@ -119,13 +122,15 @@ void ImportExport::setBackground(const char *background) {
 void ImportExport::setIncludeColorNames(bool include_color_names) {
 	m_includeColorNames = include_color_names;
 }
-static void gplColor(ColorObject *colorObject, std::ostream &stream) {
-	using boost::math::iround;
-	Color color = colorObject->getColor();
-	stream
-		<< iround(color.red * 255) << "\t"
-		<< iround(color.green * 255) << "\t"
-		<< iround(color.blue * 255) << "\t" << colorObject->getName() << '\n';
+std::vector<const ColorObject *> ImportExport::colorObjects() const {
+	return std::vector<const ColorObject *>(m_colorList.begin(), m_colorList.end());
+}
+bool ImportExport::finishExport(common::TextWriter &writer) {
+	if (!writer.flush()) {
+		m_lastError = Error::fileWriteError;
+		return false;
+	}
+	return true;
 }
 bool ImportExport::exportGPL() {
 	std::ofstream f(m_filename, std::ios::out | std::ios::trunc);
@@ -134,20 +139,10 @@ bool ImportExport::exportGPL() {
 		return false;
 	}
 	std::filesystem::path path(m_filename);
-	f << "GIMP Palette" << '\n';
-	f << "Name: " << path.filename().string() << '\n';
-	f << "Columns: 1" << '\n';
-	f << "#" << '\n';
-	for (auto color: m_colorList) {
-		gplColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f.close();
-	return true;
+	auto colorObjects = this->colorObjects();
+	common::TextWriter writer(f);
+	writeGpl(writer, path.filename().string(), common::Span<const ColorObject *const>(colorObjects.data(), colorObjects.size()));
+	return finishExport(writer);
 }
 bool ImportExport::importGPL() {
 	std::ifstream f(m_filename, std::ios::in);
@@ -208,82 +203,36 @@ bool ImportExport::exportTXT() {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	ConverterSerializePosition position(m_colorList.size());
-	for (auto color: m_colorList) {
-		std::string line = m_converter->serialize(*color, position);
-		if (m_includeColorNames) {
-			f << line << " " << color->getName() << '\n';
-		} else {
-			f << line << '\n';
-		}
-		position.incrementIndex();
-		if (position.index() + 1 == position.count()) {
-			position.last(true);
-		}
-		if (position.first())
-			position.first(false);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f.close();
-	return true;
+	auto colorObjects = this->colorObjects();
+	common::Span<const ColorObject *const> colorObjectSpan(colorObjects.data(), colorObjects.size());
+	auto lines = m_converter->serialize(colorObjectSpan);
+	common::TextWriter writer(f);
+	writeTxt(writer, colorObjectSpan, lines, m_includeColorNames);
+	return finishExport(writer);
 }
 bool ImportExport::importTXT() {
-	std::ifstream f(m_filename.c_str(), std::ios::in);
+	std::ifstream f(m_filename.c_str(), std::ios::in | std::ios::binary);
 	if (!f.is_open()) {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	common::First<float, std::greater<float>, ColorObject> bestConversion;
-	ColorObject colorObject;
-	float quality;
-	std::string line, stripChars = " \t";
-	bool imported = false;
-	for (;;) {
-		std::getline(f, line);
-		stripLeadingTrailingChars(line, stripChars);
-		if (!line.empty()) {
-			for (auto &converter: m_converters->allPaste()) {
-				if (!converter->hasDeserialize())
-					continue;
-				if (converter->deserialize(line.c_str(), colorObject, quality)) {
-					if (quality > 0) {
-						bestConversion(quality, colorObject);
-					}
-				}
-			}
-			if (bestConversion) {
-				m_colorList.add(bestConversion.data<ColorObject>());
-				imported = true;
-				bestConversion.reset();
-			}
-		}
-		if (!f.good()) {
-			if (f.eof())
-				break;
-			f.close();
-			m_lastError = Error::fileReadError;
-			return false;
-		}
+	std::stringstream content;
+	content << f.rdbuf();
+	if (f.bad()) {
+		f.close();
+		m_lastError = Error::fileReadError;
+		return false;
 	}
 	f.close();
-	if (!imported) {
+	// Text files are imported with paste converters only, display converter is not used unless it is enabled for pasting.
+	auto colorObjects = m_converters->deserializeLines(content.str(), false);
+	if (colorObjects.empty()) {
 		m_lastError = Error::noColorsImported;
+		return false;
 	}
-	return imported;
-}
-static void cssColor(ColorObject *colorObject, std::ostream &stream) {
-	Color color, hsl;
-	color = colorObject->getColor();
-	hsl = color.rgbToHsl();
-	stream << " * " << colorObject->getName()
-				 << ": " << HtmlHEX { color }
-				 << ", " << HtmlRGBA { color }
-				 << ", " << HtmlHSLA { color }
-				 << '\n';
+	for (const auto &colorObject: colorObjects)
+		m_colorList.add(colorObject);
+	return true;
 }
 bool ImportExport::exportCSS() {
 	std::ofstream f(m_filename.c_str(), std::ios::out | std::ios::trunc);
@@ -291,46 +240,13 @@ bool ImportExport::exportCSS() {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	f << "/**" << '\n'
+	auto colorObjects = this->colorObjects();
+	common::TextWriter writer(f);
+	writer << "/**" << '\n'
 		<< " * Generated by Gpick " << version::versionFull << '\n';
-	for (auto color: m_colorList) {
-		cssColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f << " */" << '\n';
-	if (!f.good()) {
-		f.close();
-		m_lastError = Error::fileWriteError;
-		return false;
-	}
-	f.close();
-	return true;
-}
-static void htmlColor(ColorObject *colorObject, Converter *converter, bool includeColorName, std::ostream &stream) {
-	Color color, textColor;
-	color = colorObject->getColor();
-	textColor = color.getContrasting();
-	stream << "<div style=\"background-color:" << HtmlRGBA { color } << "; color:" << HtmlRGB { textColor } << "\">";
-	if (includeColorName) {
-		std::string name = colorObject->getName();
-		escapeHtmlInplace(name);
-		if (!name.empty())
-			stream << name << ":<br/>";
-	}
-	if (converter)
-		stream << "<span>" << converter->serialize(*colorObject) << "</span></div>";
-	else
-		stream << "<span>" << HtmlRGB(color) << "</span></div>";
-}
-static std::string getHtmlColor(ColorObject *colorObject) {
-	Color color = colorObject->getColor();
-	std::stringstream ss;
-	ss << HtmlRGBA { color };
-	return ss.str();
+	writeCss(writer, common::Span<const ColorObject *const>(colorObjects.data(), colorObjects.size()));
+	writer << " */" << '\n';
+	return finishExport(writer);
 }
 static std::string getHtmlColor(const Color &color) {
 	std::stringstream ss;
@@ -377,7 +293,7 @@ bool ImportExport::exportHTML() {
 		break;
 	case Background::firstColor:
 		if (!m_colorList.empty()) {
-			htmlBackgroundCss = "background-color:" + getHtmlColor(m_colorList.front()) + ";";
+			htmlBackgroundCss = "background-color:" + getHtmlColor(m_colorList.front()->getColor()) + ";";
 			auto color = m_colorList.front()->getColor();
 			Color textColor = color.getContrasting();
 			htmlColorCss = "color:" + getHtmlColor(textColor) + ";";
@@ -385,7 +301,7 @@ bool ImportExport::exportHTML() {
 		break;
 	case Background::lastColor:
 		if (!m_colorList.empty()) {
-			htmlBackgroundCss = "background-color:" + getHtmlColor(m_colorList.back()) + ";";
+			htmlBackgroundCss = "background-color:" + getHtmlColor(m_colorList.back()->getColor()) + ";";
 			auto color = m_colorList.back()->getColor();
 			Color textColor = color.getContrasting();
 			htmlColorCss = "color:" + getHtmlColor(textColor) + ";";
@@ -394,7 +310,8 @@ bool ImportExport::exportHTML() {
 	case Background::controllable:
 		break;
 	}
-	f << "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"utf-8\"><title>"
+	common::TextWriter writer(f);
+	writer << "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"utf-8\"><title>"
 		<< path.filename().string() << "</title>" << '\n'
 		<< "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">" << '\n'
 		<< "<style>" << '\n'
@@ -407,45 +324,31 @@ bool ImportExport::exportHTML() {
 		<< "</head>" << '\n'
 		<< "<body>" << '\n';
 	if (m_itemSize == ItemSize::controllable || m_background == Background::controllable) {
-		f << "<form>" << '\n';
+		writer << "<form>" << '\n';
 		if (m_itemSize == ItemSize::controllable) {
-			f << "<div>" << _("Item size") << ":<input type=\"range\" id=\"itemSize\" min=\"16\" max=\"128\" value=\"64\" oninput=\"var elements = document.querySelectorAll('div#colors div'); for (var i = 0; i < elements.length; i++){ elements[i].style.width = this.value + 'px'; elements[i].style.height = this.value + 'px'; }\" />"
+			writer << "<div>" << _("Item size") << ":<input type=\"range\" id=\"itemSize\" min=\"16\" max=\"128\" value=\"64\" oninput=\"var elements = document.querySelectorAll('div#colors div'); for (var i = 0; i < elements.length; i++){ elements[i].style.width = this.value + 'px'; elements[i].style.height = this.value + 'px'; }\" />"
 				<< "</div>" << '\n';
 		}
 		if (m_background == Background::controllable) {
-			f << "<div>" << _("Background color") << ":<input type=\"color\" id=\"background\" oninput=\"document.body.style.backgroundColor = this.value;\" />"
+			writer << "<div>" << _("Background color") << ":<input type=\"color\" id=\"background\" oninput=\"document.body.style.backgroundColor = this.value;\" />"
 				<< "</div>" << '\n';
 		}
-		f << "</form>" << '\n';
-	}
-	f << "<div id=\"colors\">" << '\n';
-	std::string hexCase = m_gs.settings().getString("gpick.options.hex_case", "upper");
-	if (hexCase == "upper") {
-		f << std::uppercase;
-	} else {
-		f << std::nouppercase;
-	}
-	for (auto color: m_colorList) {
-		htmlColor(color, m_converter, m_includeColorNames, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f << "</div>" << '\n';
-	f << "<script>" << '\n'
+		writer << "</form>" << '\n';
+	}
+	writer << "<div id=\"colors\">" << '\n';
+	auto colorObjects = this->colorObjects();
+	common::Span<const ColorObject *const> colorObjectSpan(colorObjects.data(), colorObjects.size());
+	std::vector<std::string> texts;
+	if (m_converter)
+		texts = m_converter->serialize(colorObjectSpan);
+	writeHtmlColors(writer, colorObjectSpan, texts, m_includeColorNames);
+	writer << "</div>" << '\n';
+	writer << "<script>" << '\n'
 		<< "function selectText(element){ if (document.selection){ var range = document.body.createTextRange(); range.moveToElementText(element); range.select(); }else if (window.getSelection){ var range = document.createRange(); range.selectNode(element); window.getSelection().addRange(range); } }" << '\n'
 		<< "document.getElementById('colors').addEventListener('click', function(event){ if (event.target.tagName.toLowerCase() == 'span'){ event.preventDefault(); selectText(event.target); document.execCommand('copy'); }});" << '\n'
 		<< "</script>";
-	f << "</body></html>" << '\n';
-	if (!f.good()) {
-		f.close();
-		m_lastError = Error::fileWriteError;
-		return false;
-	}
-	f.close();
-	return true;
+	writer << "</body></html>" << '\n';
+	return finishExport(writer);
 }
 
 bool ImportExport::exportType(FileType type) {
@@ -470,205 +373,31 @@ bool ImportExport::exportType(FileType type) {
 	}
 	return false;
 }
-static void mtlColor(ColorObject *colorObject, std::ostream &stream) {
-	Color color = colorObject->getColor();
-	stream << "newmtl " << colorObject->getName() << '\n';
-	stream << "Ns 90.000000" << '\n';
-	stream << "Ka 0.000000 0.000000 0.000000" << '\n';
-	stream << "Kd " << color.red << " " << color.green << " " << color.blue << '\n';
-	stream << "Ks 0.500000 0.500000 0.500000" << '\n'
-				 << '\n';
-}
 bool ImportExport::exportMTL() {
 	std::ofstream f(m_filename.c_str(), std::ios::out | std::ios::trunc);
 	if (!f.is_open()) {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	for (auto color: m_colorList) {
-		mtlColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f.close();
-	return true;
-}
-union FloatInt {
-	float f;
-	uint32_t i;
-};
-static void aseColor(ColorObject *colorObject, std::ostream &stream) {
-	Color color = colorObject->getColor();
-	std::string name = colorObject->getName();
-	glong name_u16_len = 0;
-	gunichar2 *name_u16 = g_utf8_to_utf16(name.c_str(), -1, 0, &name_u16_len, 0);
-	for (glong i = 0; i < name_u16_len; ++i) {
-		name_u16[i] = boost::endian::native_to_big<uint16_t>(name_u16[i]);
-	}
-	uint16_t color_entry = boost::endian::native_to_big<uint16_t>(0x0001);
-	stream.write((char *)&color_entry, 2);
-	int32_t block_size = 2 + (name_u16_len + 1) * 2 + 4 + (3 * 4) + 2; //name length + name (zero terminated and 2 bytes per char wide) + color name + 3 float values + color type
-	block_size = boost::endian::native_to_big<uint32_t>(block_size);
-	stream.write((char *)&block_size, 4);
-	uint16_t name_length = boost::endian::native_to_big<uint16_t>(uint16_t(name_u16_len + 1));
-	stream.write((char *)&name_length, 2);
-	stream.write((char *)name_u16, (name_u16_len + 1) * 2);
-	stream << "RGB ";
-	FloatInt r, g, b;
-	r.f = color.red;
-	g.f = color.green;
-	b.f = color.blue;
-	r.i = boost::endian::native_to_big<uint32_t>(r.i);
-	g.i = boost::endian::native_to_big<uint32_t>(g.i);
-	b.i = boost::endian::native_to_big<uint32_t>(b.i);
-	stream.write((char *)&r, 4);
-	stream.write((char *)&g, 4);
-	stream.write((char *)&b, 4);
-	int16_t color_type = boost::endian::native_to_big<uint16_t>(0);
-	stream.write((char *)&color_type, 2);
-	g_free(name_u16);
+	auto colorObjects = this->colorObjects();
+	common::TextWriter writer(f);
+	writeMtl(writer, common::Span<const ColorObject *const>(colorObjects.data(), colorObjects.size()));
+	return finishExport(writer);
 }
 bool ImportExport::exportASE() {
-	std::ofstream f(m_filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
-	if (!f.is_open()) {
-		m_lastError = Error::couldNotOpenFile;
+	auto result = aseFileSave(m_filename.c_str(), m_colorList);
+	if (!result) {
+		m_lastError = result.error() == ErrorCode::fileCouldNotBeOpened ? Error::couldNotOpenFile : Error::fileWriteError;
 		return false;
 	}
-	f << "ASEF"; //magic header
-	uint32_t version = boost::endian::native_to_big<uint32_t>(0x00010000);
-	f.write((char *)&version, 4);
-	uint32_t blocks = m_colorList.size();
-	blocks = boost::endian::native_to_big<uint32_t>(blocks);
-	f.write((char *)&blocks, 4);
-	for (auto color: m_colorList) {
-		aseColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
-	}
-	f.close();
 	return true;
 }
 bool ImportExport::importASE() {
-	std::ifstream f(m_filename.c_str(), std::ios::binary);
-	if (!f.is_open()) {
-		m_lastError = Error::couldNotOpenFile;
+	auto result = aseFileLoad(m_filename.c_str(), m_colorList);
+	if (!result) {
+		m_lastError = result.error() == ErrorCode::fileCouldNotBeOpened ? Error::couldNotOpenFile : Error::fileReadError;
 		return false;
 	}
-	char magic[4];
-	f.read(magic, 4);
-	if (memcmp(magic, "ASEF", 4) != 0) {
-		f.close();
-		m_lastError = Error::fileReadError;
-		return false;
-	}
-	uint32_t version;
-	f.read((char *)&version, 4);
-	version = boost::endian::big_to_native<uint32_t>(version);
-	uint32_t blocks;
-	f.read((char *)&blocks, 4);
-	blocks = boost::endian::big_to_native<uint32_t>(blocks);
-	uint16_t block_type;
-	uint32_t block_size;
-	int color_supported;
-	for (uint32_t i = 0; i < blocks; ++i) {
-		f.read((char *)&block_type, 2);
-		block_type = boost::endian::big_to_native<uint16_t>(block_type);
-		f.read((char *)&block_size, 4);
-		block_size = boost::endian::big_to_native<uint32_t>(block_size);
-		switch (block_type) {
-		case 0x0001: //color block
-		{
-			uint16_t name_length;
-			f.read((char *)&name_length, 2);
-			name_length = boost::endian::big_to_native<uint16_t>(name_length);
-
-			gunichar2 *name_u16 = (gunichar2 *)g_malloc(name_length * 2);
-			f.read((char *)name_u16, name_length * 2);
-			for (uint32_t j = 0; j < name_length; ++j) {
-				name_u16[j] = boost::endian::big_to_native<uint16_t>(name_u16[j]);
-			}
-			gchar *name = g_utf16_to_utf8(name_u16, name_length, 0, 0, 0);
-			g_free(name_u16);
-			Color c;
-			char color_space[4];
-			f.read(color_space, 4);
-			color_supported = 0;
-			if (memcmp(color_space, "RGB ", 4) == 0) {
-				FloatInt rgb[3];
-				f.read((char *)&rgb[0], 4);
-				f.read((char *)&rgb[1], 4);
-				f.read((char *)&rgb[2], 4);
-				rgb[0].i = boost::endian::big_to_native<uint32_t>(rgb[0].i);
-				rgb[1].i = boost::endian::big_to_native<uint32_t>(rgb[1].i);
-				rgb[2].i = boost::endian::big_to_native<uint32_t>(rgb[2].i);
-				c.red = rgb[0].f;
-				c.green = rgb[1].f;
-				c.blue = rgb[2].f;
-				c.alpha = 1;
-				color_supported = 1;
-			} else if (memcmp(color_space, "CMYK", 4) == 0) {
-				Color c2;
-				FloatInt cmyk[4];
-				f.read((char *)&cmyk[0], 4);
-				f.read((char *)&cmyk[1], 4);
-				f.read((char *)&cmyk[2], 4);
-				f.read((char *)&cmyk[3], 4);
-				cmyk[0].i = boost::endian::big_to_native<uint32_t>(cmyk[0].i);
-				cmyk[1].i = boost::endian::big_to_native<uint32_t>(cmyk[1].i);
-				cmyk[2].i = boost::endian::big_to_native<uint32_t>(cmyk[2].i);
-				cmyk[3].i = boost::endian::big_to_native<uint32_t>(cmyk[3].i);
-				c2.cmyk.c = cmyk[0].f;
-				c2.cmyk.m = cmyk[1].f;
-				c2.cmyk.y = cmyk[2].f;
-				c2.cmyk.k = cmyk[3].f;
-				c = c2.cmykToRgb();
-				c.alpha = 1;
-				color_supported = 1;
-			} else if (memcmp(color_space, "Gray", 4) == 0) {
-				FloatInt gray;
-				f.read((char *)&gray, 4);
-				gray.i = boost::endian::big_to_native<uint32_t>(gray.i);
-				c.red = c.green = c.blue = gray.f;
-				c.alpha = 1;
-				color_supported = 1;
-			} else if (memcmp(color_space, "LAB ", 4) == 0) {
-				Color c2;
-				FloatInt lab[3];
-				f.read((char *)&lab[0], 4);
-				f.read((char *)&lab[1], 4);
-				f.read((char *)&lab[2], 4);
-				lab[0].i = boost::endian::big_to_native<uint32_t>(lab[0].i);
-				lab[1].i = boost::endian::big_to_native<uint32_t>(lab[1].i);
-				lab[2].i = boost::endian::big_to_native<uint32_t>(lab[2].i);
-				c2.lab.L = lab[0].f * 100;
-				c2.lab.a = lab[1].f;
-				c2.lab.b = lab[2].f;
-				c = c2.labToRgbD50();
-				c.red = math::clamp(c.red, 0.0f, 1.0f);
-				c.green = math::clamp(c.green, 0.0f, 1.0f);
-				c.blue = math::clamp(c.blue, 0.0f, 1.0f);
-				c.alpha = 1;
-				color_supported = 1;
-			}
-			if (color_supported) {
-				ColorObject colorObject(name, c);
-				m_colorList.add(colorObject);
-			}
-			uint16_t color_type;
-			f.read((char *)&color_type, 2);
-			g_free(name);
-		} break;
-		default:
-			f.seekg(block_size, std::ios::cur);
-		}
-	}
-	f.close();
 	return true;
 }
 static std::string::size_type rfind_first_of_not(std::string const &str, std::string::size_type const pos, std::string const &chars) {
@@ -823,18 +552,14 @@ ImportExport::Error ImportExport::getLastError() const {
 	return m_lastError;
 }
 struct ImportTextFile: public text_file_parser::TextFile {
-	std::ifstream m_file;
-	std::vector<Color> m_colors;
+	std::vector<ColorObject *> m_colorObjects;
 	bool m_failed;
-	ImportTextFile(const std::string &filename) {
-		m_failed = false;
-		m_file.open(filename, std::ios::in);
-	}
-	bool isOpen() {
-		return m_file.is_open();
+	ImportTextFile():
+		m_failed(false) {
 	}
 	virtual ~ImportTextFile() {
-		m_file.close();
+		for (auto *colorObject: m_colorObjects)
+			colorObject->release();
 	}
 	virtual void outOfMemory() {
 		m_failed = true;
@@ -842,27 +567,43 @@ struct ImportTextFile: public text_file_parser::TextFile {
 	virtual void syntaxError(size_t start_line, size_t start_column, size_t end_line, size_t end_colunn) {
 		m_failed = true;
 	}
-	virtual size_t read(char *buffer, size_t length) {
-		m_file.read(buffer, length);
-		size_t bytes = m_file.gcount();
-		if (bytes > 0) return bytes;
-		if (m_file.eof()) return 0;
-		if (!m_file.good()) {
-			m_failed = true;
-		}
-		return 0;
-	}
 	virtual void addColor(const Color &color) {
-		m_colors.push_back(color);
+		m_colorObjects.push_back(new ColorObject("", color));
+	}
+	virtual void addColors(const Color *colors, size_t count) {
+		m_colorObjects.reserve(m_colorObjects.size() + count);
+		for (size_t i = 0; i < count; i++)
+			m_colorObjects.push_back(new ColorObject("", colors[i]));
 	}
 };
 bool ImportExport::importTextFile(const text_file_parser::Configuration &configuration) {
-	ImportTextFile importTextFile(m_filename);
-	if (!importTextFile.isOpen()) {
+	std::error_code error;
+	auto size = std::filesystem::file_size(m_filename, error);
+	if (error) {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	if (!importTextFile.parse(configuration)) {
+	if (size == 0) {
+		m_lastError = Error::noColorsImported;
+		return false;
+	}
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+	try {
+		file = boost::interprocess::file_mapping(m_filename.c_str(), boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		m_lastError = Error::couldNotOpenFile;
+		return false;
+	}
+	try {
+		region = boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		m_lastError = Error::fileReadError;
+		return false;
+	}
+	region.advise(boost::interprocess::mapped_region::advice_sequential);
+	ImportTextFile importTextFile;
+	if (!importTextFile.parse(configuration, static_cast<const char *>(region.get_address()), region.get_size())) {
 		m_lastError = Error::parsingFailed;
 		return false;
 	}
@@ -870,13 +611,11 @@ bool ImportExport::importTextFile(const text_file_parser::Configuration &configu
 		m_lastError = Error::parsingFailed;
 		return false;
 	}
-	if (importTextFile.m_colors.size() == 0) {
+	if (importTextFile.m_colorObjects.size() == 0) {
 		m_lastError = Error::noColorsImported;
 		return false;
 	}
-	for (auto color: importTextFile.m_colors) {
-		m_colorList.add(ColorObject("", color));
-	}
+	m_colorList.add(importTextFile.m_colorObjects);
 	return true;
 }
 const std::string &ImportExport::getFilename() const {
@@ -18,13 +18,18 @@
 
 #pragma once
 #include <string>
+#include <vector>
 struct ColorList;
+struct ColorObject;
 struct Converter;
 struct Converters;
 struct GlobalState;
 namespace text_file_parser {
 struct Configuration;
 }
+namespace common {
+struct TextWriter;
+}
 enum struct FileType {
 	gpa,
 	gpl,
@@ -99,4 +104,6 @@ private:
 	GlobalState &m_gs;
 	bool m_includeColorNames;
 	Error m_lastError;
+	std::vector<const ColorObject *> colorObjects() const;
+	bool finishExport(common::TextWriter &writer);
 };
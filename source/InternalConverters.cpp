@@ -26,6 +26,7 @@
 #include "version/Version.h"
 #include <cstddef>
 #include <algorithm>
+#include <charconv>
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 using namespace common;
@@ -66,14 +67,41 @@ inline auto percentage(std::string_view &value) {
 	return sequence(save(number, value), single('%'));
 }
 const auto valueSeparator = oneOrMore(single({',', ';', '\t', ' '}));
+// Numbers are formatted without printf family functions, so that the result does not depend on the current locale.
+static void appendHex(std::string &result, int value, int digits, bool upperCase) {
+	const char *characters = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+	for (int i = digits - 1; i >= 0; i--)
+		result += characters[(value >> (i * 4)) & 0xf];
+}
+static void appendInteger(std::string &result, int value) {
+	char buffer[16];
+	auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+	result.append(buffer, end);
+}
+static void appendPercentage(std::string &result, int value) {
+	appendInteger(result, value);
+	result += '%';
+}
+static void appendFixed(std::string &result, float value) {
+	char buffer[64];
+	auto end = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(value), std::chars_format::fixed, 3).ptr;
+	result.append(buffer, end);
+}
+static void appendFixed(std::string &result, const Color &color, int channels, std::string_view separator) {
+	for (int i = 0; i < channels; i++) {
+		if (i != 0)
+			result += separator;
+		appendFixed(result, color[i]);
+	}
+}
 static std::string webHexSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[8];
+	std::string result;
+	result.reserve(7);
+	result += '#';
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "#%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	}
+	appendHex(result, toInteger(c.red), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.green), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.blue), 2, options.upperCaseHex);
 	return result;
 }
 static bool webHexDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -91,13 +119,14 @@ static bool webHexDeserialize(const char *value, ColorObject &colorObject, float
 	return true;
 }
 static std::string webHexWithAlphaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[10];
+	std::string result;
+	result.reserve(9);
+	result += '#';
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%02X%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue), toInteger(c.alpha));
-	} else {
-		std::snprintf(result, sizeof(result), "#%02x%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue), toInteger(c.alpha));
-	}
+	appendHex(result, toInteger(c.red), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.green), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.blue), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.alpha), 2, options.upperCaseHex);
 	return result;
 }
 static bool webHexWithAlphaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -115,13 +144,12 @@ static bool webHexWithAlphaDeserialize(const char *value, ColorObject &colorObje
 	return true;
 }
 static std::string webHexNoHashSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[7];
+	std::string result;
+	result.reserve(6);
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	}
+	appendHex(result, toInteger(c.red), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.green), 2, options.upperCaseHex);
+	appendHex(result, toInteger(c.blue), 2, options.upperCaseHex);
 	return result;
 }
 static bool webHexNoHashDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -139,13 +167,13 @@ static bool webHexNoHashDeserialize(const char *value, ColorObject &colorObject,
 	return true;
 }
 static std::string webHexShortSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[5];
+	std::string result;
+	result.reserve(4);
+	result += '#';
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%X%X%X", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "#%x%x%x", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue));
-	}
+	appendHex(result, toShortInteger(c.red), 1, options.upperCaseHex);
+	appendHex(result, toShortInteger(c.green), 1, options.upperCaseHex);
+	appendHex(result, toShortInteger(c.blue), 1, options.upperCaseHex);
 	return result;
 }
 static bool webHexShortDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -163,13 +191,14 @@ static bool webHexShortDeserialize(const char *value, ColorObject &colorObject,
 	return true;
 }
 static std::string webHexShortWithAlphaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[6];
+	std::string result;
+	result.reserve(5);
+	result += '#';
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%X%X%X%X", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue), toShortInteger(c.alpha));
-	} else {
-		std::snprintf(result, sizeof(result), "#%x%x%x%x", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue), toShortInteger(c.alpha));
-	}
+	appendHex(result, toShortInteger(c.red), 1, options.upperCaseHex);
+	appendHex(result, toShortInteger(c.green), 1, options.upperCaseHex);
+	appendHex(result, toShortInteger(c.blue), 1, options.upperCaseHex);
+	appendHex(result, toShortInteger(c.alpha), 1, options.upperCaseHex);
 	return result;
 }
 static bool webHexShortWithAlphaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -187,13 +216,22 @@ static bool webHexShortWithAlphaDeserialize(const char *value, ColorObject &colo
 	return true;
 }
 static std::string cssRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[22];
+	std::string result = "rgb(";
 	auto &c = colorObject.getColor();
 	if (options.cssPercentages) {
-		std::snprintf(result, sizeof(result), "rgb(%d%%, %d%%, %d%%)", toPercentage(c.red), toPercentage(c.green), toPercentage(c.blue));
+		appendPercentage(result, toPercentage(c.red));
+		result += ", ";
+		appendPercentage(result, toPercentage(c.green));
+		result += ", ";
+		appendPercentage(result, toPercentage(c.blue));
 	} else {
-		std::snprintf(result, sizeof(result), "rgb(%d, %d, %d)", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
+		appendInteger(result, toInteger(c.red));
+		result += ", ";
+		appendInteger(result, toInteger(c.green));
+		result += ", ";
+		appendInteger(result, toInteger(c.blue));
 	}
+	result += ')';
 	return result;
 }
 static bool cssRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -212,21 +250,27 @@ static bool cssRgbDeserialize(const char *value, ColorObject &colorObject, float
 	return true;
 }
 static std::string cssRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[30];
+	std::string result = "rgba(";
 	auto &c = colorObject.getColor();
-	if (options.cssAlphaPercentage) {
-		if (options.cssPercentages) {
-			std::snprintf(result, sizeof(result), "rgba(%d%%, %d%%, %d%%, %d%%)", toPercentage(c.red), toPercentage(c.green), toPercentage(c.blue), toPercentage(c.alpha));
-		} else {
-			std::snprintf(result, sizeof(result), "rgba(%d, %d, %d, %d%%)", toInteger(c.red), toInteger(c.green), toInteger(c.blue), toPercentage(c.alpha));
-		}
+	if (options.cssPercentages) {
+		appendPercentage(result, toPercentage(c.red));
+		result += ", ";
+		appendPercentage(result, toPercentage(c.green));
+		result += ", ";
+		appendPercentage(result, toPercentage(c.blue));
 	} else {
-		if (options.cssPercentages) {
-			std::snprintf(result, sizeof(result), "rgba(%d%%, %d%%, %d%%, %0.3f)", toPercentage(c.red), toPercentage(c.green), toPercentage(c.blue), c.alpha);
-		} else {
-			std::snprintf(result, sizeof(result), "rgba(%d, %d, %d, %0.3f)", toInteger(c.red), toInteger(c.green), toInteger(c.blue), c.alpha);
-		}
+		appendInteger(result, toInteger(c.red));
+		result += ", ";
+		appendInteger(result, toInteger(c.green));
+		result += ", ";
+		appendInteger(result, toInteger(c.blue));
 	}
+	result += ", ";
+	if (options.cssAlphaPercentage)
+		appendPercentage(result, toPercentage(c.alpha));
+	else
+		appendFixed(result, c.alpha);
+	result += ')';
 	return result;
 }
 static bool cssRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -245,9 +289,14 @@ static bool cssRgbaDeserialize(const char *value, ColorObject &colorObject, floa
 	return true;
 }
 static std::string cssHslSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[21];
+	std::string result = "hsl(";
 	auto c = colorObject.getColor().rgbToHsl();
-	std::snprintf(result, sizeof(result), "hsl(%d, %d%%, %d%%)", toDegrees(c.hsl.hue), toPercentage(c.hsl.saturation), toPercentage(c.hsl.lightness));
+	appendInteger(result, toDegrees(c.hsl.hue));
+	result += ", ";
+	appendPercentage(result, toPercentage(c.hsl.saturation));
+	result += ", ";
+	appendPercentage(result, toPercentage(c.hsl.lightness));
+	result += ')';
 	return result;
 }
 static bool cssHslDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -265,9 +314,16 @@ static bool cssHslDeserialize(const char *value, ColorObject &colorObject, float
 	return true;
 }
 static std::string cssHslaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[29];
+	std::string result = "hsla(";
 	auto c = colorObject.getColor().rgbToHsl();
-	std::snprintf(result, sizeof(result), "hsla(%d, %d%%, %d%%, %0.3f)", toDegrees(c.hsl.hue), toPercentage(c.hsl.saturation), toPercentage(c.hsl.lightness), c.alpha);
+	appendInteger(result, toDegrees(c.hsl.hue));
+	result += ", ";
+	appendPercentage(result, toPercentage(c.hsl.saturation));
+	result += ", ";
+	appendPercentage(result, toPercentage(c.hsl.lightness));
+	result += ", ";
+	appendFixed(result, c.alpha);
+	result += ')';
 	return result;
 }
 static bool cssHslaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -286,9 +342,8 @@ static bool cssHslaDeserialize(const char *value, ColorObject &colorObject, floa
 	return true;
 }
 static std::string csvRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[18];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f,%0.3f,%0.3f", c.red, c.green, c.blue);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 3, ","sv);
 	return result;
 }
 static bool csvRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -306,9 +361,8 @@ static bool csvRgbDeserialize(const char *value, ColorObject &colorObject, float
 	return true;
 }
 static std::string csvRgbTabSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[18];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f\t%0.3f\t%0.3f", c.red, c.green, c.blue);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 3, "\t"sv);
 	return result;
 }
 static bool csvRgbTabDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -326,9 +380,8 @@ static bool csvRgbTabDeserialize(const char *value, ColorObject &colorObject, fl
 	return true;
 }
 static std::string csvRgbSemicolonSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[18];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f;%0.3f;%0.3f", c.red, c.green, c.blue);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 3, ";"sv);
 	return result;
 }
 static bool csvRgbSemicolonDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -346,9 +399,8 @@ static bool csvRgbSemicolonDeserialize(const char *value, ColorObject &colorObje
 	return true;
 }
 static std::string csvRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[24];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f,%0.3f,%0.3f,%0.3f", c.red, c.green, c.blue, c.alpha);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 4, ","sv);
 	return result;
 }
 static bool csvRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -366,9 +418,8 @@ static bool csvRgbaDeserialize(const char *value, ColorObject &colorObject, floa
 	return true;
 }
 static std::string csvRgbaTabSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[24];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f\t%0.3f\t%0.3f\t%0.3f", c.red, c.green, c.blue, c.alpha);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 4, "\t"sv);
 	return result;
 }
 static bool csvRgbaTabDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -386,9 +437,8 @@ static bool csvRgbaTabDeserialize(const char *value, ColorObject &colorObject, f
 	return true;
 }
 static std::string csvRgbaSemicolonSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[24];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f;%0.3f;%0.3f;%0.3f", c.red, c.green, c.blue, c.alpha);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 4, ";"sv);
 	return result;
 }
 static bool csvRgbaSemicolonDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -406,9 +456,8 @@ static bool csvRgbaSemicolonDeserialize(const char *value, ColorObject &colorObj
 	return true;
 }
 static std::string valueRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[20];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f, %0.3f, %0.3f", c.red, c.green, c.blue);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 3, ", "sv);
 	return result;
 }
 static bool valueRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -426,9 +475,8 @@ static bool valueRgbDeserialize(const char *value, ColorObject &colorObject, flo
 	return true;
 }
 static std::string valueRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
-	char result[27];
-	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f, %0.3f, %0.3f, %0.3f", c.red, c.green, c.blue, c.alpha);
+	std::string result;
+	appendFixed(result, colorObject.getColor(), 4, ", "sv);
 	return result;
 }
 static bool valueRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
@@ -510,15 +558,15 @@ static std::string cssBlockWithAlphaSerialize(const ColorObject &colorObject, co
 }
 }
 void addInternalConverters(Converters &converters, Converter::Options &options) {
-	converters.add("color_web_hex", _("Web: hex code"), Serialize(webHexSerialize, options), Deserialize(webHexDeserialize, options));
-	converters.add("color_web_hex_with_alpha", _("Web: hex code with alpha"), Serialize(webHexWithAlphaSerialize, options), Deserialize(webHexWithAlphaDeserialize, options));
-	converters.add("color_web_hex_no_hash", _("Web: hex code (no hash symbol)"), Serialize(webHexNoHashSerialize, options), Deserialize(webHexNoHashDeserialize, options));
-	converters.add("color_web_hex_short", _("Web: short hex code"), Serialize(webHexShortSerialize, options), Deserialize(webHexShortDeserialize, options));
-	converters.add("color_web_hex_short_with_alpha", _("Web: short hex code with alpha"), Serialize(webHexShortWithAlphaSerialize, options), Deserialize(webHexShortWithAlphaDeserialize, options));
-	converters.add("color_css_rgb", _("CSS: red green blue"), Serialize(cssRgbSerialize, options), Deserialize(cssRgbDeserialize, options));
-	converters.add("color_css_rgba", _("CSS: red green blue alpha"), Serialize(cssRgbaSerialize, options), Deserialize(cssRgbaDeserialize, options));
-	converters.add("color_css_hsl", _("CSS: hue saturation lightness"), Serialize(cssHslSerialize, options), Deserialize(cssHslDeserialize, options));
-	converters.add("color_css_hsla", _("CSS: hue saturation lightness alpha"), Serialize(cssHslaSerialize, options), Deserialize(cssHslaDeserialize, options));
+	converters.add("color_web_hex", _("Web: hex code"), Serialize(webHexSerialize, options), Deserialize(webHexDeserialize, options), ConverterInput::hash | ConverterInput::hex6);
+	converters.add("color_web_hex_with_alpha", _("Web: hex code with alpha"), Serialize(webHexWithAlphaSerialize, options), Deserialize(webHexWithAlphaDeserialize, options), ConverterInput::hash | ConverterInput::hex8);
+	converters.add("color_web_hex_no_hash", _("Web: hex code (no hash symbol)"), Serialize(webHexNoHashSerialize, options), Deserialize(webHexNoHashDeserialize, options), ConverterInput::hex6);
+	converters.add("color_web_hex_short", _("Web: short hex code"), Serialize(webHexShortSerialize, options), Deserialize(webHexShortDeserialize, options), ConverterInput::hash | ConverterInput::hex3);
+	converters.add("color_web_hex_short_with_alpha", _("Web: short hex code with alpha"), Serialize(webHexShortWithAlphaSerialize, options), Deserialize(webHexShortWithAlphaDeserialize, options), ConverterInput::hash | ConverterInput::hex4);
+	converters.add("color_css_rgb", _("CSS: red green blue"), Serialize(cssRgbSerialize, options), Deserialize(cssRgbDeserialize, options), ConverterInput::rgbFunction | ConverterInput::digit);
+	converters.add("color_css_rgba", _("CSS: red green blue alpha"), Serialize(cssRgbaSerialize, options), Deserialize(cssRgbaDeserialize, options), ConverterInput::rgbaFunction | ConverterInput::digit);
+	converters.add("color_css_hsl", _("CSS: hue saturation lightness"), Serialize(cssHslSerialize, options), Deserialize(cssHslDeserialize, options), ConverterInput::hslFunction | ConverterInput::digit);
+	converters.add("color_css_hsla", _("CSS: hue saturation lightness alpha"), Serialize(cssHslaSerialize, options), Deserialize(cssHslaDeserialize, options), ConverterInput::hslaFunction | ConverterInput::digit);
 	converters.add("css_color_hex", "CSS(color)", Serialize(cssColorHexSerialize, options), Deserialize());
 	converters.add("css_background_color_hex", "CSS(background-color)", Serialize(cssBackgroundColorHexSerialize, options), Deserialize());
 	converters.add("css_border_color_hex", "CSS(border-color)", Serialize(cssBorderColorHexSerialize, options), Deserialize());
@@ -528,12 +576,12 @@ void addInternalConverters(Converters &converters, Converter::Options &options)
 	converters.add("css_border_left_hex", "CSS(border-left-color)", Serialize(cssBorderLeftColorHexSerialize, options), Deserialize());
 	converters.add("color_css_block", _("CSS block"), Serialize(cssBlockSerialize, options), Deserialize());
 	converters.add("color_css_block_with_alpha", _("CSS block with alpha"), Serialize(cssBlockWithAlphaSerialize, options), Deserialize());
-	converters.add("csv_rgb", "CSV RGB", Serialize(csvRgbSerialize, options), Deserialize(csvRgbDeserialize, options));
-	converters.add("csv_rgb_tab", "CSV RGB "s + _("(tab separator)"), Serialize(csvRgbTabSerialize, options), Deserialize(csvRgbTabDeserialize, options));
-	converters.add("csv_rgb_semicolon", "CSV RGB "s + _("(semicolon separator)"), Serialize(csvRgbSemicolonSerialize, options), Deserialize(csvRgbSemicolonDeserialize, options));
-	converters.add("csv_rgba", "CSV RGBA", Serialize(csvRgbaSerialize, options), Deserialize(csvRgbaDeserialize, options));
-	converters.add("csv_rgba_tab", "CSV RGBA "s + _("(tab separator)"), Serialize(csvRgbaTabSerialize, options), Deserialize(csvRgbaTabDeserialize, options));
-	converters.add("csv_rgba_semicolon", "CSV RGBA "s + _("(semicolon separator)"), Serialize(csvRgbaSemicolonSerialize, options), Deserialize(csvRgbaSemicolonDeserialize, options));
-	converters.add("value_rgb", _("RGB values"), Serialize(valueRgbSerialize, options), Deserialize(valueRgbDeserialize, options));
-	converters.add("value_rgba", _("RGBA values"), Serialize(valueRgbaSerialize, options), Deserialize(valueRgbaDeserialize, options));
+	converters.add("csv_rgb", "CSV RGB", Serialize(csvRgbSerialize, options), Deserialize(csvRgbDeserialize, options), ConverterInput::digit | ConverterInput::comma);
+	converters.add("csv_rgb_tab", "CSV RGB "s + _("(tab separator)"), Serialize(csvRgbTabSerialize, options), Deserialize(csvRgbTabDeserialize, options), ConverterInput::digit | ConverterInput::tab);
+	converters.add("csv_rgb_semicolon", "CSV RGB "s + _("(semicolon separator)"), Serialize(csvRgbSemicolonSerialize, options), Deserialize(csvRgbSemicolonDeserialize, options), ConverterInput::digit | ConverterInput::semicolon);
+	converters.add("csv_rgba", "CSV RGBA", Serialize(csvRgbaSerialize, options), Deserialize(csvRgbaDeserialize, options), ConverterInput::digit | ConverterInput::comma);
+	converters.add("csv_rgba_tab", "CSV RGBA "s + _("(tab separator)"), Serialize(csvRgbaTabSerialize, options), Deserialize(csvRgbaTabDeserialize, options), ConverterInput::digit | ConverterInput::tab);
+	converters.add("csv_rgba_semicolon", "CSV RGBA "s + _("(semicolon separator)"), Serialize(csvRgbaSemicolonSerialize, options), Deserialize(csvRgbaSemicolonDeserialize, options), ConverterInput::digit | ConverterInput::semicolon);
+	converters.add("value_rgb", _("RGB values"), Serialize(valueRgbSerialize, options), Deserialize(valueRgbDeserialize, options), ConverterInput::digit | ConverterInput::separator);
+	converters.add("value_rgba", _("RGBA values"), Serialize(valueRgbaSerialize, options), Deserialize(valueRgbaDeserialize, options), ConverterInput::digit | ConverterInput::separator);
 }
@@ -0,0 +1,645 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PaletteJournal.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "FileFormat.h"
+#include <boost/endian/conversion.hpp>
+#include <boost/interprocess/sync/named_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+namespace {
+const char journalMagic[8] = { 'G', 'P', 'J', 'O', 'U', 'R', 'N', '2' };
+// Journal header is magic, snapshot hash and writer identifier.
+const size_t journalHeaderSize = sizeof(journalMagic) + 2 * sizeof(uint64_t);
+const size_t recordHeaderSize = 2 * sizeof(uint32_t);
+enum class RecordType : uint8_t {
+	add = 1,
+	remove = 2,
+	modify = 3,
+	reorder = 4,
+};
+using Entry = PaletteJournal::Entry;
+using State = PaletteJournal::State;
+uint64_t hash(const char *data, size_t size) {
+	uint64_t result = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; i++)
+		result = (result ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ull;
+	return result;
+}
+uint32_t checksum(const uint8_t *data, size_t size) {
+	uint32_t result = 0x811c9dc5u;
+	for (size_t i = 0; i < size; i++)
+		result = (result ^ data[i]) * 0x01000193u;
+	return result;
+}
+bool sameContent(const Entry &a, const Entry &b) {
+	return a.name == b.name && std::memcmp(a.color.data, b.color.data, sizeof(a.color.data)) == 0;
+}
+bool same(const Entry &a, const Entry &b) {
+	return a.colorObject == b.colorObject && sameContent(a, b);
+}
+bool same(const Entry &entry, const ColorObject *colorObject) {
+	return entry.colorObject == colorObject && entry.name == colorObject->getInternedName() && std::memcmp(entry.color.data, colorObject->getColor().data, sizeof(entry.color.data)) == 0;
+}
+State capture(const ColorList &colorList, size_t begin, size_t end) {
+	State state;
+	state.reserve(end - begin);
+	auto colorObjects = colorList.begin();
+	for (size_t i = begin; i < end; i++)
+		state.push_back(Entry { colorObjects[i], colorObjects[i]->getColor(), colorObjects[i]->getInternedName() });
+	return state;
+}
+struct RecordWriter {
+	RecordWriter(std::vector<uint8_t> &buffer):
+		m_buffer(buffer),
+		m_recordStart(0) {
+	}
+	void begin(RecordType type) {
+		m_recordStart = m_buffer.size();
+		m_buffer.resize(m_recordStart + recordHeaderSize);
+		write(static_cast<uint8_t>(type));
+	}
+	void end() {
+		const size_t payloadStart = m_recordStart + recordHeaderSize;
+		uint32_t header[2] = {
+			boost::endian::native_to_little<uint32_t>(static_cast<uint32_t>(m_buffer.size() - payloadStart)),
+			boost::endian::native_to_little<uint32_t>(checksum(m_buffer.data() + payloadStart, m_buffer.size() - payloadStart)),
+		};
+		std::memcpy(m_buffer.data() + m_recordStart, header, sizeof(header));
+	}
+	void write(uint8_t value) {
+		m_buffer.push_back(value);
+	}
+	void write(uint32_t value) {
+		value = boost::endian::native_to_little<uint32_t>(value);
+		auto bytes = reinterpret_cast<const uint8_t *>(&value);
+		m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(value));
+	}
+	void write(size_t value) {
+		write(static_cast<uint32_t>(value));
+	}
+	void write(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		write(bits);
+	}
+	void write(const Entry &entry) {
+		for (auto value: entry.color.data)
+			write(value);
+		const auto &name = entry.name.str();
+		write(name.size());
+		m_buffer.insert(m_buffer.end(), name.begin(), name.end());
+	}
+	void add(size_t position, const Entry *entries, size_t count) {
+		begin(RecordType::add);
+		write(position);
+		write(count);
+		for (size_t i = 0; i < count; i++)
+			write(entries[i]);
+		end();
+	}
+	void remove(size_t position, size_t count) {
+		begin(RecordType::remove);
+		write(position);
+		write(count);
+		end();
+	}
+	void modify(size_t position, const Entry &entry) {
+		begin(RecordType::modify);
+		write(position);
+		write(entry);
+		end();
+	}
+private:
+	std::vector<uint8_t> &m_buffer;
+	size_t m_recordStart;
+};
+struct RecordReader {
+	RecordReader(const uint8_t *data, size_t size):
+		m_position(data),
+		m_end(data + size) {
+	}
+	size_t remaining() const {
+		return static_cast<size_t>(m_end - m_position);
+	}
+	bool read(uint8_t &value) {
+		if (remaining() < 1)
+			return false;
+		value = *m_position++;
+		return true;
+	}
+	bool read(uint32_t &value) {
+		if (remaining() < sizeof(value))
+			return false;
+		std::memcpy(&value, m_position, sizeof(value));
+		m_position += sizeof(value);
+		value = boost::endian::little_to_native<uint32_t>(value);
+		return true;
+	}
+	bool read(float &value) {
+		uint32_t bits;
+		if (!read(bits))
+			return false;
+		std::memcpy(&value, &bits, sizeof(value));
+		return true;
+	}
+	bool read(Entry &entry) {
+		for (auto &value: entry.color.data) {
+			if (!read(value))
+				return false;
+		}
+		uint32_t length;
+		if (!read(length) || length > remaining())
+			return false;
+		entry.colorObject = nullptr;
+		entry.name = common::InternedString(std::string_view(reinterpret_cast<const char *>(m_position), length));
+		m_position += length;
+		return true;
+	}
+	void skip(size_t size) {
+		m_position += std::min(size, remaining());
+	}
+	const uint8_t *position() const {
+		return m_position;
+	}
+private:
+	const uint8_t *m_position, *m_end;
+};
+// Changes limited to removed or inserted objects, with all other entries unchanged, are journaled as separate removed or inserted runs.
+bool encodeRuns(const Entry *oldEntries, size_t oldCount, const Entry *newEntries, size_t newCount, size_t offset, RecordWriter &writer) {
+	const bool removal = oldCount > newCount;
+	const Entry *longer = removal ? oldEntries : newEntries, *shorter = removal ? newEntries : oldEntries;
+	const size_t longerCount = std::max(oldCount, newCount), shorterCount = std::min(oldCount, newCount);
+	size_t i = 0, j = 0;
+	while (i < longerCount) {
+		if (j < shorterCount && same(longer[i], shorter[j])) {
+			i++;
+			j++;
+			continue;
+		}
+		size_t runStart = i;
+		while (i < longerCount && (j >= shorterCount || !same(longer[i], shorter[j])))
+			i++;
+		// Run position is the same in both lists, as all earlier runs are already applied.
+		if (removal)
+			writer.remove(offset + j, i - runStart);
+		else
+			writer.add(offset + runStart, longer + runStart, i - runStart);
+	}
+	return j == shorterCount;
+}
+// Changes within a range of the same objects are journaled as a reorder record followed by modify records.
+bool encodeReorder(const Entry *oldEntries, const Entry *newEntries, size_t count, size_t offset, RecordWriter &writer) {
+	std::unordered_map<const ColorObject *, uint32_t> positions;
+	positions.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		if (!positions.emplace(oldEntries[i].colorObject, static_cast<uint32_t>(i)).second)
+			return false;
+	}
+	std::vector<uint32_t> sources(count);
+	bool reordered = false;
+	for (size_t i = 0; i < count; i++) {
+		auto found = positions.find(newEntries[i].colorObject);
+		if (found == positions.end() || found->second == UINT32_MAX)
+			return false;
+		sources[i] = found->second;
+		found->second = UINT32_MAX;
+		if (sources[i] != i)
+			reordered = true;
+	}
+	if (reordered) {
+		writer.begin(RecordType::reorder);
+		writer.write(offset);
+		writer.write(count);
+		for (auto source: sources)
+			writer.write(source);
+		writer.end();
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!sameContent(oldEntries[sources[i]], newEntries[i]))
+			writer.modify(offset + i, newEntries[i]);
+	}
+	return true;
+}
+// Changed range is journaled as a sequence of records which turns old entries into new entries.
+void encodeChanges(const Entry *oldEntries, size_t oldCount, const Entry *newEntries, size_t newCount, size_t offset, std::vector<uint8_t> &buffer) {
+	const size_t bufferSize = buffer.size();
+	RecordWriter writer(buffer);
+	if (oldCount == newCount) {
+		if (oldCount == 0 || encodeReorder(oldEntries, newEntries, oldCount, offset, writer))
+			return;
+	} else if (oldCount == 0) {
+		writer.add(offset, newEntries, newCount);
+		return;
+	} else if (newCount == 0) {
+		writer.remove(offset, oldCount);
+		return;
+	} else if (encodeRuns(oldEntries, oldCount, newEntries, newCount, offset, writer)) {
+		return;
+	}
+	buffer.resize(bufferSize);
+	writer.remove(offset, oldCount);
+	writer.add(offset, newEntries, newCount);
+}
+// Applies records to state. Returns false when a record is incomplete or invalid, all earlier records stay applied.
+bool applyRecords(const uint8_t *data, size_t size, State &state) {
+	RecordReader reader(data, size);
+	while (reader.remaining() > 0) {
+		uint32_t payloadSize, payloadChecksum;
+		if (!reader.read(payloadSize) || !reader.read(payloadChecksum) || payloadSize > reader.remaining())
+			return false;
+		if (checksum(reader.position(), payloadSize) != payloadChecksum)
+			return false;
+		RecordReader record(reader.position(), payloadSize);
+		reader.skip(payloadSize);
+		uint8_t type;
+		uint32_t position, count;
+		if (!record.read(type) || !record.read(position) || position > state.size())
+			return false;
+		switch (static_cast<RecordType>(type)) {
+		case RecordType::add: {
+			if (!record.read(count))
+				return false;
+			State entries(count);
+			for (auto &entry: entries) {
+				if (!record.read(entry))
+					return false;
+			}
+			state.insert(state.begin() + position, entries.begin(), entries.end());
+		} break;
+		case RecordType::remove:
+			if (!record.read(count) || count > state.size() - position)
+				return false;
+			state.erase(state.begin() + position, state.begin() + position + count);
+			break;
+		case RecordType::modify:
+			if (position >= state.size() || !record.read(state[position]))
+				return false;
+			break;
+		case RecordType::reorder: {
+			if (!record.read(count) || count > state.size() - position)
+				return false;
+			State entries(count);
+			for (auto &entry: entries) {
+				uint32_t source;
+				if (!record.read(source) || source >= count)
+					return false;
+				entry = state[position + source];
+			}
+			std::move(entries.begin(), entries.end(), state.begin() + position);
+		} break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+std::string journalHeader(uint64_t snapshotHash, uint64_t writerId) {
+	uint64_t values[2] = { boost::endian::native_to_little<uint64_t>(snapshotHash), boost::endian::native_to_little<uint64_t>(writerId) };
+	std::string header(journalMagic, sizeof(journalMagic));
+	header.append(reinterpret_cast<const char *>(values), sizeof(values));
+	return header;
+}
+uint64_t newWriterId() {
+	std::random_device device;
+	uint64_t time = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+	return ((static_cast<uint64_t>(device()) << 32) | device()) ^ time;
+}
+std::optional<std::string> readFile(const std::string &path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return std::nullopt;
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+}
+PaletteJournal::PaletteJournal(const std::string &snapshotPath, const std::string &journalPath, const std::string &lockName):
+	m_snapshotPath(snapshotPath),
+	m_journalPath(journalPath),
+	m_lockName(lockName),
+	m_valid(false),
+	m_journalSize(0),
+	m_busy(false),
+	m_stop(false),
+	m_snapshotFailed(false),
+	m_writerId(newWriterId()),
+	m_snapshotHash(0),
+	m_journalOffset(0),
+	m_committed(false) {
+}
+PaletteJournal::~PaletteJournal() {
+	if (!m_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_one();
+	m_thread.join();
+}
+common::ResultVoid<ErrorCode> PaletteJournal::restore(ColorList &colorList) {
+	using Result = common::ResultVoid<ErrorCode>;
+	flush();
+	m_valid = false;
+	m_journalSize = 0;
+	m_committed = false;
+	std::optional<std::string> snapshot, journal;
+	ColorList snapshotColors;
+	std::optional<ErrorCode> loadError;
+	// Files are read under the lock, so that snapshot and journal are not replaced by another process in between.
+	if (!withLock([&]() {
+		snapshot = readFile(m_snapshotPath);
+		if (snapshot) {
+			auto result = paletteFileLoad(m_snapshotPath.c_str(), snapshotColors);
+			if (!result)
+				loadError = result.error();
+		}
+		journal = readFile(m_journalPath);
+		return true;
+	}))
+		return Result(ErrorCode::readFailed);
+	if (loadError)
+		return Result(*loadError);
+	State state = capture(snapshotColors, 0, snapshotColors.size());
+	uint64_t snapshotHash = snapshot ? hash(snapshot->data(), snapshot->size()) : 0;
+	if (journal && journal->size() >= journalHeaderSize && std::memcmp(journal->data(), journalMagic, sizeof(journalMagic)) == 0) {
+		uint64_t values[2];
+		std::memcpy(values, journal->data() + sizeof(journalMagic), sizeof(values));
+		if (boost::endian::little_to_native<uint64_t>(values[0]) == snapshotHash) {
+			auto records = reinterpret_cast<const uint8_t *>(journal->data()) + journalHeaderSize;
+			m_valid = applyRecords(records, journal->size() - journalHeaderSize, state);
+			m_journalSize = journal->size() - journalHeaderSize;
+			// Journal header names its previous writer, so the first write after restore replaces it with a snapshot owned by this journal.
+			if (m_valid) {
+				m_snapshotHash = snapshotHash;
+				m_journalOffset = journal->size();
+				m_committed = true;
+			}
+		}
+	}
+	for (auto &entry: state) {
+		auto colorObject = new ColorObject(entry.name.str(), entry.color);
+		colorList.add(colorObject);
+		entry.colorObject = colorObject;
+		colorObject->release();
+	}
+	m_state = std::move(state);
+	if (m_committed)
+		m_written = m_state;
+	return Result();
+}
+void PaletteJournal::reset(const ColorList &colorList) {
+	State state = capture(colorList, 0, colorList.size());
+	if (snapshotFailed())
+		m_valid = false;
+	bool sameColors = m_valid && state.size() == m_state.size() && std::equal(state.begin(), state.end(), m_state.begin(), sameContent);
+	m_state = std::move(state);
+	if (!sameColors)
+		requestSnapshot();
+}
+bool PaletteJournal::update(const ColorList &colorList) {
+	// Snapshot which was not written is requested again, even if colors have not changed since.
+	bool retrySnapshot = snapshotFailed();
+	if (retrySnapshot)
+		m_valid = false;
+	// Only the range between unchanged first and last entries is captured and journaled.
+	const size_t oldSize = m_state.size(), newSize = colorList.size(), commonCount = std::min(oldSize, newSize);
+	auto colorObjects = colorList.begin();
+	size_t prefix = 0;
+	while (prefix < commonCount && same(m_state[prefix], colorObjects[prefix]))
+		prefix++;
+	if (prefix == oldSize && oldSize == newSize) {
+		if (retrySnapshot)
+			requestSnapshot();
+		return false;
+	}
+	size_t suffix = 0;
+	while (suffix < commonCount - prefix && same(m_state[oldSize - 1 - suffix], colorObjects[newSize - 1 - suffix]))
+		suffix++;
+	const size_t oldCount = oldSize - prefix - suffix;
+	State changed = capture(colorList, prefix, newSize - suffix);
+	std::vector<uint8_t> records;
+	if (m_valid)
+		encodeChanges(m_state.data() + prefix, oldCount, changed.data(), changed.size(), prefix, records);
+	if (oldCount == changed.size()) {
+		std::move(changed.begin(), changed.end(), m_state.begin() + prefix);
+	} else {
+		m_state.erase(m_state.begin() + prefix, m_state.begin() + prefix + oldCount);
+		m_state.insert(m_state.begin() + prefix, std::make_move_iterator(changed.begin()), std::make_move_iterator(changed.end()));
+	}
+	m_journalSize += records.size();
+	// Snapshot size is estimated, as it is only known after snapshot is written.
+	if (!m_valid || m_journalSize > std::max(minCompactionSize, m_state.size() * 64)) {
+		requestSnapshot();
+	} else {
+		queue(std::move(records));
+	}
+	return true;
+}
+void PaletteJournal::flush() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_idleCondition.wait(lock, [this]() {
+		return !m_busy && m_pending.empty() && !m_snapshot;
+	});
+}
+size_t PaletteJournal::journalSize() const {
+	return m_journalSize;
+}
+void PaletteJournal::start() {
+	if (!m_thread.joinable())
+		m_thread = std::thread(&PaletteJournal::run, this);
+}
+void PaletteJournal::queue(std::vector<uint8_t> &&records) {
+	if (records.empty())
+		return;
+	start();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.insert(m_pending.end(), records.begin(), records.end());
+	}
+	m_condition.notify_one();
+}
+void PaletteJournal::requestSnapshot() {
+	start();
+	auto snapshot = std::make_shared<const State>(m_state);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		// Snapshot includes all earlier changes, so records which are not written yet are not needed.
+		m_pending.clear();
+		m_snapshot = std::move(snapshot);
+		m_snapshotFailed = false;
+	}
+	// Following records are encoded against the requested snapshot. If snapshot is not written, worker drops them and reports failure,
+	// so the next update requests a new snapshot instead of journaling more changes.
+	m_valid = true;
+	m_journalSize = 0;
+	m_condition.notify_one();
+}
+bool PaletteJournal::snapshotFailed() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	bool failed = m_snapshotFailed;
+	m_snapshotFailed = false;
+	return failed;
+}
+void PaletteJournal::setSnapshotFailed() {
+	m_committed = false;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_snapshotFailed = true;
+}
+void PaletteJournal::run() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;) {
+		m_condition.wait(lock, [this]() {
+			return m_stop || !m_pending.empty() || m_snapshot;
+		});
+		if (!m_pending.empty() || m_snapshot) {
+			auto snapshot = std::move(m_snapshot);
+			std::vector<uint8_t> records;
+			records.swap(m_pending);
+			m_busy = true;
+			lock.unlock();
+			if (snapshot)
+				writeSnapshot(*snapshot);
+			writeRecords(records);
+			lock.lock();
+			m_busy = false;
+			m_idleCondition.notify_all();
+			continue;
+		}
+		if (m_stop)
+			break;
+	}
+}
+template<typename Callback>
+bool PaletteJournal::withLock(Callback &&callback) {
+	using namespace boost::interprocess;
+	if (m_lockName.empty())
+		return callback();
+	try {
+		if (!m_lock)
+			m_lock = std::make_unique<named_mutex>(open_or_create, m_lockName.c_str());
+		scoped_lock<named_mutex> lock(*m_lock);
+		return callback();
+	} catch (const interprocess_exception &e) {
+		std::cerr << "failed to acquire interprocess lock: " << e.what() << std::endl;
+		return false;
+	}
+}
+bool PaletteJournal::journalUnchanged() const {
+	std::ifstream file(m_journalPath, std::ios::binary | std::ios::ate);
+	if (!file.is_open() || static_cast<size_t>(file.tellg()) != m_journalOffset)
+		return false;
+	auto expected = journalHeader(m_snapshotHash, m_writerId);
+	std::string header(expected.size(), '\0');
+	file.seekg(0);
+	file.read(&header.front(), header.size());
+	return file.good() && header == expected;
+}
+void PaletteJournal::writeRecords(const std::vector<uint8_t> &records) {
+	// Records follow a snapshot which was not written, new snapshot is requested by the next update.
+	if (records.empty() || !m_committed)
+		return;
+	if (!applyRecords(records.data(), records.size(), m_written)) {
+		setSnapshotFailed();
+		return;
+	}
+	bool written = withLock([this, &records]() {
+		// Another process has replaced or appended to the journal, so records are not valid for it anymore.
+		if (!journalUnchanged())
+			return writeSnapshotFiles(m_written);
+		std::ofstream file(m_journalPath, std::ios::binary | std::ios::app);
+		file.write(reinterpret_cast<const char *>(records.data()), records.size());
+		file.close();
+		if (!file.good()) {
+			std::cerr << "failed to write palette journal \"" << m_journalPath << "\"" << std::endl;
+			return false;
+		}
+		m_journalOffset += records.size();
+		return true;
+	});
+	if (!written)
+		setSnapshotFailed();
+}
+void PaletteJournal::writeSnapshot(const State &state) {
+	m_committed = false;
+	if (!withLock([this, &state]() {
+		return writeSnapshotFiles(state);
+	}))
+		setSnapshotFailed();
+}
+bool PaletteJournal::writeSnapshotFiles(const State &state) {
+	using namespace std::filesystem;
+	m_committed = false;
+	ColorList colorList;
+	for (const auto &entry: state)
+		colorList.add(ColorObject(entry.name.str(), entry.color));
+	std::ostringstream stream;
+	auto result = paletteStreamSave(stream, colorList);
+	if (!result) {
+		std::cerr << "failed to save palette snapshot: " << result.error() << std::endl;
+		return false;
+	}
+	auto snapshot = stream.str();
+	uint64_t snapshotHash = hash(snapshot.data(), snapshot.size());
+	auto header = journalHeader(snapshotHash, m_writerId);
+	auto snapshotTmp = m_snapshotPath + ".tmp", journalTmp = m_journalPath + ".tmp";
+	std::ofstream file(snapshotTmp, std::ios::binary);
+	file.write(snapshot.data(), snapshot.size());
+	file.close();
+	if (!file.good()) {
+		std::cerr << "failed to save palette to \"" << snapshotTmp << "\"" << std::endl;
+		return false;
+	}
+	std::ofstream journal(journalTmp, std::ios::binary);
+	journal.write(header.data(), header.size());
+	journal.close();
+	if (!journal.good()) {
+		std::cerr << "failed to save palette journal to \"" << journalTmp << "\"" << std::endl;
+		return false;
+	}
+	std::error_code ec;
+	// Snapshot is replaced first, old journal is ignored if journal replacement does not happen.
+	rename(path(snapshotTmp), path(m_snapshotPath), ec);
+	if (ec) {
+		std::cerr << "failed to move palette file \"" << snapshotTmp << "\" to \"" << m_snapshotPath << "\": " << ec << std::endl;
+		return false;
+	}
+	rename(path(journalTmp), path(m_journalPath), ec);
+	if (ec) {
+		std::cerr << "failed to move palette journal \"" << journalTmp << "\" to \"" << m_journalPath << "\": " << ec << std::endl;
+		return false;
+	}
+	if (&state != &m_written)
+		m_written = state;
+	m_snapshotHash = snapshotHash;
+	m_journalOffset = header.size();
+	m_committed = true;
+	return true;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "ErrorCode.h"
+#include "common/InternedString.h"
+#include "common/Result.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+struct ColorList;
+struct ColorObject;
+namespace boost {
+namespace interprocess {
+class named_mutex;
+}
+}
+/** \struct PaletteJournal
+ * \brief Palette snapshot file with a journal of changes made after the snapshot was written.
+ *
+ * Each update compares color list with its previous state and appends add, remove, modify and reorder records to the journal.
+ * Records are written and journal is compacted into a new snapshot on a worker thread, so updates only compare and encode changes.
+ * Journal starts with a hash of the snapshot it applies to, so journal left over after an interrupted compaction is ignored.
+ * Journal header also identifies its writer. Records are appended only while journal file is exactly as this journal left it,
+ * otherwise another process has written its own snapshot or records, and a new snapshot of the current state is written instead.
+ */
+struct PaletteJournal {
+	/**
+	 * Create journal. Files are not accessed until the first restore, reset or update.
+	 * @param[in] snapshotPath Snapshot file path. Snapshot is stored in GPA format.
+	 * @param[in] journalPath Journal file path.
+	 * @param[in] lockName Name of interprocess mutex locked while files are read or written. Empty name disables locking.
+	 */
+	PaletteJournal(const std::string &snapshotPath, const std::string &journalPath, const std::string &lockName = std::string());
+	PaletteJournal(const PaletteJournal &) = delete;
+	PaletteJournal &operator=(const PaletteJournal &) = delete;
+	/** Write all pending records and stop worker thread. */
+	~PaletteJournal();
+	/**
+	 * Load snapshot and apply journal records. Incomplete last record, left by interrupted write, is ignored.
+	 * Restored colors become the current state, so adding them to an empty color list does not produce new records.
+	 * @param[out] colorList Destination color list.
+	 * @return Success if snapshot was loaded or does not exist.
+	 */
+	common::ResultVoid<ErrorCode> restore(ColorList &colorList);
+	/**
+	 * Use color list as the current state without journaling differences. Snapshot is rewritten, unless journal already describes the same colors.
+	 * @param[in] colorList Color list.
+	 */
+	void reset(const ColorList &colorList);
+	/**
+	 * Journal differences between color list and the previous state.
+	 * @param[in] colorList Color list.
+	 * @return True if color list has changed.
+	 */
+	bool update(const ColorList &colorList);
+	/** Wait until all records and requested snapshot are written. */
+	void flush();
+	/**
+	 * Get number of record bytes journaled since the last snapshot.
+	 * @return Size in bytes.
+	 */
+	size_t journalSize() const;
+	/**
+	 * Journal is compacted into a new snapshot when record bytes exceed both this value and the estimated snapshot size.
+	 */
+	static constexpr size_t minCompactionSize = 1024 * 1024;
+	struct Entry {
+		const ColorObject *colorObject;
+		Color color;
+		common::InternedString name;
+	};
+	using State = std::vector<Entry>;
+private:
+	std::string m_snapshotPath, m_journalPath, m_lockName;
+	State m_state;
+	bool m_valid;
+	size_t m_journalSize;
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition, m_idleCondition;
+	std::vector<uint8_t> m_pending;
+	std::shared_ptr<const State> m_snapshot;
+	bool m_busy, m_stop, m_snapshotFailed;
+	// Worker thread state: colors stored in files and journal file contents as they were last written by this journal.
+	State m_written;
+	uint64_t m_writerId, m_snapshotHash;
+	size_t m_journalOffset;
+	bool m_committed;
+	std::unique_ptr<boost::interprocess::named_mutex> m_lock;
+	void start();
+	void run();
+	void queue(std::vector<uint8_t> &&records);
+	void requestSnapshot();
+	bool snapshotFailed();
+	void setSnapshotFailed();
+	template<typename Callback>
+	bool withLock(Callback &&callback);
+	bool journalUnchanged() const;
+	void writeRecords(const std::vector<uint8_t> &records);
+	void writeSnapshot(const State &state);
+	bool writeSnapshotFiles(const State &state);
+};
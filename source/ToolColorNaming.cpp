@@ -48,7 +48,8 @@ ToolColorNamingType tool_color_naming_name_to_type(const std::string &name)
 	return TOOL_COLOR_NAMING_UNKNOWN;
 }
 ToolColorNameAssigner::ToolColorNameAssigner(GlobalState &gs):
-	m_gs(gs)
+	m_gs(gs),
+	m_prepared_index(0)
 {
 	m_color_naming_type = tool_color_naming_name_to_type(m_gs.settings().getString("gpick.color_names.tool_color_naming", "automatic_name"));
 	if (m_color_naming_type == TOOL_COLOR_NAMING_AUTOMATIC_NAME){
@@ -60,6 +61,14 @@ ToolColorNameAssigner::ToolColorNameAssigner(GlobalState &gs):
 ToolColorNameAssigner::~ToolColorNameAssigner()
 {
 }
+void ToolColorNameAssigner::prepare(common::Span<const Color> colors)
+{
+	m_prepared_colors.assign(colors.data(), colors.data() + colors.size());
+	m_prepared_names.clear();
+	m_prepared_index = 0;
+	if (m_color_naming_type == TOOL_COLOR_NAMING_AUTOMATIC_NAME)
+		color_names_get(m_gs.getColorNames(), colors, m_imprecision_postfix, m_prepared_names);
+}
 void ToolColorNameAssigner::assign(ColorObject &colorObject) {
 	string name;
 	switch (m_color_naming_type){
@@ -68,7 +77,10 @@ void ToolColorNameAssigner::assign(ColorObject &colorObject) {
 			colorObject.setName("");
 			break;
 		case TOOL_COLOR_NAMING_AUTOMATIC_NAME:
-			name = color_names_get(m_gs.getColorNames(), &colorObject.getColor(), m_imprecision_postfix);
+			if (m_prepared_index < m_prepared_names.size() && m_prepared_colors[m_prepared_index] == colorObject.getColor())
+				name = m_prepared_names[m_prepared_index++];
+			else
+				name = color_names_get(m_gs.getColorNames(), &colorObject.getColor(), m_imprecision_postfix);
 			colorObject.setName(name);
 			break;
 		case TOOL_COLOR_NAMING_TOOL_SPECIFIC:
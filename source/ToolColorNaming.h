@@ -19,9 +19,11 @@
 #ifndef GPICK_TOOL_COLOR_NAMING_H_
 #define GPICK_TOOL_COLOR_NAMING_H_
 
+#include "Color.h"
+#include "common/Span.h"
 #include <string>
+#include <vector>
 struct GlobalState;
-struct Color;
 struct ColorObject;
 enum ToolColorNamingType {
 	TOOL_COLOR_NAMING_UNKNOWN = 0,
@@ -44,9 +46,17 @@ struct ToolColorNameAssigner
 		ToolColorNamingType m_color_naming_type;
 		GlobalState &m_gs;
 		bool m_imprecision_postfix;
+		std::vector<Color> m_prepared_colors;
+		std::vector<std::string> m_prepared_names;
+		size_t m_prepared_index;
 	public:
 		ToolColorNameAssigner(GlobalState &gs);
 		virtual ~ToolColorNameAssigner();
+		/**
+		 * Look up automatic names for multiple colors in one batch. Following assign calls use prepared names while colors are assigned in the same order.
+		 * @param[in] colors Colors which will be assigned next.
+		 */
+		void prepare(common::Span<const Color> colors);
 		void assign(ColorObject &colorObject);
 		virtual std::string getToolSpecificName(const ColorObject &colorObject) = 0;
 };
@@ -20,6 +20,7 @@
 #define GPICK_COLOR_NAMES_COLOR_NAMES_H_
 #include "Color.h"
 #include "dynv/MapFwd.h"
+#include "common/Span.h"
 #include <string>
 #include <vector>
 struct ColorNames;
@@ -29,7 +30,20 @@ void color_names_clear(ColorNames *color_names);
 void color_names_load(ColorNames *color_names, const dynv::Map &params);
 void color_names_load_from_list(ColorNames *color_names, const ColorList &colorList);
 int color_names_load_from_file(ColorNames *color_names, const std::string &filename);
+/**
+ * Convert color dictionary into precompiled binary format, which is memory mapped when loaded.
+ * @param[in] source Text or binary dictionary file name.
+ * @param[in] destination Binary dictionary file name.
+ * @return Zero on success.
+ */
+int color_names_compile(const std::string &source, const std::string &destination);
 void color_names_destroy(ColorNames *color_names);
 std::string color_names_get(ColorNames *color_names, const Color *color, bool imprecision_postfix);
+/**
+ * Get names for multiple colors at once. Colors are converted and looked up on multiple threads, results are the same as calling color_names_get for each color.
+ * @param[in] colors Colors in RGB color space.
+ * @param[out] names Color names in the same order as colors.
+ */
+void color_names_get(ColorNames *color_names, common::Span<const Color> colors, bool imprecision_postfix, std::vector<std::string> &names);
 void color_names_find_nearest(ColorNames *color_names, const Color &color, size_t count, std::vector<std::pair<const char*, Color>> &colors);
 #endif /* GPICK_COLOR_NAMES_COLOR_NAMES_H_ */
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Dictionary.h"
+#include "common/Parallel.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <limits>
+namespace color_names {
+namespace {
+const char magic[8] = { 'G', 'P', 'I', 'C', 'K', 'C', 'N', 'D' };
+const uint32_t formatVersion = 1;
+const uint32_t byteOrderMark = 0x01020304;
+const uint64_t sectionAlignment = 16;
+enum Section : uint8_t {
+	lightness = 0,
+	a,
+	b,
+	chroma,
+	treeIndexes,
+	nodes,
+	red,
+	green,
+	blue,
+	nameOffsets,
+	names,
+	sectionCount,
+};
+struct Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t colorCount;
+	uint32_t nodeCount;
+	uint64_t sections[sectionCount][2]; /**< Offset from the file start and size in bytes. */
+};
+static_assert(sizeof(KdTree::Node) == 48, "unexpected k-d tree node size");
+static_assert(std::numeric_limits<float>::is_iec559, "float must be IEEE 754 single precision");
+template<typename T>
+common::Span<const T> view(const std::vector<T> &values) {
+	return common::Span<const T>(values.data(), values.size());
+}
+void stripSpaces(std::string &value, const std::string &stripChars) {
+	size_t startIndex = value.find_first_not_of(stripChars);
+	size_t endIndex = value.find_last_not_of(stripChars);
+	if (startIndex == std::string::npos || endIndex == std::string::npos) {
+		value.clear();
+		return;
+	}
+	value = value.substr(startIndex, (endIndex - startIndex) + 1);
+}
+}
+void rgbToLabD50(common::Span<const Color> colors, common::Span<Color> labColors) {
+	common::parallelFor(colors.size(), 1024, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			labColors[i] = colors[i].rgbToLabD50();
+	});
+}
+struct Dictionary::Mapping {
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+};
+Dictionary::Dictionary():
+	m_indexed(true) {
+}
+Dictionary::~Dictionary() {
+}
+void Dictionary::clear() {
+	m_tree.clear();
+	m_mapping.reset();
+	m_names.clear();
+	m_nameOffsets.clear();
+	m_red.clear();
+	m_green.clear();
+	m_blue.clear();
+	m_indexed = true;
+	updateViews();
+}
+void Dictionary::updateViews() {
+	m_namesView = view(m_names);
+	m_nameOffsetsView = view(m_nameOffsets);
+	m_redView = view(m_red);
+	m_greenView = view(m_green);
+	m_blueView = view(m_blue);
+}
+size_t Dictionary::size() const {
+	return m_nameOffsetsView.size();
+}
+bool Dictionary::empty() const {
+	return m_nameOffsetsView.size() == 0;
+}
+bool Dictionary::mapped() const {
+	return static_cast<bool>(m_mapping);
+}
+const char *Dictionary::name(uint32_t index) const {
+	return m_namesView.data() + m_nameOffsetsView[index];
+}
+Color Dictionary::color(uint32_t index) const {
+	return Color(m_redView[index], m_greenView[index], m_blueView[index], 1.0f);
+}
+const KdTree &Dictionary::tree() const {
+	return m_tree;
+}
+void Dictionary::add(std::string_view name, const Color &color) {
+	if (m_mapping)
+		return;
+	m_nameOffsets.push_back(static_cast<uint32_t>(m_names.size()));
+	m_names.insert(m_names.end(), name.begin(), name.end());
+	m_names.push_back(0);
+	m_red.push_back(color.red);
+	m_green.push_back(color.green);
+	m_blue.push_back(color.blue);
+	m_indexed = false;
+	updateViews();
+}
+void Dictionary::build() {
+	if (m_indexed)
+		return;
+	std::vector<Color> labColors(m_red.size());
+	for (size_t i = 0; i < labColors.size(); i++)
+		labColors[i] = Color(m_red[i], m_green[i], m_blue[i]);
+	rgbToLabD50(common::Span<const Color>(labColors.data(), labColors.size()), common::Span<Color>(labColors.data(), labColors.size()));
+	m_tree.build(labColors);
+	m_indexed = true;
+}
+bool Dictionary::load(const std::string &filename) {
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+	char fileMagic[sizeof(magic)] = {};
+	file.read(fileMagic, sizeof(fileMagic));
+	file.close();
+	if (std::memcmp(fileMagic, magic, sizeof(magic)) == 0)
+		return loadBinary(filename);
+	return loadText(filename);
+}
+bool Dictionary::loadText(const std::string &filename) {
+	std::ifstream file(filename, std::ios::in);
+	if (!file.is_open())
+		return false;
+	clear();
+	std::string line, name;
+	std::stringstream lineStream(std::ios::in | std::ios::out);
+	const std::string stripChars = " \t,.\n\r";
+	Color color;
+	while (!file.eof()) {
+		std::getline(file, line);
+		if (line.empty() || line.at(0) == '!')
+			continue;
+		lineStream.clear();
+		lineStream.str(line);
+		if (!(lineStream >> color.red >> color.green >> color.blue))
+			continue;
+		std::getline(lineStream, name);
+		stripSpaces(name, stripChars);
+		if (name.empty())
+			continue;
+		name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+		for (size_t i = 1; i < name.length(); i++)
+			name[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+		color *= 1 / 255.0f;
+		color.alpha = 1;
+		add(name, color);
+	}
+	build();
+	return true;
+}
+bool Dictionary::saveBinary(const std::string &filename) {
+	build();
+	const auto &data = m_tree.data();
+	Header header;
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = formatVersion;
+	header.byteOrder = byteOrderMark;
+	header.colorCount = static_cast<uint32_t>(size());
+	header.nodeCount = static_cast<uint32_t>(data.nodes.size());
+	const void *sectionData[sectionCount] = {
+		data.L.data(), data.a.data(), data.b.data(), data.C.data(), data.indexes.data(), data.nodes.data(),
+		m_redView.data(), m_greenView.data(), m_blueView.data(), m_nameOffsetsView.data(), m_namesView.data(),
+	};
+	const uint64_t colorsSize = sizeof(float) * header.colorCount;
+	const uint64_t sectionSizes[sectionCount] = {
+		colorsSize, colorsSize, colorsSize, colorsSize, sizeof(uint32_t) * header.colorCount, sizeof(KdTree::Node) * header.nodeCount,
+		colorsSize, colorsSize, colorsSize, sizeof(uint32_t) * header.colorCount, m_namesView.size(),
+	};
+	uint64_t offset = sizeof(Header);
+	for (uint8_t i = 0; i < sectionCount; i++) {
+		offset = (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+		header.sections[i][0] = offset;
+		header.sections[i][1] = sectionSizes[i];
+		offset += sectionSizes[i];
+	}
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	const char padding[sectionAlignment] = {};
+	uint64_t position = sizeof(Header);
+	for (uint8_t i = 0; i < sectionCount; i++) {
+		file.write(padding, header.sections[i][0] - position);
+		if (sectionSizes[i] > 0)
+			file.write(static_cast<const char *>(sectionData[i]), sectionSizes[i]);
+		position = header.sections[i][0] + sectionSizes[i];
+	}
+	return file.good();
+}
+bool Dictionary::loadBinary(const std::string &filename) {
+	clear();
+	auto mapping = std::make_unique<Mapping>();
+	try {
+		mapping->file = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+		mapping->region = boost::interprocess::mapped_region(mapping->file, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		return false;
+	}
+	const auto *base = static_cast<const uint8_t *>(mapping->region.get_address());
+	const uint64_t fileSize = mapping->region.get_size();
+	if (fileSize < sizeof(Header))
+		return false;
+	Header header;
+	std::memcpy(&header, base, sizeof(Header));
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion || header.byteOrder != byteOrderMark)
+		return false;
+	const uint64_t colorsSize = sizeof(float) * static_cast<uint64_t>(header.colorCount);
+	const uint64_t expectedSizes[sectionCount] = {
+		colorsSize, colorsSize, colorsSize, colorsSize, sizeof(uint32_t) * static_cast<uint64_t>(header.colorCount), sizeof(KdTree::Node) * static_cast<uint64_t>(header.nodeCount),
+		colorsSize, colorsSize, colorsSize, sizeof(uint32_t) * static_cast<uint64_t>(header.colorCount), header.sections[names][1],
+	};
+	for (uint8_t i = 0; i < sectionCount; i++) {
+		uint64_t offset = header.sections[i][0], size = header.sections[i][1];
+		if (size != expectedSizes[i] || offset % alignof(KdTree::Node) != 0 || offset > fileSize || size > fileSize - offset)
+			return false;
+	}
+	auto section = [&](Section section) {
+		return base + header.sections[section][0];
+	};
+	const auto *namesData = reinterpret_cast<const char *>(section(names));
+	const auto namesSize = header.sections[names][1];
+	const auto *offsets = reinterpret_cast<const uint32_t *>(section(nameOffsets));
+	if (header.colorCount > 0 && (namesSize == 0 || namesData[namesSize - 1] != 0))
+		return false;
+	for (uint32_t i = 0; i < header.colorCount; i++) {
+		if (offsets[i] >= namesSize)
+			return false;
+	}
+	KdTree::Data data;
+	data.L = common::Span<const float>(reinterpret_cast<const float *>(section(lightness)), header.colorCount);
+	data.a = common::Span<const float>(reinterpret_cast<const float *>(section(a)), header.colorCount);
+	data.b = common::Span<const float>(reinterpret_cast<const float *>(section(b)), header.colorCount);
+	data.C = common::Span<const float>(reinterpret_cast<const float *>(section(chroma)), header.colorCount);
+	data.indexes = common::Span<const uint32_t>(reinterpret_cast<const uint32_t *>(section(treeIndexes)), header.colorCount);
+	data.nodes = common::Span<const KdTree::Node>(reinterpret_cast<const KdTree::Node *>(section(nodes)), header.nodeCount);
+	if (!m_tree.assign(data))
+		return false;
+	m_namesView = common::Span<const char>(namesData, namesSize);
+	m_nameOffsetsView = common::Span<const uint32_t>(offsets, header.colorCount);
+	m_redView = common::Span<const float>(reinterpret_cast<const float *>(section(red)), header.colorCount);
+	m_greenView = common::Span<const float>(reinterpret_cast<const float *>(section(green)), header.colorCount);
+	m_blueView = common::Span<const float>(reinterpret_cast<const float *>(section(blue)), header.colorCount);
+	m_mapping = std::move(mapping);
+	return true;
+}
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "KdTree.h"
+#include "Color.h"
+#include "common/Span.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace color_names {
+/**
+ * Convert colors into Lab color space (D50 reference white) on multiple threads. Each color is converted by Color::rgbToLabD50,
+ * so results are the same as converting colors one by one.
+ * @param[in] colors Colors in RGB color space.
+ * @param[out] labColors Colors in Lab color space. Must have the same size as colors, can be the same colors as input.
+ */
+void rgbToLabD50(common::Span<const Color> colors, common::Span<Color> labColors);
+/** \struct Dictionary
+ * \brief Color names with their nearest neighbour index.
+ *
+ * Dictionary can be loaded from a text file, filled from a color list or memory mapped from a precompiled binary file.
+ * Binary file stores Lab values in structure-of-arrays layout together with serialized k-d tree and all names in a single blob,
+ * so mapped dictionary is used directly without parsing, conversion or copying.
+ */
+struct Dictionary {
+	Dictionary();
+	Dictionary(const Dictionary &) = delete;
+	Dictionary &operator=(const Dictionary &) = delete;
+	~Dictionary();
+	/**
+	 * Load dictionary from a text or binary file. File type is detected by its contents.
+	 * @param[in] filename File name.
+	 * @return True on success.
+	 */
+	bool load(const std::string &filename);
+	/**
+	 * Load dictionary from a text file. Each line contains red, green and blue values (0-255) followed by color name.
+	 * Lines starting with "!" are ignored.
+	 * @param[in] filename File name.
+	 * @return True on success.
+	 */
+	bool loadText(const std::string &filename);
+	/**
+	 * Memory map precompiled binary dictionary.
+	 * @param[in] filename File name.
+	 * @return True on success.
+	 */
+	bool loadBinary(const std::string &filename);
+	/**
+	 * Save dictionary into binary file.
+	 * @param[in] filename File name.
+	 * @return True on success.
+	 */
+	bool saveBinary(const std::string &filename);
+	/**
+	 * Add color to dictionary. Can not be used with memory mapped dictionary.
+	 * @param[in] name Color name.
+	 * @param[in] color Color in RGB color space.
+	 */
+	void add(std::string_view name, const Color &color);
+	/**
+	 * Build nearest neighbour index if colors were added since last build. All colors are converted into Lab color space in one batch.
+	 */
+	void build();
+	void clear();
+	size_t size() const;
+	bool empty() const;
+	bool mapped() const;
+	/**
+	 * Get color name.
+	 * @param[in] index Color index.
+	 * @return Null terminated color name.
+	 */
+	const char *name(uint32_t index) const;
+	/**
+	 * Get color.
+	 * @param[in] index Color index.
+	 * @return Color in RGB color space.
+	 */
+	Color color(uint32_t index) const;
+	/**
+	 * Get nearest neighbour index. build() must be called after adding colors.
+	 * @return Index of Lab colors.
+	 */
+	const KdTree &tree() const;
+private:
+	struct Mapping;
+	std::unique_ptr<Mapping> m_mapping;
+	KdTree m_tree;
+	bool m_indexed;
+	std::vector<char> m_names;
+	std::vector<uint32_t> m_nameOffsets;
+	std::vector<float> m_red, m_green, m_blue;
+	common::Span<const char> m_namesView;
+	common::Span<const uint32_t> m_nameOffsetsView;
+	common::Span<const float> m_redView, m_greenView, m_blueView;
+	void updateViews();
+};
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "KdTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+namespace color_names {
+struct KdTree::Query {
+	Query(float L, float a, float b, size_t count):
+		L(L),
+		a(a),
+		b(b),
+		C(static_cast<float>(std::sqrt(a * a + b * b))),
+		count(count) {
+		heap.reserve(count + 1);
+	}
+	double limit() const {
+		if (heap.size() < count)
+			return std::numeric_limits<double>::infinity();
+		return heap.front().first;
+	}
+	void offer(double distance, uint32_t index) {
+		std::pair<double, uint32_t> item(distance, index);
+		if (heap.size() < count) {
+			heap.push_back(item);
+			std::push_heap(heap.begin(), heap.end());
+		} else if (item < heap.front()) {
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = item;
+			std::push_heap(heap.begin(), heap.end());
+		}
+	}
+	float L, a, b, C;
+	size_t count;
+	std::vector<std::pair<double, uint32_t>> heap;
+};
+namespace {
+// Same calculation as Color::distanceLch(entry, query) without the final square root, so that results match exactly.
+inline double distanceSquared(float L1, float a1, float b1, float C1, const KdTree::Query &query) {
+	float deltaC = query.C - C1;
+	return std::pow((query.L - L1) / 1, 2) +
+		std::pow(deltaC / (1 + 0.045 * C1), 2) +
+		std::pow((std::pow(a1 - query.a, 2) + std::pow(b1 - query.b, 2) - deltaC) / (1 + 0.015 * C1), 2);
+}
+inline double outside(float value, float min, float max) {
+	if (value < min)
+		return static_cast<double>(min) - value;
+	if (value > max)
+		return static_cast<double>(value) - max;
+	return 0;
+}
+inline double farthest(float value, float min, float max) {
+	return std::max(std::abs(static_cast<double>(value) - min), std::abs(static_cast<double>(value) - max));
+}
+// Lower bound of squared distance from query to any color inside node bounds. Lightness and chroma differences are bounded
+// directly, hue term is bounded by the smallest and largest possible squared a/b plane distance.
+double lowerBound(const KdTree::Node &node, const KdTree::Query &query) {
+	double deltaL = outside(query.L, node.min[0], node.max[0]);
+	double deltaC = outside(query.C, node.min[3], node.max[3]) / (1 + 0.045 * node.max[3]);
+	double minA = outside(query.a, node.min[1], node.max[1]), minB = outside(query.b, node.min[2], node.max[2]);
+	double maxA = farthest(query.a, node.min[1], node.max[1]), maxB = farthest(query.b, node.min[2], node.max[2]);
+	double minNumerator = minA * minA + minB * minB - (static_cast<double>(query.C) - node.min[3]);
+	double maxNumerator = maxA * maxA + maxB * maxB - (static_cast<double>(query.C) - node.max[3]);
+	double deltaH = 0;
+	if (minNumerator > 0)
+		deltaH = minNumerator / (1 + 0.015 * node.max[3]);
+	else if (maxNumerator < 0)
+		deltaH = -maxNumerator / (1 + 0.015 * node.max[3]);
+	// Shrink bound slightly to be on the safe side of floating point rounding in distanceSquared.
+	return (deltaL * deltaL + deltaC * deltaC + deltaH * deltaH) * (1 - 1e-6);
+}
+}
+KdTree::KdTree() {
+}
+void KdTree::clear() {
+	m_data = Data();
+	m_nodes.clear();
+	m_L.clear();
+	m_a.clear();
+	m_b.clear();
+	m_C.clear();
+	m_indexes.clear();
+}
+size_t KdTree::size() const {
+	return m_data.indexes.size();
+}
+bool KdTree::empty() const {
+	return m_data.indexes.size() == 0;
+}
+const KdTree::Data &KdTree::data() const {
+	return m_data;
+}
+bool KdTree::assign(const Data &data) {
+	clear();
+	size_t count = data.indexes.size();
+	if (data.L.size() != count || data.a.size() != count || data.b.size() != count || data.C.size() != count)
+		return false;
+	if ((count == 0) != (data.nodes.size() == 0) || count >= std::numeric_limits<uint32_t>::max() || data.nodes.size() >= std::numeric_limits<uint32_t>::max())
+		return false;
+	for (size_t i = 0; i < count; i++) {
+		if (data.indexes[i] >= count)
+			return false;
+	}
+	// Children must follow their parent, so that traversal always terminates, and tree depth must fit into search stack.
+	std::vector<uint8_t> depth(data.nodes.size(), 0);
+	for (uint32_t i = 0; i < data.nodes.size(); i++) {
+		const auto &node = data.nodes[i];
+		if (node.begin > node.end || node.end > count)
+			return false;
+		if (node.left == 0)
+			continue;
+		if (node.left <= i || node.left + 1 >= data.nodes.size() || depth[i] >= 60)
+			return false;
+		depth[node.left] = depth[node.left + 1] = static_cast<uint8_t>(depth[i] + 1);
+	}
+	m_data = data;
+	return true;
+}
+void KdTree::build(const std::vector<Color> &colors) {
+	clear();
+	if (colors.empty())
+		return;
+	uint32_t count = static_cast<uint32_t>(colors.size());
+	std::vector<float> chroma(count);
+	for (uint32_t i = 0; i < count; i++) {
+		chroma[i] = static_cast<float>(std::sqrt(colors[i].lab.a * colors[i].lab.a + colors[i].lab.b * colors[i].lab.b));
+	}
+	m_indexes.resize(count);
+	std::iota(m_indexes.begin(), m_indexes.end(), 0);
+	m_nodes.reserve(2 * (count / leafSize) + 1);
+	m_nodes.emplace_back();
+	buildNode(0, 0, count, colors, chroma);
+	m_L.resize(count);
+	m_a.resize(count);
+	m_b.resize(count);
+	m_C.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		const auto &color = colors[m_indexes[i]];
+		m_L[i] = color.lab.L;
+		m_a[i] = color.lab.a;
+		m_b[i] = color.lab.b;
+		m_C[i] = chroma[m_indexes[i]];
+	}
+	m_data.nodes = common::Span<const Node>(m_nodes.data(), m_nodes.size());
+	m_data.L = common::Span<const float>(m_L.data(), count);
+	m_data.a = common::Span<const float>(m_a.data(), count);
+	m_data.b = common::Span<const float>(m_b.data(), count);
+	m_data.C = common::Span<const float>(m_C.data(), count);
+	m_data.indexes = common::Span<const uint32_t>(m_indexes.data(), count);
+}
+void KdTree::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, const std::vector<Color> &colors, std::vector<float> &chroma) {
+	Node node;
+	for (int i = 0; i < 4; i++) {
+		node.min[i] = std::numeric_limits<float>::max();
+		node.max[i] = std::numeric_limits<float>::lowest();
+	}
+	for (uint32_t i = begin; i < end; i++) {
+		const auto &color = colors[m_indexes[i]];
+		for (int j = 0; j < 3; j++) {
+			node.min[j] = std::min(node.min[j], color.data[j]);
+			node.max[j] = std::max(node.max[j], color.data[j]);
+		}
+		node.min[3] = std::min(node.min[3], chroma[m_indexes[i]]);
+		node.max[3] = std::max(node.max[3], chroma[m_indexes[i]]);
+	}
+	node.begin = begin;
+	node.end = end;
+	node.left = 0;
+	node.reserved = 0;
+	if (end - begin <= leafSize) {
+		m_nodes[nodeIndex] = node;
+		return;
+	}
+	int axis = 0;
+	for (int j = 1; j < 3; j++) {
+		if (node.max[j] - node.min[j] > node.max[axis] - node.min[axis])
+			axis = j;
+	}
+	uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_indexes.begin() + begin, m_indexes.begin() + middle, m_indexes.begin() + end, [&colors, axis](uint32_t a, uint32_t b) {
+		float valueA = colors[a].data[axis], valueB = colors[b].data[axis];
+		return valueA < valueB || (valueA == valueB && a < b);
+	});
+	node.left = static_cast<uint32_t>(m_nodes.size());
+	m_nodes[nodeIndex] = node;
+	m_nodes.emplace_back();
+	m_nodes.emplace_back();
+	buildNode(node.left, begin, middle, colors, chroma);
+	buildNode(node.left + 1, middle, end, colors, chroma);
+}
+void KdTree::search(Query &query) const {
+	uint32_t stack[64];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const Node &node = m_data.nodes[stack[--stackSize]];
+		if (lowerBound(node, query) > query.limit())
+			continue;
+		if (node.left == 0) {
+			for (uint32_t i = node.begin; i < node.end; i++) {
+				query.offer(distanceSquared(m_data.L[i], m_data.a[i], m_data.b[i], m_data.C[i], query), m_data.indexes[i]);
+			}
+			continue;
+		}
+		// Push farther child first, so that closer one is visited first and tightens the limit sooner.
+		double left = lowerBound(m_data.nodes[node.left], query), right = lowerBound(m_data.nodes[node.left + 1], query);
+		if (left < right) {
+			stack[stackSize++] = node.left + 1;
+			stack[stackSize++] = node.left;
+		} else {
+			stack[stackSize++] = node.left;
+			stack[stackSize++] = node.left + 1;
+		}
+	}
+}
+void KdTree::find(const Color &color, size_t count, std::vector<Match> &matches) const {
+	matches.clear();
+	if (m_data.nodes.size() == 0 || count == 0)
+		return;
+	Query query(color.lab.L, color.lab.a, color.lab.b, count);
+	search(query);
+	std::sort_heap(query.heap.begin(), query.heap.end());
+	matches.reserve(query.heap.size());
+	for (const auto &item: query.heap) {
+		matches.push_back(Match { static_cast<float>(std::sqrt(item.first)), item.second });
+	}
+}
+bool KdTree::findNearest(const Color &color, Match &match) const {
+	if (m_data.nodes.size() == 0)
+		return false;
+	Query query(color.lab.L, color.lab.a, color.lab.b, 1);
+	search(query);
+	match = Match { static_cast<float>(std::sqrt(query.heap.front().first)), query.heap.front().second };
+	return true;
+}
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "common/Span.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace color_names {
+/** \struct KdTree
+ * \brief Static k-d tree over Lab colors for exact nearest neighbour queries using Color::distanceLch metric.
+ */
+struct KdTree {
+	static constexpr uint32_t leafSize = 8;
+	struct Match {
+		float distance;
+		uint32_t index;
+	};
+	struct Node {
+		float min[4], max[4];
+		uint32_t begin, end;
+		uint32_t left; /**< Index of left child, right child follows it. Zero for leaf nodes. */
+		uint32_t reserved;
+	};
+	struct Query;
+	/** Tree data. Arrays are stored in tree order, indexes map tree order to the original color index. */
+	struct Data {
+		common::Span<const Node> nodes;
+		common::Span<const float> L, a, b, C;
+		common::Span<const uint32_t> indexes;
+	};
+	KdTree();
+	KdTree(const KdTree &) = delete;
+	KdTree(KdTree &&) = default;
+	KdTree &operator=(const KdTree &) = delete;
+	/**
+	 * Build tree from colors.
+	 * @param[in] colors Colors in Lab color space. Match index is an index into this vector.
+	 */
+	void build(const std::vector<Color> &colors);
+	/**
+	 * Use previously built tree data without copying it. Data must stay valid while tree is used.
+	 * @param[in] data Tree data, for example from memory mapped file.
+	 * @return True if data is consistent.
+	 */
+	bool assign(const Data &data);
+	/**
+	 * Get tree data for serialization.
+	 * @return Tree data.
+	 */
+	const Data &data() const;
+	void clear();
+	size_t size() const;
+	bool empty() const;
+	/**
+	 * Find closest colors.
+	 * @param[in] color Color in Lab color space.
+	 * @param[in] count Maximum number of colors to find.
+	 * @param[out] matches Found colors ordered by distance.
+	 */
+	void find(const Color &color, size_t count, std::vector<Match> &matches) const;
+	/**
+	 * Find closest color.
+	 * @param[in] color Color in Lab color space.
+	 * @param[out] match Found color.
+	 * @return True if tree is not empty.
+	 */
+	bool findNearest(const Color &color, Match &match) const;
+private:
+	Data m_data;
+	std::vector<Node> m_nodes;
+	std::vector<float> m_L, m_a, m_b, m_C;
+	std::vector<uint32_t> m_indexes;
+	void search(Query &query) const;
+	void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, const std::vector<Color> &colors, std::vector<float> &chroma);
+};
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "InternedString.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+namespace common {
+struct InternedString::Entry {
+	Entry(std::string_view value):
+		value(value),
+		references(1) {
+	}
+	std::string value;
+	std::atomic<uint32_t> references;
+};
+namespace {
+struct Table {
+	std::mutex mutex;
+	// Keys point to entry values.
+	std::unordered_map<std::string_view, InternedString::Entry *> entries;
+};
+// Table and empty string are never destroyed, as strings can outlive static objects.
+Table &table() {
+	static Table *table = new Table();
+	return *table;
+}
+const std::string &emptyString() {
+	static const std::string *emptyString = new std::string();
+	return *emptyString;
+}
+}
+InternedString::InternedString() noexcept:
+	m_entry(nullptr) {
+}
+InternedString::InternedString(std::string_view value):
+	m_entry(nullptr) {
+	if (value.empty())
+		return;
+	auto &table = common::table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	auto i = table.entries.find(value);
+	if (i != table.entries.end()) {
+		// Entry, which has already lost its last reference, is about to be deleted, so it is replaced with a new entry.
+		uint32_t references = i->second->references.load(std::memory_order_relaxed);
+		while (references > 0) {
+			if (i->second->references.compare_exchange_weak(references, references + 1, std::memory_order_relaxed)) {
+				m_entry = i->second;
+				return;
+			}
+		}
+		table.entries.erase(i);
+	}
+	m_entry = new Entry(value);
+	table.entries.emplace(m_entry->value, m_entry);
+}
+InternedString::InternedString(const InternedString &value) noexcept:
+	m_entry(value.m_entry) {
+	if (m_entry)
+		m_entry->references.fetch_add(1, std::memory_order_relaxed);
+}
+InternedString::InternedString(InternedString &&value) noexcept:
+	m_entry(value.m_entry) {
+	value.m_entry = nullptr;
+}
+InternedString::~InternedString() {
+	release();
+}
+InternedString &InternedString::operator=(const InternedString &value) noexcept {
+	if (m_entry == value.m_entry)
+		return *this;
+	if (value.m_entry)
+		value.m_entry->references.fetch_add(1, std::memory_order_relaxed);
+	release();
+	m_entry = value.m_entry;
+	return *this;
+}
+InternedString &InternedString::operator=(InternedString &&value) noexcept {
+	if (this == &value)
+		return *this;
+	release();
+	m_entry = value.m_entry;
+	value.m_entry = nullptr;
+	return *this;
+}
+void InternedString::release() {
+	if (!m_entry)
+		return;
+	if (m_entry->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		auto &table = common::table();
+		{
+			std::lock_guard<std::mutex> lock(table.mutex);
+			auto i = table.entries.find(m_entry->value);
+			if (i != table.entries.end() && i->second == m_entry)
+				table.entries.erase(i);
+		}
+		delete m_entry;
+	}
+	m_entry = nullptr;
+}
+const std::string &InternedString::str() const {
+	return m_entry ? m_entry->value : emptyString();
+}
+bool InternedString::empty() const {
+	return m_entry == nullptr;
+}
+bool InternedString::operator==(const InternedString &value) const {
+	return m_entry == value.m_entry;
+}
+bool InternedString::operator!=(const InternedString &value) const {
+	return m_entry != value.m_entry;
+}
+size_t InternedString::tableSize() {
+	auto &table = common::table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	return table.entries.size();
+}
+}
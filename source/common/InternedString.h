@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_COMMON_INTERNED_STRING_H_
+#define GPICK_COMMON_INTERNED_STRING_H_
+#include <string>
+#include <string_view>
+namespace common {
+/** \struct InternedString
+ * \brief Immutable string stored once in a shared table.
+ *
+ * Equal strings share one table entry, which is removed when the last string referencing it is destroyed.
+ * Copying does not lock the table, while creating a non-empty string and destroying the last reference does. Empty strings do not use the table.
+ */
+struct InternedString {
+	InternedString() noexcept;
+	explicit InternedString(std::string_view value);
+	InternedString(const InternedString &value) noexcept;
+	InternedString(InternedString &&value) noexcept;
+	~InternedString();
+	InternedString &operator=(const InternedString &value) noexcept;
+	InternedString &operator=(InternedString &&value) noexcept;
+	const std::string &str() const;
+	bool empty() const;
+	bool operator==(const InternedString &value) const;
+	bool operator!=(const InternedString &value) const;
+	/**
+	 * Get number of distinct strings stored in the shared table.
+	 * @return Entry count.
+	 */
+	static size_t tableSize();
+	struct Entry;
+private:
+	Entry *m_entry;
+	void release();
+};
+}
+#endif /* GPICK_COMMON_INTERNED_STRING_H_ */
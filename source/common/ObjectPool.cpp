@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ObjectPool.h"
+#include <boost/align/aligned_alloc.hpp>
+#include <algorithm>
+#include <new>
+namespace common {
+struct ObjectPool::Block {
+	Block *previous, *next;
+	void *freeList;
+	uint32_t used, bump;
+	bool linked;
+};
+ObjectPool::ObjectPool(size_t objectSize, size_t objectAlignment):
+	m_objectSize((std::max(objectSize, sizeof(void *)) + objectAlignment - 1) / objectAlignment * objectAlignment),
+	m_objectsOffset((sizeof(Block) + objectAlignment - 1) / objectAlignment * objectAlignment),
+	m_objectsPerBlock((blockSize - m_objectsOffset) / m_objectSize),
+	m_current(nullptr),
+	m_available(nullptr),
+	m_objects(0),
+	m_blocks(0) {
+}
+ObjectPool::~ObjectPool() {
+	while (m_available) {
+		auto *block = m_available;
+		unlink(block);
+		if (block != m_current)
+			boost::alignment::aligned_free(block);
+	}
+	if (m_current)
+		boost::alignment::aligned_free(m_current);
+}
+size_t ObjectPool::objectSize() const {
+	return m_objectSize;
+}
+size_t ObjectPool::objectsPerBlock() const {
+	return m_objectsPerBlock;
+}
+void ObjectPool::statistics(size_t &objects, size_t &blocks) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	objects = m_objects;
+	blocks = m_blocks;
+}
+ObjectPool::Block *ObjectPool::newBlock() {
+	void *memory = boost::alignment::aligned_alloc(blockSize, blockSize);
+	if (!memory)
+		throw std::bad_alloc();
+	auto *block = new (memory) Block();
+	block->previous = block->next = nullptr;
+	block->freeList = nullptr;
+	block->used = block->bump = 0;
+	block->linked = false;
+	m_blocks++;
+	return block;
+}
+void ObjectPool::link(Block *block) {
+	block->previous = nullptr;
+	block->next = m_available;
+	if (m_available)
+		m_available->previous = block;
+	m_available = block;
+	block->linked = true;
+}
+void ObjectPool::unlink(Block *block) {
+	if (block->previous)
+		block->previous->next = block->next;
+	else
+		m_available = block->next;
+	if (block->next)
+		block->next->previous = block->previous;
+	block->previous = block->next = nullptr;
+	block->linked = false;
+}
+void *ObjectPool::allocate() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_current || m_current->used == m_objectsPerBlock) {
+		if (m_available) {
+			m_current = m_available;
+			unlink(m_current);
+		} else {
+			m_current = newBlock();
+		}
+	}
+	auto *block = m_current;
+	void *result;
+	if (block->bump < m_objectsPerBlock) {
+		result = reinterpret_cast<uint8_t *>(block) + m_objectsOffset + block->bump * m_objectSize;
+		block->bump++;
+	} else {
+		result = block->freeList;
+		block->freeList = *reinterpret_cast<void **>(result);
+	}
+	block->used++;
+	m_objects++;
+	return result;
+}
+void ObjectPool::deallocate(void *pointer) {
+	if (!pointer)
+		return;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto *block = reinterpret_cast<Block *>(reinterpret_cast<uintptr_t>(pointer) & ~static_cast<uintptr_t>(blockSize - 1));
+	*reinterpret_cast<void **>(pointer) = block->freeList;
+	block->freeList = pointer;
+	block->used--;
+	m_objects--;
+	if (block == m_current)
+		return;
+	if (block->used == 0) {
+		if (block->linked)
+			unlink(block);
+		boost::alignment::aligned_free(block);
+		m_blocks--;
+	} else if (!block->linked && block->used <= m_objectsPerBlock - m_objectsPerBlock / 4) {
+		link(block);
+	}
+}
+}
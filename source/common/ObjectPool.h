@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_COMMON_OBJECT_POOL_H_
+#define GPICK_COMMON_OBJECT_POOL_H_
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+namespace common {
+/** \struct ObjectPool
+ * \brief Thread safe allocator of equally sized objects.
+ *
+ * Objects are allocated from aligned fixed size blocks, so consecutive allocations are placed next to each other and deallocation finds object block without a lookup.
+ * Unused space at the end of the current block is preferred over freed slots, blocks are reused when at least a quarter of them is free and returned to the system when empty.
+ */
+struct ObjectPool {
+	static constexpr size_t blockSize = 64 * 1024;
+	/**
+	 * Create empty pool.
+	 * @param[in] objectSize Object size in bytes.
+	 * @param[in] objectAlignment Object alignment in bytes.
+	 */
+	ObjectPool(size_t objectSize, size_t objectAlignment);
+	ObjectPool(const ObjectPool &) = delete;
+	ObjectPool &operator=(const ObjectPool &) = delete;
+	/** All objects must be deallocated before pool is destroyed. */
+	~ObjectPool();
+	void *allocate();
+	void deallocate(void *pointer);
+	size_t objectSize() const;
+	size_t objectsPerBlock() const;
+	/**
+	 * Get pool usage.
+	 * @param[out] objects Number of allocated objects.
+	 * @param[out] blocks Number of allocated blocks.
+	 */
+	void statistics(size_t &objects, size_t &blocks);
+private:
+	struct Block;
+	size_t m_objectSize, m_objectsOffset, m_objectsPerBlock;
+	std::mutex m_mutex;
+	Block *m_current, *m_available;
+	size_t m_objects, m_blocks;
+	Block *newBlock();
+	void link(Block *block);
+	void unlink(Block *block);
+};
+}
+#endif /* GPICK_COMMON_OBJECT_POOL_H_ */
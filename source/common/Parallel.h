@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_COMMON_PARALLEL_H_
+#define GPICK_COMMON_PARALLEL_H_
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+namespace common {
+/**
+ * Get number of worker threads to use for parallel work.
+ * @return Hardware thread count, at least 1.
+ */
+size_t threadCount();
+/**
+ * Split index range into continuous chunks and process them on multiple threads. Current thread processes the last chunk.
+ * Chunk boundaries depend only on item count, thread count and minimal chunk size.
+ * @param[in] count Number of items.
+ * @param[in] minChunkSize Minimal number of items processed by one thread. Small ranges are processed on current thread.
+ * @param[in] callback Callable with (size_t begin, size_t end) parameters.
+ */
+template<typename Callback>
+void parallelFor(size_t count, size_t minChunkSize, Callback &&callback) {
+	if (count == 0)
+		return;
+	size_t threads = std::min(threadCount(), (count + minChunkSize - 1) / std::max<size_t>(minChunkSize, 1));
+	if (threads <= 1) {
+		callback(size_t(0), count);
+		return;
+	}
+	size_t chunkSize = (count + threads - 1) / threads;
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	size_t begin = 0;
+	for (; begin + chunkSize < count; begin += chunkSize) {
+		workers.emplace_back([&callback, begin, chunkSize]() {
+			callback(begin, begin + chunkSize);
+		});
+	}
+	callback(begin, count);
+	for (auto &worker: workers)
+		worker.join();
+}
+}
+#endif /* GPICK_COMMON_PARALLEL_H_ */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TextWriter.h"
+#include <charconv>
+#include <cstring>
+#include <ostream>
+namespace common {
+TextWriter::TextWriter():
+	m_stream(nullptr),
+	m_bufferSize(0),
+	m_good(true) {
+}
+TextWriter::TextWriter(std::ostream &stream, size_t bufferSize):
+	m_stream(&stream),
+	m_bufferSize(bufferSize),
+	m_good(true) {
+	m_buffer.reserve(bufferSize);
+}
+TextWriter::~TextWriter() {
+	flush();
+}
+TextWriter &TextWriter::operator<<(std::string_view value) {
+	if (m_stream && m_buffer.size() + value.size() > m_bufferSize) {
+		flush();
+		if (value.size() >= m_bufferSize) {
+			if (m_good) {
+				m_stream->write(value.data(), value.size());
+				m_good = m_stream->good();
+			}
+			return *this;
+		}
+	}
+	m_buffer.append(value);
+	return *this;
+}
+TextWriter &TextWriter::operator<<(const char *value) {
+	return *this << std::string_view(value);
+}
+TextWriter &TextWriter::operator<<(char value) {
+	m_buffer.push_back(value);
+	flushIfFull();
+	return *this;
+}
+TextWriter &TextWriter::operator<<(int value) {
+	char text[16];
+	auto result = std::to_chars(text, text + sizeof(text), value);
+	return *this << std::string_view(text, result.ptr - text);
+}
+TextWriter &TextWriter::operator<<(float value) {
+	return write(value, 6);
+}
+TextWriter &TextWriter::write(float value, int precision) {
+	char text[32];
+	auto result = std::to_chars(text, text + sizeof(text), value, std::chars_format::general, precision);
+	return *this << std::string_view(text, result.ptr - text);
+}
+TextWriter &TextWriter::writeHex(unsigned int value, int width) {
+	char text[16];
+	auto result = std::to_chars(text, text + sizeof(text), value, 16);
+	for (int i = static_cast<int>(result.ptr - text); i < width; i++)
+		m_buffer.push_back('0');
+	return *this << std::string_view(text, result.ptr - text);
+}
+bool TextWriter::flush() {
+	if (!m_stream)
+		return m_good;
+	if (m_good && !m_buffer.empty()) {
+		m_stream->write(m_buffer.data(), m_buffer.size());
+		m_good = m_stream->good();
+	}
+	m_buffer.clear();
+	return m_good;
+}
+std::string_view TextWriter::text() const {
+	return m_buffer;
+}
+void TextWriter::clear() {
+	m_buffer.clear();
+}
+void TextWriter::flushIfFull() {
+	if (m_stream && m_buffer.size() >= m_bufferSize)
+		flush();
+}
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_COMMON_TEXT_WRITER_H_
+#define GPICK_COMMON_TEXT_WRITER_H_
+#include "Parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace common {
+/**
+ * Buffered text output.
+ * Text is collected in a reusable buffer and written to the stream in large blocks. Numbers are formatted with std::to_chars, so output does not depend on stream locale or flags.
+ * Writer without a stream only collects text in memory.
+ */
+struct TextWriter {
+	TextWriter();
+	TextWriter(std::ostream &stream, size_t bufferSize = 256 * 1024);
+	TextWriter(TextWriter &&writer) = default;
+	TextWriter(const TextWriter &) = delete;
+	TextWriter &operator=(const TextWriter &) = delete;
+	~TextWriter();
+	TextWriter &operator<<(std::string_view value);
+	TextWriter &operator<<(const char *value);
+	TextWriter &operator<<(char value);
+	TextWriter &operator<<(int value);
+	TextWriter &operator<<(float value);
+	/**
+	 * Write floating point value in the same way as std::ostream with default float field.
+	 * @param[in] value Value.
+	 * @param[in] precision Maximum number of significant digits.
+	 */
+	TextWriter &write(float value, int precision);
+	/**
+	 * Write lower case hexadecimal value padded with zeros.
+	 * @param[in] value Value.
+	 * @param[in] width Minimal number of digits.
+	 */
+	TextWriter &writeHex(unsigned int value, int width);
+	/**
+	 * Format items on multiple threads.
+	 * Items are split into continuous chunks, each chunk is formatted into a separate in-memory writer and chunk texts are written in item order.
+	 * Small item counts are formatted directly on current thread.
+	 * @param[in] count Item count.
+	 * @param[in] callback Callable with (TextWriter &writer, size_t index) parameters. Callable must be safe to call from multiple threads.
+	 */
+	template<typename Callback>
+	TextWriter &writeParallel(size_t count, Callback &&callback) {
+		// Blocks limit memory used by chunk writers when formatting huge item counts.
+		const size_t blockSize = 64 * 1024, minChunkSize = 1024;
+		for (size_t blockBegin = 0; blockBegin < count; blockBegin += blockSize) {
+			size_t blockEnd = std::min(count, blockBegin + blockSize);
+			size_t chunkCount = std::min(threadCount(), (blockEnd - blockBegin) / minChunkSize);
+			if (chunkCount <= 1) {
+				for (size_t i = blockBegin; i < blockEnd; i++)
+					callback(*this, i);
+				continue;
+			}
+			if (m_chunks.size() < chunkCount)
+				m_chunks.resize(chunkCount);
+			parallelFor(chunkCount, 1, [this, &callback, blockBegin, blockEnd, chunkCount](size_t begin, size_t end) {
+				for (size_t chunk = begin; chunk < end; chunk++) {
+					auto &writer = m_chunks[chunk];
+					writer.clear();
+					size_t itemEnd = blockBegin + (blockEnd - blockBegin) * (chunk + 1) / chunkCount;
+					for (size_t i = blockBegin + (blockEnd - blockBegin) * chunk / chunkCount; i < itemEnd; i++)
+						callback(writer, i);
+				}
+			});
+			for (size_t chunk = 0; chunk < chunkCount; chunk++)
+				*this << m_chunks[chunk].text();
+		}
+		return *this;
+	}
+	/**
+	 * Write buffered text to the stream.
+	 * @return True if all text was written successfully so far.
+	 */
+	bool flush();
+	/**
+	 * Get buffered text which was not written to the stream yet.
+	 */
+	std::string_view text() const;
+	/**
+	 * Discard buffered text.
+	 */
+	void clear();
+private:
+	std::ostream *m_stream;
+	std::string m_buffer;
+	size_t m_bufferSize;
+	bool m_good;
+	std::vector<TextWriter> m_chunks;
+	void flushIfFull();
+};
+}
+#endif /* GPICK_COMMON_TEXT_WRITER_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2009-2020, Albertas Vyšniauskas
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
@@ -21,166 +21,119 @@
 #include "Xml.h"
 #include "Binary.h"
 #include "Types.h"
+#include <atomic>
 #include <vector>
 #include <queue>
 #include <type_traits>
 namespace dynv {
-template<typename T, typename std::enable_if_t<!std::is_reference<T>::value, int> = 0>
-auto get(const Map &map, const std::string &name, T defaultValue) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return defaultValue;
-	auto i = values.find(fieldName);
-	if (i == values.end())
-		return defaultValue;
-	auto &data = (*i)->data();
-	if (!std::holds_alternative<T>(data))
-		return defaultValue;
-	return std::get<T>(data);
-}
-template<typename T, typename std::enable_if_t<std::is_reference<T>::value, int> = 0>
-auto get(const Map &map, const std::string &name, const T &defaultValue) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return defaultValue;
-	auto i = values.find(fieldName);
-	if (i == values.end())
-		return defaultValue;
-	auto &data = (*i)->data();
-	if (!std::holds_alternative<T>(data))
-		return defaultValue;
-	return std::get<T>(data);
+// Incremented on every change of map structure, invalidating variables remembered by Path objects.
+static std::atomic<uint64_t> generation(1);
+static void structureChanged() {
+	generation.fetch_add(1, std::memory_order_relaxed);
+}
+static bool holdsMaps(const Variable &variable) {
+	return std::holds_alternative<Ref>(variable.data()) || std::holds_alternative<std::vector<Ref>>(variable.data());
 }
 template<typename T>
-auto get(const Map &map, const std::string &name) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return T();
-	auto i = values.find(fieldName);
-	if (i == values.end())
-		return T();
-	auto &data = (*i)->data();
-	if (!std::holds_alternative<T>(data))
-		return T();
-	return std::get<T>(data);
+T valueOr(const Variable *variable, const T &defaultValue) {
+	if (!variable || !std::holds_alternative<T>(variable->data()))
+		return defaultValue;
+	return std::get<T>(variable->data());
 }
 template<typename T>
-auto getVector(const Map &map, const std::string &name) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return std::vector<T>();
-	auto i = values.find(fieldName);
-	if (i == values.end())
+std::vector<T> vectorValue(const Variable *variable) {
+	if (!variable)
 		return std::vector<T>();
-	auto &data = (*i)->data();
+	auto &data = variable->data();
 	if (!std::holds_alternative<std::vector<T>>(data)) {
 		if (!std::holds_alternative<T>(data)) // try to fallback to non-vector type
 			return std::vector<T>();
-		return std::vector<T> { std::get<T>(data) };
+		auto result = std::vector<T>();
+		result.emplace_back(std::get<T>(data));
+		return result;
 	}
 	return std::get<std::vector<T>>(data);
 }
 bool Map::getBool(const std::string &name, bool defaultValue) const {
-	return get(*this, name, defaultValue);
+	return valueOr(variable(name), defaultValue);
 }
 float Map::getFloat(const std::string &name, float defaultValue) const {
-	return get(*this, name, defaultValue);
+	return valueOr(variable(name), defaultValue);
 }
 int32_t Map::getInt32(const std::string &name, int32_t defaultValue) const {
-	return get(*this, name, defaultValue);
+	return valueOr(variable(name), defaultValue);
 }
 Color Map::getColor(const std::string &name, Color defaultValue) const {
-	return get(*this, name, defaultValue);
+	return valueOr(variable(name), defaultValue);
 }
 std::string Map::getString(const std::string &name, const std::string &defaultValue) const {
-	return get(*this, name, defaultValue);
+	return valueOr(variable(name), defaultValue);
+}
+bool Map::getBool(const Path &path, bool defaultValue) const {
+	return valueOr(variable(path), defaultValue);
+}
+float Map::getFloat(const Path &path, float defaultValue) const {
+	return valueOr(variable(path), defaultValue);
+}
+int32_t Map::getInt32(const Path &path, int32_t defaultValue) const {
+	return valueOr(variable(path), defaultValue);
+}
+Color Map::getColor(const Path &path, Color defaultValue) const {
+	return valueOr(variable(path), defaultValue);
+}
+std::string Map::getString(const Path &path, const std::string &defaultValue) const {
+	return valueOr(variable(path), defaultValue);
 }
 std::vector<bool> Map::getBools(const std::string &name) const {
-	return getVector<bool>(*this, name);
+	return vectorValue<bool>(variable(name));
 }
 std::vector<float> Map::getFloats(const std::string &name) const {
-	return getVector<float>(*this, name);
+	return vectorValue<float>(variable(name));
 }
 std::vector<int32_t> Map::getInt32s(const std::string &name) const {
-	return getVector<int32_t>(*this, name);
+	return vectorValue<int32_t>(variable(name));
 }
 std::vector<Color> Map::getColors(const std::string &name) const {
-	return getVector<Color>(*this, name);
+	return vectorValue<Color>(variable(name));
 }
 std::vector<std::string> Map::getStrings(const std::string &name) const {
-	return getVector<std::string>(*this, name);
+	return vectorValue<std::string>(variable(name));
 }
 Ref Map::getMap(const std::string &name) {
-	return get<Ref>(*this, name);
+	return valueOr(variable(name), Ref());
 }
 Ref Map::getOrCreateMap(const std::string &name) {
-	bool valid;
-	std::string fieldName;
-	auto &values = valuesForPath(name, valid, fieldName, true);
-	if (!valid)
+	std::string_view fieldName;
+	auto map = mapForPath(name, fieldName, true);
+	if (!map)
 		return Ref();
-	auto i = values.find(fieldName);
-	if (i == values.end()) {
-		Ref result;
-		values.emplace(new Variable(fieldName, (result = create())));
+	auto variable = map->find(fieldName);
+	if (!variable) {
+		Ref result = create();
+		map->insert(std::make_unique<Variable>(std::string(fieldName), result));
 		return result;
 	}
-	auto &data = (*i)->data();
+	auto &data = variable->data();
 	if (!std::holds_alternative<Ref>(data)) {
-		Ref result;
-		(*i)->assign((result = create()));
+		Ref result = create();
+		variable->assign(result);
+		map->nested(*variable, true);
 		return result;
 	}
 	return std::get<Ref>(data);
 }
 const Ref Map::getMap(const std::string &name) const {
-	return get<Ref>(*this, name);
+	return valueOr(variable(name), Ref());
 }
 std::vector<Ref> Map::getMaps(const std::string &name) {
-	bool valid;
-	std::string fieldName;
-	auto &values = valuesForPath(name, valid, fieldName, true);
-	if (!valid)
-		return std::vector<Ref>();
-	auto i = values.find(fieldName);
-	if (i == values.end())
+	std::string_view fieldName;
+	auto map = mapForPath(name, fieldName, true);
+	if (!map)
 		return std::vector<Ref>();
-	auto &data = (*i)->data();
-	if (!std::holds_alternative<std::vector<Ref>>(data)) {
-		if (!std::holds_alternative<Ref>(data)) // try to fallback to non-vector type
-			return std::vector<Ref>();
-		auto result = std::vector<Ref>();
-		result.emplace_back(std::get<Ref>(data));
-		return result;
-	}
-	return std::get<std::vector<Ref>>(data);
+	return vectorValue<Ref>(map->find(fieldName));
 }
 std::vector<Ref> Map::getMaps(const std::string &name) const {
-	bool valid;
-	std::string fieldName;
-	auto &values = valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return std::vector<Ref>();
-	auto i = values.find(fieldName);
-	if (i == values.end())
-		return std::vector<Ref>();
-	auto &data = (*i)->data();
-	if (!std::holds_alternative<std::vector<Ref>>(data)) {
-		if (!std::holds_alternative<Ref>(data)) // try to fallback to non-vector type
-			return std::vector<Ref>();
-		auto result = std::vector<Ref>();
-		result.emplace_back(std::get<Ref>(data));
-		return result;
-	}
-	return std::get<std::vector<Ref>>(data);
+	return vectorValue<Ref>(variable(name));
 }
 struct IsMap {
 	template<typename T>
@@ -191,253 +144,298 @@ struct IsMap {
 		return true;
 	}
 };
-const Map::Set &Map::valuesForPath(const std::string &path, bool &valid, std::string &name) const {
-	size_t position = path.find('.');
-	if (position == std::string::npos) {
-		name = path;
-		valid = true;
-		return m_values;
+Variable *Map::find(std::string_view name) const {
+	if (m_index) {
+		auto i = m_index->find(name);
+		return i != m_index->end() ? i->second : nullptr;
 	}
-	size_t from = 0;
-	auto pathPart = path.substr(from, position);
-	Ref next;
-	auto i = m_values.find(pathPart);
-	if (i == m_values.end()) {
-		valid = false;
-		return m_values;
-	} else {
-		if (!std::visit(IsMap(), (*i)->data())) {
-			valid = false;
-			return m_values;
-		}
-		next = std::get<Ref>((*i)->data());
-		if (!next) {
-			valid = false;
-			return m_values;
+	auto i = m_values.find(name);
+	return i != m_values.end() ? i->get() : nullptr;
+}
+Variable &Map::insert(std::unique_ptr<Variable> &&value) {
+	auto &variable = **m_values.emplace(std::move(value)).first;
+	if (m_index)
+		m_index->emplace(variable.name(), &variable);
+	nested(variable, true);
+	return variable;
+}
+bool Map::erase(std::string_view name) {
+	auto i = m_values.find(name);
+	if (i == m_values.end())
+		return false;
+	if (m_index)
+		m_index->erase((*i)->name());
+	m_values.erase(i);
+	structureChanged();
+	return true;
+}
+void Map::nested(Variable &variable, bool structural) {
+	if (m_index) {
+		auto &data = variable.data();
+		if (std::holds_alternative<Ref>(data)) {
+			auto &map = std::get<Ref>(data);
+			if (map && !map->indexed())
+				map->setIndexed(true);
+		} else if (std::holds_alternative<std::vector<Ref>>(data)) {
+			for (auto &map: std::get<std::vector<Ref>>(data))
+				if (map && !map->indexed())
+					map->setIndexed(true);
 		}
 	}
+	if (structural)
+		structureChanged();
+}
+const Map *Map::mapForPath(std::string_view path, std::string_view &name) const {
+	const Map *map = this;
+	size_t from = 0;
 	for (;;) {
-		from = position + 1;
-		position = path.find('.', from);
-		if (position == std::string::npos) {
+		size_t position = path.find('.', from);
+		if (position == std::string_view::npos) {
 			name = path.substr(from);
-			valid = true;
-			return next->m_values;
-		}
-		pathPart = path.substr(from, position - from);
-		i = next->m_values.find(pathPart);
-		if (i == next->m_values.end()) {
-			valid = false;
-			return m_values;
-		} else {
-			if (!std::visit(IsMap(), (*i)->data())) {
-				valid = false;
-				return m_values;
-			}
-			next = std::get<Ref>((*i)->data());
-			if (!next) {
-				valid = false;
-				return m_values;
-			}
+			return map;
 		}
+		auto variable = map->find(path.substr(from, position - from));
+		if (!variable || !std::visit(IsMap(), variable->data()))
+			return nullptr;
+		map = std::get<Ref>(variable->data()).pointer();
+		if (!map)
+			return nullptr;
+		from = position + 1;
 	}
 }
-Map::Set &Map::valuesForPath(const std::string &path, bool &valid, std::string &name, bool createMissing) {
-	size_t position = path.find('.');
-	if (position == std::string::npos) {
-		name = path;
-		valid = true;
-		return m_values;
-	}
+Map *Map::mapForPath(std::string_view path, std::string_view &name, bool createMissing) {
+	if (!createMissing)
+		return const_cast<Map *>(static_cast<const Map *>(this)->mapForPath(path, name));
+	Map *map = this;
 	size_t from = 0;
-	auto pathPart = path.substr(from, position);
-	Ref next;
-	auto i = m_values.find(pathPart);
-	if (i == m_values.end()) {
-		if (!createMissing) {
-			valid = false;
-			return m_values;
+	for (;;) {
+		size_t position = path.find('.', from);
+		if (position == std::string_view::npos) {
+			name = path.substr(from);
+			return map;
 		}
-		m_values.emplace(new Variable(pathPart, (next = create())));
-	} else {
-		if (!std::visit(IsMap(), (*i)->data())) {
-			valid = false;
-			return m_values;
+		auto pathPart = path.substr(from, position - from);
+		auto variable = map->find(pathPart);
+		Map *next = nullptr;
+		if (variable) {
+			if (!std::visit(IsMap(), variable->data()))
+				return nullptr;
+			next = std::get<Ref>(variable->data()).pointer();
 		}
-		next = std::get<Ref>((*i)->data());
 		if (!next) {
-			if (!createMissing) {
-				valid = false;
-				return m_values;
+			Ref created = create();
+			next = created.pointer();
+			if (variable) {
+				variable->assign(created);
+				map->nested(*variable, true);
+			} else {
+				map->insert(std::make_unique<Variable>(std::string(pathPart), created));
 			}
-			m_values.emplace(new Variable(pathPart, (next = create())));
 		}
-	}
-	for (;;) {
+		map = next;
 		from = position + 1;
-		position = path.find('.', from);
-		if (position == std::string::npos) {
-			name = path.substr(from);
-			valid = true;
-			return next->m_values;
-		}
-		pathPart = path.substr(from, position - from);
-		i = next->m_values.find(pathPart);
-		if (i == next->m_values.end()) {
-			if (!createMissing) {
-				valid = false;
-				return m_values;
-			}
-			next->m_values.emplace(new Variable(pathPart, (next = create())));
-		} else {
-			if (!std::visit(IsMap(), (*i)->data())) {
-				valid = false;
-				return m_values;
-			}
-			next = std::get<Ref>((*i)->data());
-			if (!next) {
-				if (!createMissing) {
-					valid = false;
-					return m_values;
-				}
-				next->m_values.emplace(new Variable(pathPart, (next = create())));
-			}
+	}
+}
+const Variable *Map::variable(std::string_view path) const {
+	std::string_view fieldName;
+	auto map = mapForPath(path, fieldName);
+	if (!map)
+		return nullptr;
+	return map->find(fieldName);
+}
+Variable *Map::variable(const Path &path) const {
+	uint64_t currentGeneration = generation.load(std::memory_order_relaxed);
+	if (path.m_map == this && path.m_generation == currentGeneration)
+		return path.m_variable;
+	const Map *map = this;
+	Variable *result = nullptr;
+	for (size_t i = 0, count = path.size(); i < count; i++) {
+		result = map->find(path[i]);
+		if (!result || i + 1 == count)
+			break;
+		map = std::holds_alternative<Ref>(result->data()) ? std::get<Ref>(result->data()).pointer() : nullptr;
+		if (!map) {
+			result = nullptr;
+			break;
 		}
 	}
+	path.m_map = this;
+	path.m_variable = result;
+	path.m_generation = currentGeneration;
+	return result;
 }
 template<typename T>
-Map &setByPath(Map &map, const std::string &name, T value) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName, true);
-	if (valid) {
-		auto i = values.find(fieldName);
-		if (i == values.end())
-			values.emplace(new Variable(fieldName, value));
-		else {
-			(*i)->assign(value);
-		}
+Map &Map::setByPath(std::string_view path, const T &value) {
+	std::string_view fieldName;
+	auto map = mapForPath(path, fieldName, true);
+	if (!map)
+		return *this;
+	auto variable = map->find(fieldName);
+	if (!variable) {
+		map->insert(std::make_unique<Variable>(std::string(fieldName), value));
+		return *this;
 	}
-	return map;
+	bool structural = holdsMaps(*variable);
+	variable->assign(value);
+	map->nested(*variable, structural || holdsMaps(*variable));
+	return *this;
 }
 template<typename T>
-Map &setByPath(Map &map, const std::string &name, common::Span<T> value) {
-	bool valid;
-	std::string fieldName;
-	auto &values = map.valuesForPath(name, valid, fieldName, true);
-	if (valid) {
-		auto i = values.find(fieldName);
-		if (i == values.end())
-			values.emplace(new Variable(fieldName, std::vector<T>(value.begin(), value.end())));
-		else {
-			(*i)->assign(std::vector<T>(value.begin(), value.end()));
-		}
+Map &Map::setByPath(const Path &path, const T &value) {
+	auto variable = this->variable(path);
+	if (variable && std::holds_alternative<T>(variable->data())) {
+		std::get<T>(variable->data()) = value;
+		return *this;
 	}
-	return map;
+	return setByPath(std::string_view(path.str()), value);
+}
+template<typename T>
+std::vector<T> toVector(const common::Span<T> values) {
+	return std::vector<T>(values.begin(), values.end());
 }
 Map &Map::set(const std::string &name, bool value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, float value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, int32_t value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, const Color &value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, const std::string &value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, std::string_view value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, const char *value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, Ref value) {
-	return setByPath(*this, name, value);
+	return setByPath(name, value);
 }
 Map &Map::set(const std::string &name, const std::vector<bool> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<float> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<int32_t> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<Color> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<std::string> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<const char *> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const std::vector<Ref> &values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, values);
 }
 Map &Map::set(const std::string &name, const common::Span<bool> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<float> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<int32_t> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<Color> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<std::string> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<const char *> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
 }
 Map &Map::set(const std::string &name, const common::Span<Ref> values) {
-	return setByPath(*this, name, values);
+	return setByPath(name, toVector(values));
+}
+Map &Map::set(const Path &path, bool value) {
+	return setByPath(path, value);
+}
+Map &Map::set(const Path &path, float value) {
+	return setByPath(path, value);
+}
+Map &Map::set(const Path &path, int32_t value) {
+	return setByPath(path, value);
+}
+Map &Map::set(const Path &path, const Color &value) {
+	return setByPath(path, value);
+}
+Map &Map::set(const Path &path, const std::string &value) {
+	return setByPath(path, value);
 }
 Map &Map::set(std::unique_ptr<Variable> &&value) {
 	if (!value)
 		return *this;
-	auto i = m_values.find(value->name());
-	if (i == m_values.end())
-		m_values.emplace(std::move(value));
-	else
-		(*i)->data() = std::move(value->data());
+	auto variable = find(value->name());
+	if (!variable) {
+		insert(std::move(value));
+		return *this;
+	}
+	bool structural = holdsMaps(*variable);
+	variable->data() = std::move(value->data());
+	nested(*variable, structural || holdsMaps(*variable));
 	return *this;
 }
 bool Map::remove(const std::string &name) {
-	bool valid;
-	std::string fieldName;
-	auto &values = valuesForPath(name, valid, fieldName, false);
-	if (!valid)
-		return false;
-	auto i = values.find(fieldName);
-	if (i == values.end())
+	std::string_view fieldName;
+	auto map = mapForPath(name, fieldName, false);
+	if (!map)
 		return false;
-	values.erase(i);
-	return true;
+	return map->erase(fieldName);
 }
 bool Map::removeAll() {
-	bool result = !m_values.empty();
+	if (m_values.empty())
+		return false;
+	if (m_index)
+		m_index->clear();
 	m_values.clear();
-	return result;
+	structureChanged();
+	return true;
 }
 size_t Map::size() const {
 	return m_values.size();
 }
 bool Map::contains(const std::string &name) const {
-	bool valid;
-	std::string fieldName;
-	auto &values = valuesForPath(name, valid, fieldName);
-	if (!valid)
-		return false;
-	return values.find(fieldName) != values.end();
+	return variable(name) != nullptr;
+}
+bool Map::contains(const Path &path) const {
+	return variable(path) != nullptr;
+}
+void Map::setIndexed(bool indexed) {
+	if (indexed) {
+		m_index = std::make_unique<Index>();
+		m_index->reserve(m_values.size());
+		for (const auto &value: m_values)
+			m_index->emplace(value->name(), value.get());
+	} else {
+		m_index.reset();
+	}
+	for (const auto &value: m_values) {
+		auto &data = value->data();
+		if (std::holds_alternative<Ref>(data)) {
+			auto &map = std::get<Ref>(data);
+			if (map && map->indexed() != indexed)
+				map->setIndexed(indexed);
+		} else if (std::holds_alternative<std::vector<Ref>>(data)) {
+			for (auto &map: std::get<std::vector<Ref>>(data))
+				if (map && map->indexed() != indexed)
+					map->setIndexed(indexed);
+		}
+	}
+}
+bool Map::indexed() const {
+	return m_index != nullptr;
 }
 struct TypeNameVisitor {
 	template<typename T>
@@ -450,10 +448,10 @@ struct TypeNameVisitor {
 	}
 };
 std::string Map::type(const std::string &name) const {
-	auto i = m_values.find(name);
-	if (i == m_values.end())
+	auto variable = find(name);
+	if (!variable)
 		return "";
-	return std::visit(TypeNameVisitor(), (*i)->data());
+	return std::visit(TypeNameVisitor(), variable->data());
 }
 bool Map::serialize(std::ostream &stream, const std::unordered_map<types::ValueType, uint8_t> &typeMap) const {
 	return binary::serialize(stream, *this, typeMap);
@@ -498,6 +496,8 @@ bool Map::visit(std::function<bool(const Variable &value)> visitor, bool recursi
 Map::Map() {
 }
 Map::~Map() {
+	if (!m_values.empty())
+		structureChanged();
 }
 Ref Map::create() {
 	return Ref(new Map());
@@ -505,10 +505,10 @@ Ref Map::create() {
 bool Map::Compare::operator()(const std::unique_ptr<Variable> &a, const std::unique_ptr<Variable> &b) const {
 	return a->name() < b->name();
 }
-bool Map::Compare::operator()(const std::string &name, const std::unique_ptr<Variable> &b) const {
+bool Map::Compare::operator()(std::string_view name, const std::unique_ptr<Variable> &b) const {
 	return name < b->name();
 }
-bool Map::Compare::operator()(const std::unique_ptr<Variable> &a, const std::string &name) const {
+bool Map::Compare::operator()(const std::unique_ptr<Variable> &a, std::string_view name) const {
 	return a->name() < name;
 }
 }
@@ -19,6 +19,7 @@
 #ifndef GPICK_DYNV_MAP_H_
 #define GPICK_DYNV_MAP_H_
 #include "MapFwd.h"
+#include "Path.h"
 #include "Color.h"
 #include "Types.h"
 #include "common/Ref.h"
@@ -40,8 +41,8 @@ struct Map: public common::Ref<Map>::Counter {
 	struct Compare {
 		using is_transparent = void;
 		bool operator()(const std::unique_ptr<Variable> &a, const std::unique_ptr<Variable> &b) const;
-		bool operator()(const std::string &name, const std::unique_ptr<Variable> &b) const;
-		bool operator()(const std::unique_ptr<Variable> &a, const std::string &name) const;
+		bool operator()(std::string_view name, const std::unique_ptr<Variable> &b) const;
+		bool operator()(const std::unique_ptr<Variable> &a, std::string_view name) const;
 	};
 	using Set = std::set<std::unique_ptr<Variable>, Compare>;
 	Map();
@@ -51,6 +52,11 @@ struct Map: public common::Ref<Map>::Counter {
 	int32_t getInt32(const std::string &name, int32_t defaultValue = 0) const;
 	Color getColor(const std::string &name, Color defaultValue = {}) const;
 	std::string getString(const std::string &name, const std::string &defaultValue = m_defaultString) const;
+	bool getBool(const Path &path, bool defaultValue = false) const;
+	float getFloat(const Path &path, float defaultValue = 0.0f) const;
+	int32_t getInt32(const Path &path, int32_t defaultValue = 0) const;
+	Color getColor(const Path &path, Color defaultValue = {}) const;
+	std::string getString(const Path &path, const std::string &defaultValue = m_defaultString) const;
 	std::vector<bool> getBools(const std::string &name) const;
 	std::vector<float> getFloats(const std::string &name) const;
 	std::vector<int32_t> getInt32s(const std::string &name) const;
@@ -89,21 +95,52 @@ struct Map: public common::Ref<Map>::Counter {
 		return this->set(name, value);
 	}
 	Map &set(std::unique_ptr<Variable> &&value);
+	/**
+	 * Set variable value. Existing variable of the same type is updated in place without path traversal.
+	 * @param[in] path Variable path.
+	 * @param[in] value New value.
+	 * @return Map reference.
+	 */
+	Map &set(const Path &path, bool value);
+	Map &set(const Path &path, float value);
+	Map &set(const Path &path, int32_t value);
+	Map &set(const Path &path, const Color &value);
+	Map &set(const Path &path, const std::string &value);
 	bool remove(const std::string &name);
 	bool removeAll();
 	size_t size() const;
 	bool contains(const std::string &name) const;
+	bool contains(const Path &path) const;
 	std::string type(const std::string &name) const;
 	bool serialize(std::ostream &stream, const std::unordered_map<types::ValueType, uint8_t> &typeMap) const;
 	bool serializeXml(std::ostream &stream) const;
 	bool deserialize(std::istream &stream, const std::unordered_map<uint8_t, types::ValueType> &typeMap);
 	bool deserializeXml(std::istream &stream);
 	bool visit(std::function<bool(const Variable &value)> visitor, bool recursive = false) const;
+	/**
+	 * Enable or disable hash index of variable names in this map and all nested maps.
+	 * Maps nested later into an indexed map are indexed too. Index speeds up lookups in large maps, while iteration order stays sorted by name.
+	 * @param[in] indexed Index state.
+	 */
+	void setIndexed(bool indexed);
+	bool indexed() const;
 	static Ref create();
-	Set &valuesForPath(const std::string &path, bool &valid, std::string &name, bool createMissing);
-	const Set &valuesForPath(const std::string &path, bool &valid, std::string &name) const;
 private:
+	using Index = std::unordered_map<std::string_view, Variable *>;
 	Set m_values;
+	std::unique_ptr<Index> m_index;
+	Variable *find(std::string_view name) const;
+	Variable &insert(std::unique_ptr<Variable> &&variable);
+	bool erase(std::string_view name);
+	void nested(Variable &variable, bool structural);
+	Map *mapForPath(std::string_view path, std::string_view &name, bool createMissing);
+	const Map *mapForPath(std::string_view path, std::string_view &name) const;
+	const Variable *variable(std::string_view path) const;
+	Variable *variable(const Path &path) const;
+	template<typename T>
+	Map &setByPath(std::string_view path, const T &value);
+	template<typename T>
+	Map &setByPath(const Path &path, const T &value);
 	static const std::string m_defaultString;
 };
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_DYNV_PATH_H_
+#define GPICK_DYNV_PATH_H_
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace dynv {
+struct Map;
+struct Variable;
+/** \struct Path
+ * \brief Pre-parsed variable path for repeated lookups of the same setting.
+ *
+ * Path is split into components once on construction. Path also remembers the variable it was last resolved to and reuses it until
+ * any map is structurally changed, so repeated lookups skip path traversal completely.
+ * Remembered lookup state is not synchronized, so the same Path object must not be used from multiple threads at once.
+ */
+struct Path {
+	/**
+	 * Create path.
+	 * @param[in] path Dot separated variable path, e.g. "gpick.picker.refresh_rate".
+	 */
+	explicit Path(std::string_view path);
+	const std::string &str() const;
+	size_t size() const;
+	const std::string &operator[](size_t index) const;
+private:
+	std::string m_path;
+	std::vector<std::string> m_parts;
+	mutable const Map *m_map;
+	mutable Variable *m_variable;
+	mutable uint64_t m_generation;
+	friend struct Map;
+};
+}
+#endif /* GPICK_DYNV_PATH_H_ */
@@ -20,6 +20,8 @@
 #include "uiUtilities.h"
 #include "Color.h"
 #include "Paths.h"
+#include "TileRenderer.h"
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -41,6 +43,8 @@ struct GtkColorComponentPrivate {
 	ReferenceObserver labObserver;
 	cairo_surface_t *patternSurface;
 	cairo_pattern_t *pattern;
+	TileRenderer *tiles;
+	std::vector<bool> *outOfGamut;
 	const char *label[maxNumberOfChannels][2];
 	gchar *text[maxNumberOfChannels];
 	double range[maxNumberOfChannels];
@@ -110,6 +114,8 @@ static void onFinalize(GObject *color_obj) {
 		cairo_surface_destroy(ns->patternSurface);
 	if (ns->pattern)
 		cairo_pattern_destroy(ns->pattern);
+	delete ns->tiles;
+	delete[] ns->outOfGamut;
 	gpointer parent_class = g_type_class_peek_parent(G_OBJECT_CLASS(GTK_COLOR_COMPONENT_GET_CLASS(color_obj)));
 	G_OBJECT_CLASS(parent_class)->finalize(color_obj);
 }
@@ -153,6 +159,8 @@ GtkWidget *gtk_color_component_new(ColorSpace colorSpace) {
 	ns->patternSurface = cairo_image_surface_create_from_png(patternFilename.c_str());
 	ns->pattern = cairo_pattern_create_for_surface(ns->patternSurface);
 	cairo_pattern_set_extend(ns->pattern, CAIRO_EXTEND_REPEAT);
+	ns->tiles = new TileRenderer();
+	ns->outOfGamut = new std::vector<bool>[maxNumberOfChannels];
 	ns->lastEventPosition = -1;
 	ns->changingColor = false;
 	ns->labIlluminant = ReferenceIlluminant::D50;
@@ -248,10 +256,56 @@ void gtk_color_component_set_color(GtkColorComponent *colorComponent, const Colo
 	}
 	gtk_widget_queue_draw(GTK_WIDGET(colorComponent));
 }
-static void interpolateColors(Color *color1, Color *color2, float position, Color *result) {
-	result->rgb.red = color1->rgb.red * (1 - position) + color2->rgb.red * position;
-	result->rgb.green = color1->rgb.green * (1 - position) + color2->rgb.green * position;
-	result->rgb.blue = color1->rgb.blue * (1 - position) + color2->rgb.blue * position;
+// Renders one device pixel row of channel gradients. Each channel is one logical pixel high, as all rows of a channel are equal.
+static void renderRow(GtkColorComponentPrivate *ns, int scale, const math::Matrix3d &adaptationMatrix, int y, const color_batch::Channels &row) {
+	int channel = y / scale;
+	float step = 1.0f / (row.size - 1);
+	if (channel == ns->channels - 1) {
+		for (size_t x = 0; x < row.size; ++x)
+			row.data[0][x] = row.data[1][x] = row.data[2][x] = x * step;
+		return;
+	}
+	switch (ns->colorSpace) {
+	case ColorSpace::rgb:
+	case ColorSpace::hsv:
+	case ColorSpace::hsl:
+		for (int i = 0; i < 3; ++i)
+			std::fill(row.data[i], row.data[i] + row.size, ns->color[i]);
+		for (size_t x = 0; x < row.size; ++x)
+			row.data[channel][x] = x * step;
+		if (ns->colorSpace == ColorSpace::hsv)
+			color_batch::hsvToRgb(row);
+		else if (ns->colorSpace == ColorSpace::hsl)
+			color_batch::hslToRgb(row);
+		break;
+	case ColorSpace::cmyk: {
+		Color c = ns->color;
+		for (size_t x = 0; x < row.size; ++x) {
+			c[channel] = x * step;
+			Color rgb = c.cmykToRgb();
+			row.data[0][x] = rgb.rgb.red;
+			row.data[1][x] = rgb.rgb.green;
+			row.data[2][x] = rgb.rgb.blue;
+		}
+	} break;
+	case ColorSpace::lab:
+	case ColorSpace::lch: {
+		for (int i = 0; i < 3; ++i)
+			std::fill(row.data[i], row.data[i] + row.size, ns->color[i]);
+		for (size_t x = 0; x < row.size; ++x)
+			row.data[channel][x] = static_cast<float>(x * step * ns->range[channel] + ns->offset[channel]);
+		if (ns->colorSpace == ColorSpace::lab)
+			color_batch::labToRgb(row, Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
+		else
+			color_batch::lchToRgb(row, Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
+		if (y % scale == 0) {
+			auto &outOfGamut = ns->outOfGamut[channel];
+			for (size_t x = 0; x < row.size; ++x) {
+				outOfGamut[x] = row.data[0][x] < 0 || row.data[0][x] > 1 || row.data[1][x] < 0 || row.data[1][x] > 1 || row.data[2][x] < 0 || row.data[2][x] > 1;
+			}
+		}
+	} break;
+	}
 }
 #if GTK_MAJOR_VERSION >= 3
 #else
@@ -272,249 +326,40 @@ static int get_x_offset(GtkWidget *widget) {
 }
 static gboolean onDraw(GtkWidget *widget, cairo_t *cr) {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(widget);
-	Color c[maxNumberOfChannels];
 	double pointer_pos[maxNumberOfChannels];
-	int steps;
-	int i, j;
+	int i;
 	for (int i = 0; i < ns->channels; ++i) {
 		if (i < 4)
 			pointer_pos[i] = (ns->color[i] - ns->offset[i]) / ns->range[i];
 		else
 			pointer_pos[i] = (ns->alpha - ns->offset[i]) / ns->range[i];
 	}
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, ns->channels * 16);
-	unsigned char *data = cairo_image_surface_get_data(surface);
-	int stride = cairo_image_surface_get_stride(surface);
-	int surface_width = cairo_image_surface_get_width(surface);
-	unsigned char *col_ptr;
-	Color *rgb_points = new Color[ns->channels * 200];
-	double int_part;
-	math::Matrix3d adaptationMatrix;
-	std::vector<std::vector<bool>> out_of_gamut(maxNumberOfChannels, std::vector<bool>(false, 1));
-	switch (ns->colorSpace) {
-	case ColorSpace::rgb:
-		steps = 1;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i < surface_width; ++i) {
-			c[0].rgb.red = c[1].rgb.green = c[2].rgb.blue = (float)i / (float)(surface_width - 1);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::hsv:
-		steps = 100;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].hsv.hue = c[1].hsv.saturation = c[2].hsv.value = i / static_cast<float>(steps);
-			for (j = 0; j < 3; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].hsvToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::hsl:
-		steps = 100;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].hsl.hue = c[1].hsl.saturation = c[2].hsl.lightness = i / static_cast<float>(steps);
-			for (j = 0; j < 3; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].hslToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::cmyk:
-		steps = 100;
-		for (i = 0; i < 4; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].cmyk.c = c[1].cmyk.m = c[2].cmyk.y = c[3].cmyk.k = i / static_cast<float>(steps);
-			for (j = 0; j < 4; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].cmykToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			interpolateColors(&rgb_points[3 * (steps + 1) + index], &rgb_points[3 * (steps + 1) + index + 1], position, &c[3]);
-			c[4].rgb.red = c[4].rgb.green = c[4].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::lab:
-		steps = 100;
-		adaptationMatrix = Color::getChromaticAdaptationMatrix(Color::getReference(ns->labIlluminant, ns->labObserver), Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].labToRgb(Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::lch:
-		steps = 100;
-		adaptationMatrix = Color::getChromaticAdaptationMatrix(Color::getReference(ns->labIlluminant, ns->labObserver), Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].lchToRgb(Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	default:
-		break;
-	}
-	delete[] rgb_points;
-	cairo_surface_mark_dirty(surface);
-	cairo_save(cr);
+	int scale = TileRenderer::scale(widget);
+	bool gamut = ns->colorSpace == ColorSpace::lab || ns->colorSpace == ColorSpace::lch;
+	for (i = 0; i < ns->channels; ++i)
+		ns->outOfGamut[i].resize(gamut && i < 3 ? 200 * scale : 0);
+	auto adaptationMatrix = Color::getChromaticAdaptationMatrix(Color::getReference(ns->labIlluminant, ns->labObserver), Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
+	auto key = { static_cast<float>(static_cast<int>(ns->colorSpace)), ns->color[0], ns->color[1], ns->color[2], ns->color[3], static_cast<float>(static_cast<int>(ns->labIlluminant)), static_cast<float>(static_cast<int>(ns->labObserver)) };
+	cairo_surface_t *surface = ns->tiles->render(key, 200, ns->channels, scale, [ns, scale, &adaptationMatrix](int y, const color_batch::Channels &row) {
+		renderRow(ns, scale, adaptationMatrix, y, row);
+	});
 	int offset_x = get_x_offset(widget);
-	cairo_set_source_surface(cr, surface, offset_x, 0);
-	cairo_surface_destroy(surface);
-	for (i = 0; i < ns->channels; ++i) {
-		cairo_rectangle(cr, offset_x, 16 * i, 200, 15);
-		cairo_fill(cr);
+	if (surface) {
+		cairo_save(cr);
+		cairo_set_source_surface(cr, surface, 0, 0);
+		cairo_pattern_t *source = cairo_get_source(cr);
+		cairo_matrix_t matrix;
+		cairo_matrix_init_scale(&matrix, 1, 1 / 16.0);
+		cairo_matrix_translate(&matrix, -offset_x, 0);
+		cairo_pattern_set_matrix(source, &matrix);
+		cairo_pattern_set_filter(source, CAIRO_FILTER_NEAREST);
+		for (i = 0; i < ns->channels; ++i) {
+			cairo_rectangle(cr, offset_x, 16 * i, 200, 15);
+			cairo_fill(cr);
+		}
+		cairo_restore(cr);
 	}
-	cairo_restore(cr);
+	std::vector<bool> *out_of_gamut = ns->outOfGamut;
 	for (i = 0; i < ns->channels; ++i) {
 		cairo_matrix_t matrix;
 		cairo_matrix_init_translate(&matrix, -offset_x - 64, -64 + 5 * i);
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorListModel.h"
+#include "ColorObject.h"
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static void init(CustomColorListModel *model);
+static void class_init(CustomColorListModelClass *klass);
+static void tree_model_init(GtkTreeModelIface *iface);
+static void finalize(GObject *object);
+static GtkTreeModelFlags get_flags(GtkTreeModel *tree_model);
+static gint get_n_columns(GtkTreeModel *tree_model);
+static GType get_column_type(GtkTreeModel *tree_model, gint index);
+static gboolean get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path);
+static GtkTreePath *get_path(GtkTreeModel *tree_model, GtkTreeIter *iter);
+static void get_value(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value);
+static gboolean iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter);
+static gboolean iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent);
+static gboolean iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter);
+static gint iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter);
+static gboolean iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent, gint n);
+static gboolean iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child);
+
+// Enough for all visible rows of any reasonable view, so that scrolling does not format the same rows repeatedly.
+static const size_t textCacheSize = 4096;
+struct CustomColorListModelPrivate
+{
+	std::function<std::string(ColorObject &)> formatter;
+	std::vector<ColorObject *> rows;
+	// Rows in [gapStart, gapStart + gapSize) are hidden from views. Gap is only non-empty while range insertion or removal is being announced row by row.
+	size_t gapStart = 0, gapSize = 0;
+	// First row index of each color object. Entries are only trusted for rows before validRows, other entries are fixed up on demand.
+	std::unordered_map<ColorObject *, size_t> indices;
+	size_t validRows = 0;
+	std::list<std::pair<ColorObject *, std::string>> texts;
+	std::unordered_map<ColorObject *, std::list<std::pair<ColorObject *, std::string>>::iterator> textIndex;
+	size_t size() const
+	{
+		return rows.size() - gapSize;
+	}
+	ColorObject *at(size_t index) const
+	{
+		return rows[index < gapStart ? index : index + gapSize];
+	}
+	const std::string &text(ColorObject *colorObject)
+	{
+		auto i = textIndex.find(colorObject);
+		if (i != textIndex.end()) {
+			texts.splice(texts.begin(), texts, i->second);
+			return i->second->second;
+		}
+		texts.emplace_front(colorObject, formatter(*colorObject));
+		textIndex.emplace(colorObject, texts.begin());
+		if (texts.size() > textCacheSize) {
+			textIndex.erase(texts.back().first);
+			texts.pop_back();
+		}
+		return texts.front().second;
+	}
+	void invalidateText(ColorObject *colorObject)
+	{
+		auto i = textIndex.find(colorObject);
+		if (i == textIndex.end())
+			return;
+		texts.erase(i->second);
+		textIndex.erase(i);
+	}
+	void invalidateTexts()
+	{
+		texts.clear();
+		textIndex.clear();
+	}
+	void invalidateIndices(size_t position)
+	{
+		if (position < validRows)
+			validRows = position;
+	}
+	void validateIndices()
+	{
+		for (size_t i = validRows; i < rows.size(); i++) {
+			auto *colorObject = rows[i];
+			auto [entry, inserted] = indices.emplace(colorObject, i);
+			if (!inserted && !(entry->second < i && rows[entry->second] == colorObject))
+				entry->second = i;
+		}
+		validRows = rows.size();
+	}
+	bool find(ColorObject *colorObject, size_t &index)
+	{
+		auto entry = indices.find(colorObject);
+		if (entry != indices.end() && entry->second < validRows && rows[entry->second] == colorObject) {
+			index = entry->second;
+			return true;
+		}
+		if (validRows == rows.size()) {
+			if (entry != indices.end())
+				indices.erase(entry);
+			return false;
+		}
+		validateIndices();
+		return find(colorObject, index);
+	}
+	void insert(size_t position, common::Span<ColorObject *const> colorObjects)
+	{
+		bool append = position == validRows && validRows == rows.size();
+		rows.insert(rows.begin() + position, colorObjects.data(), colorObjects.data() + colorObjects.size());
+		for (size_t i = 0; i < colorObjects.size(); i++) {
+			rows[position + i]->reference();
+			// Appended to fully indexed rows, so an existing entry already points to an earlier row.
+			if (append)
+				indices.emplace(rows[position + i], position + i);
+		}
+		if (append)
+			validRows = rows.size();
+		else
+			invalidateIndices(position);
+	}
+	ColorObject *remove(size_t position)
+	{
+		auto *colorObject = rows[position];
+		rows.erase(rows.begin() + position);
+		auto entry = indices.find(colorObject);
+		if (entry != indices.end() && entry->second == position)
+			indices.erase(entry);
+		invalidateIndices(position);
+		invalidateText(colorObject);
+		return colorObject;
+	}
+};
+static gpointer parent_class;
+
+GType custom_color_list_model_get_type()
+{
+	static GType color_list_model_type = 0;
+	if (color_list_model_type == 0){
+		static const GTypeInfo color_list_model_info = { sizeof(CustomColorListModelClass), nullptr, /* base_init */
+		nullptr, /* base_finalize */
+		(GClassInitFunc) class_init, nullptr, /* class_finalize */
+		nullptr, /* class_data */
+		sizeof(CustomColorListModel), 0, /* n_preallocs */
+		(GInstanceInitFunc) init, };
+		static const GInterfaceInfo tree_model_info = { (GInterfaceInitFunc) tree_model_init, nullptr, /* interface_finalize */
+		nullptr, /* interface_data */ };
+		color_list_model_type = g_type_register_static(G_TYPE_OBJECT, "CustomColorListModel", &color_list_model_info, (GTypeFlags) 0);
+		g_type_add_interface_static(color_list_model_type, GTK_TYPE_TREE_MODEL, &tree_model_info);
+	}
+	return color_list_model_type;
+}
+static void init(CustomColorListModel *model)
+{
+	model->stamp = g_random_int();
+	model->priv = new CustomColorListModelPrivate();
+}
+static void class_init(CustomColorListModelClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	parent_class = g_type_class_peek_parent(klass);
+	object_class->finalize = finalize;
+}
+static void tree_model_init(GtkTreeModelIface *iface)
+{
+	iface->get_flags = get_flags;
+	iface->get_n_columns = get_n_columns;
+	iface->get_column_type = get_column_type;
+	iface->get_iter = get_iter;
+	iface->get_path = get_path;
+	iface->get_value = get_value;
+	iface->iter_next = iter_next;
+	iface->iter_children = iter_children;
+	iface->iter_has_child = iter_has_child;
+	iface->iter_n_children = iter_n_children;
+	iface->iter_nth_child = iter_nth_child;
+	iface->iter_parent = iter_parent;
+}
+static void finalize(GObject *object)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(object);
+	for (auto *colorObject: model->priv->rows)
+		colorObject->release();
+	delete model->priv;
+	model->priv = nullptr;
+	(*G_OBJECT_CLASS(parent_class)->finalize)(object);
+}
+static void set_iter(CustomColorListModel *model, GtkTreeIter *iter, size_t index)
+{
+	iter->stamp = model->stamp;
+	iter->user_data = GSIZE_TO_POINTER(index);
+	iter->user_data2 = nullptr;
+	iter->user_data3 = nullptr;
+}
+static size_t iter_index(GtkTreeIter *iter)
+{
+	return GPOINTER_TO_SIZE(iter->user_data);
+}
+static bool valid_iter(CustomColorListModel *model, GtkTreeIter *iter)
+{
+	return iter != nullptr && iter->stamp == model->stamp && iter_index(iter) < model->priv->size();
+}
+static GtkTreeModelFlags get_flags(GtkTreeModel *tree_model)
+{
+	return GTK_TREE_MODEL_LIST_ONLY;
+}
+static gint get_n_columns(GtkTreeModel *tree_model)
+{
+	return 3;
+}
+static GType get_column_type(GtkTreeModel *tree_model, gint index)
+{
+	switch (index){
+	case 0:
+		return G_TYPE_POINTER;
+	case 1:
+	case 2:
+		return G_TYPE_STRING;
+	}
+	return G_TYPE_INVALID;
+}
+static gboolean get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	if (gtk_tree_path_get_depth(path) != 1)
+		return false;
+	gint index = gtk_tree_path_get_indices(path)[0];
+	if (index < 0 || static_cast<size_t>(index) >= model->priv->size())
+		return false;
+	set_iter(model, iter, index);
+	return true;
+}
+static GtkTreePath *get_path(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	g_return_val_if_fail(valid_iter(model, iter), nullptr);
+	GtkTreePath *path = gtk_tree_path_new();
+	gtk_tree_path_append_index(path, static_cast<gint>(iter_index(iter)));
+	return path;
+}
+static void get_value(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	g_value_init(value, get_column_type(tree_model, column));
+	if (!valid_iter(model, iter))
+		return;
+	ColorObject *colorObject = model->priv->at(iter_index(iter));
+	switch (column){
+	case 0:
+		g_value_set_pointer(value, colorObject);
+		break;
+	case 1:
+		g_value_set_string(value, model->priv->text(colorObject).c_str());
+		break;
+	case 2:
+		g_value_set_string(value, colorObject->getName().c_str());
+		break;
+	}
+}
+static gboolean iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	size_t index = iter_index(iter) + 1;
+	if (index >= model->priv->size()){
+		iter->stamp = 0;
+		return false;
+	}
+	set_iter(model, iter, index);
+	return true;
+}
+static gboolean iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent)
+{
+	return iter_nth_child(tree_model, iter, parent, 0);
+}
+static gboolean iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+	return false;
+}
+static gint iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	if (iter)
+		return 0;
+	return static_cast<gint>(model->priv->size());
+}
+static gboolean iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent, gint n)
+{
+	CustomColorListModel *model = CUSTOM_COLOR_LIST_MODEL(tree_model);
+	if (parent || n < 0 || static_cast<size_t>(n) >= model->priv->size())
+		return false;
+	set_iter(model, iter, n);
+	return true;
+}
+static gboolean iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child)
+{
+	return false;
+}
+static void row_inserted(CustomColorListModel *model, size_t index, GtkTreeIter *iter)
+{
+	set_iter(model, iter, index);
+	GtkTreePath *path = gtk_tree_path_new_from_indices(static_cast<gint>(index), -1);
+	gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, iter);
+	gtk_tree_path_free(path);
+}
+static void row_deleted(CustomColorListModel *model, size_t index)
+{
+	GtkTreePath *path = gtk_tree_path_new_from_indices(static_cast<gint>(index), -1);
+	gtk_tree_model_row_deleted(GTK_TREE_MODEL(model), path);
+	gtk_tree_path_free(path);
+}
+static void row_changed(CustomColorListModel *model, GtkTreeIter *iter)
+{
+	GtkTreePath *path = gtk_tree_path_new_from_indices(static_cast<gint>(iter_index(iter)), -1);
+	gtk_tree_model_row_changed(GTK_TREE_MODEL(model), path, iter);
+	gtk_tree_path_free(path);
+}
+CustomColorListModel *custom_color_list_model_new(std::function<std::string(ColorObject &)> &&formatter)
+{
+	CustomColorListModel *model = (CustomColorListModel*)g_object_new(CUSTOM_TYPE_COLOR_LIST_MODEL, nullptr);
+	model->priv->formatter = std::move(formatter);
+	return model;
+}
+size_t custom_color_list_model_size(CustomColorListModel *model)
+{
+	return model->priv->size();
+}
+ColorObject *custom_color_list_model_get(CustomColorListModel *model, GtkTreeIter *iter)
+{
+	g_return_val_if_fail(valid_iter(model, iter), nullptr);
+	return model->priv->at(iter_index(iter));
+}
+void custom_color_list_model_insert(CustomColorListModel *model, size_t position, ColorObject *colorObject, GtkTreeIter *iter)
+{
+	position = std::min(position, model->priv->size());
+	model->priv->insert(position, common::Span<ColorObject *const>(&colorObject, 1));
+	GtkTreeIter insertedIter;
+	row_inserted(model, position, iter ? iter : &insertedIter);
+}
+void custom_color_list_model_append(CustomColorListModel *model, ColorObject *colorObject)
+{
+	custom_color_list_model_insert(model, model->priv->size(), colorObject);
+}
+void custom_color_list_model_insert_range(CustomColorListModel *model, size_t position, common::Span<ColorObject *const> colorObjects)
+{
+	auto &priv = *model->priv;
+	position = std::min(position, priv.size());
+	priv.insert(position, colorObjects);
+	// All rows are inserted at once, and then revealed to views one by one.
+	priv.gapStart = position;
+	priv.gapSize = colorObjects.size();
+	GtkTreeIter iter;
+	for (size_t i = 0; i < colorObjects.size(); i++){
+		priv.gapStart++;
+		priv.gapSize--;
+		row_inserted(model, position + i, &iter);
+	}
+}
+bool custom_color_list_model_remove(CustomColorListModel *model, GtkTreeIter *iter)
+{
+	g_return_val_if_fail(valid_iter(model, iter), false);
+	size_t index = iter_index(iter);
+	ColorObject *colorObject = model->priv->remove(index);
+	row_deleted(model, index);
+	colorObject->release();
+	if (index >= model->priv->size()){
+		iter->stamp = 0;
+		return false;
+	}
+	set_iter(model, iter, index);
+	return true;
+}
+size_t custom_color_list_model_remove_objects(CustomColorListModel *model, common::Span<ColorObject *const> colorObjects)
+{
+	if (colorObjects.size() == 1)
+		return custom_color_list_model_remove_object(model, colorObjects[0]) ? 1 : 0;
+	std::unordered_map<ColorObject *, size_t> counts;
+	for (auto *colorObject: colorObjects)
+		counts[colorObject]++;
+	auto &priv = *model->priv;
+	auto &rows = priv.rows;
+	size_t remaining = colorObjects.size(), removed = 0;
+	// Kept rows are moved to the start of the gap, while removed rows are moved into the gap, so that rows visible to views always match announced removals.
+	priv.gapStart = 0;
+	priv.gapSize = 0;
+	for (size_t read = 0; read < rows.size() && remaining > 0; read++){
+		ColorObject *colorObject = rows[read];
+		auto count = counts.find(colorObject);
+		if (count == counts.end() || count->second == 0){
+			rows[priv.gapStart++] = colorObject;
+			continue;
+		}
+		count->second--;
+		remaining--;
+		priv.gapSize++;
+		priv.invalidateIndices(priv.gapStart);
+		priv.invalidateText(colorObject);
+		row_deleted(model, priv.gapStart);
+		colorObject->release();
+		removed++;
+	}
+	rows.erase(rows.begin() + priv.gapStart, rows.begin() + priv.gapStart + priv.gapSize);
+	priv.gapStart = 0;
+	priv.gapSize = 0;
+	return removed;
+}
+bool custom_color_list_model_remove_object(CustomColorListModel *model, ColorObject *colorObject)
+{
+	size_t index;
+	if (!model->priv->find(colorObject, index))
+		return false;
+	GtkTreeIter iter;
+	set_iter(model, &iter, index);
+	custom_color_list_model_remove(model, &iter);
+	return true;
+}
+void custom_color_list_model_clear(CustomColorListModel *model)
+{
+	auto &rows = model->priv->rows;
+	while (!rows.empty()){
+		size_t index = rows.size() - 1;
+		ColorObject *colorObject = model->priv->remove(index);
+		row_deleted(model, index);
+		colorObject->release();
+	}
+	model->priv->indices.clear();
+	model->priv->validRows = 0;
+	model->priv->invalidateTexts();
+}
+void custom_color_list_model_set(CustomColorListModel *model, GtkTreeIter *iter, ColorObject *colorObject)
+{
+	g_return_if_fail(valid_iter(model, iter));
+	size_t index = iter_index(iter);
+	ColorObject *previous = model->priv->at(index);
+	model->priv->rows[index] = colorObject->reference();
+	model->priv->invalidateIndices(index);
+	model->priv->invalidateText(previous);
+	previous->release();
+	row_changed(model, iter);
+}
+void custom_color_list_model_update(CustomColorListModel *model, GtkTreeIter *iter, bool onlyName)
+{
+	g_return_if_fail(valid_iter(model, iter));
+	if (!onlyName)
+		model->priv->invalidateText(model->priv->at(iter_index(iter)));
+	row_changed(model, iter);
+}
+void custom_color_list_model_invalidate(CustomColorListModel *model)
+{
+	model->priv->invalidateTexts();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_GTK_COLOR_LIST_MODEL_H_
+#define GPICK_GTK_COLOR_LIST_MODEL_H_
+
+#include "common/Span.h"
+#include <gtk/gtk.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+struct ColorObject;
+
+#define CUSTOM_TYPE_COLOR_LIST_MODEL (custom_color_list_model_get_type())
+#define CUSTOM_COLOR_LIST_MODEL(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), CUSTOM_TYPE_COLOR_LIST_MODEL, CustomColorListModel))
+#define CUSTOM_COLOR_LIST_MODEL_CLASS(obj) (G_TYPE_CHECK_CLASS_CAST((obj), CUSTOM_TYPE_COLOR_LIST_MODEL, CustomColorListModelClass))
+#define CUSTOM_IS_COLOR_LIST_MODEL(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), CUSTOM_TYPE_COLOR_LIST_MODEL))
+#define CUSTOM_IS_COLOR_LIST_MODEL_CLASS(obj) (G_TYPE_CHECK_CLASS_TYPE((obj), CUSTOM_TYPE_COLOR_LIST_MODEL))
+#define CUSTOM_COLOR_LIST_MODEL_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS((obj), CUSTOM_TYPE_COLOR_LIST_MODEL, CustomColorListModelClass))
+
+/** \struct CustomColorListModel
+ * \brief List only tree model of color objects.
+ *
+ * Model has three columns: color object pointer, color text and color name. Rows only store referenced color object pointers.
+ * Color text is produced by formatter only when a row is displayed, and is kept in a bounded least recently used cache.
+ * Iterators are invalidated by any insertion or removal.
+ */
+struct CustomColorListModelPrivate;
+struct CustomColorListModel
+{
+	GObject parent;
+	gint stamp;
+	CustomColorListModelPrivate *priv;
+};
+struct CustomColorListModelClass
+{
+	GObjectClass parent_class;
+};
+GType custom_color_list_model_get_type();
+/**
+ * Create empty model.
+ * @param[in] formatter Color text formatter.
+ * @return Model with reference count of one.
+ */
+CustomColorListModel *custom_color_list_model_new(std::function<std::string(ColorObject &)> &&formatter);
+size_t custom_color_list_model_size(CustomColorListModel *model);
+/**
+ * Get color object of a row. Model keeps the reference.
+ * @param[in] model Model.
+ * @param[in] iter Valid row iterator.
+ * @return Color object.
+ */
+ColorObject *custom_color_list_model_get(CustomColorListModel *model, GtkTreeIter *iter);
+/**
+ * Insert row before position. Color object is referenced by the model.
+ * @param[in] model Model.
+ * @param[in] position Row position. Positions past the last row append row.
+ * @param[in] colorObject Color object.
+ * @param[out] iter Optional iterator to store inserted row position into.
+ */
+void custom_color_list_model_insert(CustomColorListModel *model, size_t position, ColorObject *colorObject, GtkTreeIter *iter = nullptr);
+void custom_color_list_model_append(CustomColorListModel *model, ColorObject *colorObject);
+/**
+ * Insert rows before position. Rows are stored at once, while views are notified about each row.
+ * @param[in] model Model.
+ * @param[in] position Row position. Positions past the last row append rows.
+ * @param[in] colorObjects Color objects. Each color object is referenced by the model.
+ */
+void custom_color_list_model_insert_range(CustomColorListModel *model, size_t position, common::Span<ColorObject *const> colorObjects);
+/**
+ * Remove row and release its color object.
+ * @param[in] model Model.
+ * @param[in,out] iter Row to remove. Set to the next row after removal.
+ * @return True if iterator points to the next row, false if removed row was the last one.
+ */
+bool custom_color_list_model_remove(CustomColorListModel *model, GtkTreeIter *iter);
+/**
+ * Remove first row containing color object. Row position is found in constant time, unless rows before it were inserted or removed since the last lookup.
+ * @param[in] model Model.
+ * @param[in] colorObject Color object.
+ * @return True if row was found and removed.
+ */
+bool custom_color_list_model_remove_object(CustomColorListModel *model, ColorObject *colorObject);
+/**
+ * Remove first row containing each of color objects in a single pass over all rows.
+ * @param[in] model Model.
+ * @param[in] colorObjects Color objects. Color object which is listed multiple times removes multiple rows.
+ * @return Number of removed rows.
+ */
+size_t custom_color_list_model_remove_objects(CustomColorListModel *model, common::Span<ColorObject *const> colorObjects);
+void custom_color_list_model_clear(CustomColorListModel *model);
+/**
+ * Replace color object of a row.
+ * @param[in] model Model.
+ * @param[in] iter Valid row iterator.
+ * @param[in] colorObject New color object. Referenced by the model, while previous color object is released.
+ */
+void custom_color_list_model_set(CustomColorListModel *model, GtkTreeIter *iter, ColorObject *colorObject);
+/**
+ * Notify views about changed color object of a row.
+ * @param[in] model Model.
+ * @param[in] iter Valid row iterator.
+ * @param[in] onlyName True if only color name changed, so cached color text is kept.
+ */
+void custom_color_list_model_update(CustomColorListModel *model, GtkTreeIter *iter, bool onlyName);
+/**
+ * Drop all cached color texts, for example after formatter options change. Views are not notified and have to be redrawn.
+ * @param[in] model Model.
+ */
+void custom_color_list_model_invalidate(CustomColorListModel *model);
+
+#endif /* GPICK_GTK_COLOR_LIST_MODEL_H_ */
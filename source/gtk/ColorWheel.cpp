@@ -19,7 +19,8 @@
 #include "ColorWheel.h"
 #include "Color.h"
 #include "ColorWheelType.h"
-#include <iostream>
+#include "TileRenderer.h"
+#include <algorithm>
 enum {
 	HUE_CHANGED, SATURATION_VALUE_CHANGED, LAST_SIGNAL
 };
@@ -41,7 +42,8 @@ struct GtkColorWheelPrivate {
 	float block_size;
 	bool block_editable;
 	const ColorWheelType *color_wheel_type;
-	cairo_surface_t *cache_color_wheel;
+	TileRenderer *wheel_tiles;
+	TileRenderer *block_tiles;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *pointer_grab;
 #endif
@@ -61,10 +63,8 @@ static gboolean expose(GtkWidget *color_wheel, GdkEventExpose *event);
 static void finalize(GObject *color_wheel_obj)
 {
 	GtkColorWheelPrivate *ns = GET_PRIVATE(color_wheel_obj);
-	if (ns->cache_color_wheel){
-		cairo_surface_destroy(ns->cache_color_wheel);
-		ns->cache_color_wheel = 0;
-	}
+	delete ns->wheel_tiles;
+	delete ns->block_tiles;
 	G_OBJECT_CLASS(parent_class)->finalize(color_wheel_obj);
 }
 static void gtk_color_wheel_class_init(GtkColorWheelClass *color_wheel_class)
@@ -107,7 +107,8 @@ GtkWidget* gtk_color_wheel_new()
 	ns->selected = &ns->cpoint[0];
 	ns->block_editable = true;
 	ns->color_wheel_type = &color_wheel_types_get()[0];
-	ns->cache_color_wheel = 0;
+	ns->wheel_tiles = new TileRenderer();
+	ns->block_tiles = new TileRenderer();
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointer_grab = nullptr;
 #endif
@@ -119,10 +120,7 @@ void gtk_color_wheel_set_color_wheel_type(GtkColorWheel *color_wheel, const Colo
 	GtkColorWheelPrivate *ns = GET_PRIVATE(color_wheel);
 	if (ns->color_wheel_type != color_wheel_type){
 		ns->color_wheel_type = color_wheel_type;
-		if (ns->cache_color_wheel){
-			cairo_surface_destroy(ns->cache_color_wheel);
-			ns->cache_color_wheel = 0;
-		}
+		ns->wheel_tiles->reset();
 		gtk_widget_queue_draw(GTK_WIDGET(color_wheel));
 	}
 }
@@ -221,78 +219,47 @@ static void draw_dot(cairo_t *cr, double x, double y, double size)
 	cairo_set_line_width(cr, 1);
 	cairo_stroke(cr);
 }
-static void draw_sat_val_block(cairo_t *cr, double pos_x, double pos_y, double size, double hue)
+static void draw_sat_val_block(GtkColorWheelPrivate *ns, int scale, cairo_t *cr, double pos_x, double pos_y, double size, double hue)
 {
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(size)), static_cast<int>(std::ceil(size)));
-	unsigned char *data = cairo_image_surface_get_data(surface);
-	int stride = cairo_image_surface_get_stride(surface);
-	int surface_width = cairo_image_surface_get_width(surface);
-	int surface_height = cairo_image_surface_get_height(surface);
-	Color c;
-	uint8_t *line_data;
-	for (int y = 0; y < surface_height; ++y){
-		line_data = data + stride * y;
-		for (int x = 0; x < surface_width; ++x){
-			c.hsv.hue = static_cast<float>(hue);
-			c.hsv.saturation = static_cast<float>(x / size);
-			c.hsv.value = static_cast<float>(y / size);
-			c = c.hsvToRgb();
-			line_data[2] = static_cast<uint8_t>(c.rgb.red * 255);
-			line_data[1] = static_cast<uint8_t>(c.rgb.green * 255);
-			line_data[0] = static_cast<uint8_t>(c.rgb.blue * 255);
-			line_data[3] = 0xFF;
-			line_data += 4;
+	int surface_size = static_cast<int>(std::ceil(size));
+	float step = static_cast<float>(1 / (size * scale));
+	float block_hue = static_cast<float>(hue);
+	cairo_surface_t *surface = ns->block_tiles->render({block_hue, static_cast<float>(size)}, surface_size, surface_size, scale, [block_hue, step](int y, const color_batch::Channels &row){
+		std::fill(row.data[0], row.data[0] + row.size, block_hue);
+		for (size_t x = 0; x < row.size; ++x){
+			row.data[1][x] = x * step;
 		}
-	}
-	cairo_surface_mark_dirty(surface);
+		std::fill(row.data[2], row.data[2] + row.size, y * step);
+		color_batch::hsvToRgb(row);
+	});
+	if (!surface) return;
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, pos_x - size / 2, pos_y - size / 2);
-	cairo_surface_destroy(surface);
 	cairo_rectangle(cr, pos_x - size / 2, pos_y - size / 2, size, size);
 	cairo_fill(cr);
 	cairo_restore(cr);
 }
-static void draw_wheel(GtkColorWheelPrivate *ns, cairo_t *cr, double radius, double width, const ColorWheelType *wheel)
+static void draw_wheel(GtkColorWheelPrivate *ns, int scale, cairo_t *cr, double radius, double width, const ColorWheelType *wheel)
 {
-	cairo_surface_t *surface;
 	double inner_radius = radius - width;
-	if (ns->cache_color_wheel){
-		surface = ns->cache_color_wheel;
-	}else{
-		surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(radius * 2)), static_cast<int>(std::ceil(radius * 2)));
-		if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS){
-			std::cerr << "ColorWheel image surface allocation failed" << std::endl;
-			return;
-		}
-		unsigned char *data = cairo_image_surface_get_data(surface);
-		int stride = cairo_image_surface_get_stride(surface);
-		int surface_width = cairo_image_surface_get_width(surface);
-		int surface_height = cairo_image_surface_get_height(surface);
-		double radius_sq = radius * radius + 2 * radius + 1;
-		double inner_radius_sq = inner_radius * inner_radius - 2 * inner_radius + 1;
+	int surface_size = static_cast<int>(std::ceil(radius * 2));
+	double center = surface_size / 2;
+	double step = 1.0 / scale;
+	// Whole square is rendered, as only the ring is painted by stroking the surface below.
+	cairo_surface_t *surface = ns->wheel_tiles->render({static_cast<float>(radius)}, surface_size, surface_size, scale, [wheel, center, step](int y, const color_batch::Channels &row){
 		Color c;
-		uint8_t *line_data;
-		for (int y = 0; y < surface_height; ++y){
-			line_data = data + stride * y;
-			for (int x = 0; x < surface_width; ++x){
-				int dx = -(x - surface_width / 2);
-				int dy = y - surface_height / 2;
-				int dist = dx * dx + dy * dy;
-				if ((dist >= inner_radius_sq) && (dist <= radius_sq)){
-					double angle = atan2((double)dx, (double)dy) + math::PI;
-					wheel->hue_to_hsl(angle / (math::PI * 2), &c);
-					c = c.hslToRgb();
-					line_data[2] = static_cast<uint8_t>(c.rgb.red * 255);
-					line_data[1] = static_cast<uint8_t>(c.rgb.green * 255);
-					line_data[0] = static_cast<uint8_t>(c.rgb.blue * 255);
-					line_data[3] = 0xFF;
-				}
-				line_data += 4;
-			}
+		double dy = y * step - center;
+		for (size_t x = 0; x < row.size; ++x){
+			double dx = -(x * step - center);
+			double angle = atan2(dx, dy) + math::PI;
+			wheel->hue_to_hsl(angle / (math::PI * 2), &c);
+			row.data[0][x] = c.hsl.hue;
+			row.data[1][x] = c.hsl.saturation;
+			row.data[2][x] = c.hsl.lightness;
 		}
-		ns->cache_color_wheel = surface;
-	}
-	cairo_surface_mark_dirty(surface);
+		color_batch::hslToRgb(row);
+	});
+	if (!surface) return;
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, 0, 0);
 	cairo_set_line_width(cr, width);
@@ -371,12 +338,13 @@ static gboolean motion_notify(GtkWidget *widget, GdkEventMotion *event)
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
 	GtkColorWheelPrivate *ns = GET_PRIVATE(widget);
-	draw_wheel(ns, cr, ns->radius, ns->circle_width, ns->color_wheel_type);
+	int scale = TileRenderer::scale(widget);
+	draw_wheel(ns, scale, cr, ns->radius, ns->circle_width, ns->color_wheel_type);
 	if (ns->selected){
 		double block_size = 2 * (ns->radius - ns->circle_width) * sin(math::PI / 4) - 6;
 		Color hsl;
 		ns->color_wheel_type->hue_to_hsl(ns->selected->hue, &hsl);
-		draw_sat_val_block(cr, ns->radius, ns->radius, block_size, hsl.hsl.hue);
+		draw_sat_val_block(ns, scale, cr, ns->radius, ns->radius, block_size, hsl.hsl.hue);
 		draw_dot(cr, ns->radius - block_size / 2 + block_size * ns->selected->saturation, ns->radius - block_size / 2 + block_size * ns->selected->lightness, 4);
 	}
 	for (uint32_t i = 0; i != ns->n_cpoint; i++){
@@ -210,7 +210,7 @@ void gtk_color_set_hcenter(GtkColor* widget, bool hcenter)
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
 	GtkColorPrivate *ns = GET_PRIVATE(widget);
-	Color color, split_color;
+	Color color, split_color, text_color;
 #if GTK_MAJOR_VERSION >= 3
 	int width = gtk_widget_get_allocated_width(widget), height = gtk_widget_get_allocated_height(widget);
 #else
@@ -220,15 +220,16 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 #endif
 	bool sensitive = gtk_widget_get_sensitive(widget);
 	if (ns->transformation_chain){
-		ns->transformation_chain->apply(&ns->color, &color);
-		if (ns->split){
-			ns->transformation_chain->apply(&ns->split_color, &split_color);
-		}
+		// All widget colors are transformed in one batch.
+		Color colors[3] = { ns->color, ns->split_color, ns->text_color };
+		ns->transformation_chain->apply(common::Span<const Color>(colors, 3), common::Span<Color>(colors, 3));
+		color = colors[0];
+		split_color = colors[1];
+		text_color = ns->secondary_color ? colors[2] : ns->text_color;
 	}else{
 		color = ns->color;
-		if (ns->split){
-			split_color = ns->split_color;
-		}
+		split_color = ns->split_color;
+		text_color = ns->text_color;
 	}
 	if (ns->rounded_rectangle){
 		if (sensitive){
@@ -287,16 +288,7 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 		pango_font_description_set_absolute_size(font_description, 14 * PANGO_SCALE);
 		pango_layout_set_font_description(layout, font_description);
 		pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
-		if (ns->transformation_chain){
-			if (ns->secondary_color){
-				ns->transformation_chain->apply(&ns->text_color, &color);
-			}else{
-				color = ns->text_color;
-			}
-		}else{
-			color = ns->text_color;
-		}
-		gtk::setColor(cr, color);
+		gtk::setColor(cr, text_color);
 		pango_layout_set_markup(layout, ns->text.c_str(), -1);
 		pango_layout_set_width(layout, (width - 10) * PANGO_SCALE);
 		pango_layout_set_height(layout, height * PANGO_SCALE);
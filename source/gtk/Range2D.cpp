@@ -18,6 +18,7 @@
 
 #include "Range2D.h"
 #include "Color.h"
+#include "TileRenderer.h"
 using namespace std;
 
 enum {
@@ -31,7 +32,7 @@ struct GtkRange2DPrivate {
 	char *yname;
 	float block_size;
 	bool grab_block;
-	cairo_surface_t *cache_range_2d;
+	TileRenderer *tiles;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *pointer_grab;
 #endif
@@ -51,10 +52,7 @@ static void finalize(GObject *range_2d_obj)
 	GtkRange2DPrivate *ns = GET_PRIVATE(range_2d_obj);
 	if (ns->xname) g_free(ns->xname);
 	if (ns->yname) g_free(ns->yname);
-	if (ns->cache_range_2d){
-		cairo_surface_destroy(ns->cache_range_2d);
-		ns->cache_range_2d = 0;
-	}
+	delete ns->tiles;
 	gpointer parent_class = g_type_class_peek_parent(G_OBJECT_CLASS(GTK_RANGE_2D_GET_CLASS(range_2d_obj)));
 	G_OBJECT_CLASS(parent_class)->finalize(range_2d_obj);
 }
@@ -90,7 +88,7 @@ GtkWidget* gtk_range_2d_new()
 #else
 	gtk_widget_set_size_request(GTK_WIDGET(widget), static_cast<int>(ns->block_size + widget->style->xthickness * 2), static_cast<int>(ns->block_size + widget->style->ythickness * 2));
 #endif
-	ns->cache_range_2d = 0;
+	ns->tiles = new TileRenderer();
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointer_grab = nullptr;
 #endif
@@ -125,37 +123,28 @@ static void draw_dot(cairo_t *cr, double x, double y, double size)
 	cairo_set_line_width(cr, 1);
 	cairo_stroke(cr);
 }
-static void draw_sat_val_block(GtkRange2DPrivate *ns, cairo_t *cr, double pos_x, double pos_y, double size)
+static void draw_sat_val_block(GtkRange2DPrivate *ns, int scale, cairo_t *cr, double pos_x, double pos_y, double size)
 {
-	cairo_surface_t *surface;
-	if (ns->cache_range_2d){
-		surface = ns->cache_range_2d;
-	}else{
-		surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(size)), static_cast<int>(std::ceil(size)));
-		unsigned char *data = cairo_image_surface_get_data(surface);
-		int stride = cairo_image_surface_get_stride(surface);
-		int surface_width = cairo_image_surface_get_width(surface);
-		int surface_height = cairo_image_surface_get_height(surface);
+	int surface_size = static_cast<int>(std::ceil(size));
+	float step = static_cast<float>(1.0 / scale);
+	float inverse_size = static_cast<float>(1 / size);
+	cairo_surface_t *surface = ns->tiles->render({static_cast<float>(size)}, surface_size, surface_size, scale, [step, inverse_size](int y, const color_batch::Channels &row){
 		float v;
-		uint8_t *line_data;
-		for (int y = 0; y < surface_height; ++y){
-			line_data = data + stride * y;
-			for (int x = 0; x < surface_width; ++x){
-				if ((x % 16 < 8) ^ (y % 16 < 8) ){
-					v = math::mix(0.5f, 1.0f, static_cast<float>(std::pow(x / size, 2)));
-				}else{
-					v = math::mix(0.5f, 0.0f, static_cast<float>(std::pow(1 - (y / size), 2)));
-				}
-				line_data[2] = static_cast<uint8_t>(v * 255);
-				line_data[1] = static_cast<uint8_t>(v / 2 * 255);
-				line_data[0] = static_cast<uint8_t>(v / 4 * 255);
-				line_data[3] = 0xFF;
-				line_data += 4;
+		int logical_y = static_cast<int>(y * step);
+		float vertical = math::mix(0.5f, 0.0f, std::pow(1 - (y * step * inverse_size), 2.0f));
+		for (size_t x = 0; x < row.size; ++x){
+			int logical_x = static_cast<int>(x * step);
+			if ((logical_x % 16 < 8) ^ (logical_y % 16 < 8)){
+				v = math::mix(0.5f, 1.0f, std::pow(x * step * inverse_size, 2.0f));
+			}else{
+				v = vertical;
 			}
+			row.data[0][x] = v;
+			row.data[1][x] = v / 2;
+			row.data[2][x] = v / 4;
 		}
-		ns->cache_range_2d = surface;
-	}
-	cairo_surface_mark_dirty(surface);
+	});
+	if (!surface) return;
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, pos_x, pos_y);
 	cairo_rectangle(cr, pos_x, pos_y, size, size);
@@ -184,7 +173,7 @@ static gboolean motion_notify(GtkWidget *widget, GdkEventMotion *event)
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
 	GtkRange2DPrivate *ns = GET_PRIVATE(widget);
-	draw_sat_val_block(ns, cr, 0, 0, ns->block_size);
+	draw_sat_val_block(ns, TileRenderer::scale(widget), cr, 0, 0, ns->block_size);
 	draw_dot(cr, ns->block_size * ns->x, ns->block_size * ns->y, 6);
 	if (ns->xname){
 		PangoLayout *layout;
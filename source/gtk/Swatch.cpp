@@ -19,6 +19,7 @@
 #include "Swatch.h"
 #include "Color.h"
 #include <math.h>
+#include <algorithm>
 #include <boost/math/special_functions/round.hpp>
 
 enum {
@@ -265,48 +266,34 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 	draw_hexagon(cr, radius_multi * std::cos(rotation + (ns->current_color) * (2 * math::PI) / edges), radius_multi * std::sin(rotation + (ns->current_color) * (2
 			* math::PI) / edges), 27);
 	cairo_stroke(cr);
-	Color color;
+	Color colors[7];
+	if (ns->transformation_chain) {
+		ns->transformation_chain->apply(common::Span<const Color>(ns->color, 7), common::Span<Color>(colors, 7));
+	} else {
+		std::copy(ns->color, ns->color + 7, colors);
+	}
 	//Draw fill
 	for (int i = 1; i < 7; ++i) {
 		if (i == ns->current_color)
 			continue;
-		if (ns->transformation_chain){
-			ns->transformation_chain->apply(&ns->color[i], &color);
-		}else{
-			color = ns->color[i];
-		}
+		const Color &color = colors[i];
 		cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 		draw_hexagon(cr, radius_multi * std::cos(rotation + i * (2 * math::PI) / edges), radius_multi * std::sin(rotation + i * (2 * math::PI) / edges), 25.5);
 		cairo_fill(cr);
 	}
-	if (ns->transformation_chain){
-		ns->transformation_chain->apply(&ns->color[ns->current_color], &color);
-	}else{
-		color = ns->color[ns->current_color];
-	}
-	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
+	const Color &current = colors[ns->current_color];
+	cairo_set_source_rgb(cr, boost::math::round(current.rgb.red * 255.0) / 255.0, boost::math::round(current.rgb.green * 255.0) / 255.0, boost::math::round(current.rgb.blue * 255.0) / 255.0);
 	draw_hexagon(cr, radius_multi * std::cos(rotation + (ns->current_color) * (2 * math::PI) / edges), radius_multi * std::sin(rotation + (ns->current_color) * (2 * math::PI) / edges), 25.5);
 	cairo_fill(cr);
 	//Draw center
-	if (ns->transformation_chain){
-		ns->transformation_chain->apply(&ns->color[0], &color);
-	}else{
-		color = ns->color[0];
-	}
-	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
+	const Color &center = colors[0];
+	cairo_set_source_rgb(cr, boost::math::round(center.rgb.red * 255.0) / 255.0, boost::math::round(center.rgb.green * 255.0) / 255.0, boost::math::round(center.rgb.blue * 255.0) / 255.0);
 	draw_hexagon(cr, 0, 0, 25.5);
 	cairo_fill(cr);
 	//Draw numbers
 	char numb[2] = " ";
 	for (int i = 1; i < 7; ++i) {
-		Color c;
-		if (ns->transformation_chain){
-			Color t;
-			ns->transformation_chain->apply(&ns->color[i], &t);
-			c = t.getContrasting();
-		}else{
-			c = ns->color[i].getContrasting();
-		}
+		Color c = colors[i].getContrasting();
 		cairo_text_extents_t extends;
 		numb[0] = '0' + i;
 		cairo_text_extents(cr, numb, &extends);
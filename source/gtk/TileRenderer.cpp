@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "TileRenderer.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <iostream>
+
+// Rows are split between threads only when each thread gets at least this many pixels.
+static const size_t minPixelsPerThread = 16384;
+TileRenderer::TileRenderer():
+	m_surface(nullptr),
+	m_width(0),
+	m_height(0),
+	m_scale(0) {
+}
+TileRenderer::~TileRenderer() {
+	reset();
+}
+void TileRenderer::reset() {
+	if (m_surface) {
+		cairo_surface_destroy(m_surface);
+		m_surface = nullptr;
+	}
+	m_key.clear();
+}
+cairo_surface_t *TileRenderer::render(std::initializer_list<float> key, int width, int height, int scale, const Row &row) {
+	scale = std::max(scale, 1);
+	if (m_surface && m_width == width && m_height == height && m_scale == scale && std::equal(key.begin(), key.end(), m_key.begin(), m_key.end()))
+		return m_surface;
+	if (!m_surface || m_width != width || m_height != height || m_scale != scale) {
+		reset();
+		cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width * scale, height * scale);
+		if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+			std::cerr << "Tile image surface allocation failed" << std::endl;
+			cairo_surface_destroy(surface);
+			return nullptr;
+		}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 14, 0)
+		cairo_surface_set_device_scale(surface, scale, scale);
+#endif
+		m_surface = surface;
+		m_width = width;
+		m_height = height;
+		m_scale = scale;
+	}
+	m_key.assign(key.begin(), key.end());
+	cairo_surface_flush(m_surface);
+	unsigned char *data = cairo_image_surface_get_data(m_surface);
+	int stride = cairo_image_surface_get_stride(m_surface);
+	size_t surfaceWidth = cairo_image_surface_get_width(m_surface);
+	size_t surfaceHeight = cairo_image_surface_get_height(m_surface);
+	common::parallelFor(surfaceHeight, std::max<size_t>(minPixelsPerThread / std::max<size_t>(surfaceWidth, 1), 1), [&](size_t begin, size_t end) {
+		std::vector<float> buffer(surfaceWidth * 3);
+		color_batch::Channels channels(buffer.data(), buffer.data() + surfaceWidth, buffer.data() + surfaceWidth * 2, surfaceWidth);
+		for (size_t y = begin; y < end; y++) {
+			row(static_cast<int>(y), channels);
+			color_batch::rgbToArgb32(channels, reinterpret_cast<uint32_t *>(data + stride * y));
+		}
+	});
+	cairo_surface_mark_dirty(m_surface);
+	return m_surface;
+}
+int TileRenderer::scale(GtkWidget *widget) {
+#if GTK_MAJOR_VERSION >= 3
+	return std::max(gtk_widget_get_scale_factor(widget), 1);
+#else
+	return 1;
+#endif
+}
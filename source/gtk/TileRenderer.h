@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_GTK_TILE_RENDERER_H_
+#define GPICK_GTK_TILE_RENDERER_H_
+
+#include "ColorBatch.h"
+#include <gtk/gtk.h>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/** \struct TileRenderer
+ * \brief Procedurally rendered image surface, which is reused until its key, size or scale changes.
+ *
+ * Rows are rendered on multiple threads. Each row is filled with RGB values by a callback and then packed into surface pixels.
+ */
+struct TileRenderer {
+	/** Callable with (int y, const color_batch::Channels &row) parameters, filling device pixel row y with RGB values. */
+	using Row = std::function<void(int, const color_batch::Channels &)>;
+	TileRenderer();
+	TileRenderer(const TileRenderer &) = delete;
+	~TileRenderer();
+	TileRenderer &operator=(const TileRenderer &) = delete;
+	/**
+	 * Get surface, rendering it again only when key, size or scale differ from previous call.
+	 * @param[in] key Values which fully determine surface contents, for example hue.
+	 * @param[in] width Surface width in logical pixels.
+	 * @param[in] height Surface height in logical pixels.
+	 * @param[in] scale Device scale. Surface has width * scale by height * scale device pixels.
+	 * @param[in] row Row callback. Called from multiple threads at once.
+	 * @return Surface owned by renderer or nullptr if surface allocation failed.
+	 */
+	cairo_surface_t *render(std::initializer_list<float> key, int width, int height, int scale, const Row &row);
+	/**
+	 * Drop cached surface, so next render() call renders it again.
+	 */
+	void reset();
+	/**
+	 * Get device scale of widget window.
+	 * @param[in] widget Widget.
+	 * @return Device scale, at least 1.
+	 */
+	static int scale(GtkWidget *widget);
+private:
+	cairo_surface_t *m_surface;
+	std::vector<float> m_key;
+	int m_width, m_height, m_scale;
+};
+
+#endif /* GPICK_GTK_TILE_RENDERER_H_ */
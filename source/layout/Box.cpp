@@ -145,10 +145,7 @@ void Text::draw(Context &context, const math::Rectanglef &parentRect) {
 		math::Vector2f textOffset(0, 0);
 		if (style()) {
 			pango_font_description_set_absolute_size(fontDescription, style()->fontSize() * drawRect.getHeight() * PANGO_SCALE);
-			Color color = style()->color();
-			if (context.getTransformationChain()) {
-				context.getTransformationChain()->apply(&color, &color);
-			}
+			Color color = context.styleColor(*style());
 			cairo_set_source_rgba(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0, color.alpha);
 			textOffset = style()->textOffset() * math::Vector2f(drawRect.getWidth(), drawRect.getHeight());
 		} else {
@@ -200,10 +197,7 @@ Fill &Fill::setHelperOnly(bool helperOnly) {
 void Fill::draw(Context &context, const math::Rectanglef &parentRect) {
 	math::Rectanglef drawRect = rect().impose(parentRect);
 	cairo_t *cr = context.getCairo();
-	Color color = style()->color();
-	if (context.getTransformationChain()) {
-		context.getTransformationChain()->apply(&color, &color);
-	}
+	Color color = context.styleColor(*style());
 	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 	cairo_rectangle(cr, drawRect.getX(), drawRect.getY(), drawRect.getWidth(), drawRect.getHeight());
 	cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
@@ -239,10 +233,7 @@ Circle &Circle::setHelperOnly(bool helperOnly) {
 void Circle::draw(Context &context, const math::Rectanglef &parentRect) {
 	math::Rectanglef drawRect = rect().impose(parentRect);
 	cairo_t *cr = context.getCairo();
-	Color color = style()->color();
-	if (context.getTransformationChain()) {
-		context.getTransformationChain()->apply(&color, &color);
-	}
+	Color color = context.styleColor(*style());
 	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 	cairo_save(cr);
 	cairo_translate(cr, drawRect.getX() + drawRect.getWidth() / 2, drawRect.getY() + drawRect.getHeight() / 2);
@@ -298,10 +289,7 @@ Pie &Pie::setHelperOnly(bool helperOnly) {
 void Pie::draw(Context &context, const math::Rectanglef &parentRect) {
 	math::Rectanglef drawRect = rect().impose(parentRect);
 	cairo_t *cr = context.getCairo();
-	Color color = style()->color();
-	if (context.getTransformationChain()) {
-		context.getTransformationChain()->apply(&color, &color);
-	}
+	Color color = context.styleColor(*style());
 	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 	cairo_save(cr);
 	cairo_translate(cr, drawRect.getX() + drawRect.getWidth() / 2, drawRect.getY() + drawRect.getHeight() / 2);
@@ -17,11 +17,24 @@
  */
 
 #include "Context.h"
+#include "System.h"
+#include "Style.h"
+#include <vector>
 namespace layout {
 Context::Context(System &system, cairo_t *cr, transformation::Chain *chain):
 	m_system(system),
 	m_cr(cr),
 	m_chain(chain) {
+	if (!m_chain)
+		return;
+	const auto &styles = m_system.styles();
+	std::vector<Color> colors;
+	colors.reserve(styles.size());
+	for (const auto &style: styles)
+		colors.push_back(style->color());
+	m_chain->apply(common::Span<const Color>(colors.data(), colors.size()), common::Span<Color>(colors.data(), colors.size()));
+	for (size_t i = 0; i < styles.size(); i++)
+		m_styleColors.emplace(styles[i].pointer(), colors[i]);
 }
 Context::~Context() {
 }
@@ -31,6 +44,16 @@ cairo_t *Context::getCairo() const {
 transformation::Chain *Context::getTransformationChain() const {
 	return m_chain;
 }
+Color Context::styleColor(const Style &style) const {
+	Color color = style.color();
+	if (!m_chain)
+		return color;
+	auto i = m_styleColors.find(&style);
+	if (i != m_styleColors.end())
+		return i->second;
+	m_chain->apply(&color, &color);
+	return color;
+}
 System &Context::system() {
 	return m_system;
 }
@@ -18,20 +18,31 @@
 
 #ifndef GPICK_LAYOUT_CONTEXT_H_
 #define GPICK_LAYOUT_CONTEXT_H_
+#include "Color.h"
 #include "transformation/Chain.h"
 #include <cairo/cairo.h>
+#include <unordered_map>
 namespace layout {
 struct System;
+struct Style;
 struct Context {
 	Context(System &system, cairo_t *cr, transformation::Chain *chain);
 	~Context();
 	cairo_t *getCairo() const;
 	transformation::Chain *getTransformationChain() const;
+	/**
+	 * Get style color with transformation chain applied.
+	 * Colors of all system styles are transformed in one batch when context is created.
+	 * @param[in] style Style.
+	 * @return Transformed color.
+	 */
+	Color styleColor(const Style &style) const;
 	System &system();
 private:
 	System &m_system;
 	cairo_t *m_cr;
 	transformation::Chain *m_chain;
+	std::unordered_map<const Style *, Color> m_styleColors;
 };
 }
 #endif /* GPICK_LAYOUT_CONTEXT_H_ */
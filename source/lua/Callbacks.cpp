@@ -21,7 +21,8 @@
 using namespace std;
 namespace lua
 {
-Callbacks::Callbacks()
+Callbacks::Callbacks():
+	m_component_to_text_revision(0)
 {
 }
 Ref &Callbacks::optionChange()
@@ -39,5 +40,10 @@ Ref &Callbacks::componentToText()
 void Callbacks::componentToText(Ref &&ref)
 {
 	m_component_to_text = move(ref);
+	m_component_to_text_revision++;
+}
+uint32_t Callbacks::componentToTextRevision() const
+{
+	return m_component_to_text_revision;
 }
 }
@@ -19,6 +19,7 @@
 #ifndef GPICK_LUA_CALLBACKS_H_
 #define GPICK_LUA_CALLBACKS_H_
 #include "Ref.h"
+#include <cstdint>
 namespace lua
 {
 struct Callbacks
@@ -30,9 +31,15 @@ struct Callbacks
 	void optionChange(Ref &&ref);
 	Ref &componentToText();
 	void componentToText(Ref &&ref);
+	/**
+	 * Get number of times component to text callback was set. Allows detecting callback changes.
+	 * @return Revision number.
+	 */
+	uint32_t componentToTextRevision() const;
 	private:
 	Ref m_option_change;
 	Ref m_component_to_text;
+	uint32_t m_component_to_text_revision;
 };
 }
 #endif /* GPICK_LUA_CALLBACKS_H_ */
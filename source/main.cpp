@@ -17,11 +17,11 @@
  */
 
 #include "main.h"
-#include "Paths.h"
 #include "uiAbout.h"
 #include "uiApp.h"
 #include "I18N.h"
 #include "version/Version.h"
+#include "color_names/ColorNames.h"
 #include <gtk/gtk.h>
 #include <string>
 #include <iostream>
@@ -37,6 +37,7 @@ static gboolean single_color_pick_mode = FALSE;
 static gboolean version_information = FALSE;
 static gboolean do_not_start = FALSE;
 static gchar *converter_name = nullptr;
+static gchar *compile_dictionary = nullptr;
 static GOptionEntry commandline_entries[] =
 {
 	{"geometry", 'g', 0, G_OPTION_ARG_STRING, &commandline_geometry, "Window geometry", "GEOMETRY"},
@@ -46,6 +47,7 @@ static GOptionEntry commandline_entries[] =
 	{"no-newline", 0, 0, G_OPTION_ARG_NONE, &output_without_newline, "Output picked color without newline", nullptr},
 	{"no-start", 0, 0, G_OPTION_ARG_NONE, &do_not_start, "Do not start Gpick if it is not already running", nullptr},
 	{"converter-name", 'c', 0, G_OPTION_ARG_STRING, &converter_name, "Converter name used for floating picker mode", nullptr},
+	{"compile-dictionary", 0, 0, G_OPTION_ARG_FILENAME, &compile_dictionary, "Convert color dictionary into binary format and exit", "FILE"},
 	{"version", 'v', 0, G_OPTION_ARG_NONE, &version_information, "Print version information", nullptr},
 	{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &commandline_filename, nullptr, "[FILE...]"},
 	{nullptr}
@@ -53,13 +55,14 @@ static GOptionEntry commandline_entries[] =
 int main(int argc, char **argv)
 {
 	std::setlocale(LC_ALL, "");
-	gtk_init(&argc, &argv);
+	// Display is not needed to print version or compile dictionary, which is done during build.
+	bool display_available = gtk_init_check(&argc, &argv);
 	initialize_i18n();
 	g_set_application_name(program_name);
 	GError *error = nullptr;
 	GOptionContext *context = g_option_context_new("- advanced color picker");
 	g_option_context_add_main_entries(context, commandline_entries, 0);
-	g_option_context_add_group(context, gtk_get_option_group(TRUE));
+	g_option_context_add_group(context, gtk_get_option_group(display_available));
 	gchar **argv_copy;
 #ifdef WIN32
 	argv_copy = g_win32_get_command_line();
@@ -79,6 +82,31 @@ int main(int argc, char **argv)
 		g_strfreev(argv_copy);
 		return 0;
 	}
+	if (compile_dictionary){
+		std::string source = compile_dictionary, destination;
+		if (commandline_filename){
+			destination = commandline_filename[0];
+		}else{
+			auto extension = source.rfind('.');
+			auto separator = source.find_last_of("/\\");
+			if (extension != std::string::npos && (separator == std::string::npos || extension > separator))
+				destination = source.substr(0, extension) + ".gpd";
+			else
+				destination = source + ".gpd";
+		}
+		int return_value = color_names_compile(source, destination);
+		if (return_value != 0)
+			std::cerr << "Failed to convert color dictionary \"" << source << "\" into \"" << destination << "\"\n";
+		g_option_context_free(context);
+		g_strfreev(argv_copy);
+		return return_value;
+	}
+	if (!display_available){
+		std::cerr << "Cannot open display\n";
+		g_option_context_free(context);
+		g_strfreev(argv_copy);
+		return 1;
+	}
 	StartupOptions options;
 	options.floating_picker_mode = pick_color;
 	options.output_picked_color = output_picked_color;
@@ -96,8 +124,7 @@ int main(int argc, char **argv)
 				app_load_file(args, commandline_filename[0]);
 			}else{
 				if (app_is_autoload_enabled(args)){
-					auto autosaveFile = buildConfigPath("autosave.gpa");
-					app_load_file(args, autosaveFile, true);
+					app_load_autosave(args);
 				}
 			}
 		}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorHistogram.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <cmath>
+namespace math {
+// Linear values are stored as fixed point numbers, so that sums are exact and do not depend on addition order.
+static const double fixedPointScale = 1 << 20;
+ColorHistogram::ColorHistogram(uint8_t bitsPerChannel):
+	m_bitsPerChannel(std::clamp(bitsPerChannel, minBitsPerChannel, maxBitsPerChannel)),
+	m_bins(new Bin[size_t(1) << (3 * m_bitsPerChannel)]) {
+	for (int i = 0; i < 256; i++)
+		m_linearValues[i] = static_cast<uint32_t>(std::lround(Color::linearRgbFromUint8(static_cast<uint8_t>(i)) * fixedPointScale));
+	clear();
+}
+void ColorHistogram::clear() {
+	for (size_t i = 0, count = binCount(); i < count; i++) {
+		auto &bin = m_bins[i];
+		bin.pixels.store(0, std::memory_order_relaxed);
+		for (auto &sum: bin.sums)
+			sum.store(0, std::memory_order_relaxed);
+	}
+}
+uint8_t ColorHistogram::bitsPerChannel() const {
+	return m_bitsPerChannel;
+}
+size_t ColorHistogram::binCount() const {
+	return size_t(1) << (3 * m_bitsPerChannel);
+}
+uint64_t ColorHistogram::totalPixels() const {
+	uint64_t result = 0;
+	for (size_t i = 0, count = binCount(); i < count; i++)
+		result += m_bins[i].pixels.load(std::memory_order_relaxed);
+	return result;
+}
+size_t ColorHistogram::binIndex(uint8_t red, uint8_t green, uint8_t blue) const {
+	const int shift = 8 - m_bitsPerChannel;
+	return (static_cast<size_t>(red >> shift) << (2 * m_bitsPerChannel)) | (static_cast<size_t>(green >> shift) << m_bitsPerChannel) | static_cast<size_t>(blue >> shift);
+}
+Color ColorHistogram::binColor(size_t index, uint64_t pixels) const {
+	const auto &bin = m_bins[index];
+	const double scale = 1 / (fixedPointScale * static_cast<double>(pixels));
+	return Color(static_cast<float>(bin.sums[0].load(std::memory_order_relaxed) * scale), static_cast<float>(bin.sums[1].load(std::memory_order_relaxed) * scale), static_cast<float>(bin.sums[2].load(std::memory_order_relaxed) * scale), 1.0f);
+}
+void ColorHistogram::add(uint8_t red, uint8_t green, uint8_t blue, uint32_t pixels) {
+	auto &bin = m_bins[binIndex(red, green, blue)];
+	bin.pixels.fetch_add(pixels, std::memory_order_relaxed);
+	bin.sums[0].fetch_add(static_cast<uint64_t>(m_linearValues[red]) * pixels, std::memory_order_relaxed);
+	bin.sums[1].fetch_add(static_cast<uint64_t>(m_linearValues[green]) * pixels, std::memory_order_relaxed);
+	bin.sums[2].fetch_add(static_cast<uint64_t>(m_linearValues[blue]) * pixels, std::memory_order_relaxed);
+}
+void ColorHistogram::addImage(const uint8_t *data, int width, int height, int stride, int channels, int step) {
+	if (width <= 0 || height <= 0 || channels <= 0)
+		return;
+	step = std::max(step, 1);
+	const int rows = (height + step - 1) / step, columns = (width + step - 1) / step;
+	const int pixelsPerChunk = 1 << 16;
+	const ptrdiff_t pixelStep = static_cast<ptrdiff_t>(channels) * step;
+	common::parallelFor(rows, std::max(1, pixelsPerChunk / columns), [=](size_t begin, size_t end) {
+		for (size_t row = begin; row < end; row++) {
+			const uint8_t *pixel = data + static_cast<ptrdiff_t>(stride) * static_cast<ptrdiff_t>(row * step);
+			// Runs of equal pixels are added at once, which avoids contention on bins of large single colored areas.
+			uint8_t red = 0, green = 0, blue = 0;
+			uint32_t run = 0;
+			for (int x = 0; x < columns; x++, pixel += pixelStep) {
+				uint8_t r = pixel[0], g = channels >= 3 ? pixel[1] : r, b = channels >= 3 ? pixel[2] : r;
+				if (run > 0 && r == red && g == green && b == blue) {
+					run++;
+					continue;
+				}
+				if (run > 0)
+					add(red, green, blue, run);
+				red = r;
+				green = g;
+				blue = b;
+				run = 1;
+			}
+			if (run > 0)
+				add(red, green, blue, run);
+		}
+	});
+}
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+namespace math {
+/** \struct ColorHistogram
+ * \brief Packed RGB histogram of 8-bit images, which can be filled from multiple threads at once.
+ *
+ * Each bin counts pixels and sums their linear RGB values in fixed point. Bins are updated with relaxed atomic additions of integers,
+ * so the histogram contents do not depend on the number of threads or the order of additions.
+ * Color::initialize() must be called before use.
+ */
+struct ColorHistogram {
+	static constexpr uint8_t minBitsPerChannel = 4;
+	static constexpr uint8_t maxBitsPerChannel = 7;
+	/**
+	 * Create empty histogram.
+	 * @param[in] bitsPerChannel Number of most significant bits of each 8-bit channel used for bin selection. Histogram has 2^(3 * bitsPerChannel) bins.
+	 */
+	ColorHistogram(uint8_t bitsPerChannel = 6);
+	ColorHistogram(const ColorHistogram &) = delete;
+	ColorHistogram &operator=(const ColorHistogram &) = delete;
+	void clear();
+	/**
+	 * Add pixels of the same color. Can be called from multiple threads at once.
+	 * @param[in] red Red value.
+	 * @param[in] green Green value.
+	 * @param[in] blue Blue value.
+	 * @param[in] pixels Pixel count.
+	 */
+	void add(uint8_t red, uint8_t green, uint8_t blue, uint32_t pixels = 1);
+	/**
+	 * Add pixels of 8-bit image. Rows are processed on multiple threads.
+	 * @param[in] data Image data.
+	 * @param[in] width Image width.
+	 * @param[in] height Image height.
+	 * @param[in] stride Distance between rows in bytes.
+	 * @param[in] channels Number of channels. Single channel images are treated as grayscale, channels after the third are ignored.
+	 * @param[in] step Subsampling step. Only every step-th pixel of every step-th row, starting with the first row and column, is added.
+	 */
+	void addImage(const uint8_t *data, int width, int height, int stride, int channels, int step = 1);
+	uint8_t bitsPerChannel() const;
+	size_t binCount() const;
+	uint64_t totalPixels() const;
+	/**
+	 * Visit all non-empty bins in bin order.
+	 * @param[in] callback Callable with (const Color &color, uint64_t pixels) parameters. Color is the average bin color in linear RGB color space.
+	 */
+	template<typename Callback>
+	void visit(Callback &&callback) const {
+		for (size_t i = 0, count = binCount(); i < count; i++) {
+			uint64_t pixels = m_bins[i].pixels.load(std::memory_order_relaxed);
+			if (pixels == 0)
+				continue;
+			callback(binColor(i, pixels), pixels);
+		}
+	}
+private:
+	struct Bin {
+		std::atomic<uint64_t> pixels;
+		std::atomic<uint64_t> sums[3];
+	};
+	uint8_t m_bitsPerChannel;
+	std::unique_ptr<Bin[]> m_bins;
+	std::array<uint32_t, 256> m_linearValues;
+	size_t binIndex(uint8_t red, uint8_t green, uint8_t blue) const;
+	Color binColor(size_t index, uint64_t pixels) const;
+};
+}
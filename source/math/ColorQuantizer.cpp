@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorQuantizer.h"
+#include "ColorHistogram.h"
+#include "OctreeColorQuantization.h"
+#include "ColorBatch.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+namespace math {
+namespace {
+// Histogram colors with coordinates in the color space used for distance calculations.
+struct Samples {
+	Samples(const ColorHistogram &histogram, size_t padding = 1) {
+		histogram.visit([this](const Color &color, uint64_t pixels) {
+			colors.push_back(color);
+			this->pixels.push_back(pixels);
+		});
+		count = colors.size();
+		size_t paddedCount = (count + padding - 1) / padding * padding;
+		for (auto &channel: coordinates)
+			channel.resize(paddedCount, 0.0f);
+		for (size_t i = 0; i < count; i++) {
+			for (int j = 0; j < 3; j++)
+				coordinates[j][i] = colors[i][j];
+		}
+	}
+	color_batch::Channels channels() {
+		return color_batch::Channels(coordinates[0].data(), coordinates[1].data(), coordinates[2].data(), count);
+	}
+	size_t count;
+	std::vector<Color> colors;
+	std::vector<uint64_t> pixels;
+	std::array<std::vector<float>, 3> coordinates;
+};
+struct Sum {
+	double coordinates[3] = { 0, 0, 0 };
+	double color[3] = { 0, 0, 0 };
+	uint64_t pixels = 0;
+	void add(const Samples &samples, size_t index) {
+		const double weight = static_cast<double>(samples.pixels[index]);
+		for (int j = 0; j < 3; j++) {
+			coordinates[j] += samples.coordinates[j][index] * weight;
+			color[j] += samples.colors[index][j] * weight;
+		}
+		pixels += samples.pixels[index];
+	}
+	QuantizedColor result() const {
+		const double scale = 1.0 / static_cast<double>(pixels);
+		return QuantizedColor { Color(static_cast<float>(color[0] * scale), static_cast<float>(color[1] * scale), static_cast<float>(color[2] * scale), 1.0f), pixels };
+	}
+};
+}
+std::vector<QuantizedColor> OctreeQuantizer::quantize(const ColorHistogram &histogram, size_t numberOfColors) const {
+	OctreeColorQuantization octree;
+	octree.add(histogram);
+	octree.reduce(std::max<size_t>(numberOfColors, 1));
+	std::vector<QuantizedColor> result;
+	octree.visit([&result](const float sum[3], size_t pixels) {
+		result.push_back(QuantizedColor { Color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f), pixels });
+	});
+	return result;
+}
+namespace {
+struct Box {
+	size_t begin, end;
+	uint8_t channel;
+	double error;
+};
+Box makeBox(const Samples &samples, size_t begin, size_t end) {
+	double sums[3] = { 0, 0, 0 }, squareSums[3] = { 0, 0, 0 }, pixels = 0;
+	for (size_t i = begin; i < end; i++) {
+		const double weight = static_cast<double>(samples.pixels[i]);
+		for (int j = 0; j < 3; j++) {
+			const double value = samples.coordinates[j][i];
+			sums[j] += value * weight;
+			squareSums[j] += value * value * weight;
+		}
+		pixels += weight;
+	}
+	Box box { begin, end, 0, 0 };
+	double maxError = -1;
+	for (uint8_t j = 0; j < 3; j++) {
+		double error = std::max(0.0, squareSums[j] - sums[j] * sums[j] / pixels);
+		box.error += error;
+		if (error > maxError) {
+			maxError = error;
+			box.channel = j;
+		}
+	}
+	if (end - begin < 2)
+		box.error = 0;
+	return box;
+}
+}
+std::vector<QuantizedColor> MedianCutQuantizer::quantize(const ColorHistogram &histogram, size_t numberOfColors) const {
+	Samples samples(histogram);
+	if (samples.count == 0 || numberOfColors == 0)
+		return {};
+	color_batch::nonLinearRgb(samples.channels());
+	std::vector<size_t> order(samples.count);
+	for (size_t i = 0; i < samples.count; i++)
+		order[i] = i;
+	std::vector<Box> boxes;
+	boxes.push_back(makeBox(samples, 0, samples.count));
+	// Samples are reordered through an index, so that coordinates of each box stay continuous after sorting.
+	Samples sorted = samples;
+	auto applyOrder = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			size_t index = order[i];
+			sorted.colors[i] = samples.colors[index];
+			sorted.pixels[i] = samples.pixels[index];
+			for (int j = 0; j < 3; j++)
+				sorted.coordinates[j][i] = samples.coordinates[j][index];
+		}
+	};
+	while (boxes.size() < numberOfColors) {
+		auto box = std::max_element(boxes.begin(), boxes.end(), [](const Box &a, const Box &b) {
+			return a.error < b.error;
+		});
+		if (box->error <= 0)
+			break;
+		const auto &channel = samples.coordinates[box->channel];
+		std::sort(order.begin() + box->begin, order.begin() + box->end, [&channel](size_t a, size_t b) {
+			return channel[a] < channel[b] || (channel[a] == channel[b] && a < b);
+		});
+		applyOrder(box->begin, box->end);
+		uint64_t total = 0, half = 0;
+		for (size_t i = box->begin; i < box->end; i++)
+			total += sorted.pixels[i];
+		size_t split = box->begin + 1;
+		for (size_t i = box->begin; i < box->end - 1; i++) {
+			half += sorted.pixels[i];
+			split = i + 1;
+			if (half * 2 >= total)
+				break;
+		}
+		size_t begin = box->begin, end = box->end;
+		*box = makeBox(sorted, begin, split);
+		boxes.push_back(makeBox(sorted, split, end));
+	}
+	std::sort(boxes.begin(), boxes.end(), [](const Box &a, const Box &b) {
+		return a.begin < b.begin;
+	});
+	std::vector<QuantizedColor> result;
+	result.reserve(boxes.size());
+	for (const auto &box: boxes) {
+		Sum sum;
+		for (size_t i = box.begin; i < box.end; i++)
+			sum.add(sorted, i);
+		result.push_back(sum.result());
+	}
+	return result;
+}
+KMeansQuantizer::KMeansQuantizer(std::unique_ptr<IColorQuantizer> initial, Space space, uint32_t maxIterations, uint64_t maxDistances):
+	m_initial(std::move(initial)),
+	m_space(space),
+	m_maxIterations(maxIterations),
+	m_maxDistances(maxDistances) {
+}
+namespace {
+// Samples are assigned in fixed size blocks, so that the inner loop over block samples has constant trip count, no branches and is vectorized by compiler.
+constexpr size_t blockSize = 16;
+void toSpace(const color_batch::Channels &channels, KMeansQuantizer::Space space) {
+	if (space == KMeansQuantizer::Space::lab) {
+		color_batch::nonLinearRgb(channels);
+		color_batch::rgbToLabD50(channels);
+	}
+}
+void assign(const Samples &samples, const std::array<std::vector<float>, 3> &centers, size_t begin, size_t end, uint32_t *assignments) {
+	const float *x = samples.coordinates[0].data(), *y = samples.coordinates[1].data(), *z = samples.coordinates[2].data();
+	const size_t centerCount = centers[0].size();
+	for (size_t block = begin; block < end; block += blockSize) {
+		float best[blockSize];
+		uint32_t bestIndex[blockSize];
+		for (size_t i = 0; i < blockSize; i++) {
+			best[i] = std::numeric_limits<float>::max();
+			bestIndex[i] = 0;
+		}
+		for (size_t center = 0; center < centerCount; center++) {
+			const float cx = centers[0][center], cy = centers[1][center], cz = centers[2][center];
+			const uint32_t index = static_cast<uint32_t>(center);
+			for (size_t i = 0; i < blockSize; i++) {
+				const float dx = x[block + i] - cx, dy = y[block + i] - cy, dz = z[block + i] - cz;
+				const float distance = dx * dx + dy * dy + dz * dz;
+				const bool closer = distance < best[i];
+				best[i] = closer ? distance : best[i];
+				bestIndex[i] = closer ? index : bestIndex[i];
+			}
+		}
+		for (size_t i = 0; i < blockSize; i++)
+			assignments[block + i] = bestIndex[i];
+	}
+}
+}
+std::vector<QuantizedColor> KMeansQuantizer::quantize(const ColorHistogram &histogram, size_t numberOfColors) const {
+	auto initial = m_initial->quantize(histogram, numberOfColors);
+	if (initial.size() < 2)
+		return initial;
+	Samples samples(histogram, blockSize);
+	toSpace(samples.channels(), m_space);
+	std::array<std::vector<float>, 3> centers;
+	for (auto &channel: centers)
+		channel.resize(initial.size());
+	for (size_t i = 0; i < initial.size(); i++) {
+		for (int j = 0; j < 3; j++)
+			centers[j][i] = initial[i].color[j];
+	}
+	toSpace(color_batch::Channels(centers[0].data(), centers[1].data(), centers[2].data(), initial.size()), m_space);
+	const size_t paddedCount = samples.coordinates[0].size();
+	std::vector<uint32_t> assignments(paddedCount), previousAssignments(paddedCount, std::numeric_limits<uint32_t>::max());
+	std::vector<Sum> sums(initial.size());
+	const size_t blocks = paddedCount / blockSize;
+	const size_t minBlocksPerThread = std::max<size_t>(1, (1 << 16) / (blockSize * initial.size()));
+	// Each iteration assigns all samples, the first assignment to initial centers is not counted as a refinement iteration.
+	const uint64_t distancesPerIteration = static_cast<uint64_t>(paddedCount) * initial.size();
+	const uint32_t maxIterations = static_cast<uint32_t>(std::min<uint64_t>(m_maxIterations, std::max<uint64_t>(m_maxDistances / distancesPerIteration, 1) - 1));
+	for (uint32_t iteration = 0;; iteration++) {
+		common::parallelFor(blocks, minBlocksPerThread, [&](size_t begin, size_t end) {
+			assign(samples, centers, begin * blockSize, end * blockSize, assignments.data());
+		});
+		// Sums are accumulated on a single thread in sample order, so that result does not depend on thread count.
+		std::fill(sums.begin(), sums.end(), Sum());
+		for (size_t i = 0; i < samples.count; i++)
+			sums[assignments[i]].add(samples, i);
+		if (iteration >= maxIterations || std::equal(assignments.begin(), assignments.begin() + samples.count, previousAssignments.begin()))
+			break;
+		for (size_t center = 0; center < sums.size(); center++) {
+			const auto &sum = sums[center];
+			if (sum.pixels == 0)
+				continue;
+			for (int j = 0; j < 3; j++)
+				centers[j][center] = static_cast<float>(sum.coordinates[j] / static_cast<double>(sum.pixels));
+		}
+		std::swap(assignments, previousAssignments);
+	}
+	std::vector<QuantizedColor> result;
+	result.reserve(sums.size());
+	for (const auto &sum: sums) {
+		if (sum.pixels > 0)
+			result.push_back(sum.result());
+	}
+	return result;
+}
+std::unique_ptr<IColorQuantizer> createQuantizer(QuantizerType type) {
+	switch (type) {
+	case QuantizerType::octree:
+		return std::make_unique<OctreeQuantizer>();
+	case QuantizerType::medianCut:
+		return std::make_unique<MedianCutQuantizer>();
+	case QuantizerType::kMeansLinearRgb:
+		return std::make_unique<KMeansQuantizer>(std::make_unique<MedianCutQuantizer>(), KMeansQuantizer::Space::linearRgb);
+	case QuantizerType::kMeansLab:
+		return std::make_unique<KMeansQuantizer>(std::make_unique<MedianCutQuantizer>(), KMeansQuantizer::Space::lab);
+	}
+	return std::make_unique<OctreeQuantizer>();
+}
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+namespace math {
+struct ColorHistogram;
+/** \struct QuantizedColor
+ * \brief Palette color produced by color quantizer.
+ */
+struct QuantizedColor {
+	/** Average color of all pixels represented by palette color, in linear RGB color space. */
+	Color color;
+	uint64_t pixels;
+};
+/** \struct IColorQuantizer
+ * \brief Color quantization algorithm interface.
+ */
+struct IColorQuantizer {
+	virtual ~IColorQuantizer() = default;
+	/**
+	 * Reduce histogram colors to a palette.
+	 * Result depends only on histogram contents and parameters, not on the number of threads used.
+	 * @param[in] histogram Color histogram.
+	 * @param[in] numberOfColors Maximum number of palette colors.
+	 * @return Palette colors. Histogram with less distinct colors produces less palette colors.
+	 */
+	virtual std::vector<QuantizedColor> quantize(const ColorHistogram &histogram, size_t numberOfColors) const = 0;
+};
+/** \struct OctreeQuantizer
+ * \brief Octree color quantization, see OctreeColorQuantization.
+ */
+struct OctreeQuantizer: IColorQuantizer {
+	virtual std::vector<QuantizedColor> quantize(const ColorHistogram &histogram, size_t numberOfColors) const override;
+};
+/** \struct MedianCutQuantizer
+ * \brief Median cut color quantization in sRGB color space.
+ *
+ * Box with the largest sum of squared errors is split at the pixel median of its widest channel until requested number of boxes is reached.
+ */
+struct MedianCutQuantizer: IColorQuantizer {
+	virtual std::vector<QuantizedColor> quantize(const ColorHistogram &histogram, size_t numberOfColors) const override;
+};
+/** \struct KMeansQuantizer
+ * \brief K-means (Lloyd) refinement of a palette produced by another quantizer.
+ */
+struct KMeansQuantizer: IColorQuantizer {
+	enum class Space {
+		linearRgb,
+		lab,
+	};
+	/**
+	 * Create k-means quantizer.
+	 * @param[in] initial Quantizer used to select initial cluster centers.
+	 * @param[in] space Color space in which distances and cluster centers are calculated.
+	 * @param[in] maxIterations Maximum number of refinement iterations. Refinement stops early when cluster assignments do not change.
+	 * @param[in] maxDistances Maximum number of sample to cluster center distance calculations, which bounds the cost for large palettes
+	 * of images with many distinct colors. Assignment to initial centers is always done, even if it exceeds the limit.
+	 */
+	KMeansQuantizer(std::unique_ptr<IColorQuantizer> initial, Space space = Space::lab, uint32_t maxIterations = 16, uint64_t maxDistances = uint64_t(1) << 30);
+	virtual std::vector<QuantizedColor> quantize(const ColorHistogram &histogram, size_t numberOfColors) const override;
+private:
+	std::unique_ptr<IColorQuantizer> m_initial;
+	Space m_space;
+	uint32_t m_maxIterations;
+	uint64_t m_maxDistances;
+};
+enum class QuantizerType {
+	octree,
+	medianCut,
+	kMeansLinearRgb,
+	kMeansLab,
+};
+/**
+ * Create color quantizer. K-means quantizers are initialized with median cut.
+ * @param[in] type Quantizer type.
+ * @return Color quantizer.
+ */
+std::unique_ptr<IColorQuantizer> createQuantizer(QuantizerType type);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MultiKeySort.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <cstring>
+namespace math {
+namespace {
+const size_t minChunkSize = 1 << 16;
+const int digitBits = 8;
+const size_t digitCount = 1 << digitBits;
+// Maps float to unsigned integer with the same order. Negative zero is treated as positive zero.
+uint32_t orderedKey(float value) {
+	value += 0.0f;
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+// Chunk boundaries do not depend on scheduling, so sort results are the same on any number of threads.
+size_t chunkCount(size_t count) {
+	return std::clamp<size_t>(count / minChunkSize, 1, common::threadCount());
+}
+size_t chunkBegin(size_t chunk, size_t chunks, size_t count) {
+	return chunk * count / chunks;
+}
+}
+MultiKeySort::MultiKeySort() {
+}
+common::Span<const uint32_t> MultiKeySort::sort(common::Span<const Key> keys) {
+	const size_t count = keys.size() > 0 ? keys[0].values.size() : 0;
+	m_order.resize(count);
+	if (count == 0)
+		return common::Span<const uint32_t>();
+	m_items.resize(count);
+	m_buffer.resize(count);
+	// Least significant key is sorted first, stable sorts by more significant keys keep the order of equal items.
+	for (size_t i = keys.size(); i > 0; --i) {
+		const auto &key = keys[i - 1];
+		setKeys(key.maxGroups > 1 ? groupValues(key) : key.values, key.reverse, i == keys.size());
+		radixSort();
+	}
+	common::parallelFor(count, minChunkSize, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			m_order[i] = static_cast<uint32_t>(m_items[i]);
+	});
+	return common::Span<const uint32_t>(m_order.data(), count);
+}
+common::Span<const float> MultiKeySort::groupValues(const Key &key) {
+	const size_t count = key.values.size();
+	m_tree.clear();
+	for (size_t i = 0; i < count; i++)
+		m_tree.add(key.values[i]);
+	m_tree.reduce(key.maxGroups);
+	m_tree.reduceByMinDistance(key.minGroupDistance);
+	m_groupValues.resize(count);
+	common::parallelFor(count, minChunkSize, [this, &key](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			m_groupValues[i] = m_tree.find(key.values[i]);
+	});
+	return common::Span<const float>(m_groupValues.data(), count);
+}
+void MultiKeySort::setKeys(common::Span<const float> values, bool reverse, bool first) {
+	const uint32_t mask = reverse ? 0xffffffffu : 0;
+	// Items hold sort key in the upper half and item index in the lower half.
+	common::parallelFor(m_items.size(), minChunkSize, [this, values, mask, first](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			uint32_t index = first ? static_cast<uint32_t>(i) : static_cast<uint32_t>(m_items[i]);
+			m_items[i] = (static_cast<uint64_t>(orderedKey(values[index]) ^ mask) << 32) | index;
+		}
+	});
+}
+void MultiKeySort::radixSort() {
+	const size_t count = m_items.size(), chunks = chunkCount(count);
+	m_histograms.resize(chunks * digitCount);
+	for (int shift = 32; shift < 64; shift += digitBits) {
+		std::fill(m_histograms.begin(), m_histograms.end(), 0);
+		common::parallelFor(chunks, 1, [this, shift, chunks, count](size_t beginChunk, size_t endChunk) {
+			for (size_t chunk = beginChunk; chunk < endChunk; chunk++) {
+				size_t *histogram = &m_histograms[chunk * digitCount];
+				for (size_t i = chunkBegin(chunk, chunks, count), end = chunkBegin(chunk + 1, chunks, count); i < end; i++)
+					histogram[(m_items[i] >> shift) & (digitCount - 1)]++;
+			}
+		});
+		// Pass is skipped when all items have the same digit, which is common for upper digits and grouped keys.
+		bool skip = false;
+		size_t offset = 0;
+		for (size_t digit = 0; digit < digitCount; digit++) {
+			size_t digitTotal = 0;
+			for (size_t chunk = 0; chunk < chunks; chunk++) {
+				size_t &value = m_histograms[chunk * digitCount + digit];
+				size_t chunkTotal = value;
+				value = offset;
+				offset += chunkTotal;
+				digitTotal += chunkTotal;
+			}
+			if (digitTotal == count) {
+				skip = true;
+				break;
+			}
+		}
+		if (skip)
+			continue;
+		common::parallelFor(chunks, 1, [this, shift, chunks, count](size_t beginChunk, size_t endChunk) {
+			for (size_t chunk = beginChunk; chunk < endChunk; chunk++) {
+				size_t *offsets = &m_histograms[chunk * digitCount];
+				for (size_t i = chunkBegin(chunk, chunks, count), end = chunkBegin(chunk + 1, chunks, count); i < end; i++)
+					m_buffer[offsets[(m_items[i] >> shift) & (digitCount - 1)]++] = m_items[i];
+			}
+		});
+		m_items.swap(m_buffer);
+	}
+}
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "BinaryTreeQuantization.h"
+#include "common/Span.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace math {
+/** \struct MultiKeySort
+ * \brief Stable sort of item indices by several float keys, each of which can be grouped before sorting.
+ *
+ * Keys are sorted with a parallel least significant digit radix sort, starting with the last key. Float keys are mapped to unsigned integers
+ * with the same order, so no precision is lost. Buffers are kept between sorts, so repeated sorts of the same number of items do not allocate memory.
+ */
+struct MultiKeySort {
+	struct Key {
+		/** Key value of each item. */
+		common::Span<const float> values;
+		/** Sort in descending order. */
+		bool reverse = false;
+		/** Maximum number of groups. Key values are replaced with average values of their groups when greater than 1. */
+		size_t maxGroups = 0;
+		/** Groups closer than this value are merged. */
+		float minGroupDistance = 0;
+	};
+	MultiKeySort();
+	MultiKeySort(const MultiKeySort &) = delete;
+	MultiKeySort &operator=(const MultiKeySort &) = delete;
+	/**
+	 * Sort items by keys.
+	 * @param[in] keys Keys in order of priority. All keys must have the same number of values.
+	 * @return Item indices in sorted order. Valid until the next sort.
+	 */
+	common::Span<const uint32_t> sort(common::Span<const Key> keys);
+private:
+	std::vector<uint64_t> m_items, m_buffer;
+	std::vector<float> m_groupValues;
+	std::vector<size_t> m_histograms;
+	std::vector<uint32_t> m_order;
+	BinaryTreeQuantization<float> m_tree;
+	common::Span<const float> groupValues(const Key &key);
+	void setKeys(common::Span<const float> values, bool reverse, bool first);
+	void radixSort();
+};
+}
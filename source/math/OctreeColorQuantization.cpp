@@ -17,6 +17,7 @@
  */
 
 #include "OctreeColorQuantization.h"
+#include "ColorHistogram.h"
 #include <algorithm>
 #include <cstring>
 #include <new>
@@ -198,6 +199,15 @@ void OctreeColorQuantization::add(const Color &color, const Position position) {
 void OctreeColorQuantization::add(const Color &color, size_t pixels, const Position position) {
 	m_root.add(color, pixels, position, 0, *this);
 }
+void OctreeColorQuantization::add(const ColorHistogram &histogram) {
+	histogram.visit([this](const Color &color, uint64_t pixels) {
+		Color nonLinearColor = color.nonLinearRgbFast();
+		auto toUint8 = [](float value) {
+			return static_cast<uint8_t>(std::clamp(static_cast<int>(value * 256), 0, 255));
+		};
+		m_root.add(color, static_cast<size_t>(pixels), Position { toUint8(nonLinearColor.red), toUint8(nonLinearColor.green), toUint8(nonLinearColor.blue) }, 0, *this);
+	});
+}
 void OctreeColorQuantization::clear() {
 	m_root.clear();
 	m_bufferResource.release();
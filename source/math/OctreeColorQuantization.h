@@ -26,6 +26,7 @@
 #include <utility>
 #include <vector>
 namespace math {
+struct ColorHistogram;
 struct OctreeColorQuantization {
 	static constexpr uint8_t children = 8;
 	static constexpr uint8_t maxDepth = 8;
@@ -66,6 +67,11 @@ struct OctreeColorQuantization {
 	OctreeColorQuantization(const OctreeColorQuantization &ocq);
 	void add(const Color &color, const Position position);
 	void add(const Color &color, size_t pixels, const Position position);
+	/**
+	 * Add all histogram bins in bin order, so that result depends only on histogram contents.
+	 * @param[in] histogram Color histogram.
+	 */
+	void add(const ColorHistogram &histogram);
 	void clear();
 	void reduce(size_t numberOfColors, bool accurate = true);
 	size_t size() const;
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ReductionTree.h"
+#include <limits>
+namespace math {
+namespace {
+struct Cluster {
+	double lab[3];
+	double pixels;
+	bool active;
+	void merge(const Cluster &cluster) {
+		const double total = pixels + cluster.pixels;
+		for (int j = 0; j < 3; j++)
+			lab[j] = (lab[j] * pixels + cluster.lab[j] * cluster.pixels) / total;
+		pixels = total;
+	}
+};
+// Ward's distance: increase of total squared error when two clusters are merged.
+double distance(const Cluster &a, const Cluster &b) {
+	double dl = a.lab[0] - b.lab[0], da = a.lab[1] - b.lab[1], db = a.lab[2] - b.lab[2];
+	return (a.pixels * b.pixels) / (a.pixels + b.pixels) * (dl * dl + da * da + db * db);
+}
+struct Merge {
+	uint32_t a, b;
+	double cost;
+};
+}
+ReductionTree::ReductionTree() {
+}
+ReductionTree::ReductionTree(const std::vector<QuantizedColor> &colors) {
+	const size_t count = colors.size();
+	if (count == 0)
+		return;
+	std::vector<Cluster> clusters(count);
+	for (size_t i = 0; i < count; i++) {
+		Color lab = colors[i].color.nonLinearRgb().rgbToLabD50();
+		auto &cluster = clusters[i];
+		for (int j = 0; j < 3; j++)
+			cluster.lab[j] = lab[j];
+		cluster.pixels = static_cast<double>(colors[i].pixels);
+		cluster.active = true;
+	}
+	// Nearest neighbor chain finds all merges in O(n^2) time. Ward's distance is reducible, so sorting merges by cost afterwards gives the same merge order as greedy merging.
+	std::vector<Merge> merges;
+	merges.reserve(count - 1);
+	std::vector<uint32_t> chain;
+	size_t firstActive = 0;
+	while (merges.size() + 1 < count) {
+		if (chain.empty()) {
+			while (!clusters[firstActive].active)
+				firstActive++;
+			chain.push_back(static_cast<uint32_t>(firstActive));
+		}
+		uint32_t a = chain.back();
+		uint32_t previous = chain.size() >= 2 ? chain[chain.size() - 2] : std::numeric_limits<uint32_t>::max();
+		uint32_t nearest = previous;
+		double nearestDistance = previous != std::numeric_limits<uint32_t>::max() ? distance(clusters[a], clusters[previous]) : std::numeric_limits<double>::max();
+		for (size_t i = 0; i < count; i++) {
+			if (i == a || !clusters[i].active)
+				continue;
+			double value = distance(clusters[a], clusters[i]);
+			if (value < nearestDistance) {
+				nearestDistance = value;
+				nearest = static_cast<uint32_t>(i);
+			}
+		}
+		if (nearest != previous) {
+			chain.push_back(nearest);
+			continue;
+		}
+		chain.pop_back();
+		chain.pop_back();
+		merges.push_back(Merge { std::min(a, nearest), std::max(a, nearest), nearestDistance });
+		clusters[std::min(a, nearest)].merge(clusters[std::max(a, nearest)]);
+		clusters[std::max(a, nearest)].active = false;
+	}
+	std::stable_sort(merges.begin(), merges.end(), [](const Merge &a, const Merge &b) {
+		return a.cost < b.cost;
+	});
+	// Replay merges in cost order. Each input color slot tracks the tree node of the cluster it currently represents, found through union-find.
+	std::vector<uint32_t> parent(count), node(count);
+	for (size_t i = 0; i < count; i++) {
+		parent[i] = static_cast<uint32_t>(i);
+		node[i] = static_cast<uint32_t>(i);
+	}
+	auto find = [&parent](uint32_t i) {
+		while (parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	};
+	m_nodes.reserve(2 * count - 1);
+	for (size_t i = 0; i < count; i++)
+		m_nodes.push_back(Node { colors[i], { 0, 0 } });
+	for (const auto &merge: merges) {
+		uint32_t a = find(merge.a), b = find(merge.b);
+		const auto &first = m_nodes[node[a]].color, &second = m_nodes[node[b]].color;
+		const uint64_t pixels = first.pixels + second.pixels;
+		const float firstWeight = static_cast<float>(static_cast<double>(first.pixels) / pixels), secondWeight = 1 - firstWeight;
+		Color color(first.color[0] * firstWeight + second.color[0] * secondWeight, first.color[1] * firstWeight + second.color[1] * secondWeight, first.color[2] * firstWeight + second.color[2] * secondWeight, 1.0f);
+		m_nodes.push_back(Node { QuantizedColor { color, pixels }, { node[a], node[b] } });
+		parent[b] = a;
+		node[a] = static_cast<uint32_t>(m_nodes.size() - 1);
+	}
+}
+size_t ReductionTree::size() const {
+	return (m_nodes.size() + 1) / 2;
+}
+std::vector<QuantizedColor> ReductionTree::palette(size_t numberOfColors) const {
+	std::vector<QuantizedColor> result;
+	result.reserve(std::min(numberOfColors, size()));
+	visit(numberOfColors, [&result](const QuantizedColor &color) {
+		result.push_back(color);
+	});
+	return result;
+}
+}
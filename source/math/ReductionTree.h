@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "ColorQuantizer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace math {
+/** \struct ReductionTree
+ * \brief Merge log of palette colors, which allows getting reduced palette of any size without repeating the reduction.
+ *
+ * Colors are merged pairwise by Ward's criterion (smallest increase of squared error in Lab color space) until one color remains.
+ * Palette of N colors contains nodes which exist after the first (size() - N) merges, so palettes of all sizes are nested.
+ */
+struct ReductionTree {
+	ReductionTree();
+	/**
+	 * Build merge log of palette colors. Complexity is quadratic in the number of colors.
+	 * @param[in] colors Palette colors.
+	 */
+	explicit ReductionTree(const std::vector<QuantizedColor> &colors);
+	/**
+	 * Get maximum palette size.
+	 * @return Number of colors tree was built from.
+	 */
+	size_t size() const;
+	/**
+	 * Visit colors of reduced palette. Only O(numberOfColors) tree nodes are visited.
+	 * @param[in] numberOfColors Palette size, clamped to 1..size().
+	 * @param[in] callback Callable with (const QuantizedColor &color) parameter.
+	 */
+	template<typename Callback>
+	void visit(size_t numberOfColors, Callback &&callback) const {
+		if (m_nodes.empty())
+			return;
+		const size_t leafs = size();
+		const size_t lastNode = leafs + (leafs - std::clamp<size_t>(numberOfColors, 1, leafs));
+		std::vector<uint32_t> stack { static_cast<uint32_t>(m_nodes.size() - 1) };
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const auto &node = m_nodes[index];
+			if (index < lastNode) {
+				callback(node.color);
+				continue;
+			}
+			stack.push_back(node.children[1]);
+			stack.push_back(node.children[0]);
+		}
+	}
+	/**
+	 * Get reduced palette.
+	 * @param[in] numberOfColors Palette size, clamped to 1..size().
+	 * @return Palette colors.
+	 */
+	std::vector<QuantizedColor> palette(size_t numberOfColors) const;
+private:
+	struct Node {
+		QuantizedColor color;
+		uint32_t children[2];
+	};
+	// Input colors first, followed by merged nodes in merge order. Last node is the root.
+	std::vector<Node> m_nodes;
+};
+}
@@ -17,6 +17,12 @@
  */
 
 #include "TextFile.h"
+#include "Color.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
 namespace text_file_parser {
 Configuration::Configuration(bool initialValue) {
 	singleLineCComments = initialValue;
@@ -34,9 +40,66 @@ Configuration::Configuration(bool initialValue) {
 	intValues = initialValue;
 }
 bool scanner(TextFile &text_file, const Configuration &configuration);
+bool scanChunk(const char *data, size_t length, const Configuration &configuration, std::vector<Color> &colors, size_t &errorLine, size_t &errorStartColumn, size_t &errorEndColumn);
 bool TextFile::parse(const Configuration &configuration) {
 	return scanner(*this, configuration);
 }
+namespace {
+// Smaller chunks are not worth starting a thread for.
+const size_t MinChunkSize = 1024 * 1024;
+struct Chunk {
+	const char *data;
+	size_t length;
+	std::vector<Color> colors;
+	bool failed;
+	size_t errorLine, errorStartColumn, errorEndColumn;
+};
+}
+bool TextFile::parse(const Configuration &configuration, const char *data, size_t length) {
+	// Only multi-line comments can continue past newline, so any position after newline is a safe split point without them.
+	size_t chunkCount = 1;
+	if (!configuration.multiLineCComments || std::string_view(data, length).find("/*") == std::string_view::npos)
+		chunkCount = std::max<size_t>(1, std::min(common::threadCount(), length / MinChunkSize));
+	std::vector<Chunk> chunks;
+	chunks.reserve(chunkCount);
+	const char *end = data + length;
+	const char *chunkStart = data;
+	for (size_t i = 1; i <= chunkCount && chunkStart < end; i++) {
+		const char *chunkEnd = end;
+		if (i < chunkCount) {
+			chunkEnd = std::max(chunkStart, data + length / chunkCount * i);
+			auto *newline = static_cast<const char *>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+			chunkEnd = newline ? newline + 1 : end;
+		}
+		auto &chunk = chunks.emplace_back();
+		chunk.data = chunkStart;
+		chunk.length = chunkEnd - chunkStart;
+		chunkStart = chunkEnd;
+	}
+	common::parallelFor(chunks.size(), 1, [&chunks, &configuration](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			auto &chunk = chunks[i];
+			chunk.failed = !scanChunk(chunk.data, chunk.length, configuration, chunk.colors, chunk.errorLine, chunk.errorStartColumn, chunk.errorEndColumn);
+		}
+	});
+	for (auto &chunk: chunks) {
+		if (!chunk.colors.empty())
+			addColors(chunk.colors.data(), chunk.colors.size());
+		if (chunk.failed) {
+			size_t line = std::count(data, chunk.data, '\n') + chunk.errorLine;
+			syntaxError(line, chunk.errorStartColumn, line, chunk.errorEndColumn);
+			return false;
+		}
+	}
+	return true;
+}
 TextFile::~TextFile() {
 }
+size_t TextFile::read(char *, size_t) {
+	return 0;
+}
+void TextFile::addColors(const Color *colors, size_t count) {
+	for (size_t i = 0; i < count; i++)
+		addColor(colors[i]);
+}
 }
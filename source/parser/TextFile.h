@@ -39,11 +39,29 @@ struct Configuration {
 };
 struct TextFile {
 	bool parse(const Configuration &configuration);
+	/**
+	 * Parse text which is already in memory, for example a memory mapped file.
+	 * Text is split after newline characters into chunks which are parsed on multiple threads. Colors are reported in text order and syntax errors use whole text line numbers.
+	 * Text is parsed as a single chunk when multi-line comments are enabled and text contains a comment start.
+	 * @param[in] configuration Parser configuration.
+	 * @param[in] data Text data.
+	 * @param[in] length Text length in bytes.
+	 * @return True on success.
+	 */
+	bool parse(const Configuration &configuration, const char *data, size_t length);
 	virtual ~TextFile();
 	virtual void outOfMemory() = 0;
 	virtual void syntaxError(size_t startLine, size_t startColumn, size_t endLine, size_t endColunn) = 0;
-	virtual size_t read(char *buffer, size_t length) = 0;
+	/**
+	 * Read next part of text. Only used when parsing without in-memory text.
+	 * @return Number of bytes read, 0 on end of text.
+	 */
+	virtual size_t read(char *buffer, size_t length);
 	virtual void addColor(const Color &color) = 0;
+	/**
+	 * Add multiple parsed colors at once. Default implementation calls addColor for each color.
+	 */
+	virtual void addColors(const Color *colors, size_t count);
 };
 }
 #endif /* GPICK_PARSER_TEXT_FILE_H_ */
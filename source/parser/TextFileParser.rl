@@ -17,10 +17,11 @@
  */
 
 #include "parser/TextFile.h"
+#include "parser/TokenScan.h"
 #include "Color.h"
 #include "math/Algorithms.h"
 #include <cstring>
-#include <functional>
+#include <cstddef>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -41,62 +42,32 @@ struct FSM {
 	int cs;
 	int act;
 	char ws;
-	char *ts, *te;
+	const char *ts, *te;
 	char buffer[8 * 1024];
-	int line, column, lineStart, bufferOffset;
+	const char *start;
+	size_t line;
+	ptrdiff_t lineStart;
+	int column, bufferOffset;
 	int64_t numberI64;
 	std::vector<std::pair<int64_t, Unit>> numbersI64;
-	char *numberStart;
+	const char *numberStart;
 	std::vector<std::pair<double, Unit>> numbersDouble;
-	std::function<void(const Color&)> addColor;
+	std::vector<Color> colors;
 	void handleNewline() {
 		line++;
 		column = 0;
-		lineStart = te - buffer;
+		lineStart = te - start;
 	}
-	int hexToInt(char hex) {
-		if (hex >= '0' && hex <= '9') return hex - '0';
-		if (hex >= 'a' && hex <= 'f') return hex - 'a' + 10;
-		if (hex >= 'A' && hex <= 'F') return hex - 'A' + 10;
-		return 0;
-	}
-	int hexPairToInt(const char *hexPair) {
-		return hexToInt(hexPair[0]) << 4 | hexToInt(hexPair[1]);
-	}
-	void colorHexFull(bool withHashSymbol) {
-		Color color;
-		int startIndex = withHashSymbol ? 1 : 0;
-		color.red = hexPairToInt(ts + startIndex) / 255.0f;
-		color.green = hexPairToInt(ts + startIndex + 2) / 255.0f;
-		color.blue = hexPairToInt(ts + startIndex + 4) / 255.0f;
-		color.alpha = 1;
-		addColor(color);
-	}
-	void colorHexShort(bool withHashSymbol) {
-		Color color;
-		int startIndex = withHashSymbol ? 1 : 0;
-		color.red = hexToInt(ts[startIndex + 0]) / 15.0f;
-		color.green = hexToInt(ts[startIndex + 1]) / 15.0f;
-		color.blue = hexToInt(ts[startIndex + 2]) / 15.0f;
-		color.alpha = 1;
-		addColor(color);
+	void addColor(const Color &color) {
+		colors.push_back(color.normalizeRgb());
 	}
-	void colorHexWithAlphaFull(bool withHashSymbol) {
+	void colorHex(bool withHashSymbol, size_t digits) {
+		uint32_t value = decodeHexColor(ts + (withHashSymbol ? 1 : 0), digits);
 		Color color;
-		int startIndex = withHashSymbol ? 1 : 0;
-		color.red = hexPairToInt(ts + startIndex) / 255.0f;
-		color.green = hexPairToInt(ts + startIndex + 2) / 255.0f;
-		color.blue = hexPairToInt(ts + startIndex + 4) / 255.0f;
-		color.alpha = hexPairToInt(ts + startIndex + 6) / 255.0f;
-		addColor(color);
-	}
-	void colorHexWithAlphaShort(bool withHashSymbol) {
-		Color color;
-		int startIndex = withHashSymbol ? 1 : 0;
-		color.red = hexToInt(ts[startIndex + 0]) / 15.0f;
-		color.green = hexToInt(ts[startIndex + 1]) / 15.0f;
-		color.blue = hexToInt(ts[startIndex + 2]) / 15.0f;
-		color.alpha = hexToInt(ts[startIndex + 3]) / 15.0f;
+		color.red = (value & 0xff) / 255.0f;
+		color.green = ((value >> 8) & 0xff) / 255.0f;
+		color.blue = ((value >> 16) & 0xff) / 255.0f;
+		color.alpha = (value >> 24) / 255.0f;
 		addColor(color);
 	}
 	float getPercentage(size_t index) const {
@@ -263,14 +234,14 @@ struct FSM {
 		( any - newline ) { };
 		*|;
 	main := |*
-		( '#'[0-9a-fA-F]{8} ) when fullHexWithAlpha { fsm.colorHexWithAlphaFull(true); };
-		( '#'[0-9a-fA-F]{6} ) when fullHex { fsm.colorHexFull(true); };
-		( '#'[0-9a-fA-F]{4} ) when shortHexWithAlpha { fsm.colorHexWithAlphaShort(true); };
-		( '#'[0-9a-fA-F]{3} ) when shortHex { fsm.colorHexShort(true); };
-		( [0-9a-fA-F]{8} ) when fullHexWithAlpha { fsm.colorHexWithAlphaFull(false); };
-		( [0-9a-fA-F]{6} ) when fullHex { fsm.colorHexFull(false); };
-		( [0-9a-fA-F]{4} ) when shortHexWithAlpha { fsm.colorHexWithAlphaShort(false); };
-		( [0-9a-fA-F]{3} ) when shortHex { fsm.colorHexShort(false); };
+		( '#'[0-9a-fA-F]{8} ) when fullHexWithAlpha { fsm.colorHex(true, 8); };
+		( '#'[0-9a-fA-F]{6} ) when fullHex { fsm.colorHex(true, 6); };
+		( '#'[0-9a-fA-F]{4} ) when shortHexWithAlpha { fsm.colorHex(true, 4); };
+		( '#'[0-9a-fA-F]{3} ) when shortHex { fsm.colorHex(true, 3); };
+		( [0-9a-fA-F]{8} ) when fullHexWithAlpha { fsm.colorHex(false, 8); };
+		( [0-9a-fA-F]{6} ) when fullHex { fsm.colorHex(false, 6); };
+		( [0-9a-fA-F]{4} ) when shortHexWithAlpha { fsm.colorHex(false, 4); };
+		( [0-9a-fA-F]{3} ) when shortHex { fsm.colorHex(false, 3); };
 		( 'rgb'i '(' ws* numberOrPercentage ws+ numberOrPercentage ws+ numberOrPercentage ws* ')' ) when cssRgb { fsm.colorRgb(); };
 		( 'rgb'i '(' ws* numberOrPercentage ws* ',' ws* numberOrPercentage ws* ',' ws* numberOrPercentage ws* ')' ) when cssRgb { fsm.colorRgb(); };
 		( 'rgba'i '(' ws* numberOrPercentage ws+ numberOrPercentage ws+ numberOrPercentage ws* '/' ws* numberOrPercentage ws* ')' ) when cssRgba { fsm.colorRgba(); };
@@ -286,35 +257,40 @@ struct FSM {
 		( '//' ) when singleLineCComments { fgoto singleLineComment; };
 		( '/*' ) when multiLineCComments { fgoto multiLineComment; };
 		( '#' ) when singleLineHashComments { fgoto singleLineComment; };
-		( any - newline ) { fsm.clearNumberStacks(); };
+		( any - newline ) { fsm.clearNumberStacks(); fexec findTokenStart(p + 1, pe); };
 		( newline ) { fsm.clearNumberStacks(); };
 		*|;
 }%%
 
 %% write data;
 
+static void flushColors(FSM &fsm, TextFile &textFile) {
+	if (fsm.colors.empty())
+		return;
+	textFile.addColors(fsm.colors.data(), fsm.colors.size());
+	fsm.colors.clear();
+}
 bool scanner(TextFile &textFile, const Configuration &configuration) {
 	FSM fsm = {};
+	fsm.start = fsm.buffer;
 	bool parseError = false;
-	fsm.addColor = [&textFile](const Color &color) {
-		textFile.addColor(color.normalizeRgb());
-	};
 	%% write init;
 	int have = 0;
 	while (1) {
-		char *p = fsm.buffer + have;
+		const char *p = fsm.buffer + have;
 		int ws = sizeof(fsm.buffer) - have;
 		if (ws == 0) {
 			textFile.outOfMemory();
 			break;
 		}
-		char *eof = 0;
+		const char *eof = 0;
 		auto readSize = textFile.read(fsm.buffer + have, ws);
-		char *pe = p + readSize;
+		const char *pe = p + readSize;
 		if (readSize > 0) {
 			if (readSize < sizeof(fsm.buffer))
 				eof = pe;
 			%% write exec;
+			flushColors(fsm, textFile);
 			if (fsm.cs == text_file_error) {
 				parseError = true;
 				textFile.syntaxError(fsm.line, fsm.ts - fsm.buffer - fsm.lineStart, fsm.line, fsm.te - fsm.buffer - fsm.lineStart);
@@ -338,4 +314,24 @@ bool scanner(TextFile &textFile, const Configuration &configuration) {
 	}
 	return parseError == false;
 }
+bool scanChunk(const char *data, size_t length, const Configuration &configuration, std::vector<Color> &colors, size_t &errorLine, size_t &errorStartColumn, size_t &errorEndColumn) {
+	FSM fsm = {};
+	fsm.start = data;
+	fsm.colors.swap(colors);
+	%% write init;
+	const char *p = data;
+	const char *pe = data + length;
+	const char *eof = pe;
+	%% write exec;
+	fsm.colors.swap(colors);
+	if (fsm.cs == text_file_error) {
+		const char *tokenStart = fsm.ts ? fsm.ts : p;
+		const char *tokenEnd = fsm.te ? fsm.te : tokenStart;
+		errorLine = fsm.line;
+		errorStartColumn = tokenStart - data - fsm.lineStart;
+		errorEndColumn = tokenEnd - data - fsm.lineStart;
+		return false;
+	}
+	return true;
+}
 }
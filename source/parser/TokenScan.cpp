@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TokenScan.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GPICK_TOKEN_SCAN_SSE2
+#endif
+namespace text_file_parser {
+namespace {
+bool canStartToken(unsigned char c) {
+	unsigned char folded = c | 0x20;
+	return (c >= '+' && c <= '9') || c == '#' || c == '\n' || c == '\r' || (folded >= 'a' && folded <= 'f') || folded == 'h' || folded == 'r';
+}
+#ifdef GPICK_TOKEN_SCAN_SSE2
+// Signed byte comparison, characters outside ASCII range are negative and never match.
+__m128i inRange(__m128i value, char min, char max) {
+	return _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8(min - 1)), _mm_cmplt_epi8(value, _mm_set1_epi8(max + 1)));
+}
+__m128i equal(__m128i value, char c) {
+	return _mm_cmpeq_epi8(value, _mm_set1_epi8(c));
+}
+#endif
+}
+const char *findTokenStartScalar(const char *begin, const char *end) {
+	for (; begin < end; ++begin) {
+		if (canStartToken(static_cast<unsigned char>(*begin)))
+			return begin;
+	}
+	return end;
+}
+const char *findTokenStart(const char *begin, const char *end) {
+#ifdef GPICK_TOKEN_SCAN_SSE2
+	for (; end - begin >= 16; begin += 16) {
+		__m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		__m128i folded = _mm_or_si128(text, _mm_set1_epi8(0x20));
+		__m128i matches = _mm_or_si128(inRange(text, '+', '9'), inRange(folded, 'a', 'f'));
+		matches = _mm_or_si128(matches, _mm_or_si128(equal(folded, 'h'), equal(folded, 'r')));
+		matches = _mm_or_si128(matches, _mm_or_si128(equal(text, '#'), _mm_or_si128(equal(text, '\n'), equal(text, '\r'))));
+		if (_mm_movemask_epi8(matches) != 0)
+			return findTokenStartScalar(begin, begin + 16);
+	}
+#endif
+	return findTokenStartScalar(begin, end);
+}
+}
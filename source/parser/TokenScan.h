@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPICK_PARSER_TOKEN_SCAN_H_
+#define GPICK_PARSER_TOKEN_SCAN_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <boost/endian/conversion.hpp>
+namespace text_file_parser {
+/**
+ * Find first character which can start a color, number or comment token, or is a newline.
+ * Scanner matches every skipped character as separate unrelated text, so skipping them does not change parsing results.
+ * Uses SSE2 to check 16 characters at a time when available.
+ * @param[in] begin Text start.
+ * @param[in] end Text end.
+ * @return Pointer to first such character or end.
+ */
+const char *findTokenStart(const char *begin, const char *end);
+/**
+ * Character by character version of findTokenStart.
+ */
+const char *findTokenStartScalar(const char *begin, const char *end);
+/**
+ * Decode already validated hexadecimal color digits in one 64-bit word instead of converting them one by one.
+ * @param[in] digits Hexadecimal digits.
+ * @param[in] length Number of digits: 3, 4, 6 or 8.
+ * @return Red, green, blue and alpha values in range [0, 255], red in lowest byte. Alpha is 255 when digits do not include it.
+ */
+inline uint32_t decodeHexColor(const char *digits, size_t length) {
+	uint64_t word = 0;
+	std::memcpy(&word, digits, length);
+	boost::endian::little_to_native_inplace(word);
+	// '0'-'9' have low nibble equal to their value, 'a'-'f' and 'A'-'F' have bit 6 set and low nibble equal to value - 9.
+	uint64_t values = (word & 0x0f0f0f0f0f0f0f0full) + ((word >> 6) & 0x0101010101010101ull) * 9;
+	uint64_t bytes;
+	if (length <= 4) {
+		bytes = values * 0x11;
+	} else {
+		uint64_t pairs = ((values << 4) | (values >> 8)) & 0x00ff00ff00ff00ffull;
+		pairs = (pairs | (pairs >> 8)) & 0x0000ffff0000ffffull;
+		bytes = pairs | (pairs >> 16);
+	}
+	if (length == 3 || length == 6)
+		bytes |= 0xff000000u;
+	return static_cast<uint32_t>(bytes);
+}
+}
+#endif /* GPICK_PARSER_TOKEN_SCAN_H_ */
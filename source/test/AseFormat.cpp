@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "AseFormat.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "common/Format.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace {
+struct ExpectedSwatch {
+	std::string name;
+	Color color;
+};
+// Generates ASE file contents with RGB, Gray and CMYK entries, nested groups and names outside basic multilingual plane. Used as fuzzing and benchmark corpus.
+struct CorpusGenerator {
+	CorpusGenerator(uint32_t seed):
+		random(seed) {
+	}
+	std::string generate(size_t swatchCount) {
+		std::string data("ASEF");
+		append32(data, 0x00010000u);
+		size_t blockCountPosition = data.length();
+		append32(data, 0);
+		uint32_t blocks = 0, depth = 0;
+		for (size_t i = 0; i < swatchCount; i++) {
+			if (random.next() % 16 == 0) {
+				appendGroupStart(data, common::format("group {}", i));
+				depth++, blocks++;
+			} else if (depth > 0 && random.next() % 8 == 0) {
+				append16(data, 0xc002u);
+				append32(data, 0);
+				depth--, blocks++;
+			}
+			appendSwatch(data, i);
+			blocks++;
+		}
+		for (; depth > 0; depth--, blocks++) {
+			append16(data, 0xc002u);
+			append32(data, 0);
+		}
+		for (int i = 0; i < 4; i++)
+			data[blockCountPosition + i] = static_cast<char>(blocks >> (24 - i * 8));
+		return data;
+	}
+	std::vector<ExpectedSwatch> expected;
+	test::RandomGenerator random;
+private:
+	static void append16(std::string &data, uint16_t value) {
+		data.push_back(static_cast<char>(value >> 8));
+		data.push_back(static_cast<char>(value));
+	}
+	static void append32(std::string &data, uint32_t value) {
+		append16(data, static_cast<uint16_t>(value >> 16));
+		append16(data, static_cast<uint16_t>(value));
+	}
+	static void appendFloat(std::string &data, float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		append32(data, bits);
+	}
+	static void appendName(std::string &data, std::string_view name, bool withEmoji) {
+		append16(data, static_cast<uint16_t>(name.length() + (withEmoji ? 3 : 1)));
+		for (auto c: name)
+			append16(data, static_cast<uint8_t>(c));
+		if (withEmoji) {
+			append16(data, 0xd83cu);
+			append16(data, 0xdfa8u);
+		}
+		append16(data, 0);
+	}
+	static void appendGroupStart(std::string &data, std::string_view name) {
+		append16(data, 0xc001u);
+		append32(data, static_cast<uint32_t>(2 + (name.length() + 1) * 2));
+		appendName(data, name, false);
+	}
+	void appendSwatch(std::string &data, size_t index) {
+		std::string name = common::format("swatch {}", index);
+		bool withEmoji = random.next() % 4 == 0;
+		Color color(random.nextFloat(), random.nextFloat(), random.nextFloat(), 1.0f);
+		append16(data, 0x0001u);
+		size_t blockSizePosition = data.length();
+		append32(data, 0);
+		appendName(data, name, withEmoji);
+		switch (random.next() % 3) {
+		case 0:
+			data.append("RGB ");
+			appendFloat(data, color.red);
+			appendFloat(data, color.green);
+			appendFloat(data, color.blue);
+			break;
+		case 1:
+			data.append("Gray");
+			appendFloat(data, color.red);
+			color.green = color.blue = color.red;
+			break;
+		case 2: {
+			Color cmyk;
+			cmyk.cmyk.c = color.red;
+			cmyk.cmyk.m = color.green;
+			cmyk.cmyk.y = color.blue;
+			cmyk.cmyk.k = 0.0f;
+			data.append("CMYK");
+			appendFloat(data, cmyk.cmyk.c);
+			appendFloat(data, cmyk.cmyk.m);
+			appendFloat(data, cmyk.cmyk.y);
+			appendFloat(data, cmyk.cmyk.k);
+			color = cmyk.cmykToRgb();
+			color.alpha = 1.0f;
+		} break;
+		}
+		append16(data, 2);
+		uint32_t blockSize = static_cast<uint32_t>(data.length() - blockSizePosition - 4);
+		for (int i = 0; i < 4; i++)
+			data[blockSizePosition + i] = static_cast<char>(blockSize >> (24 - i * 8));
+		expected.push_back(ExpectedSwatch { withEmoji ? name + "\xf0\x9f\x8e\xa8" : name, color });
+	}
+};
+common::ResultVoid<ErrorCode> load(const std::string &data, ColorList &colors) {
+	return aseBufferLoad(reinterpret_cast<const uint8_t *>(data.data()), data.size(), colors);
+}
+}
+BOOST_AUTO_TEST_SUITE(aseFormat)
+BOOST_AUTO_TEST_CASE(roundTrip) {
+	const char *names[] = { "Red", "", "Žalia", "青", "palette \xf0\x9f\x8e\xa8", "invalid \xff utf-8" };
+	ColorList colors, loaded;
+	test::RandomGenerator random(1);
+	for (auto name: names)
+		colors.add(ColorObject(name, Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), 1.0f)));
+	std::stringstream output(std::ios::out | std::ios::binary);
+	auto result = aseStreamSave(output, colors);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	result = load(output.str(), loaded);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	BOOST_REQUIRE_EQUAL(loaded.size(), colors.size());
+	for (size_t i = 0; i < colors.size(); ++i) {
+		auto *expected = *(colors.begin() + i), *colorObject = *(loaded.begin() + i);
+		BOOST_CHECK(colorObject->getColor() == expected->getColor());
+		if (i + 1 < colors.size())
+			BOOST_CHECK_EQUAL(colorObject->getName(), expected->getName());
+	}
+	BOOST_CHECK_EQUAL((*(loaded.end() - 1))->getName(), "invalid \xef\xbf\xbd utf-8");
+}
+BOOST_AUTO_TEST_CASE(groups) {
+	CorpusGenerator generator(2);
+	auto data = generator.generate(500);
+	ColorList loaded;
+	auto result = load(data, loaded);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	BOOST_REQUIRE_EQUAL(loaded.size(), generator.expected.size());
+	for (size_t i = 0; i < loaded.size(); ++i) {
+		auto *colorObject = *(loaded.begin() + i);
+		BOOST_CHECK_EQUAL(colorObject->getName(), generator.expected[i].name);
+		BOOST_CHECK_MESSAGE(colorObject->getColor() == generator.expected[i].color, "loaded wrong color at index " << i << ", " << colorObject->getColor() << " != " << generator.expected[i].color);
+	}
+}
+BOOST_AUTO_TEST_CASE(unpairedSurrogate) {
+	std::string data("ASEF\x00\x01\x00\x00\x00\x00\x00\x01"
+		"\x00\x01\x00\x00\x00\x12"
+		"\x00\x03\xd8\x3c\x00\x41\x00\x00"
+		"Gray\x3f\x80\x00\x00\x00\x02", 36);
+	ColorList loaded;
+	auto result = load(data, loaded);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	BOOST_REQUIRE_EQUAL(loaded.size(), 1);
+	BOOST_CHECK_EQUAL((*loaded.begin())->getName(), "\xef\xbf\xbd" "A");
+	BOOST_CHECK((*loaded.begin())->getColor() == Color(1.0f, 1.0f, 1.0f, 1.0f));
+}
+BOOST_AUTO_TEST_CASE(truncated) {
+	CorpusGenerator generator(3);
+	auto data = generator.generate(20);
+	for (size_t length = 0; length < data.size(); length++) {
+		ColorList loaded;
+		BOOST_CHECK_MESSAGE(!load(data.substr(0, length), loaded), "truncated file of length " << length << " loaded");
+		BOOST_CHECK(loaded.empty());
+	}
+	ColorList loaded;
+	BOOST_CHECK(!aseFileLoad("test/missing.ase", loaded));
+}
+BOOST_AUTO_TEST_CASE(fuzz) {
+	CorpusGenerator generator(4);
+	auto data = generator.generate(50);
+	test::RandomGenerator random(5);
+	for (int i = 0; i < 5000; i++) {
+		auto mutated = data;
+		for (uint32_t j = 0, count = 1 + random.next() % 8; j < count; j++)
+			mutated[12 + random.next() % (mutated.size() - 12)] = static_cast<char>(random.next());
+		ColorList loaded;
+		if (load(mutated, loaded))
+			BOOST_CHECK_LE(loaded.size(), generator.expected.size());
+		else
+			BOOST_CHECK(loaded.empty());
+	}
+}
+BOOST_AUTO_TEST_CASE(benchmarkLoad, BENCHMARK_DECORATORS) {
+	CorpusGenerator generator(6);
+	auto data = generator.generate(100000);
+	ColorList loaded;
+	test::benchmark("load 100000 swatches", [&]() {
+		BOOST_REQUIRE(load(data, loaded));
+	});
+	BOOST_CHECK_EQUAL(loaded.size(), generator.expected.size());
+	std::stringstream output(std::ios::out | std::ios::binary);
+	test::benchmark("save 100000 swatches", [&]() {
+		BOOST_REQUIRE(aseStreamSave(output, loaded));
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+/** Decorators for benchmark test cases. Benchmarks are disabled by default, run them with "tests --run_test=@benchmark --log_level=message". */
+#define BENCHMARK_DECORATORS *boost::unit_test::disabled() * boost::unit_test::label("benchmark")
+namespace test {
+template<typename Callback>
+double measure(Callback &&callback) {
+	auto start = std::chrono::steady_clock::now();
+	callback();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+template<typename Callback>
+double benchmark(std::string_view name, Callback &&callback) {
+	double seconds = measure(std::forward<Callback>(callback));
+	BOOST_TEST_MESSAGE(name << ": " << seconds * 1000 << " ms");
+	return seconds;
+}
+/** Deterministic pseudo random number generator, so that benchmarks and tests always use the same data. */
+struct RandomGenerator {
+	RandomGenerator(uint32_t seed = 1):
+		m_state(seed) {
+	}
+	uint32_t next() {
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+	float nextFloat(float min = 0.0f, float max = 1.0f) {
+		return min + (max - min) * static_cast<float>(next() >> 8) * (1.0f / (1 << 24));
+	}
+private:
+	uint32_t m_state;
+};
+}
@@ -18,8 +18,11 @@
 
 #include <boost/test/unit_test.hpp>
 #include "Common.h"
+#include "Benchmark.h"
 #include "Color.h"
+#include <cmath>
 #include <iostream>
+#include <vector>
 namespace {
 const Color testColor = { 0.5f, 0.25f, 0.1f, 1.0f };
 struct Initialize {
@@ -160,4 +163,47 @@ BOOST_AUTO_TEST_CASE(sRGBMatrix) {
 	auto result = Color(Color::sRGBInvertedMatrix * (Color::sRGBMatrix * testColor.rgbVector<double>()));
 	BOOST_CHECK_EQUAL(result, testColor);
 }
+BOOST_AUTO_TEST_CASE(linearRgbLookup) {
+	for (int i = 0; i < 256; i++) {
+		Color expected = Color(i, 0, 255 - i).linearRgb();
+		BOOST_CHECK_EQUAL(Color::linearRgbFromUint8(static_cast<uint8_t>(i), 0, static_cast<uint8_t>(255 - i)), expected);
+	}
+}
+BOOST_AUTO_TEST_CASE(nonLinearRgbLookup) {
+	float maxError = 0;
+	for (int i = 0; i <= 100000; i++) {
+		Color color(i / 100000.0f);
+		maxError = std::max(maxError, std::abs(color.nonLinearRgbFast().red - color.nonLinearRgb().red));
+	}
+	BOOST_CHECK_LT(maxError, 1e-6f);
+	Color outOfRange(-0.5f, 1.5f, 4.0f, 0.5f);
+	BOOST_CHECK_EQUAL(outOfRange.nonLinearRgbFast(), outOfRange.nonLinearRgb());
+	for (int i = 0; i < 256; i++) {
+		BOOST_CHECK_EQUAL(std::lround(Color(Color::linearRgbFromUint8(static_cast<uint8_t>(i))).nonLinearRgbFast().red * 255), i);
+	}
+}
+BOOST_AUTO_TEST_CASE(benchmarkLinearRgb, BENCHMARK_DECORATORS) {
+	test::RandomGenerator random;
+	std::vector<uint8_t> pixels(3 * 1000000);
+	for (auto &value: pixels)
+		value = static_cast<uint8_t>(random.next());
+	std::vector<Color> colors(pixels.size() / 3);
+	test::benchmark("linearRgb, 1 megapixel", [&]() {
+		for (size_t i = 0; i < colors.size(); i++)
+			colors[i] = Color(pixels[i * 3] / 255.0f, pixels[i * 3 + 1] / 255.0f, pixels[i * 3 + 2] / 255.0f).linearRgbInplace();
+	});
+	test::benchmark("linearRgbFromUint8, 1 megapixel", [&]() {
+		for (size_t i = 0; i < colors.size(); i++)
+			colors[i] = Color::linearRgbFromUint8(pixels[i * 3], pixels[i * 3 + 1], pixels[i * 3 + 2]);
+	});
+	std::vector<Color> results(colors.size());
+	test::benchmark("nonLinearRgb, 1 megapixel", [&]() {
+		for (size_t i = 0; i < colors.size(); i++)
+			results[i] = colors[i].nonLinearRgb();
+	});
+	test::benchmark("nonLinearRgbFast, 1 megapixel", [&]() {
+		for (size_t i = 0; i < colors.size(); i++)
+			results[i] = colors[i].nonLinearRgbFast();
+	});
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Common.h"
+#include "Benchmark.h"
+#include "ColorBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+using namespace color_batch;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+	~Initialize() {
+		setInstructions(supportedInstructions());
+	}
+};
+const Instructions allInstructions[] = { Instructions::scalar, Instructions::sse2, Instructions::avx2 };
+struct Buffers {
+	Buffers(const std::vector<Color> &colors):
+		x(colors.size()),
+		y(colors.size()),
+		z(colors.size()) {
+		split(common::Span<const Color>(colors.data(), colors.size()), channels());
+	}
+	Channels channels() {
+		return Channels(x.data(), y.data(), z.data(), x.size());
+	}
+	std::vector<float> x, y, z;
+};
+// Odd count makes sure that partially filled vectors are handled.
+std::vector<Color> randomColors(const Color &min, const Color &max, size_t count = 1003) {
+	test::RandomGenerator random(7);
+	std::vector<Color> colors(count);
+	for (auto &color: colors) {
+		for (int i = 0; i < 3; i++)
+			color[i] = random.nextFloat(min[i], max[i]);
+		color.alpha = 1.0f;
+	}
+	return colors;
+}
+std::vector<Color> labColors() {
+	auto colors = randomColors(Color(0.0f), Color(1.0f));
+	for (auto &color: colors)
+		color = color.rgbToLabD50();
+	return colors;
+}
+std::vector<Color> lchColors() {
+	auto colors = randomColors(Color(0.0f), Color(1.0f));
+	for (auto &color: colors)
+		color = color.rgbToLchD50();
+	return colors;
+}
+// Tolerance is relative for values larger than one.
+void check(const std::vector<Color> &inputs, std::function<void(const Channels &)> batch, std::function<Color(const Color &)> scalar, float tolerance, bool hue = false) {
+	for (auto instructions: allInstructions) {
+		if (setInstructions(instructions) != instructions)
+			continue;
+		Buffers buffers(inputs);
+		batch(buffers.channels());
+		for (size_t i = 0; i < inputs.size(); i++) {
+			Color expected = scalar(inputs[i]);
+			for (int channel = 0; channel < 3; channel++) {
+				float value = buffers.channels().data[channel][i];
+				float difference = std::abs(value - expected[channel]);
+				if (hue && channel == 2) {
+					// Hue is unstable for nearly achromatic colors and wraps around at 360 degrees.
+					if (expected[1] < 0.5f)
+						continue;
+					difference = std::min(difference, 360.0f - difference);
+				}
+				difference /= std::max(std::abs(expected[channel]), 1.0f);
+				BOOST_CHECK_MESSAGE(difference <= tolerance, "instructions " << static_cast<int>(instructions) << ", input " << inputs[i] << ", channel " << channel << ": " << value << " != " << expected[channel]);
+			}
+		}
+	}
+}
+}
+BOOST_FIXTURE_TEST_SUITE(colorBatch, Initialize)
+BOOST_AUTO_TEST_CASE(splitJoin) {
+	std::vector<Color> colors = { { 0.1f, 0.2f, 0.3f, 0.4f }, { 0.5f, 0.6f, 0.7f, 0.8f } };
+	Buffers buffers(colors);
+	BOOST_CHECK_EQUAL(buffers.y[1], 0.6f);
+	buffers.y[1] = 0.0f;
+	join(buffers.channels(), common::Span<Color>(colors.data(), colors.size()));
+	BOOST_CHECK_EQUAL(colors[1], Color(0.5f, 0.0f, 0.7f, 0.8f));
+	BOOST_CHECK_EQUAL(colors[0], Color(0.1f, 0.2f, 0.3f, 0.4f));
+}
+BOOST_AUTO_TEST_CASE(linearRgb) {
+	check(randomColors(Color(-0.1f), Color(1.1f)), color_batch::linearRgb, [](const Color &color) {
+		return color.linearRgb();
+	}, 2e-6f);
+	check(randomColors(Color(-0.1f), Color(1.1f)), color_batch::nonLinearRgb, [](const Color &color) {
+		return color.nonLinearRgb();
+	}, 2e-6f);
+}
+BOOST_AUTO_TEST_CASE(xyz) {
+	check(randomColors(Color(0.0f), Color(1.0f)), [](const Channels &channels) {
+		rgbToXyz(channels, Color::sRGBMatrix);
+	}, [](const Color &color) {
+		return color.rgbToXyz(Color::sRGBMatrix);
+	}, 2e-6f);
+	check(randomColors(Color(0.0f), Color(90.0f)), [](const Channels &channels) {
+		xyzToRgb(channels, Color::sRGBInvertedMatrix);
+	}, [](const Color &color) {
+		return color.xyzToRgb(Color::sRGBInvertedMatrix);
+	}, 1e-5f);
+}
+BOOST_AUTO_TEST_CASE(lab) {
+	const auto &white = Color::getReference(ReferenceIlluminant::D50, ReferenceObserver::_2);
+	check(randomColors(Color(0.0f), Color(90.0f)), [&white](const Channels &channels) {
+		xyzToLab(channels, white);
+	}, [&white](const Color &color) {
+		return color.xyzToLab(white);
+	}, 1e-4f);
+	check(labColors(), [&white](const Channels &channels) {
+		labToXyz(channels, white);
+	}, [&white](const Color &color) {
+		return color.labToXyz(white);
+	}, 1e-6f);
+	check(randomColors(Color(0.0f), Color(1.0f)), rgbToLabD50, [](const Color &color) {
+		return color.rgbToLabD50();
+	}, 1e-4f);
+	check(labColors(), labToRgbD50, [](const Color &color) {
+		return color.labToRgbD50();
+	}, 1e-5f);
+}
+BOOST_AUTO_TEST_CASE(lch) {
+	check(labColors(), labToLch, [](const Color &color) {
+		return color.labToLch();
+	}, 1e-3f, true);
+	check(lchColors(), lchToLab, [](const Color &color) {
+		return color.lchToLab();
+	}, 1e-4f);
+	check(randomColors(Color(0.0f), Color(1.0f)), rgbToLchD50, [](const Color &color) {
+		return color.rgbToLchD50();
+	}, 1e-3f, true);
+	check(lchColors(), lchToRgbD50, [](const Color &color) {
+		return color.lchToRgbD50();
+	}, 1e-5f);
+}
+BOOST_AUTO_TEST_CASE(hsvHsl) {
+	check(randomColors(Color(0.0f), Color(1.0f)), color_batch::hsvToRgb, [](const Color &color) {
+		return color.hsvToRgb();
+	}, 2e-6f);
+	check(randomColors(Color(0.0f), Color(1.0f)), color_batch::hslToRgb, [](const Color &color) {
+		return color.hslToRgb();
+	}, 2e-6f);
+	std::vector<Color> sectors;
+	for (int i = 0; i <= 12; i++)
+		sectors.emplace_back(i / 12.0f, 0.75f, 0.5f, 1.0f);
+	check(sectors, color_batch::hsvToRgb, [](const Color &color) {
+		return color.hsvToRgb();
+	}, 2e-6f);
+	check(sectors, color_batch::hslToRgb, [](const Color &color) {
+		return color.hslToRgb();
+	}, 2e-6f);
+}
+BOOST_AUTO_TEST_CASE(argb32) {
+	std::vector<Color> colors = { { 0.0f, 0.5f, 1.0f }, { -0.5f, 1.5f, 0.25f } };
+	Buffers buffers(colors);
+	uint32_t pixels[2];
+	rgbToArgb32(buffers.channels(), pixels);
+	BOOST_CHECK_EQUAL(pixels[0], 0xff007fffu);
+	BOOST_CHECK_EQUAL(pixels[1], 0xff00ff3fu);
+}
+BOOST_AUTO_TEST_CASE(achromatic) {
+	std::vector<Color> colors = { { 0.0f, 0.0f, 0.0f }, { 50.0f, 0.0f, 0.0f }, { 100.0f, 0.0f, 0.0f } };
+	for (auto instructions: allInstructions) {
+		if (setInstructions(instructions) != instructions)
+			continue;
+		Buffers buffers(colors);
+		labToLch(buffers.channels());
+		for (size_t i = 0; i < colors.size(); i++) {
+			BOOST_CHECK_EQUAL(buffers.y[i], 0.0f);
+			BOOST_CHECK_EQUAL(buffers.z[i], 0.0f);
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(benchmarkRgbToLab, BENCHMARK_DECORATORS) {
+	auto colors = randomColors(Color(0.0f), Color(1.0f), 1000000);
+	std::vector<Color> results(colors.size());
+	test::benchmark("Color::rgbToLabD50, 1M colors", [&]() {
+		for (size_t i = 0; i < colors.size(); i++)
+			results[i] = colors[i].rgbToLabD50();
+	});
+	const char *names[] = { "scalar", "SSE2", "AVX2" };
+	for (auto instructions: allInstructions) {
+		if (setInstructions(instructions) != instructions)
+			continue;
+		Buffers buffers(colors);
+		test::benchmark(std::string("color_batch::rgbToLabD50, 1M colors, ") + names[static_cast<int>(instructions)], [&]() {
+			rgbToLabD50(buffers.channels());
+		});
+		buffers = Buffers(colors);
+		test::benchmark(std::string("color_batch::rgbToLchD50, 1M colors, ") + names[static_cast<int>(instructions)], [&]() {
+			rgbToLchD50(buffers.channels());
+		});
+		test::benchmark(std::string("color_batch::lchToRgbD50, 1M colors, ") + names[static_cast<int>(instructions)], [&]() {
+			lchToRgbD50(buffers.channels());
+		});
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "math/ColorHistogram.h"
+#include "math/OctreeColorQuantization.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+struct Image {
+	Image(int width, int height, int channels, uint32_t seed):
+		width(width),
+		height(height),
+		channels(channels),
+		stride(width * channels + 3),
+		data(stride * height) {
+		test::RandomGenerator random(seed);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				uint8_t *pixel = &data[y * stride + x * channels];
+				// Blocks of equal colors mixed with noise.
+				uint32_t value = (x / 16 + y / 16) % 5 == 0 ? random.next() : (x / 16) * 2654435761u + (y / 16) * 40503u;
+				for (int c = 0; c < channels; c++)
+					pixel[c] = static_cast<uint8_t>(value >> (c * 8));
+			}
+		}
+	}
+	int width, height, channels, stride;
+	std::vector<uint8_t> data;
+};
+struct Bin {
+	Color color;
+	uint64_t pixels;
+	bool operator==(const Bin &bin) const {
+		return pixels == bin.pixels && color.red == bin.color.red && color.green == bin.color.green && color.blue == bin.color.blue;
+	}
+};
+std::vector<Bin> bins(const ColorHistogram &histogram) {
+	std::vector<Bin> result;
+	histogram.visit([&](const Color &color, uint64_t pixels) {
+		result.push_back(Bin { color, pixels });
+	});
+	return result;
+}
+std::vector<Bin> leafs(OctreeColorQuantization &octree) {
+	std::vector<Bin> result;
+	octree.visit([&](const float sum[3], size_t pixels) {
+		result.push_back(Bin { Color(sum[0], sum[1], sum[2]), pixels });
+	});
+	return result;
+}
+}
+BOOST_FIXTURE_TEST_SUITE(colorHistogram, Initialize)
+BOOST_AUTO_TEST_CASE(binColors) {
+	ColorHistogram histogram(5);
+	BOOST_CHECK_EQUAL(histogram.binCount(), 1 << 15);
+	histogram.add(255, 0, 0, 2);
+	histogram.add(250, 0, 0, 2);
+	histogram.add(0, 0, 128);
+	BOOST_CHECK_EQUAL(histogram.totalPixels(), 5);
+	auto result = bins(histogram);
+	BOOST_REQUIRE_EQUAL(result.size(), 2);
+	BOOST_CHECK_EQUAL(result[0].pixels, 1);
+	BOOST_CHECK_CLOSE(result[0].color.blue, Color::linearRgbFromUint8(128), 1e-3f);
+	BOOST_CHECK_EQUAL(result[1].pixels, 4);
+	BOOST_CHECK_CLOSE(result[1].color.red, (Color::linearRgbFromUint8(255) + Color::linearRgbFromUint8(250)) / 2, 1e-3f);
+	BOOST_CHECK_EQUAL(result[1].color.green, 0.0f);
+	histogram.clear();
+	BOOST_CHECK_EQUAL(histogram.totalPixels(), 0);
+	BOOST_CHECK(bins(histogram).empty());
+}
+BOOST_AUTO_TEST_CASE(grayscale) {
+	Image image(64, 64, 1, 3);
+	ColorHistogram histogram;
+	histogram.addImage(image.data.data(), image.width, image.height, image.stride, image.channels);
+	BOOST_CHECK_EQUAL(histogram.totalPixels(), 64 * 64);
+	histogram.visit([](const Color &color, uint64_t) {
+		BOOST_CHECK_EQUAL(color.red, color.green);
+		BOOST_CHECK_EQUAL(color.red, color.blue);
+	});
+}
+BOOST_AUTO_TEST_CASE(deterministic) {
+	Image image(300, 200, 4, 1);
+	ColorHistogram sequential, parallel, threaded;
+	for (int y = 0; y < image.height; y++) {
+		for (int x = 0; x < image.width; x++) {
+			const uint8_t *pixel = &image.data[y * image.stride + x * image.channels];
+			sequential.add(pixel[0], pixel[1], pixel[2]);
+		}
+	}
+	parallel.addImage(image.data.data(), image.width, image.height, image.stride, image.channels);
+	// Interleaved columns on several threads, added in a different order than all other histograms.
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 5; t++) {
+		threads.emplace_back([&, t]() {
+			for (int y = image.height - 1; y >= 0; y--) {
+				for (int x = t; x < image.width; x += 5) {
+					const uint8_t *pixel = &image.data[y * image.stride + x * image.channels];
+					threaded.add(pixel[0], pixel[1], pixel[2]);
+				}
+			}
+		});
+	}
+	for (auto &thread: threads)
+		thread.join();
+	auto expected = bins(sequential);
+	BOOST_CHECK(bins(parallel) == expected);
+	BOOST_CHECK(bins(threaded) == expected);
+	OctreeColorQuantization sequentialOctree, threadedOctree;
+	sequentialOctree.add(sequential);
+	threadedOctree.add(threaded);
+	sequentialOctree.reduce(100);
+	threadedOctree.reduce(100);
+	BOOST_CHECK_EQUAL(sequentialOctree.size(), 100);
+	BOOST_CHECK(leafs(sequentialOctree) == leafs(threadedOctree));
+}
+BOOST_AUTO_TEST_CASE(subsampling) {
+	Image image(301, 202, 3, 2);
+	const int step = 3;
+	ColorHistogram sequential, subsampled, rows;
+	for (int y = 0; y < image.height; y += step) {
+		for (int x = 0; x < image.width; x += step) {
+			const uint8_t *pixel = &image.data[y * image.stride + x * image.channels];
+			sequential.add(pixel[0], pixel[1], pixel[2]);
+		}
+	}
+	subsampled.addImage(image.data.data(), image.width, image.height, image.stride, image.channels, step);
+	BOOST_CHECK_EQUAL(subsampled.totalPixels(), 101 * 68);
+	// Row ranges starting at multiples of step, as added while image is being decoded.
+	for (int y = 0; y < image.height; y += 7 * step) {
+		int height = std::min(7 * step, image.height - y);
+		rows.addImage(&image.data[y * image.stride], image.width, height, image.stride, image.channels, step);
+	}
+	auto expected = bins(sequential);
+	BOOST_CHECK(bins(subsampled) == expected);
+	BOOST_CHECK(bins(rows) == expected);
+}
+BOOST_AUTO_TEST_CASE(benchmarkQuantization, BENCHMARK_DECORATORS) {
+	Image image(2048, 2048, 3, 1);
+	test::benchmark("octree from pixels, 4 megapixels", [&]() {
+		OctreeColorQuantization octree;
+		for (int y = 0; y < image.height; y++) {
+			for (int x = 0; x < image.width; x++) {
+				const uint8_t *pixel = &image.data[y * image.stride + x * image.channels];
+				octree.add(Color::linearRgbFromUint8(pixel[0], pixel[1], pixel[2]), { pixel[0], pixel[1], pixel[2] });
+			}
+		}
+		octree.reduce(1000);
+	});
+	test::benchmark("octree from histogram, 4 megapixels", [&]() {
+		ColorHistogram histogram;
+		histogram.addImage(image.data.data(), image.width, image.height, image.stride, image.channels);
+		OctreeColorQuantization octree;
+		octree.add(histogram);
+		octree.reduce(1000);
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
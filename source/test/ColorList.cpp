@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "IPalette.h"
+#include "common/Format.h"
+#include "common/ObjectPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+namespace {
+// Keeps a copy of color list rows, like list palette does.
+struct MirrorPalette: public IPalette {
+	MirrorPalette(bool ranges):
+		ranges(ranges) {
+	}
+	virtual void add(ColorList &, ColorObject *colorObject) override {
+		rows.push_back(colorObject);
+		addCalls++;
+	}
+	virtual void remove(ColorList &, ColorObject *colorObject) override {
+		rows.erase(std::find(rows.begin(), rows.end(), colorObject));
+		removeCalls++;
+	}
+	virtual void addRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		if (!ranges)
+			return IPalette::addRange(colorList, colorObjects);
+		rows.insert(rows.end(), colorObjects.data(), colorObjects.data() + colorObjects.size());
+		addCalls++;
+	}
+	virtual void removeRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		if (!ranges)
+			return IPalette::removeRange(colorList, colorObjects);
+		std::vector<ColorObject *> removed(colorObjects.data(), colorObjects.data() + colorObjects.size());
+		std::sort(removed.begin(), removed.end());
+		rows.erase(std::remove_if(rows.begin(), rows.end(), [&removed](ColorObject *colorObject) {
+			return std::binary_search(removed.begin(), removed.end(), colorObject);
+		}), rows.end());
+		removeCalls++;
+	}
+	virtual void removeSelected(ColorList &) override {
+	}
+	virtual void clear(ColorList &) override {
+		rows.clear();
+	}
+	virtual void update(ColorList &) override {
+		updates++;
+	}
+	bool ranges;
+	std::vector<ColorObject *> rows;
+	size_t addCalls = 0, removeCalls = 0, updates = 0;
+};
+ColorList makeColors(size_t count) {
+	ColorList colorList;
+	test::RandomGenerator random;
+	for (size_t i = 0; i < count; i++)
+		colorList.add(ColorObject(common::format("color {}", i), Color(random.nextFloat(), random.nextFloat(), random.nextFloat())));
+	return colorList;
+}
+// Color object layout before pooling and name interning, allocated with global operator new.
+struct HeapColorObject {
+	virtual ~HeapColorObject() = default;
+	uint32_t references = 1;
+	std::string name;
+	Color color;
+};
+bool sameRows(const ColorList &colorList, const MirrorPalette &palette) {
+	return std::equal(colorList.begin(), colorList.end(), palette.rows.begin(), palette.rows.end());
+}
+}
+BOOST_AUTO_TEST_SUITE(colorList)
+BOOST_AUTO_TEST_CASE(addRange) {
+	auto colors = makeColors(100);
+	MirrorPalette palette(true);
+	ColorList colorList(palette);
+	colorList.add(*colors.begin());
+	colorList.add(colors);
+	BOOST_CHECK_EQUAL(colorList.size(), 101);
+	BOOST_CHECK_EQUAL(palette.addCalls, 2);
+	BOOST_CHECK_EQUAL(palette.updates, 1);
+	BOOST_CHECK(sameRows(colorList, palette));
+	std::vector<ColorObject *> colorObjects(colors.begin(), colors.begin() + 10);
+	colorList.add(colorObjects);
+	BOOST_CHECK_EQUAL(colorList.size(), 111);
+	BOOST_CHECK_EQUAL(palette.addCalls, 3);
+	BOOST_CHECK_EQUAL(palette.updates, 2);
+	BOOST_CHECK(sameRows(colorList, palette));
+	colorList.add(std::vector<ColorObject *>());
+	BOOST_CHECK_EQUAL(palette.addCalls, 3);
+}
+BOOST_AUTO_TEST_CASE(removeRange) {
+	auto colors = makeColors(100);
+	MirrorPalette palette(true), singlePalette(false);
+	ColorList colorList(palette), singleColorList(singlePalette);
+	colorList.add(colors);
+	singleColorList.add(colors);
+	BOOST_CHECK_EQUAL(singlePalette.addCalls, 100);
+	size_t index = 0;
+	auto everyThird = [&index](ColorObject *) {
+		return index++ % 3 == 0;
+	};
+	{
+		auto guard = colorList.changeGuard();
+		colorList.remove(everyThird, false, true);
+	}
+	index = 0;
+	singleColorList.remove(everyThird, false, true);
+	BOOST_CHECK_EQUAL(colorList.size(), 66);
+	BOOST_CHECK_EQUAL(palette.removeCalls, 1);
+	BOOST_CHECK_EQUAL(palette.updates, 2);
+	BOOST_CHECK(sameRows(colorList, palette));
+	BOOST_CHECK_EQUAL(singlePalette.removeCalls, 34);
+	BOOST_CHECK(sameRows(singleColorList, singlePalette));
+	colorList.remove([](ColorObject *) {
+		return false;
+	}, false, true);
+	BOOST_CHECK_EQUAL(palette.removeCalls, 1);
+	BOOST_CHECK_EQUAL(colors.begin()[1]->references(), 3);
+}
+BOOST_AUTO_TEST_CASE(benchmarkInsert, BENCHMARK_DECORATORS) {
+	const size_t count = 1000000;
+	auto colors = makeColors(count);
+	test::benchmark("1M colors, no-op palette, one by one", [&]() {
+		ColorList colorList;
+		auto guard = colorList.changeGuard();
+		for (auto *colorObject: colors)
+			colorList.add(colorObject);
+	});
+	test::benchmark("1M colors, no-op palette, range", [&]() {
+		ColorList colorList;
+		colorList.add(colors);
+	});
+	test::benchmark("1M colors, mirror palette, one by one", [&]() {
+		MirrorPalette palette(false);
+		ColorList colorList(palette);
+		colorList.add(colors);
+	});
+	test::benchmark("1M colors, mirror palette, range", [&]() {
+		MirrorPalette palette(true);
+		ColorList colorList(palette);
+		colorList.add(colors);
+	});
+	auto lowRed = [](ColorObject *colorObject) {
+		return colorObject->getColor().red < 0.5f;
+	};
+	MirrorPalette palette(true), singlePalette(false);
+	ColorList colorList(palette), singleColorList(singlePalette);
+	colorList.add(colors);
+	singleColorList.add(std::vector<ColorObject *>(colors.begin(), colors.begin() + count / 10));
+	test::benchmark("remove half of 1M colors, mirror palette, range", [&]() {
+		colorList.remove(lowRed, false, true);
+	});
+	test::benchmark("remove half of 100k colors, mirror palette, one by one", [&]() {
+		singleColorList.remove(lowRed, false, true);
+	});
+}
+BOOST_AUTO_TEST_CASE(pooledObjects) {
+	size_t objects, bytes;
+	ColorObject::poolStatistics(objects, bytes);
+	std::vector<ColorObject *> colorObjects;
+	for (int i = 0; i < 100; i++)
+		colorObjects.push_back(new ColorObject("pooled", Color(0.5f)));
+	// Allocation order depends on objects freed by earlier tests, so only check that objects are distinct and packed into
+	// the current block and at most one more. Contiguous placement in a fresh pool is covered by objectPool/contiguous.
+	std::set<uintptr_t> addresses, blocks;
+	for (auto *colorObject: colorObjects) {
+		auto address = reinterpret_cast<uintptr_t>(colorObject);
+		addresses.insert(address);
+		blocks.insert(address & ~static_cast<uintptr_t>(common::ObjectPool::blockSize - 1));
+	}
+	BOOST_CHECK_EQUAL(addresses.size(), colorObjects.size());
+	BOOST_CHECK_LE(blocks.size(), 2u);
+	BOOST_CHECK(&colorObjects[0]->getName() == &colorObjects[99]->getName());
+	size_t pooledObjects, pooledBytes;
+	ColorObject::poolStatistics(pooledObjects, pooledBytes);
+	BOOST_CHECK_EQUAL(pooledObjects, objects + 100);
+	BOOST_CHECK_LE(pooledBytes, bytes + common::ObjectPool::blockSize);
+	BOOST_CHECK_EQUAL(pooledBytes % common::ObjectPool::blockSize, 0u);
+	auto copy = colorObjects[0]->copy();
+	BOOST_CHECK_EQUAL(copy->getName(), "pooled");
+	copy->setName("renamed");
+	BOOST_CHECK_EQUAL(colorObjects[0]->getName(), "pooled");
+	for (auto *colorObject: colorObjects)
+		colorObject->release();
+	copy = common::nullRef;
+	ColorObject::poolStatistics(pooledObjects, pooledBytes);
+	BOOST_CHECK_EQUAL(pooledObjects, objects);
+}
+BOOST_AUTO_TEST_CASE(benchmarkMemory, BENCHMARK_DECORATORS) {
+	const size_t count = 1000000;
+	// Quantizer and most imported palettes repeat a small set of names.
+	std::vector<std::string> names;
+	for (int i = 0; i < 256; i++)
+		names.push_back(common::format("imported color name {}", i));
+	size_t objects, bytes;
+	ColorObject::poolStatistics(objects, bytes);
+	std::vector<ColorObject *> pooled;
+	std::vector<std::unique_ptr<HeapColorObject>> heap;
+	pooled.reserve(count);
+	heap.reserve(count);
+	test::RandomGenerator random;
+	std::vector<Color> colors;
+	for (size_t i = 0; i < count; i++)
+		colors.emplace_back(random.nextFloat(), random.nextFloat(), random.nextFloat());
+	test::benchmark("create 1M pooled colors", [&]() {
+		for (size_t i = 0; i < count; i++)
+			pooled.push_back(new ColorObject(names[i % names.size()], colors[i]));
+	});
+	test::benchmark("create 1M heap colors", [&]() {
+		for (size_t i = 0; i < count; i++) {
+			auto colorObject = std::make_unique<HeapColorObject>();
+			colorObject->name = names[i % names.size()];
+			colorObject->color = colors[i];
+			heap.push_back(std::move(colorObject));
+		}
+	});
+	size_t pooledObjects, pooledBytes;
+	ColorObject::poolStatistics(pooledObjects, pooledBytes);
+	BOOST_TEST_MESSAGE("pooled color: " << static_cast<double>(pooledBytes - bytes) / (pooledObjects - objects) << " bytes per entry, " << sizeof(ColorObject) << " bytes object");
+	// Heap allocator adds at least 8 bytes and rounds up to 16, names longer than 15 characters have their own allocation.
+	auto heapSize = [](size_t size) {
+		return (size + 8 + 15) / 16 * 16;
+	};
+	BOOST_TEST_MESSAGE("heap color: " << heapSize(sizeof(HeapColorObject)) + heapSize(names[0].size() + 1) << " bytes per entry, " << sizeof(HeapColorObject) << " bytes object");
+	float pooledSum = 0, heapSum = 0;
+	test::benchmark("iterate 1M pooled colors", [&]() {
+		for (int repeat = 0; repeat < 10; repeat++)
+			for (auto *colorObject: pooled)
+				pooledSum += colorObject->getColor().red + colorObject->getName().size();
+	});
+	test::benchmark("iterate 1M heap colors", [&]() {
+		for (int repeat = 0; repeat < 10; repeat++)
+			for (auto &colorObject: heap)
+				heapSum += colorObject->color.red + colorObject->name.size();
+	});
+	BOOST_CHECK_EQUAL(pooledSum, heapSum);
+	test::benchmark("destroy 1M pooled colors", [&]() {
+		for (auto *colorObject: pooled)
+			colorObject->release();
+		pooled.clear();
+	});
+	test::benchmark("destroy 1M heap colors", [&]() {
+		heap.clear();
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
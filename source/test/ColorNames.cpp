@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "color_names/ColorNames.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+namespace {
+struct Names {
+	Names():
+		colorNames(color_names_new()) {
+		Color::initialize();
+	}
+	~Names() {
+		color_names_destroy(colorNames);
+	}
+	ColorNames *colorNames;
+};
+void writeDictionary(const std::string &path, size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	std::ofstream file(path, std::ios::trunc);
+	for (size_t i = 0; i < count; i++)
+		file << (random.next() % 256) << ' ' << (random.next() % 256) << ' ' << (random.next() % 256) << "\tcolor " << i << '\n';
+}
+std::vector<Color> randomColors(size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	std::vector<Color> colors(count);
+	for (auto &color: colors)
+		color = Color(random.nextFloat(), random.nextFloat(), random.nextFloat());
+	return colors;
+}
+}
+BOOST_AUTO_TEST_SUITE(colorNames)
+BOOST_FIXTURE_TEST_CASE(batchMatchesScalar, Names) {
+	test::TemporaryFile text("color-names.txt");
+	writeDictionary(text.path, 3000, 1);
+	BOOST_REQUIRE_EQUAL(color_names_load_from_file(colorNames, text.path), 0);
+	ColorList colorList;
+	auto paletteColors = randomColors(500, 2);
+	for (size_t i = 0; i < paletteColors.size(); i++)
+		colorList.add(ColorObject("palette " + std::to_string(i), paletteColors[i]));
+	color_names_load_from_list(colorNames, colorList);
+	auto colors = randomColors(5000, 3);
+	// Exact palette colors have zero distance and are named without imprecision postfix.
+	colors.insert(colors.end(), paletteColors.begin(), paletteColors.end());
+	for (auto imprecisionPostfix: { false, true }) {
+		BOOST_TEST_CONTEXT("imprecision postfix " << imprecisionPostfix) {
+			std::vector<std::string> names;
+			color_names_get(colorNames, common::Span<const Color>(colors.data(), colors.size()), imprecisionPostfix, names);
+			BOOST_REQUIRE_EQUAL(names.size(), colors.size());
+			size_t imprecise = 0;
+			for (size_t i = 0; i < colors.size(); i++) {
+				BOOST_CHECK_EQUAL(names[i], color_names_get(colorNames, &colors[i], imprecisionPostfix));
+				if (names[i].size() > 2 && names[i].compare(names[i].size() - 2, 2, " ~") == 0)
+					imprecise++;
+			}
+			if (imprecisionPostfix) {
+				BOOST_CHECK_GT(imprecise, 0);
+				BOOST_CHECK_LT(imprecise, colors.size());
+			} else {
+				BOOST_CHECK_EQUAL(imprecise, 0);
+			}
+			for (size_t i = 0; i < paletteColors.size(); i++)
+				BOOST_CHECK_EQUAL(names[colors.size() - paletteColors.size() + i], "palette " + std::to_string(i));
+		}
+	}
+}
+BOOST_FIXTURE_TEST_CASE(emptyNames, Names) {
+	auto colors = randomColors(10, 4);
+	std::vector<std::string> names(3, "stale");
+	color_names_get(colorNames, common::Span<const Color>(colors.data(), colors.size()), true, names);
+	BOOST_REQUIRE_EQUAL(names.size(), colors.size());
+	for (size_t i = 0; i < colors.size(); i++) {
+		BOOST_CHECK(names[i].empty());
+		BOOST_CHECK(color_names_get(colorNames, &colors[i], true).empty());
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "math/ColorQuantizer.h"
+#include "math/ColorHistogram.h"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+// Smooth gradient in the top half and noisy color clusters in the bottom half.
+struct Image {
+	Image(int width, int height, uint32_t seed):
+		width(width),
+		height(height),
+		data(width * height * 3) {
+		test::RandomGenerator random(seed);
+		uint8_t clusters[12][3];
+		for (auto &cluster: clusters) {
+			for (auto &value: cluster)
+				value = static_cast<uint8_t>(random.next() >> 24);
+		}
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				uint8_t *pixel = &data[(y * width + x) * 3];
+				if (y < height / 2) {
+					pixel[0] = static_cast<uint8_t>(x * 255 / width);
+					pixel[1] = static_cast<uint8_t>(y * 2 * 255 / height);
+					pixel[2] = static_cast<uint8_t>(255 - x * 255 / width);
+				} else {
+					const uint8_t *cluster = clusters[(x / 32 + y / 32 * 7) % 12];
+					for (int c = 0; c < 3; c++)
+						pixel[c] = static_cast<uint8_t>(std::clamp(cluster[c] + static_cast<int>(random.nextFloat(-12, 12)), 0, 255));
+				}
+			}
+		}
+	}
+	int width, height;
+	std::vector<uint8_t> data;
+};
+// Mean CIE76 color difference between image pixels and the closest palette colors.
+double meanDeltaE(const Image &image, const std::vector<QuantizedColor> &palette) {
+	std::vector<Color> labPalette;
+	for (const auto &color: palette)
+		labPalette.push_back(color.color.nonLinearRgb().rgbToLabD50());
+	double sum = 0;
+	for (size_t i = 0, count = image.data.size() / 3; i < count; i++) {
+		const uint8_t *pixel = &image.data[i * 3];
+		Color lab = Color(pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f).rgbToLabD50();
+		float best = std::numeric_limits<float>::max();
+		for (const auto &color: labPalette) {
+			float dl = lab.lab.L - color.lab.L, da = lab.lab.a - color.lab.a, db = lab.lab.b - color.lab.b;
+			best = std::min(best, dl * dl + da * da + db * db);
+		}
+		sum += std::sqrt(best);
+	}
+	return sum / (image.data.size() / 3);
+}
+bool equal(const std::vector<QuantizedColor> &a, const std::vector<QuantizedColor> &b) {
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].pixels != b[i].pixels || a[i].color.red != b[i].color.red || a[i].color.green != b[i].color.green || a[i].color.blue != b[i].color.blue)
+			return false;
+	}
+	return true;
+}
+const QuantizerType quantizerTypes[] = { QuantizerType::octree, QuantizerType::medianCut, QuantizerType::kMeansLinearRgb, QuantizerType::kMeansLab };
+const char *quantizerNames[] = { "octree", "median cut", "k-means linear RGB", "k-means Lab" };
+}
+BOOST_FIXTURE_TEST_SUITE(colorQuantizer, Initialize)
+BOOST_AUTO_TEST_CASE(pixelCount) {
+	Image image(256, 128, 1);
+	ColorHistogram histogram;
+	histogram.addImage(image.data.data(), image.width, image.height, image.width * 3, 3);
+	for (auto type: quantizerTypes) {
+		auto palette = createQuantizer(type)->quantize(histogram, 32);
+		BOOST_CHECK_LE(palette.size(), 32);
+		BOOST_CHECK_GE(palette.size(), 16);
+		uint64_t pixels = 0;
+		for (const auto &color: palette)
+			pixels += color.pixels;
+		BOOST_CHECK_EQUAL(pixels, histogram.totalPixels());
+	}
+}
+BOOST_AUTO_TEST_CASE(distinctColors) {
+	ColorHistogram histogram;
+	const uint8_t colors[4][3] = { { 250, 10, 10 }, { 10, 250, 10 }, { 10, 10, 250 }, { 128, 128, 128 } };
+	for (int i = 0; i < 4; i++)
+		histogram.add(colors[i][0], colors[i][1], colors[i][2], (i + 1) * 100);
+	for (auto type: quantizerTypes) {
+		auto quantizer = createQuantizer(type);
+		BOOST_CHECK_EQUAL(quantizer->quantize(histogram, 10).size(), 4);
+		auto palette = quantizer->quantize(histogram, 4);
+		BOOST_REQUIRE_EQUAL(palette.size(), 4);
+		for (int i = 0; i < 4; i++) {
+			Color expected = Color::linearRgbFromUint8(colors[i][0], colors[i][1], colors[i][2]);
+			size_t matches = 0;
+			for (const auto &color: palette) {
+				if (color.pixels == static_cast<uint64_t>((i + 1) * 100) && std::abs(color.color.red - expected.red) < 1e-5f && std::abs(color.color.green - expected.green) < 1e-5f && std::abs(color.color.blue - expected.blue) < 1e-5f)
+					matches++;
+			}
+			BOOST_CHECK_EQUAL(matches, 1);
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(emptyHistogram) {
+	ColorHistogram histogram;
+	for (auto type: quantizerTypes)
+		BOOST_CHECK(createQuantizer(type)->quantize(histogram, 8).empty());
+}
+BOOST_AUTO_TEST_CASE(kMeansRefines) {
+	Image image(256, 256, 2);
+	ColorHistogram histogram;
+	histogram.addImage(image.data.data(), image.width, image.height, image.width * 3, 3);
+	double medianCut = meanDeltaE(image, MedianCutQuantizer().quantize(histogram, 16));
+	double kMeans = meanDeltaE(image, createQuantizer(QuantizerType::kMeansLab)->quantize(histogram, 16));
+	BOOST_CHECK_LT(kMeans, medianCut);
+}
+BOOST_AUTO_TEST_CASE(algorithmsDiffer) {
+	Image image(256, 256, 4);
+	ColorHistogram histogram;
+	histogram.addImage(image.data.data(), image.width, image.height, image.width * 3, 3);
+	for (size_t colors: { 8, 64 }) {
+		std::vector<std::vector<QuantizedColor>> palettes;
+		for (auto type: quantizerTypes)
+			palettes.push_back(createQuantizer(type)->quantize(histogram, colors));
+		for (size_t i = 0; i < palettes.size(); i++) {
+			BOOST_CHECK_LE(palettes[i].size(), colors);
+			for (size_t j = i + 1; j < palettes.size(); j++)
+				BOOST_CHECK_MESSAGE(!equal(palettes[i], palettes[j]), quantizerNames[i] << " and " << quantizerNames[j] << " produce the same " << colors << " color palette");
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(kMeansBounded) {
+	Image image(256, 256, 5);
+	ColorHistogram histogram;
+	histogram.addImage(image.data.data(), image.width, image.height, image.width * 3, 3);
+	auto assignedOnly = KMeansQuantizer(std::make_unique<MedianCutQuantizer>(), KMeansQuantizer::Space::lab, 0).quantize(histogram, 64);
+	auto bounded = KMeansQuantizer(std::make_unique<MedianCutQuantizer>(), KMeansQuantizer::Space::lab, 16, 1).quantize(histogram, 64);
+	auto refined = KMeansQuantizer(std::make_unique<MedianCutQuantizer>(), KMeansQuantizer::Space::lab, 16).quantize(histogram, 64);
+	BOOST_CHECK(equal(assignedOnly, bounded));
+	BOOST_CHECK(!equal(bounded, refined));
+}
+BOOST_AUTO_TEST_CASE(benchmarkQuality, BENCHMARK_DECORATORS) {
+	Image image(2048, 1024, 3);
+	const double megapixels = image.width * image.height / 1e6;
+	for (size_t colors: { 16, 64, 256 }) {
+		for (size_t i = 0; i < std::size(quantizerTypes); i++) {
+			auto quantizer = createQuantizer(quantizerTypes[i]);
+			std::vector<QuantizedColor> palette;
+			double seconds = test::measure([&]() {
+				ColorHistogram histogram;
+				histogram.addImage(image.data.data(), image.width, image.height, image.width * 3, 3);
+				palette = quantizer->quantize(histogram, colors);
+			});
+			BOOST_TEST_MESSAGE(quantizerNames[i] << ", " << colors << " colors: mean delta E " << meanDeltaE(image, palette) << ", " << seconds * 1000 / megapixels << " ms per megapixel");
+		}
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
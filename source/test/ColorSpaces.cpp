@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include "ColorSpaces.h"
+#include "Color.h"
+#include <string>
+#include <vector>
+BOOST_AUTO_TEST_SUITE(componentTexts)
+BOOST_AUTO_TEST_CASE(formatComponentTexts) {
+	std::vector<std::string> texts;
+	ComponentTexts::format(ColorSpace::rgb, Color(0.5f, 1.0f, 0.0f), 0.26f, texts);
+	BOOST_CHECK(texts == (std::vector<std::string> { "128", "255", "0", "26" }));
+	ComponentTexts::format(ColorSpace::hsl, Color(0.5f, 0.25f, 0.125f), 1.0f, texts);
+	BOOST_CHECK(texts == (std::vector<std::string> { "180", "25", "13", "100" }));
+	ComponentTexts::format(ColorSpace::cmyk, Color(0.1f, 0.2f, 0.3f, 0.4f), 0.5f, texts);
+	BOOST_CHECK(texts == (std::vector<std::string> { "26", "51", "77", "102", "50" }));
+	ComponentTexts::format(ColorSpace::lab, Color(53.4f, -20.5f, -0.2f), 1.0f, texts);
+	BOOST_CHECK(texts == (std::vector<std::string> { "53", "-20", "0", "100" }));
+	ComponentTexts::format(ColorSpace::lch, Color(50.0f, 33.6f, 359.7f), 0.0f, texts);
+	BOOST_CHECK(texts == (std::vector<std::string> { "50", "34", "360", "0" }));
+}
+BOOST_AUTO_TEST_CASE(componentTextsCache) {
+	ComponentTexts cache;
+	int calls = 0;
+	auto format = [&calls](std::vector<std::string> &texts) {
+		texts.assign(1, std::to_string(++calls));
+	};
+	Color color(0.1f, 0.2f, 0.3f);
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::rgb, color, 1.0f, 0, format)[0], "1");
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::rgb, color, 1.0f, 0, format)[0], "1");
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::hsv, color, 1.0f, 0, format)[0], "2");
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::rgb, color, 0.5f, 0, format)[0], "3");
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::rgb, color, 0.5f, 1, format)[0], "4");
+	color.blue = 0.4f;
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::rgb, color, 0.5f, 1, format)[0], "5");
+	BOOST_CHECK_EQUAL(cache.get(ColorSpace::hsv, Color(0.1f, 0.2f, 0.3f), 1.0f, 0, format)[0], "2");
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,6 +17,8 @@
  */
 
 #include "Common.h"
+#include <cstdio>
+#include <filesystem>
 #include <ostream>
 std::ostream &operator<<(std::ostream &stream, const Color &color) {
 	stream << '[' << color[0] << ", " << color[1] << ", " << color[2] << ", " << color[3] << ']';
@@ -31,3 +33,11 @@ std::ostream &operator<<(std::ostream &stream, const dynv::Ref &map) {
 	return stream;
 }
 }
+namespace test {
+TemporaryFile::TemporaryFile(const std::string &name):
+	path((std::filesystem::temp_directory_path() / ("gpick-test-" + name)).string()) {
+}
+TemporaryFile::~TemporaryFile() {
+	std::remove(path.c_str());
+}
+}
@@ -19,7 +19,16 @@
 #include "Color.h"
 #include "dynv/Map.h"
 #include <iosfwd>
+#include <string>
 std::ostream &operator<<(std::ostream &stream, const Color &color);
 namespace dynv {
 std::ostream &operator<<(std::ostream &stream, const dynv::Ref &map);
 }
+namespace test {
+/** File in temporary directory, which is removed when object is destroyed. */
+struct TemporaryFile {
+	TemporaryFile(const std::string &name);
+	~TemporaryFile();
+	std::string path;
+};
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "color_names/Dictionary.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace color_names;
+namespace {
+std::string randomDictionary(size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	std::stringstream text;
+	text << "! generated dictionary\n";
+	for (size_t i = 0; i < count; i++) {
+		text << (random.next() % 256) << ' ' << (random.next() % 256) << ' ' << (random.next() % 256) << "\tcolor " << i << '\n';
+	}
+	return text.str();
+}
+void writeFile(const std::string &path, const std::string &data) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(data.data(), data.size());
+}
+std::string readFile(const std::string &path) {
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream data;
+	data << file.rdbuf();
+	return data.str();
+}
+}
+BOOST_AUTO_TEST_SUITE(dictionary)
+BOOST_AUTO_TEST_CASE(loadText) {
+	Color::initialize();
+	test::TemporaryFile text("dictionary.txt");
+	writeFile(text.path, "! comment\n255 0 0 Red\n  0 255   0\t Green  \n0 0 255 Blue\n1 2\n");
+	Dictionary dictionary;
+	BOOST_REQUIRE(dictionary.load(text.path));
+	BOOST_CHECK(!dictionary.mapped());
+	BOOST_REQUIRE_EQUAL(dictionary.size(), 3);
+	BOOST_CHECK_EQUAL(dictionary.name(0), "Red");
+	BOOST_CHECK_EQUAL(dictionary.name(1), "Green");
+	BOOST_CHECK_EQUAL(dictionary.name(2), "Blue");
+	BOOST_CHECK(dictionary.color(1) == Color(0.0f, 1.0f, 0.0f));
+	KdTree::Match match;
+	BOOST_REQUIRE(dictionary.tree().findNearest(Color(0.0f, 0.1f, 0.9f).rgbToLabD50(), match));
+	BOOST_CHECK_EQUAL(match.index, 2);
+}
+BOOST_AUTO_TEST_CASE(binaryRoundTrip) {
+	Color::initialize();
+	test::TemporaryFile text("dictionary.txt"), binary("dictionary.gpd");
+	writeFile(text.path, randomDictionary(2000, 1));
+	Dictionary source, mapped;
+	BOOST_REQUIRE(source.loadText(text.path));
+	BOOST_REQUIRE(source.saveBinary(binary.path));
+	BOOST_REQUIRE(mapped.load(binary.path));
+	BOOST_CHECK(mapped.mapped());
+	BOOST_REQUIRE_EQUAL(mapped.size(), source.size());
+	for (uint32_t i = 0; i < source.size(); i++) {
+		BOOST_CHECK_EQUAL(mapped.name(i), source.name(i));
+		BOOST_CHECK(mapped.color(i) == source.color(i));
+	}
+	test::RandomGenerator random(2);
+	std::vector<KdTree::Match> expected, found;
+	for (int i = 0; i < 100; i++) {
+		Color query = Color(random.nextFloat(), random.nextFloat(), random.nextFloat()).rgbToLabD50();
+		source.tree().find(query, 5, expected);
+		mapped.tree().find(query, 5, found);
+		BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+		for (size_t j = 0; j < found.size(); j++) {
+			BOOST_CHECK_EQUAL(found[j].index, expected[j].index);
+			BOOST_CHECK_EQUAL(found[j].distance, expected[j].distance);
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(matchesLinearSearch) {
+	Color::initialize();
+	test::TemporaryFile text("dictionary.txt"), binary("dictionary.gpd");
+	writeFile(text.path, randomDictionary(2000, 6));
+	Dictionary source, mapped;
+	BOOST_REQUIRE(source.loadText(text.path));
+	BOOST_REQUIRE(source.saveBinary(binary.path));
+	BOOST_REQUIRE(mapped.load(binary.path));
+	// Dictionary colors and queries must be converted the same way, otherwise nearest names near ties differ from a linear search.
+	std::vector<Color> labColors(source.size());
+	for (uint32_t i = 0; i < source.size(); i++)
+		labColors[i] = source.color(i).rgbToLabD50();
+	test::RandomGenerator random(7);
+	for (int i = 0; i < 1000; i++) {
+		Color query = Color(random.nextFloat(), random.nextFloat(), random.nextFloat()).rgbToLabD50();
+		uint32_t expected = 0;
+		float expectedDistance = Color::distanceLch(labColors[0], query);
+		for (uint32_t j = 1; j < labColors.size(); j++) {
+			float distance = Color::distanceLch(labColors[j], query);
+			if (distance < expectedDistance) {
+				expected = j;
+				expectedDistance = distance;
+			}
+		}
+		for (const auto *dictionary: { &source, &mapped }) {
+			KdTree::Match match;
+			BOOST_REQUIRE(dictionary->tree().findNearest(query, match));
+			BOOST_CHECK_EQUAL(match.index, expected);
+			BOOST_CHECK_EQUAL(match.distance, expectedDistance);
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(rejectsCorruptedBinary) {
+	Color::initialize();
+	test::TemporaryFile text("dictionary.txt"), binary("dictionary.gpd"), corrupted("corrupted.gpd");
+	writeFile(text.path, randomDictionary(100, 3));
+	Dictionary source;
+	BOOST_REQUIRE(source.loadText(text.path));
+	BOOST_REQUIRE(source.saveBinary(binary.path));
+	auto data = readFile(binary.path);
+	for (size_t size: { size_t(0), size_t(8), size_t(64), data.size() / 2, data.size() - 1 }) {
+		writeFile(corrupted.path, data.substr(0, size));
+		Dictionary dictionary;
+		BOOST_CHECK_MESSAGE(!dictionary.loadBinary(corrupted.path), "truncated file of size " << size << " was accepted");
+	}
+	test::RandomGenerator random(4);
+	for (int i = 0; i < 200; i++) {
+		auto modified = data;
+		auto offset = 8 + random.next() % (std::min<size_t>(modified.size(), 256) - 8);
+		modified[offset] = static_cast<char>(modified[offset] ^ (1 << (random.next() % 8)));
+		writeFile(corrupted.path, modified);
+		Dictionary dictionary;
+		if (dictionary.loadBinary(corrupted.path)) {
+			KdTree::Match match;
+			dictionary.tree().findNearest(Color(50.0f, 0.0f, 0.0f), match);
+			BOOST_CHECK(match.index < dictionary.size());
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(loadTime, BENCHMARK_DECORATORS) {
+	Color::initialize();
+	test::TemporaryFile text("dictionary.txt"), binary("dictionary.gpd");
+	writeFile(text.path, randomDictionary(100000, 5));
+	{
+		Dictionary source;
+		BOOST_REQUIRE(source.loadText(text.path));
+		BOOST_REQUIRE(source.saveBinary(binary.path));
+	}
+	test::benchmark("text dictionary load, 100k colors", [&]() {
+		Dictionary dictionary;
+		dictionary.load(text.path);
+	});
+	test::benchmark("binary dictionary load, 100k colors", [&]() {
+		Dictionary dictionary;
+		dictionary.load(binary.path);
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
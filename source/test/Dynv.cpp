@@ -18,8 +18,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include "Common.h"
+#include "Benchmark.h"
 #include "Color.h"
 #include "dynv/Map.h"
+#include "dynv/Variable.h"
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -273,4 +275,112 @@ BOOST_AUTO_TEST_CASE(binaryDeserialize) {
 	BOOST_REQUIRE(resultMap.deserialize(output, valueTypeMap));
 	BOOST_CHECK_EQUAL(resultMap.size(), 4);
 }
+BOOST_AUTO_TEST_CASE(pathLookup) {
+	Map map;
+	const dynv::Path path("a.b.c"), missing("a.b.d"), throughValue("a.b.c.d");
+	BOOST_CHECK_EQUAL(path.size(), 3);
+	BOOST_CHECK_EQUAL(path.str(), "a.b.c");
+	BOOST_CHECK(!map.contains(path));
+	BOOST_CHECK_EQUAL(map.getInt32(path, 1), 1);
+	map.set("a.b.c", 5);
+	BOOST_CHECK(map.contains(path));
+	BOOST_CHECK_EQUAL(map.getInt32(path, 1), 5);
+	BOOST_CHECK_EQUAL(map.getInt32(missing, 1), 1);
+	BOOST_CHECK_EQUAL(map.getInt32(throughValue, 1), 1);
+	map.set(path, 6);
+	BOOST_CHECK_EQUAL(map.getInt32("a.b.c", 0), 6);
+	map.set(path, std::string("text"));
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 0);
+	BOOST_CHECK_EQUAL(map.getString(path, ""), "text");
+	map.set(missing, true);
+	BOOST_CHECK_EQUAL(map.getBool("a.b.d", false), true);
+	Map other;
+	other.set("a.b.c", 7);
+	BOOST_CHECK_EQUAL(other.getInt32(path, 0), 7);
+	BOOST_CHECK_EQUAL(map.getString(path, ""), "text");
+}
+BOOST_AUTO_TEST_CASE(pathInvalidation) {
+	Map map;
+	const dynv::Path path("a.b.c");
+	map.set("a.b.c", 5);
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 5);
+	BOOST_CHECK(map.remove("a.b.c"));
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 0);
+	map.set("a.b.c", 6);
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 6);
+	Ref replacement(new Map());
+	replacement->set("c", 7);
+	map.set("a.b", replacement);
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 7);
+	map.set("a", 1);
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 0);
+	map.remove("a");
+	map.getOrCreateMap("a.b")->set("c", 8);
+	BOOST_CHECK_EQUAL(map.getInt32(path, 0), 8);
+	map.removeAll();
+	BOOST_CHECK(!map.contains(path));
+	{
+		Map temporary;
+		temporary.set("a.b.c", 9);
+		BOOST_CHECK_EQUAL(temporary.getInt32(path, 0), 9);
+	}
+	Map other;
+	BOOST_CHECK_EQUAL(other.getInt32(path, 0), 0);
+}
+BOOST_AUTO_TEST_CASE(indexedMap) {
+	Map map;
+	map.set("a.b", 1);
+	map.set("c", 2);
+	BOOST_CHECK(!map.indexed());
+	map.setIndexed(true);
+	BOOST_CHECK(map.indexed());
+	BOOST_CHECK(map.getMap("a")->indexed());
+	map.set("d.e", 3);
+	BOOST_CHECK(map.getMap("d")->indexed());
+	Ref nested(new Map());
+	nested->set("g", 4);
+	map.set("f", nested);
+	BOOST_CHECK(nested->indexed());
+	BOOST_CHECK_EQUAL(map.getInt32("a.b", 0), 1);
+	BOOST_CHECK_EQUAL(map.getInt32("c", 0), 2);
+	BOOST_CHECK_EQUAL(map.getInt32(dynv::Path("d.e"), 0), 3);
+	BOOST_CHECK_EQUAL(map.getInt32("f.g", 0), 4);
+	BOOST_CHECK(map.remove("c"));
+	BOOST_CHECK(!map.contains("c"));
+	map.set("c", 5);
+	BOOST_CHECK_EQUAL(map.getInt32("c", 0), 5);
+	std::vector<std::string> names;
+	map.visit([&names](const dynv::Variable &variable) {
+		names.push_back(variable.name());
+		return true;
+	});
+	BOOST_CHECK((names == std::vector<std::string> { "a", "c", "d", "f" }));
+	map.setIndexed(false);
+	BOOST_CHECK(!map.getMap("a")->indexed());
+	BOOST_CHECK_EQUAL(map.getInt32("f.g", 0), 4);
+}
+BOOST_AUTO_TEST_CASE(benchmarkLookup, BENCHMARK_DECORATORS) {
+	Map map;
+	for (int i = 0; i < 20; i++)
+		for (int j = 0; j < 50; j++)
+			map.set("gpick.section" + std::to_string(i) + ".option" + std::to_string(j), i * j);
+	const int lookups = 1000000;
+	const std::string name = "gpick.section10.option25";
+	int32_t sum = 0;
+	test::benchmark("string path lookups", [&]() {
+		for (int i = 0; i < lookups; i++)
+			sum += map.getInt32(name, 0);
+	});
+	map.setIndexed(true);
+	test::benchmark("string path lookups, indexed", [&]() {
+		for (int i = 0; i < lookups; i++)
+			sum += map.getInt32(name, 0);
+	});
+	const dynv::Path path(name);
+	test::benchmark("precompiled path lookups", [&]() {
+		for (int i = 0; i < lookups; i++)
+			sum += map.getInt32(path, 0);
+	});
+	BOOST_CHECK_EQUAL(sum, 3 * lookups * 250);
+}
 BOOST_AUTO_TEST_SUITE_END()
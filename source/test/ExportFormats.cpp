@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "ExportFormats.h"
+#include "HtmlUtils.h"
+#include "ColorObject.h"
+#include "common/TextWriter.h"
+#include <boost/math/special_functions/round.hpp>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+namespace {
+struct ColorObjects {
+	ColorObjects(size_t count) {
+		test::RandomGenerator random;
+		const char *names[] = { "", "Red", "Salmon <pink> & \"orange\"", "Robin's egg" };
+		for (size_t i = 0; i < count; i++)
+			colorObjects.emplace_back(names[i % 4], Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), random.nextFloat()));
+		for (auto &colorObject: colorObjects) {
+			pointers.push_back(&colorObject);
+			texts.push_back(hexText(colorObject.getColor()));
+		}
+	}
+	common::Span<const ColorObject *const> span() const {
+		return common::Span<const ColorObject *const>(pointers.data(), pointers.size());
+	}
+	static std::string hexText(const Color &color) {
+		std::stringstream stream;
+		stream << HtmlHEX { color };
+		return stream.str();
+	}
+	std::vector<ColorObject> colorObjects;
+	std::vector<const ColorObject *> pointers;
+	std::vector<std::string> texts;
+};
+// Stream based output, as exporters wrote files before common::TextWriter.
+void streamGpl(std::ostream &stream, const ColorObjects &colorObjects) {
+	using boost::math::iround;
+	stream << "GIMP Palette" << '\n' << "Name: palette.gpl" << '\n' << "Columns: 1" << '\n' << "#" << '\n';
+	for (auto *colorObject: colorObjects.pointers) {
+		Color color = colorObject->getColor();
+		stream << iround(color.red * 255) << "\t" << iround(color.green * 255) << "\t" << iround(color.blue * 255) << "\t" << colorObject->getName() << '\n';
+	}
+}
+void streamCss(std::ostream &stream, const ColorObjects &colorObjects) {
+	for (auto *colorObject: colorObjects.pointers) {
+		Color color = colorObject->getColor();
+		stream << " * " << colorObject->getName() << ": " << HtmlHEX { color } << ", " << HtmlRGBA { color } << ", " << HtmlHSLA { color } << '\n';
+	}
+}
+void streamMtl(std::ostream &stream, const ColorObjects &colorObjects) {
+	for (auto *colorObject: colorObjects.pointers) {
+		Color color = colorObject->getColor();
+		stream << "newmtl " << colorObject->getName() << '\n';
+		stream << "Ns 90.000000" << '\n';
+		stream << "Ka 0.000000 0.000000 0.000000" << '\n';
+		stream << "Kd " << color.red << " " << color.green << " " << color.blue << '\n';
+		stream << "Ks 0.500000 0.500000 0.500000" << '\n' << '\n';
+	}
+}
+void streamTxt(std::ostream &stream, const ColorObjects &colorObjects) {
+	for (size_t i = 0; i < colorObjects.pointers.size(); i++)
+		stream << colorObjects.texts[i] << " " << colorObjects.pointers[i]->getName() << '\n';
+}
+void streamHtml(std::ostream &stream, const ColorObjects &colorObjects) {
+	for (size_t i = 0; i < colorObjects.pointers.size(); i++) {
+		auto *colorObject = colorObjects.pointers[i];
+		Color color = colorObject->getColor();
+		stream << "<div style=\"background-color:" << HtmlRGBA { color } << "; color:" << HtmlRGB { color.getContrasting() } << "\">";
+		std::string name = escapeHtml(colorObject->getName());
+		if (!name.empty())
+			stream << name << ":<br/>";
+		stream << "<span>" << colorObjects.texts[i] << "</span></div>";
+	}
+}
+template<typename Callback>
+std::string write(Callback &&callback) {
+	std::stringstream stream;
+	{
+		common::TextWriter writer(stream, 1024);
+		callback(writer);
+	}
+	return stream.str();
+}
+template<typename Callback>
+std::string streamWrite(Callback &&callback) {
+	std::stringstream stream;
+	callback(stream);
+	return stream.str();
+}
+}
+BOOST_AUTO_TEST_SUITE(exportFormats)
+BOOST_AUTO_TEST_CASE(textWriter) {
+	std::stringstream stream;
+	{
+		common::TextWriter writer(stream, 8);
+		writer << "values: " << 42 << ' ' << -7 << ' ' << 0.5f << ' ' << 1.0f / 3.0f << ' ';
+		writer.write(0.12345f, 3) << ' ';
+		writer.writeHex(10, 2);
+		writer.writeHex(255, 2);
+		writer << ' ' << HtmlEscape { "<a & 'b'>" };
+		BOOST_CHECK(writer.flush());
+	}
+	BOOST_CHECK_EQUAL(stream.str(), "values: 42 -7 0.5 0.333333 0.123 0aff &lt;a &amp; &apos;b&apos;&gt;");
+	std::string text = write([](common::TextWriter &writer) {
+		writer.writeParallel(100000, [](common::TextWriter &writer, size_t index) {
+			writer << static_cast<int>(index) << '\n';
+		});
+	});
+	std::stringstream expected;
+	for (int i = 0; i < 100000; i++)
+		expected << i << '\n';
+	BOOST_CHECK(text == expected.str());
+}
+BOOST_AUTO_TEST_CASE(sameAsStreamOutput) {
+	ColorObjects colorObjects(5000);
+	BOOST_CHECK(write([&](common::TextWriter &writer) { writeGpl(writer, "palette.gpl", colorObjects.span()); }) == streamWrite([&](std::ostream &stream) { streamGpl(stream, colorObjects); }));
+	BOOST_CHECK(write([&](common::TextWriter &writer) { writeCss(writer, colorObjects.span()); }) == streamWrite([&](std::ostream &stream) { streamCss(stream, colorObjects); }));
+	BOOST_CHECK(write([&](common::TextWriter &writer) { writeMtl(writer, colorObjects.span()); }) == streamWrite([&](std::ostream &stream) { streamMtl(stream, colorObjects); }));
+	BOOST_CHECK(write([&](common::TextWriter &writer) { writeTxt(writer, colorObjects.span(), colorObjects.texts, true); }) == streamWrite([&](std::ostream &stream) { streamTxt(stream, colorObjects); }));
+	BOOST_CHECK(write([&](common::TextWriter &writer) { writeHtmlColors(writer, colorObjects.span(), colorObjects.texts, true); }) == streamWrite([&](std::ostream &stream) { streamHtml(stream, colorObjects); }));
+}
+BOOST_AUTO_TEST_CASE(benchmarkExport, BENCHMARK_DECORATORS) {
+	ColorObjects colorObjects(500000);
+	auto benchmark = [&](const char *name, auto &&writeCallback, auto &&streamCallback) {
+		size_t size = 0;
+		double streamSeconds = test::measure([&]() {
+			size = streamWrite(streamCallback).size();
+		});
+		double seconds = test::measure([&]() {
+			write(writeCallback);
+		});
+		double megabytes = size / (1024.0 * 1024.0);
+		BOOST_TEST_MESSAGE(name << ", 500k colors: " << megabytes / seconds << " MB/s, " << megabytes / streamSeconds << " MB/s with std::ostream");
+	};
+	benchmark("GPL", [&](common::TextWriter &writer) { writeGpl(writer, "palette.gpl", colorObjects.span()); }, [&](std::ostream &stream) { streamGpl(stream, colorObjects); });
+	benchmark("CSS", [&](common::TextWriter &writer) { writeCss(writer, colorObjects.span()); }, [&](std::ostream &stream) { streamCss(stream, colorObjects); });
+	benchmark("MTL", [&](common::TextWriter &writer) { writeMtl(writer, colorObjects.span()); }, [&](std::ostream &stream) { streamMtl(stream, colorObjects); });
+	benchmark("TXT", [&](common::TextWriter &writer) { writeTxt(writer, colorObjects.span(), colorObjects.texts, true); }, [&](std::ostream &stream) { streamTxt(stream, colorObjects); });
+	benchmark("HTML", [&](common::TextWriter &writer) { writeHtmlColors(writer, colorObjects.span(), colorObjects.texts, true); }, [&](std::ostream &stream) { streamHtml(stream, colorObjects); });
+}
+BOOST_AUTO_TEST_SUITE_END()
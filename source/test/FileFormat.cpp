@@ -17,10 +17,12 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
 #include "Common.h"
 #include "FileFormat.h"
 #include "ColorList.h"
 #include "ColorObject.h"
+#include "common/Format.h"
 #include <string_view>
 #include <sstream>
 #include <fstream>
@@ -110,4 +112,51 @@ BOOST_AUTO_TEST_CASE(load) {
 		BOOST_CHECK_MESSAGE(loaded[i].name == savedColors[i].name, "loaded wrong name at index " << i << ", " << loaded[i].name << " != " << savedColors[i].name);
 	}
 }
+static void randomColors(ColorList &colors, size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	for (size_t i = 0; i < count; i++)
+		colors.add(ColorObject(common::format("color {}", i), Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), random.nextFloat())));
+}
+BOOST_AUTO_TEST_CASE(roundTrip) {
+	ColorList colors, loaded;
+	randomColors(colors, 1000, 1);
+	test::TemporaryFile file("palette.gpa");
+	auto result = paletteFileSave(file.path.c_str(), colors);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	result = paletteFileLoad(file.path.c_str(), loaded);
+	BOOST_REQUIRE_MESSAGE(result, result.error());
+	BOOST_REQUIRE_EQUAL(loaded.size(), colors.size());
+	for (size_t i = 0; i < colors.size(); ++i) {
+		auto *expected = *(colors.begin() + i), *colorObject = *(loaded.begin() + i);
+		BOOST_CHECK(colorObject->getColor() == expected->getColor());
+		BOOST_CHECK_EQUAL(colorObject->getName(), expected->getName());
+	}
+}
+BOOST_AUTO_TEST_CASE(truncated) {
+	ColorList colors;
+	randomColors(colors, 10, 2);
+	std::stringstream output(std::ios::out | std::ios::binary);
+	BOOST_REQUIRE(paletteStreamSave(output, colors));
+	auto data = output.str();
+	test::TemporaryFile file("truncated.gpa");
+	{
+		std::ofstream stream(file.path, std::ios::binary);
+		stream.write(data.data(), data.size() - 5);
+	}
+	ColorList loaded;
+	BOOST_CHECK(!paletteFileLoad(file.path.c_str(), loaded));
+	BOOST_CHECK(loaded.empty());
+	BOOST_CHECK(!paletteFileLoad((file.path + ".missing").c_str(), loaded));
+}
+BOOST_AUTO_TEST_CASE(benchmarkLoad, BENCHMARK_DECORATORS) {
+	ColorList colors;
+	randomColors(colors, 200000, 3);
+	test::TemporaryFile file("benchmark.gpa");
+	BOOST_REQUIRE(paletteFileSave(file.path.c_str(), colors));
+	ColorList loaded;
+	test::benchmark("load 200000 colors", [&]() {
+		BOOST_REQUIRE(paletteFileLoad(file.path.c_str(), loaded));
+	});
+	BOOST_CHECK_EQUAL(loaded.size(), colors.size());
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <boost/test/unit_test.hpp>
+#include "Common.h"
+#include "Benchmark.h"
+#include "ImageRows.h"
+#include "math/ColorHistogram.h"
+#include <png.h>
+#include <cstdio>
+#include <jpeglib.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+struct Image {
+	Image(int width, int height, int channels, uint32_t seed):
+		width(width),
+		height(height),
+		channels(channels),
+		data(static_cast<size_t>(width) * height * channels) {
+		test::RandomGenerator random(seed);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				uint8_t *pixel = &data[(static_cast<size_t>(y) * width + x) * channels];
+				uint32_t value = (x / 32 + y / 32) % 3 == 0 ? random.next() : (x / 32) * 2654435761u + (y / 32) * 40503u;
+				for (int c = 0; c < channels; c++)
+					pixel[c] = static_cast<uint8_t>(value >> (c * 8));
+			}
+		}
+	}
+	int width, height, channels;
+	std::vector<uint8_t> data;
+	int stride() const {
+		return width * channels;
+	}
+	void savePng(const std::string &path, int interlaceType = PNG_INTERLACE_NONE) const {
+		FILE *file = std::fopen(path.c_str(), "wb");
+		png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+		png_infop info = png_create_info_struct(png);
+		png_init_io(png, file);
+		png_set_IHDR(png, info, width, height, 8, channels == 1 ? PNG_COLOR_TYPE_GRAY : channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA, interlaceType, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		png_set_compression_level(png, 1);
+		png_write_info(png, info);
+		std::vector<png_bytep> rows;
+		for (int y = 0; y < height; y++)
+			rows.push_back(const_cast<png_bytep>(&data[static_cast<size_t>(y) * stride()]));
+		png_write_image(png, rows.data());
+		png_write_end(png, nullptr);
+		png_destroy_write_struct(&png, &info);
+		std::fclose(file);
+	}
+	void saveJpeg(const std::string &path) const {
+		FILE *file = std::fopen(path.c_str(), "wb");
+		jpeg_compress_struct compress;
+		jpeg_error_mgr error;
+		compress.err = jpeg_std_error(&error);
+		jpeg_create_compress(&compress);
+		jpeg_stdio_dest(&compress, file);
+		compress.image_width = width;
+		compress.image_height = height;
+		compress.input_components = channels;
+		compress.in_color_space = channels == 1 ? JCS_GRAYSCALE : JCS_RGB;
+		jpeg_set_defaults(&compress);
+		jpeg_set_quality(&compress, 90, TRUE);
+		jpeg_start_compress(&compress, TRUE);
+		while (compress.next_scanline < compress.image_height) {
+			JSAMPROW row = const_cast<JSAMPROW>(&data[static_cast<size_t>(compress.next_scanline) * stride()]);
+			jpeg_write_scanlines(&compress, &row, 1);
+		}
+		jpeg_finish_compress(&compress);
+		jpeg_destroy_compress(&compress);
+		std::fclose(file);
+	}
+};
+struct Rows {
+	int width = 0, height = 0, channels = 0, bands = 0;
+	std::vector<uint8_t> data;
+};
+common::ResultVoid<ErrorCode> readRows(const std::string &path, int step, Rows &rows) {
+	return imageFileReadRows(path.c_str(), step, [&rows](const uint8_t *data, int width, int height, int stride, int channels) {
+		rows.width = width;
+		rows.channels = channels;
+		rows.height += height;
+		rows.bands++;
+		for (int y = 0; y < height; y++)
+			rows.data.insert(rows.data.end(), data + static_cast<size_t>(y) * stride, data + static_cast<size_t>(y) * stride + width * channels);
+	});
+}
+bool equal(const ColorHistogram &a, const ColorHistogram &b) {
+	std::vector<std::pair<Color, uint64_t>> binsA, binsB;
+	a.visit([&](const Color &color, uint64_t pixels) {
+		binsA.emplace_back(color, pixels);
+	});
+	b.visit([&](const Color &color, uint64_t pixels) {
+		binsB.emplace_back(color, pixels);
+	});
+	if (binsA.size() != binsB.size())
+		return false;
+	for (size_t i = 0; i < binsA.size(); i++) {
+		if (binsA[i].second != binsB[i].second || binsA[i].first.red != binsB[i].first.red || binsA[i].first.green != binsB[i].first.green || binsA[i].first.blue != binsB[i].first.blue)
+			return false;
+	}
+	return true;
+}
+}
+BOOST_FIXTURE_TEST_SUITE(imageRows, Initialize)
+BOOST_AUTO_TEST_CASE(pngBands) {
+	// Larger than one band, so rows are split between bands.
+	Image image(1100, 2001, 3, 1);
+	test::TemporaryFile file("image-rows.png");
+	image.savePng(file.path);
+	for (int step: { 1, 3 }) {
+		Rows rows;
+		BOOST_REQUIRE(readRows(file.path, step, rows));
+		if (step == 1)
+			BOOST_CHECK_GT(rows.bands, 1);
+		BOOST_CHECK_EQUAL(rows.width, (image.width + step - 1) / step);
+		BOOST_CHECK_EQUAL(rows.height, (image.height + step - 1) / step);
+		BOOST_CHECK_EQUAL(rows.channels, 3);
+		ColorHistogram expected, streamed;
+		expected.addImage(image.data.data(), image.width, image.height, image.stride(), image.channels, step);
+		streamed.addImage(rows.data.data(), rows.width, rows.height, rows.width * rows.channels, rows.channels);
+		BOOST_CHECK(equal(expected, streamed));
+	}
+}
+BOOST_AUTO_TEST_CASE(pngChannels) {
+	for (int channels: { 1, 4 }) {
+		Image image(77, 55, channels, 2);
+		test::TemporaryFile file("image-rows.png");
+		image.savePng(file.path);
+		Rows rows;
+		BOOST_REQUIRE(readRows(file.path, 1, rows));
+		BOOST_CHECK_EQUAL(rows.bands, 1);
+		BOOST_CHECK_EQUAL(rows.channels, channels);
+		BOOST_CHECK(rows.data == image.data);
+	}
+}
+BOOST_AUTO_TEST_CASE(jpegSubsampling) {
+	for (int channels: { 1, 3 }) {
+		Image image(301, 203, channels, 3);
+		test::TemporaryFile file("image-rows.jpg");
+		image.saveJpeg(file.path);
+		Rows full, subsampled;
+		BOOST_REQUIRE(readRows(file.path, 1, full));
+		BOOST_REQUIRE(readRows(file.path, 4, subsampled));
+		BOOST_CHECK_EQUAL(full.width, image.width);
+		BOOST_CHECK_EQUAL(full.height, image.height);
+		BOOST_CHECK_EQUAL(full.channels, channels);
+		ColorHistogram expected, streamed;
+		expected.addImage(full.data.data(), full.width, full.height, full.width * full.channels, full.channels, 4);
+		streamed.addImage(subsampled.data.data(), subsampled.width, subsampled.height, subsampled.width * subsampled.channels, subsampled.channels);
+		BOOST_CHECK_EQUAL(streamed.totalPixels(), 76 * 51);
+		BOOST_CHECK(equal(expected, streamed));
+	}
+}
+BOOST_AUTO_TEST_CASE(unsupported) {
+	Image image(40, 30, 3, 4);
+	test::TemporaryFile file("image-rows.png");
+	image.savePng(file.path, PNG_INTERLACE_ADAM7);
+	Rows rows;
+	auto result = readRows(file.path, 1, rows);
+	BOOST_CHECK(!result);
+	BOOST_CHECK(result.error() == ErrorCode::unsupportedFormat);
+	BOOST_CHECK_EQUAL(rows.bands, 0);
+	std::ofstream(file.path, std::ios::binary | std::ios::trunc) << "GIF89a";
+	result = readRows(file.path, 1, rows);
+	BOOST_CHECK(result.error() == ErrorCode::unsupportedFormat);
+	auto missing = readRows("/nonexistent/image.png", 1, rows);
+	BOOST_CHECK(!missing);
+	BOOST_CHECK(missing.error() == ErrorCode::fileCouldNotBeOpened);
+}
+BOOST_AUTO_TEST_CASE(truncated) {
+	Image image(200, 200, 3, 5);
+	test::TemporaryFile png("image-rows.png"), jpeg("image-rows.jpg");
+	image.savePng(png.path);
+	image.saveJpeg(jpeg.path);
+	// JPEG decoder fills missing data at the end of file with gray, so only truncated JPEG headers are errors.
+	for (const auto &[path, size]: { std::make_pair(png.path, 0), std::make_pair(jpeg.path, 40) }) {
+		std::ifstream input(path, std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		input.close();
+		std::ofstream(path, std::ios::binary | std::ios::trunc) << content.substr(0, size ? size : content.size() / 2);
+		Rows rows;
+		auto result = readRows(path, 1, rows);
+		BOOST_CHECK(!result);
+		BOOST_CHECK(result.error() == ErrorCode::badFile);
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
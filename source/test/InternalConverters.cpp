@@ -22,6 +22,11 @@
 #include "InternalConverters.h"
 #include "ColorObject.h"
 #include "Common.h"
+#include "Benchmark.h"
+#include "common/First.h"
+#include <clocale>
+#include <sstream>
+#include <vector>
 BOOST_AUTO_TEST_SUITE(internalConverters)
 BOOST_AUTO_TEST_CASE(webHex) {
 	Converter::Options options = {};
@@ -534,4 +539,231 @@ BOOST_AUTO_TEST_CASE(valueRgba) {
 			BOOST_CHECK_MESSAGE(colorObject.getColor() == colors[i].color, "wrong color at index " << i << ", " << colorObject.getColor() << " != " << colors[i].color);
 	}
 }
+BOOST_AUTO_TEST_CASE(serialize) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	ColorObject colorObject("", Color(32, 64, 128, 16));
+	const struct {
+		const char *name;
+		const char *text;
+	} results[] = {
+		{ "color_web_hex", "#204080" },
+		{ "color_web_hex_with_alpha", "#20408010" },
+		{ "color_web_hex_no_hash", "204080" },
+		{ "color_web_hex_short", "#248" },
+		{ "color_web_hex_short_with_alpha", "#2481" },
+		{ "color_css_rgb", "rgb(32, 64, 128)" },
+		{ "color_css_rgba", "rgba(32, 64, 128, 0.063)" },
+		{ "color_css_hsl", "hsl(220, 60%, 31%)" },
+		{ "color_css_hsla", "hsla(220, 60%, 31%, 0.063)" },
+		{ "css_color_hex", "color: #204080" },
+		{ "csv_rgb", "0.125,0.251,0.502" },
+		{ "csv_rgb_tab", "0.125\t0.251\t0.502" },
+		{ "csv_rgb_semicolon", "0.125;0.251;0.502" },
+		{ "csv_rgba", "0.125,0.251,0.502,0.063" },
+		{ "value_rgba", "0.125, 0.251, 0.502, 0.063" },
+	};
+	for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); ++i) {
+		auto *converter = converters.byName(results[i].name);
+		BOOST_REQUIRE(converter != nullptr);
+		BOOST_CHECK_EQUAL(converter->serialize(colorObject), results[i].text);
+	}
+	options.upperCaseHex = true;
+	options.cssPercentages = true;
+	options.cssAlphaPercentage = true;
+	BOOST_CHECK_EQUAL(converters.byName("color_web_hex")->serialize(Color(171, 205, 239, 255)), "#ABCDEF");
+	BOOST_CHECK_EQUAL(converters.byName("color_css_rgba")->serialize(colorObject), "rgba(12%, 25%, 50%, 6%)");
+}
+BOOST_AUTO_TEST_CASE(serializeIgnoresLocale) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	std::string locale = std::setlocale(LC_NUMERIC, nullptr);
+	for (auto name: { "de_DE.UTF-8", "lt_LT.UTF-8", "fr_FR.UTF-8" }) {
+		if (!std::setlocale(LC_NUMERIC, name))
+			continue;
+		BOOST_CHECK_EQUAL(converters.byName("csv_rgb")->serialize(Color(0.5f, 0.25f, 0.125f, 1.0f)), "0.500,0.250,0.125");
+	}
+	std::setlocale(LC_NUMERIC, locale.c_str());
+}
+BOOST_AUTO_TEST_CASE(serializeList) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	std::vector<ColorObject> colorObjects = { ColorObject("a", Color(255, 0, 0, 255)), ColorObject("b", Color(0, 255, 0, 255)), ColorObject("c", Color(0, 0, 255, 255)) };
+	std::vector<const ColorObject *> pointers;
+	for (auto &colorObject: colorObjects)
+		pointers.push_back(&colorObject);
+	auto *converter = converters.byName("color_css_block");
+	BOOST_REQUIRE(converter != nullptr);
+	auto texts = converter->serialize(common::Span<const ColorObject *const>(pointers.data(), pointers.size()));
+	BOOST_REQUIRE_EQUAL(texts.size(), 3);
+	ConverterSerializePosition position(pointers.size());
+	for (size_t i = 0; i < pointers.size(); i++) {
+		if (i + 1 == pointers.size())
+			position.last(true);
+		BOOST_CHECK_EQUAL(texts[i], converter->serialize(*pointers[i], position));
+		position.first(false);
+		position.incrementIndex();
+	}
+	BOOST_CHECK(texts[0].find("Generated by Gpick") != std::string::npos);
+	BOOST_CHECK(texts[1].find("Generated by Gpick") == std::string::npos);
+	BOOST_CHECK(texts[2].find("\n */") != std::string::npos);
+	BOOST_CHECK(converter->serialize(common::Span<const ColorObject *const>()).empty());
+}
+BOOST_AUTO_TEST_CASE(benchmarkSerialize, BENCHMARK_DECORATORS) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	test::RandomGenerator random;
+	const size_t count = 200000;
+	std::vector<ColorObject> colorObjects;
+	colorObjects.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		colorObjects.emplace_back("", Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), random.nextFloat()));
+	std::vector<const ColorObject *> pointers;
+	for (auto &colorObject: colorObjects)
+		pointers.push_back(&colorObject);
+	common::Span<const ColorObject *const> span(pointers.data(), pointers.size());
+	size_t length = 0;
+	for (auto *converter: converters.all()) {
+		if (!converter->hasSerialize())
+			continue;
+		double localeSeconds = test::measure([&]() {
+			// Locale switching each color, as was done before serialization became locale independent.
+			for (auto *colorObject: pointers) {
+				auto locale = std::setlocale(LC_NUMERIC, "C");
+				length += converter->serialize(*colorObject).length();
+				std::setlocale(LC_NUMERIC, locale);
+			}
+		});
+		double seconds = test::measure([&]() {
+			auto texts = converter->serialize(span);
+			length += texts.size();
+		});
+		BOOST_TEST_MESSAGE(converter->name() << ": " << static_cast<uint64_t>(count / seconds) << " colors/s, " << static_cast<uint64_t>(count / localeSeconds) << " colors/s with locale switching");
+	}
+	BOOST_CHECK(length > 0);
+}
+BOOST_AUTO_TEST_CASE(classifyInput) {
+	BOOST_CHECK(Converter::classifyInput("") == ConverterInput::none);
+	BOOST_CHECK(Converter::classifyInput("#204080") == (ConverterInput::hash | ConverterInput::digit | ConverterInput::hex3 | ConverterInput::hex4 | ConverterInput::hex6));
+	BOOST_CHECK(Converter::classifyInput("#abc") == (ConverterInput::hash | ConverterInput::hex3));
+	BOOST_CHECK(Converter::classifyInput("rgba(1, 2)") == (ConverterInput::rgbaFunction | ConverterInput::digit | ConverterInput::comma | ConverterInput::space | ConverterInput::separator));
+	BOOST_CHECK(Converter::classifyInput("hsl(1;2\t") == (ConverterInput::hslFunction | ConverterInput::digit | ConverterInput::semicolon | ConverterInput::tab | ConverterInput::separator));
+	BOOST_CHECK(Converter::classifyInput("hsla(rgb(") == (ConverterInput::hslaFunction | ConverterInput::rgbFunction));
+}
+BOOST_AUTO_TEST_CASE(requiredInput) {
+	// Every text converter can deserialize must have all properties converter requires.
+	std::vector<std::string> texts = { "#204080", " #204080 ", "##20408010", "204080", "#248", "#2481", "rgb(32, 64, 128)", "rgb(12.5%, 25%, 50%)", "rgb(50%, rgb(32, 64, 128)", "rgba(32,64,128,0.5)", "hsl(120, 50%, 50%)", "hsla(120,50%,50%,50%)", "0.125,0.25,0.5", "0.125\t0.25\t0.5", "0.125;0.25;0.5,0.75", ".5 .25 .125", " 0.125  0.25  0.5  0.75 ", "1e5,2,3", "-1,+2,3" };
+	test::RandomGenerator random;
+	for (int i = 0; i < 8; i++) {
+		Converter::Options options = { (i & 1) != 0, (i & 2) != 0, (i & 4) != 0 };
+		Converters converters;
+		addInternalConverters(converters, options);
+		for (int j = 0; j < 100; j++) {
+			ColorObject colorObject("", Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), random.nextFloat()));
+			for (auto *converter: converters.all())
+				texts.push_back(converter->serialize(colorObject));
+		}
+	}
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	ColorObject colorObject;
+	float quality;
+	size_t deserialized = 0;
+	for (const auto &text: texts) {
+		auto input = Converter::classifyInput(text);
+		for (auto *converter: converters.all()) {
+			if (!converter->hasDeserialize() || !converter->deserialize(text.c_str(), colorObject, quality))
+				continue;
+			deserialized++;
+			BOOST_CHECK_MESSAGE(converter->accepts(input), converter->name() << " rejects \"" << text << "\"");
+		}
+	}
+	BOOST_CHECK(deserialized > texts.size());
+}
+BOOST_AUTO_TEST_CASE(deserializeLines) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	for (auto *converter: converters.all())
+		converter->paste(true);
+	converters.rebuildCopyPasteArrays();
+	auto colorObjects = converters.deserializeLines("#204080\n\n  rgb(32, 64, 128)  \r\nnot a color\n \t\n0.125, 0.25, 0.5\n#102030", true);
+	BOOST_REQUIRE_EQUAL(colorObjects.size(), 4);
+	BOOST_CHECK(colorObjects[0].getColor() == Color(32, 64, 128, 255));
+	BOOST_CHECK(colorObjects[1].getColor() == Color(32, 64, 128, 255));
+	BOOST_CHECK(colorObjects[2].getColor() == Color(0.125f, 0.25f, 0.5f, 1.0f));
+	BOOST_CHECK(colorObjects[3].getColor() == Color(16, 32, 48, 255));
+	ColorObject colorObject;
+	BOOST_REQUIRE(converters.deserialize("  rgb(32, 64, 128)", colorObject));
+	BOOST_CHECK(colorObject.getColor() == Color(32, 64, 128, 255));
+	BOOST_CHECK(converters.deserializeLines("", true).empty());
+	BOOST_CHECK(converters.deserializeLines("\n\n", false).empty());
+}
+BOOST_AUTO_TEST_CASE(deserializeLinesConverterSet) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	for (auto *converter: converters.all())
+		converter->paste(false);
+	converters.byName("color_web_hex")->paste(true);
+	converters.rebuildCopyPasteArrays();
+	converters.display("color_css_rgb");
+	const char *text = "rgb(32, 64, 128)\n#102030";
+	// Display converter is used for pasting even when it is not a paste converter.
+	auto colorObjects = converters.deserializeLines(text, true);
+	BOOST_REQUIRE_EQUAL(colorObjects.size(), 2);
+	BOOST_CHECK(colorObjects[0].getColor() == Color(32, 64, 128, 255));
+	BOOST_CHECK(colorObjects[1].getColor() == Color(16, 32, 48, 255));
+	// Text file import only uses paste converters.
+	colorObjects = converters.deserializeLines(text, false);
+	BOOST_REQUIRE_EQUAL(colorObjects.size(), 1);
+	BOOST_CHECK(colorObjects[0].getColor() == Color(16, 32, 48, 255));
+	converters.byName("color_css_rgb")->paste(true);
+	converters.rebuildCopyPasteArrays();
+	BOOST_CHECK_EQUAL(converters.deserializeLines(text, false).size(), 2);
+}
+BOOST_AUTO_TEST_CASE(benchmarkDeserialize, BENCHMARK_DECORATORS) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	for (auto *converter: converters.all())
+		converter->paste(true);
+	converters.rebuildCopyPasteArrays();
+	test::RandomGenerator random;
+	std::string text;
+	const size_t count = 20000;
+	for (size_t i = 0; i < count; i++) {
+		ColorObject colorObject("", Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), 1.0f));
+		auto *converter = converters.allPaste()[random.next() % converters.allPaste().size()];
+		text += converter->serialize(colorObject);
+		text += '\n';
+	}
+	size_t colors = 0;
+	double seconds = test::measure([&]() {
+		// Every converter on every line, as done before converters were selected by input properties.
+		std::stringstream stream(text);
+		std::string line;
+		ColorObject colorObject;
+		float quality;
+		while (std::getline(stream, line)) {
+			common::First<float, std::greater<float>, ColorObject> bestConversion;
+			for (auto *converter: converters.allPaste()) {
+				if (converter->deserialize(line.c_str(), colorObject, quality) && quality > 0)
+					bestConversion(quality, colorObject);
+			}
+			if (bestConversion)
+				colors++;
+		}
+	});
+	BOOST_TEST_MESSAGE("all converters: " << static_cast<uint64_t>(count / seconds) << " lines/s");
+	seconds = test::measure([&]() {
+		BOOST_CHECK_EQUAL(converters.deserializeLines(text, false).size(), colors);
+	});
+	BOOST_TEST_MESSAGE("classified input: " << static_cast<uint64_t>(count / seconds) << " lines/s");
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/InternedString.h"
+#include <string>
+#include <thread>
+#include <vector>
+using common::InternedString;
+BOOST_AUTO_TEST_SUITE(internedString)
+BOOST_AUTO_TEST_CASE(sharing) {
+	size_t tableSize = InternedString::tableSize();
+	InternedString empty, a("interned test"), b(std::string("interned ") + "test"), c("other");
+	BOOST_CHECK(empty.empty());
+	BOOST_CHECK_EQUAL(empty.str(), "");
+	BOOST_CHECK_EQUAL(a.str(), "interned test");
+	BOOST_CHECK(a == b);
+	BOOST_CHECK(&a.str() == &b.str());
+	BOOST_CHECK(a != c);
+	BOOST_CHECK_EQUAL(InternedString::tableSize(), tableSize + 2);
+	InternedString d = c;
+	c = a;
+	BOOST_CHECK_EQUAL(InternedString::tableSize(), tableSize + 2);
+	d = InternedString();
+	BOOST_CHECK_EQUAL(InternedString::tableSize(), tableSize + 1);
+	a = InternedString();
+	b = InternedString();
+	BOOST_CHECK_EQUAL(c.str(), "interned test");
+	c = InternedString("");
+	BOOST_CHECK_EQUAL(InternedString::tableSize(), tableSize);
+}
+BOOST_AUTO_TEST_CASE(threads) {
+	size_t tableSize = InternedString::tableSize();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([]() {
+			for (int i = 0; i < 20000; i++) {
+				InternedString value("shared " + std::to_string(i % 7));
+				InternedString copy = value;
+				BOOST_REQUIRE_EQUAL(copy.str(), "shared " + std::to_string(i % 7));
+			}
+		});
+	}
+	for (auto &thread: threads)
+		thread.join();
+	BOOST_CHECK_EQUAL(InternedString::tableSize(), tableSize);
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "color_names/KdTree.h"
+#include "math/Algorithms.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+using namespace color_names;
+BOOST_AUTO_TEST_SUITE(kdTree)
+static std::vector<Color> randomColors(size_t count, uint32_t seed) {
+	Color::initialize();
+	test::RandomGenerator random(seed);
+	std::vector<Color> colors(count);
+	for (auto &color: colors) {
+		Color rgb(random.nextFloat(), random.nextFloat(), random.nextFloat());
+		color = rgb.rgbToLabD50();
+	}
+	return colors;
+}
+static std::vector<KdTree::Match> bruteForce(const std::vector<Color> &colors, const Color &color, size_t count) {
+	std::vector<KdTree::Match> matches;
+	for (uint32_t i = 0; i < colors.size(); i++) {
+		matches.push_back(KdTree::Match { Color::distanceLch(colors[i], color), i });
+	}
+	std::sort(matches.begin(), matches.end(), [](const KdTree::Match &a, const KdTree::Match &b) {
+		return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+	});
+	if (matches.size() > count)
+		matches.resize(count);
+	return matches;
+}
+BOOST_AUTO_TEST_CASE(empty) {
+	KdTree tree;
+	tree.build({});
+	BOOST_CHECK(tree.empty());
+	KdTree::Match match;
+	BOOST_CHECK(!tree.findNearest(Color(50.0f, 0.0f, 0.0f), match));
+	std::vector<KdTree::Match> matches;
+	tree.find(Color(50.0f, 0.0f, 0.0f), 5, matches);
+	BOOST_CHECK(matches.empty());
+}
+BOOST_AUTO_TEST_CASE(lessColorsThanRequested) {
+	auto colors = randomColors(5, 3);
+	KdTree tree;
+	tree.build(colors);
+	std::vector<KdTree::Match> matches;
+	tree.find(Color(50.0f, 10.0f, -10.0f), 9, matches);
+	BOOST_CHECK_EQUAL(matches.size(), 5);
+}
+BOOST_AUTO_TEST_CASE(matchesBruteForce) {
+	auto colors = randomColors(5000, 7);
+	auto queries = randomColors(200, 11);
+	KdTree tree;
+	tree.build(colors);
+	BOOST_CHECK_EQUAL(tree.size(), colors.size());
+	std::vector<KdTree::Match> matches;
+	for (const auto &query: queries) {
+		auto expected = bruteForce(colors, query, 9);
+		tree.find(query, 9, matches);
+		BOOST_REQUIRE_EQUAL(matches.size(), expected.size());
+		for (size_t i = 0; i < matches.size(); i++) {
+			BOOST_CHECK_EQUAL(matches[i].index, expected[i].index);
+			BOOST_CHECK_EQUAL(matches[i].distance, expected[i].distance);
+		}
+		KdTree::Match match;
+		BOOST_REQUIRE(tree.findNearest(query, match));
+		BOOST_CHECK_EQUAL(match.index, expected[0].index);
+	}
+}
+BOOST_AUTO_TEST_CASE(duplicateColors) {
+	std::vector<Color> colors(100, Color(50.0f, 20.0f, 20.0f));
+	KdTree tree;
+	tree.build(colors);
+	std::vector<KdTree::Match> matches;
+	tree.find(Color(50.0f, 20.0f, 20.0f), 3, matches);
+	BOOST_REQUIRE_EQUAL(matches.size(), 3);
+	for (uint32_t i = 0; i < 3; i++) {
+		BOOST_CHECK_EQUAL(matches[i].index, i);
+		BOOST_CHECK_EQUAL(matches[i].distance, 0.0f);
+	}
+}
+namespace {
+// Simplified copy of the bucket grid previously used by color names, kept for comparison.
+struct Grid {
+	static const int SpaceDivisions = 8;
+	Grid(const std::vector<Color> &colors):
+		colors(colors) {
+		for (uint32_t i = 0; i < colors.size(); i++)
+			buckets[index(colors[i].lab.L, 100, 0)][index(colors[i].lab.a, 200, 100)][index(colors[i].lab.b, 200, 100)].push_back(i);
+	}
+	static int index(float value, float range, float offset, float shift = 0) {
+		return math::clamp(int((value + offset) / range * SpaceDivisions + shift), 0, SpaceDivisions - 1);
+	}
+	uint32_t findNearest(const Color &color) const {
+		int start[3] = { index(color.lab.L, 100, 0, -0.5f), index(color.lab.a, 200, 100, -0.5f), index(color.lab.b, 200, 100, -0.5f) };
+		int end[3] = { index(color.lab.L, 100, 0, 0.5f), index(color.lab.a, 200, 100, 0.5f), index(color.lab.b, 200, 100, 0.5f) };
+		std::array<std::array<std::array<bool, SpaceDivisions>, SpaceDivisions>, SpaceDivisions> visited {};
+		float bestDistance = 1e5;
+		uint32_t best = 0;
+		bool found = false;
+		for (int expansion = 0; expansion < SpaceDivisions - 1 && !found; ++expansion) {
+			for (int x = std::max(start[0] - expansion, 0); x <= std::min(end[0] + expansion, SpaceDivisions - 1); ++x) {
+				for (int y = std::max(start[1] - expansion, 0); y <= std::min(end[1] + expansion, SpaceDivisions - 1); ++y) {
+					for (int z = std::max(start[2] - expansion, 0); z <= std::min(end[2] + expansion, SpaceDivisions - 1); ++z) {
+						if (visited[x][y][z])
+							continue;
+						visited[x][y][z] = true;
+						for (auto i: buckets[x][y][z]) {
+							float distance = Color::distanceLch(colors[i], color);
+							if (distance < bestDistance) {
+								bestDistance = distance;
+								best = i;
+								found = true;
+							}
+						}
+					}
+				}
+			}
+		}
+		return best;
+	}
+	const std::vector<Color> &colors;
+	std::vector<uint32_t> buckets[SpaceDivisions][SpaceDivisions][SpaceDivisions];
+};
+}
+BOOST_AUTO_TEST_CASE(benchmarkAgainstGrid, BENCHMARK_DECORATORS) {
+	auto colors = randomColors(100000, 5);
+	auto queries = randomColors(10000, 13);
+	KdTree tree;
+	test::benchmark("k-d tree build, 100k colors", [&]() {
+		tree.build(colors);
+	});
+	Grid grid(colors);
+	size_t gridSum = 0, treeSum = 0;
+	test::benchmark("grid, 10k queries", [&]() {
+		for (const auto &query: queries)
+			gridSum += grid.findNearest(query);
+	});
+	test::benchmark("k-d tree, 10k queries", [&]() {
+		KdTree::Match match;
+		for (const auto &query: queries) {
+			tree.findNearest(query, match);
+			treeSum += match.index;
+		}
+	});
+	std::vector<KdTree::Match> matches;
+	test::benchmark("k-d tree, 10k queries for 9 closest colors", [&]() {
+		for (const auto &query: queries)
+			tree.find(query, 9, matches);
+	});
+	BOOST_CHECK(gridSum > 0 && treeSum > 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "math/MultiKeySort.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <vector>
+using namespace math;
+namespace {
+using Key = MultiKeySort::Key;
+std::vector<float> randomValues(size_t count, uint32_t seed, int distinct = 0) {
+	test::RandomGenerator random(seed);
+	std::vector<float> values(count);
+	for (auto &value: values)
+		value = distinct > 0 ? static_cast<float>(random.next() % distinct) / distinct : random.nextFloat(-1.0f, 1.0f);
+	return values;
+}
+std::vector<uint32_t> stableSort(const std::vector<std::vector<float>> &values, const std::vector<bool> &reverse) {
+	std::vector<uint32_t> result(values[0].size());
+	std::iota(result.begin(), result.end(), 0);
+	std::stable_sort(result.begin(), result.end(), [&](uint32_t a, uint32_t b) {
+		for (size_t i = 0; i < values.size(); i++) {
+			if (values[i][a] != values[i][b])
+				return (values[i][a] < values[i][b]) != reverse[i];
+		}
+		return false;
+	});
+	return result;
+}
+bool same(common::Span<const uint32_t> a, const std::vector<uint32_t> &b) {
+	return a.size() == b.size() && std::equal(b.begin(), b.end(), a.data());
+}
+}
+BOOST_AUTO_TEST_SUITE(multiKeySort)
+BOOST_AUTO_TEST_CASE(singleKey) {
+	std::vector<float> values { 0.5f, -1.0f, 0.0f, -0.0f, 0.5f, 2.0f, -3.5f };
+	MultiKeySort sort;
+	Key key { common::Span<const float>(values.data(), values.size()) };
+	BOOST_CHECK(same(sort.sort(common::Span<const Key>(&key, 1)), { 6, 1, 2, 3, 0, 4, 5 }));
+	key.reverse = true;
+	BOOST_CHECK(same(sort.sort(common::Span<const Key>(&key, 1)), { 5, 0, 4, 2, 3, 1, 6 }));
+	BOOST_CHECK_EQUAL(sort.sort(common::Span<const Key>()).size(), 0);
+}
+BOOST_AUTO_TEST_CASE(multipleKeys) {
+	MultiKeySort sort;
+	// Large enough to be sorted on multiple threads.
+	for (size_t count: { 1000, 300000 }) {
+		std::vector<std::vector<float>> values { randomValues(count, 1, 7), randomValues(count, 2, 100), randomValues(count, 3) };
+		for (int variant = 0; variant < 4; variant++) {
+			std::vector<bool> reverse { (variant & 1) != 0, (variant & 2) != 0, variant == 3 };
+			std::vector<Key> keys;
+			for (size_t i = 0; i < values.size(); i++)
+				keys.push_back(Key { common::Span<const float>(values[i].data(), count), reverse[i] });
+			BOOST_CHECK(same(sort.sort(common::Span<const Key>(keys.data(), keys.size())), stableSort(values, reverse)));
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(grouping) {
+	const size_t count = 10000;
+	auto groupValues = randomValues(count, 4);
+	for (auto &value: groupValues)
+		value = std::fabs(value);
+	auto sortValues = randomValues(count, 5);
+	BinaryTreeQuantization<float> tree;
+	for (auto value: groupValues)
+		tree.add(value);
+	tree.reduce(5);
+	tree.reduceByMinDistance(0.1f);
+	std::vector<std::vector<float>> values { groupValues, sortValues };
+	for (auto &value: values[0])
+		value = tree.find(value);
+	MultiKeySort sort;
+	Key keys[] = {
+		{ common::Span<const float>(groupValues.data(), count), true, 5, 0.1f },
+		{ common::Span<const float>(sortValues.data(), count), false },
+	};
+	auto order = sort.sort(common::Span<const Key>(keys, 2));
+	BOOST_CHECK(same(order, stableSort(values, { true, false })));
+	size_t groups = 1;
+	for (size_t i = 1; i < count; i++) {
+		if (values[0][order[i]] != values[0][order[i - 1]])
+			groups++;
+	}
+	BOOST_CHECK_LE(groups, 5);
+}
+BOOST_AUTO_TEST_CASE(benchmarkSort, BENCHMARK_DECORATORS) {
+	const size_t count = 1000000;
+	auto hue = randomValues(count, 1), lightness = randomValues(count, 2), chroma = randomValues(count, 3);
+	using Item = std::tuple<float, float, uint32_t>;
+	std::vector<Item> items;
+	test::benchmark("1M colors, group and sort, tuple stable sort", [&]() {
+		BinaryTreeQuantization<float> tree;
+		for (auto value: hue)
+			tree.add(value);
+		tree.reduce(10);
+		tree.reduceByMinDistance(0.5f);
+		items.clear();
+		for (size_t i = 0; i < count; i++)
+			items.emplace_back(tree.find(hue[i]), lightness[i], static_cast<uint32_t>(i));
+		std::stable_sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+			if (std::get<0>(a) != std::get<0>(b))
+				return std::get<0>(a) < std::get<0>(b);
+			return std::get<1>(a) < std::get<1>(b);
+		});
+	});
+	MultiKeySort sort;
+	Key keys[] = {
+		{ common::Span<const float>(hue.data(), count), false, 10, 0.5f },
+		{ common::Span<const float>(lightness.data(), count) },
+		{ common::Span<const float>(chroma.data(), count) },
+	};
+	test::benchmark("1M colors, group and sort, first run", [&]() {
+		sort.sort(common::Span<const Key>(keys, 2));
+	});
+	test::benchmark("1M colors, group and sort", [&]() {
+		sort.sort(common::Span<const Key>(keys, 2));
+	});
+	test::benchmark("1M colors, group by hue, sort by lightness and chroma", [&]() {
+		sort.sort(common::Span<const Key>(keys, 3));
+	});
+	keys[0].maxGroups = 0;
+	test::benchmark("1M colors, sort by hue, lightness and chroma", [&]() {
+		sort.sort(common::Span<const Key>(keys, 3));
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
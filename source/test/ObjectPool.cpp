@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/ObjectPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+using common::ObjectPool;
+BOOST_AUTO_TEST_SUITE(objectPool)
+struct Object {
+	double values[3];
+};
+BOOST_AUTO_TEST_CASE(contiguous) {
+	ObjectPool pool(sizeof(Object), alignof(Object));
+	std::vector<void *> objects;
+	for (int i = 0; i < 100; i++)
+		objects.push_back(pool.allocate());
+	for (size_t i = 1; i < objects.size(); i++)
+		BOOST_CHECK_EQUAL(static_cast<uint8_t *>(objects[i]) - static_cast<uint8_t *>(objects[i - 1]), pool.objectSize());
+	BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(objects[0]) % alignof(Object), 0);
+	for (auto *object: objects)
+		pool.deallocate(object);
+}
+BOOST_AUTO_TEST_CASE(reuse) {
+	ObjectPool pool(sizeof(Object), alignof(Object));
+	const size_t count = pool.objectsPerBlock() * 3;
+	std::vector<void *> objects;
+	for (size_t i = 0; i < count; i++)
+		objects.push_back(pool.allocate());
+	size_t allocated, blocks;
+	pool.statistics(allocated, blocks);
+	BOOST_CHECK_EQUAL(allocated, count);
+	BOOST_CHECK_EQUAL(blocks, 3);
+	// Free every other object of the first block, so that block can be reused.
+	for (size_t i = 0; i < pool.objectsPerBlock(); i += 2)
+		pool.deallocate(objects[i]);
+	std::vector<void *> reused;
+	for (size_t i = 0; i < pool.objectsPerBlock() / 2; i++)
+		reused.push_back(pool.allocate());
+	pool.statistics(allocated, blocks);
+	BOOST_CHECK_EQUAL(blocks, 3);
+	for (size_t i = 1; i < pool.objectsPerBlock(); i += 2)
+		pool.deallocate(objects[i]);
+	for (size_t i = pool.objectsPerBlock(); i < count; i++)
+		pool.deallocate(objects[i]);
+	for (auto *object: reused)
+		pool.deallocate(object);
+	pool.statistics(allocated, blocks);
+	BOOST_CHECK_EQUAL(allocated, 0);
+	BOOST_CHECK_LE(blocks, 1);
+}
+BOOST_AUTO_TEST_CASE(threads) {
+	ObjectPool pool(sizeof(Object), alignof(Object));
+	std::vector<std::thread> threads;
+	std::vector<std::vector<void *>> objects(4);
+	for (size_t t = 0; t < objects.size(); t++) {
+		threads.emplace_back([&pool, &objects, t]() {
+			for (int i = 0; i < 10000; i++) {
+				objects[t].push_back(pool.allocate());
+				if (i % 3 == 0) {
+					pool.deallocate(objects[t].back());
+					objects[t].pop_back();
+				}
+			}
+		});
+	}
+	for (auto &thread: threads)
+		thread.join();
+	std::vector<void *> all;
+	for (auto &list: objects)
+		all.insert(all.end(), list.begin(), list.end());
+	std::sort(all.begin(), all.end());
+	BOOST_CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+	size_t allocated, blocks;
+	pool.statistics(allocated, blocks);
+	BOOST_CHECK_EQUAL(allocated, all.size());
+	for (auto *object: all)
+		pool.deallocate(object);
+}
+BOOST_AUTO_TEST_SUITE_END()
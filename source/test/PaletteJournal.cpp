@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "PaletteJournal.h"
+#include "FileFormat.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "common/Format.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+namespace {
+struct Files {
+	Files(const std::string &name):
+		snapshot(name + ".gpa"),
+		journal(name + ".journal") {
+	}
+	test::TemporaryFile snapshot, journal;
+};
+void addColors(ColorList &colorList, size_t count, size_t first = 0) {
+	test::RandomGenerator random(static_cast<uint32_t>(first + 1));
+	for (size_t i = first; i < first + count; i++)
+		colorList.add(ColorObject(common::format("color {}", i % 300), Color(random.nextFloat(), random.nextFloat(), random.nextFloat(), random.nextFloat())));
+}
+bool sameColors(const ColorList &a, const ColorList &b) {
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const ColorObject *a, const ColorObject *b) {
+		return a->getName() == b->getName() && std::memcmp(a->getColor().data, b->getColor().data, sizeof(a->getColor().data)) == 0;
+	});
+}
+bool restoresSameColors(const Files &files, const ColorList &expected) {
+	PaletteJournal journal(files.snapshot.path, files.journal.path);
+	ColorList restored;
+	if (!journal.restore(restored))
+		return false;
+	return sameColors(restored, expected);
+}
+}
+BOOST_AUTO_TEST_SUITE(paletteJournal)
+BOOST_AUTO_TEST_CASE(journalChanges) {
+	Files files("journal-changes");
+	ColorList colorList;
+	addColors(colorList, 1000);
+	PaletteJournal journal(files.snapshot.path, files.journal.path);
+	journal.reset(colorList);
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, colorList));
+	BOOST_CHECK(!journal.update(colorList));
+	colorList.begin()[10]->setColor(Color(0.25f));
+	BOOST_CHECK(journal.update(colorList));
+	BOOST_CHECK_LT(journal.journalSize(), 64);
+	colorList.begin()[20]->setName("renamed");
+	addColors(colorList, 5, 1000);
+	journal.update(colorList);
+	colorList.add(new ColorObject("inserted", Color(0.5f)), 3);
+	colorList.begin()[3]->release();
+	journal.update(colorList);
+	size_t journalSize = journal.journalSize(), index = 0;
+	colorList.remove([&index](ColorObject *) {
+		return index++ % 100 == 7;
+	}, false, false);
+	journal.update(colorList);
+	// Each removed run has its own small record.
+	BOOST_CHECK_LT(journal.journalSize() - journalSize, 11 * 20);
+	journalSize = journal.journalSize();
+	std::reverse(colorList.begin() + 100, colorList.begin() + 200);
+	colorList.begin()[150]->setName("reordered");
+	journal.update(colorList);
+	// Reorder record stores source positions, not colors.
+	BOOST_CHECK_LT(journal.journalSize() - journalSize, 100 * sizeof(uint32_t) + 100);
+	std::rotate(colorList.begin(), colorList.begin() + 1, colorList.end());
+	journal.update(colorList);
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, colorList));
+	colorList.removeAll();
+	journal.update(colorList);
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, colorList));
+}
+BOOST_AUTO_TEST_CASE(mixedChanges) {
+	Files files("mixed-changes");
+	ColorList colorList;
+	addColors(colorList, 200);
+	PaletteJournal journal(files.snapshot.path, files.journal.path);
+	journal.reset(colorList);
+	test::RandomGenerator random(7);
+	for (int step = 0; step < 200; step++) {
+		switch (random.next() % 4) {
+		case 0:
+			addColors(colorList, random.next() % 3 + 1, 200 + step);
+			break;
+		case 1:
+			if (!colorList.empty()) {
+				size_t removed = random.next() % colorList.size();
+				size_t index = 0;
+				colorList.remove([&](ColorObject *) {
+					return index++ == removed;
+				}, false, false);
+			}
+			break;
+		case 2:
+			if (colorList.size() > 1)
+				std::swap(colorList.begin()[random.next() % colorList.size()], colorList.begin()[random.next() % colorList.size()]);
+			break;
+		case 3:
+			if (!colorList.empty())
+				colorList.begin()[random.next() % colorList.size()]->setColor(Color(random.nextFloat()));
+			break;
+		}
+		journal.update(colorList);
+	}
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, colorList));
+}
+BOOST_AUTO_TEST_CASE(interruptedWrites) {
+	Files files("interrupted");
+	ColorList colorList;
+	addColors(colorList, 100);
+	{
+		PaletteJournal journal(files.snapshot.path, files.journal.path);
+		journal.reset(colorList);
+		colorList.begin()[0]->setName("first");
+		journal.update(colorList);
+	}
+	// Partially written record is ignored.
+	{
+		std::ofstream file(files.journal.path, std::ios::binary | std::ios::app);
+		file.write("\x20\x00\x00\x00\x01", 5);
+	}
+	ColorList restored;
+	{
+		PaletteJournal journal(files.snapshot.path, files.journal.path);
+		BOOST_REQUIRE(journal.restore(restored));
+		BOOST_CHECK(sameColors(restored, colorList));
+		// Journal with invalid tail is replaced by a new snapshot.
+		restored.begin()[1]->setName("second");
+		journal.update(restored);
+	}
+	BOOST_CHECK(restoresSameColors(files, restored));
+	// Journal written for a different snapshot is ignored.
+	std::ifstream file(files.journal.path, std::ios::binary);
+	std::vector<char> staleJournal((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	ColorList other;
+	addColors(other, 10);
+	{
+		PaletteJournal journal(files.snapshot.path, files.journal.path);
+		journal.reset(other);
+	}
+	{
+		std::ofstream file(files.journal.path, std::ios::binary | std::ios::trunc);
+		file.write(staleJournal.data(), staleJournal.size());
+	}
+	BOOST_CHECK(restoresSameColors(files, other));
+}
+BOOST_AUTO_TEST_CASE(twoWriters) {
+	Files files("two-writers");
+	ColorList first, second;
+	addColors(first, 100);
+	addColors(second, 50, 100);
+	PaletteJournal firstJournal(files.snapshot.path, files.journal.path, "gpick.test.journal");
+	PaletteJournal secondJournal(files.snapshot.path, files.journal.path, "gpick.test.journal");
+	firstJournal.reset(first);
+	firstJournal.flush();
+	secondJournal.reset(second);
+	secondJournal.flush();
+	test::RandomGenerator random(11);
+	// Writers take turns, each restore must return the whole palette of the last writer and never a mix of both.
+	for (int step = 0; step < 20; step++) {
+		bool useFirst = step % 3 != 2;
+		auto &colorList = useFirst ? first : second;
+		auto &journal = useFirst ? firstJournal : secondJournal;
+		colorList.begin()[random.next() % colorList.size()]->setColor(Color(random.nextFloat()));
+		if (step % 4 == 0)
+			addColors(colorList, 2, 1000 + step * 2);
+		BOOST_CHECK(journal.update(colorList));
+		journal.flush();
+		BOOST_CHECK_MESSAGE(restoresSameColors(files, colorList), "restored colors do not match last writer at step " << step);
+	}
+}
+BOOST_AUTO_TEST_CASE(failedSnapshot) {
+	Files files("failed-snapshot");
+	ColorList colorList;
+	addColors(colorList, 100);
+	PaletteJournal journal(files.snapshot.path, files.journal.path);
+	journal.reset(colorList);
+	journal.flush();
+	ColorList saved;
+	saved.add(colorList);
+	// Directory in place of temporary snapshot file makes snapshot writes fail, while journal stays writable.
+	const auto blocker = files.snapshot.path + ".tmp";
+	std::filesystem::create_directory(blocker);
+	ColorList other;
+	addColors(other, 20, 100);
+	journal.reset(other);
+	other.begin()[5]->setName("modified");
+	journal.update(other);
+	journal.flush();
+	other.begin()[6]->setName("modified again");
+	journal.update(other);
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, saved));
+	// Snapshot is retried by the next update, even without new changes.
+	std::filesystem::remove(blocker);
+	BOOST_CHECK(!journal.update(other));
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, other));
+	other.begin()[7]->setName("journaled");
+	journal.update(other);
+	journal.flush();
+	BOOST_CHECK(restoresSameColors(files, other));
+}
+BOOST_AUTO_TEST_CASE(benchmarkSave, BENCHMARK_DECORATORS) {
+	for (size_t count: { 10000, 100000, 1000000 }) {
+		Files files("benchmark");
+		ColorList colorList;
+		addColors(colorList, count);
+		test::benchmark(common::format("{} colors, full save", count), [&]() {
+			paletteFileSave(files.snapshot.path.c_str(), colorList);
+		});
+		PaletteJournal journal(files.snapshot.path, files.journal.path);
+		test::benchmark(common::format("{} colors, snapshot", count), [&]() {
+			journal.reset(colorList);
+			journal.flush();
+		});
+		test::benchmark(common::format("{} colors, journal 100 modifications", count), [&]() {
+			for (size_t i = 0; i < 100; i++) {
+				colorList.begin()[i * (count / 100)]->setColor(Color(0.5f));
+				journal.update(colorList);
+			}
+			journal.flush();
+		});
+		test::benchmark(common::format("{} colors, unchanged update", count), [&]() {
+			journal.update(colorList);
+		});
+		test::benchmark(common::format("{} colors, restore", count), [&]() {
+			PaletteJournal restoreJournal(files.snapshot.path, files.journal.path);
+			ColorList restored;
+			restoreJournal.restore(restored);
+		});
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/Parallel.h"
+#include <atomic>
+#include <numeric>
+using namespace common;
+BOOST_AUTO_TEST_SUITE(parallel)
+BOOST_AUTO_TEST_CASE(coversRange) {
+	std::vector<int> values(100000, 0);
+	parallelFor(values.size(), 1000, [&values](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			values[i]++;
+	});
+	BOOST_CHECK_EQUAL(std::accumulate(values.begin(), values.end(), 0), 100000);
+	BOOST_CHECK_EQUAL(*std::min_element(values.begin(), values.end()), 1);
+}
+BOOST_AUTO_TEST_CASE(smallRange) {
+	std::atomic<size_t> calls = 0;
+	parallelFor(10, 1000, [&calls](size_t begin, size_t end) {
+		BOOST_CHECK_EQUAL(begin, 0);
+		BOOST_CHECK_EQUAL(end, 10);
+		calls++;
+	});
+	BOOST_CHECK_EQUAL(calls, 1);
+}
+BOOST_AUTO_TEST_CASE(emptyRange) {
+	size_t calls = 0;
+	parallelFor(0, 1, [&calls](size_t, size_t) {
+		calls++;
+	});
+	BOOST_CHECK_EQUAL(calls, 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
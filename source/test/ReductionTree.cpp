@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "math/ReductionTree.h"
+#include "math/ColorHistogram.h"
+#include "math/OctreeColorQuantization.h"
+#include <cmath>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+std::vector<QuantizedColor> randomColors(size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	std::vector<QuantizedColor> result;
+	for (size_t i = 0; i < count; i++)
+		result.push_back(QuantizedColor { Color(random.nextFloat(), random.nextFloat(), random.nextFloat()), 1 + random.next() % 1000 });
+	return result;
+}
+uint64_t totalPixels(const std::vector<QuantizedColor> &colors) {
+	uint64_t result = 0;
+	for (const auto &color: colors)
+		result += color.pixels;
+	return result;
+}
+}
+BOOST_FIXTURE_TEST_SUITE(reductionTree, Initialize)
+BOOST_AUTO_TEST_CASE(empty) {
+	ReductionTree tree;
+	BOOST_CHECK_EQUAL(tree.size(), 0);
+	BOOST_CHECK(tree.palette(10).empty());
+	BOOST_CHECK(ReductionTree(std::vector<QuantizedColor>()).palette(1).empty());
+}
+BOOST_AUTO_TEST_CASE(paletteSizes) {
+	auto colors = randomColors(200, 1);
+	ReductionTree tree(colors);
+	BOOST_CHECK_EQUAL(tree.size(), 200);
+	for (size_t numberOfColors = 1; numberOfColors <= 200; numberOfColors++) {
+		auto palette = tree.palette(numberOfColors);
+		BOOST_REQUIRE_EQUAL(palette.size(), numberOfColors);
+		BOOST_CHECK_EQUAL(totalPixels(palette), totalPixels(colors));
+	}
+	BOOST_CHECK_EQUAL(tree.palette(0).size(), 1);
+	BOOST_CHECK_EQUAL(tree.palette(1000).size(), 200);
+	// Single color is pixel weighted average of all colors.
+	double sums[3] = { 0, 0, 0 };
+	for (const auto &color: colors) {
+		for (int j = 0; j < 3; j++)
+			sums[j] += color.color[j] * color.pixels;
+	}
+	auto single = tree.palette(1)[0];
+	for (int j = 0; j < 3; j++)
+		BOOST_CHECK_CLOSE(single.color[j], sums[j] / totalPixels(colors), 1e-3);
+}
+BOOST_AUTO_TEST_CASE(groups) {
+	std::vector<QuantizedColor> colors;
+	const Color centers[3] = { Color(0.8f, 0.1f, 0.1f), Color(0.1f, 0.7f, 0.1f), Color(0.1f, 0.1f, 0.6f) };
+	test::RandomGenerator random(2);
+	for (int i = 0; i < 30; i++) {
+		const auto &center = centers[i % 3];
+		colors.push_back(QuantizedColor { Color(center.red + random.nextFloat(-0.02f, 0.02f), center.green + random.nextFloat(-0.02f, 0.02f), center.blue + random.nextFloat(-0.02f, 0.02f)), 10 });
+	}
+	auto palette = ReductionTree(colors).palette(3);
+	BOOST_REQUIRE_EQUAL(palette.size(), 3);
+	for (const auto &center: centers) {
+		size_t matches = 0;
+		for (const auto &color: palette) {
+			if (color.pixels == 100 && std::abs(color.color.red - center.red) < 0.02f && std::abs(color.color.green - center.green) < 0.02f && std::abs(color.color.blue - center.blue) < 0.02f)
+				matches++;
+		}
+		BOOST_CHECK_EQUAL(matches, 1);
+	}
+}
+BOOST_AUTO_TEST_CASE(benchmarkPaletteSizes, BENCHMARK_DECORATORS) {
+	test::RandomGenerator random(3);
+	ColorHistogram histogram;
+	for (int i = 0; i < 1000000; i++)
+		histogram.add(static_cast<uint8_t>(random.next()), static_cast<uint8_t>(random.next()), static_cast<uint8_t>(random.next()));
+	OctreeColorQuantization octree;
+	octree.add(histogram);
+	octree.reduce(1000);
+	test::benchmark("octree copy and reduce, palettes of 1-1000 colors", [&]() {
+		for (size_t numberOfColors = 1; numberOfColors <= 1000; numberOfColors++) {
+			OctreeColorQuantization reducedOctree(octree);
+			reducedOctree.reduce(numberOfColors);
+		}
+	});
+	ReductionTree tree;
+	test::benchmark("reduction tree build, 1000 colors", [&]() {
+		tree = ReductionTree(OctreeQuantizer().quantize(histogram, 1000));
+	});
+	test::benchmark("reduction tree, palettes of 1-1000 colors", [&]() {
+		size_t colors = 0;
+		for (size_t numberOfColors = 1; numberOfColors <= 1000; numberOfColors++)
+			tree.visit(numberOfColors, [&colors](const QuantizedColor &) {
+				colors++;
+			});
+		BOOST_CHECK_EQUAL(colors, 1000 * 1001 / 2);
+	});
+}
+BOOST_AUTO_TEST_SUITE_END()
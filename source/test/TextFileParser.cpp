@@ -18,9 +18,13 @@
 
 #include <boost/test/unit_test.hpp>
 #include "parser/TextFile.h"
+#include "parser/TokenScan.h"
 #include "Color.h"
 #include "Common.h"
+#include "Benchmark.h"
+#include <sstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <string_view>
 using namespace text_file_parser;
@@ -82,6 +86,10 @@ struct Parser: public TextFile {
 		Configuration configuration;
 		TextFile::parse(configuration);
 	}
+	void parse(std::string_view text, const Configuration &configuration) {
+		if (!TextFile::parse(configuration, text.data(), text.length()))
+			m_failed = true;
+	}
 };
 }
 BOOST_AUTO_TEST_SUITE(textFileParser)
@@ -190,4 +198,100 @@ BOOST_AUTO_TEST_CASE(outOfRangeFloatValue) {
 	Color color = { 0xaa, 0xbb, 0 };
 	BOOST_CHECK_MESSAGE(parser[0] == color, parser[0] << " != " << color);
 }
+BOOST_AUTO_TEST_CASE(inMemoryChunks) {
+	std::string text;
+	for (int i = 0; i < 100000; ++i)
+		text += ".item { color: rgb(" + std::to_string(i % 256) + ", 187, 204); } // #ccbbaa\r\n";
+	Parser streaming(text);
+	Parser inMemory(nullptr);
+	Configuration configuration;
+	configuration.multiLineCComments = false;
+	inMemory.parse(text, configuration);
+	BOOST_CHECK(!inMemory.m_failed);
+	BOOST_REQUIRE_EQUAL(inMemory.count(), 100000);
+	BOOST_REQUIRE_EQUAL(streaming.count(), 100000);
+	for (size_t i = 0; i < inMemory.count(); ++i) {
+		Color color = { static_cast<int>(i % 256), 0xbb, 0xcc };
+		BOOST_REQUIRE_MESSAGE(inMemory[i] == color, "color " << (i + 1) << " incorrect, " << inMemory[i] << " != " << color);
+	}
+}
+BOOST_AUTO_TEST_CASE(inMemoryMultiLineComments) {
+	std::string text = "/*color: #ccbbaa\r\n*/\r\ncolor: #aabbcc";
+	Parser parser(nullptr);
+	parser.parse(text, Configuration());
+	BOOST_REQUIRE_EQUAL(parser.count(), 1);
+	Color color = { 0xaa, 0xbb, 0xcc };
+	BOOST_CHECK_MESSAGE(parser[0] == color, parser[0] << " != " << color);
+}
+BOOST_AUTO_TEST_CASE(decodeHex) {
+	BOOST_CHECK_EQUAL(decodeHexColor("aAbBcC", 6), 0xffccbbaau);
+	BOOST_CHECK_EQUAL(decodeHexColor("AABBCCDD", 8), 0xddccbbaau);
+	BOOST_CHECK_EQUAL(decodeHexColor("abc", 3), 0xffccbbaau);
+	BOOST_CHECK_EQUAL(decodeHexColor("aBcD", 4), 0xddccbbaau);
+	BOOST_CHECK_EQUAL(decodeHexColor("01234567", 8), 0x67452301u);
+	BOOST_CHECK_EQUAL(decodeHexColor("89abef", 6), 0xffefab89u);
+	BOOST_CHECK_EQUAL(decodeHexColor("09f", 3), 0xffff9900u);
+}
+BOOST_AUTO_TEST_CASE(tokenStart) {
+	for (int c = 0; c < 256; ++c) {
+		for (size_t position = 0; position < 40; ++position) {
+			std::string text(40, ' ');
+			text[position] = static_cast<char>(c);
+			auto *expected = findTokenStartScalar(text.data(), text.data() + text.length());
+			auto *result = findTokenStart(text.data(), text.data() + text.length());
+			BOOST_REQUIRE_MESSAGE(result == expected, "character " << c << " at " << position);
+		}
+	}
+	std::string_view text = "color: #aabbcc";
+	BOOST_CHECK_EQUAL(findTokenStart(text.data(), text.data() + text.length()) - text.data(), 0);
+	text = "  ;{}: \t\"#";
+	BOOST_CHECK_EQUAL(findTokenStart(text.data(), text.data() + text.length()) - text.data(), 9);
+	text = "xyz; :{} wxyz; \"pq\" zlmn_ijk; tokyo";
+	BOOST_CHECK_EQUAL(findTokenStart(text.data(), text.data() + text.length()) - text.data(), text.length());
+	for (char c: std::string_view("#+-./0123456789abcdefABCDEFhHrR\r\n"))
+		BOOST_CHECK_MESSAGE(findTokenStart(&c, &c + 1) == &c, "character " << c);
+	for (char c: std::string_view(" \t;:{}()\"'gGiIxXzZ"))
+		BOOST_CHECK_MESSAGE(findTokenStart(&c, &c + 1) == &c + 1, "character " << c);
+}
+BOOST_AUTO_TEST_CASE(benchmarkParse, BENCHMARK_DECORATORS) {
+	test::RandomGenerator random;
+	std::string text;
+	while (text.size() < 64 * 1024 * 1024) {
+		text += "/* Generated style sheet */\n.item" + std::to_string(random.next() % 1000) + " {\n";
+		text += "\tbackground-color: #" + std::to_string(100000 + random.next() % 900000) + ";\n";
+		text += "\tcolor: rgb(" + std::to_string(random.next() % 256) + ", " + std::to_string(random.next() % 256) + ", " + std::to_string(random.next() % 256) + ");\n";
+		text += "\tborder: 1px solid hsl(" + std::to_string(random.next() % 360) + ", 50%, 50%);\n}\n";
+	}
+	double megabytes = text.size() / (1024.0 * 1024.0);
+	double seconds = test::measure([&]() {
+		std::stringstream stream(text);
+		Parser parser(&stream);
+		parser.parse();
+	});
+	BOOST_TEST_MESSAGE("streaming parser: " << megabytes / seconds << " MB/s");
+	Configuration configuration;
+	seconds = test::measure([&]() {
+		Parser parser(nullptr);
+		parser.parse(text, configuration);
+	});
+	BOOST_TEST_MESSAGE("in-memory parser, single chunk: " << megabytes / seconds << " MB/s");
+	configuration.multiLineCComments = false;
+	seconds = test::measure([&]() {
+		Parser parser(nullptr);
+		parser.parse(text, configuration);
+	});
+	BOOST_TEST_MESSAGE("in-memory parser, parallel chunks: " << megabytes / seconds << " MB/s");
+	size_t tokens = 0;
+	seconds = test::measure([&]() {
+		for (const char *p = text.data(), *end = text.data() + text.size(); p < end; p++, tokens++)
+			p = findTokenStartScalar(p, end);
+	});
+	BOOST_TEST_MESSAGE("token start search, scalar: " << megabytes / seconds << " MB/s");
+	seconds = test::measure([&]() {
+		for (const char *p = text.data(), *end = text.data() + text.size(); p < end; p++, tokens--)
+			p = findTokenStart(p, end);
+	});
+	BOOST_TEST_MESSAGE("token start search: " << megabytes / seconds << " MB/s");
+	BOOST_CHECK_EQUAL(tokens, 0);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2009-2022, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Benchmark.h"
+#include "Common.h"
+#include "transformation/Chain.h"
+#include "transformation/Invert.h"
+#include "transformation/GammaModification.h"
+#include "transformation/Quantization.h"
+#include "transformation/ColorVisionDeficiency.h"
+#include "dynv/Map.h"
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace transformation;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+using ChainBuilder = std::function<void(Chain &chain)>;
+const size_t sizes[] = { 1, 255, 256, 257, 1000 };
+std::vector<Color> randomColors(size_t count, uint32_t seed) {
+	test::RandomGenerator random(seed);
+	std::vector<Color> colors(count);
+	for (auto &color: colors) {
+		color = Color(random.nextFloat(), random.nextFloat(), random.nextFloat());
+		color.alpha = random.nextFloat();
+	}
+	return colors;
+}
+bool equal(const Color &a, const Color &b) {
+	for (int i = 0; i < 4; i++) {
+		if (std::abs(a[i] - b[i]) > 1e-5f)
+			return false;
+	}
+	return true;
+}
+void checkChain(const ChainBuilder &builder) {
+	Chain chain;
+	builder(chain);
+	for (auto size: sizes) {
+		auto input = randomColors(size, static_cast<uint32_t>(size));
+		std::vector<Color> expected(size), output(size);
+		for (size_t i = 0; i < size; i++)
+			chain.apply(&input[i], &expected[i]);
+		chain.apply(common::Span<const Color>(input.data(), input.size()), common::Span<Color>(output.data(), output.size()));
+		auto inPlace = input;
+		chain.apply(common::Span<const Color>(inPlace.data(), inPlace.size()), common::Span<Color>(inPlace.data(), inPlace.size()));
+		for (size_t i = 0; i < size; i++) {
+			BOOST_TEST_CONTEXT("size " << size << ", index " << i << ", input " << input[i]) {
+				BOOST_CHECK_MESSAGE(equal(output[i], expected[i]), output[i] << " != " << expected[i]);
+				BOOST_CHECK_MESSAGE(equal(inPlace[i], expected[i]), inPlace[i] << " != " << expected[i]);
+				BOOST_CHECK_EQUAL(output[i].alpha, input[i].alpha);
+			}
+		}
+	}
+}
+std::unique_ptr<Quantization> makeQuantization(float value, bool clipTop) {
+	dynv::Map options;
+	options.set("value", value);
+	options.set("clip-top", clipTop);
+	auto transformation = std::make_unique<Quantization>();
+	transformation->deserialize(options);
+	return transformation;
+}
+const ColorVisionDeficiency::Type deficiencyTypes[] = {
+	ColorVisionDeficiency::Type::protanomaly,
+	ColorVisionDeficiency::Type::deuteranomaly,
+	ColorVisionDeficiency::Type::tritanomaly,
+	ColorVisionDeficiency::Type::protanopia,
+	ColorVisionDeficiency::Type::deuteranopia,
+	ColorVisionDeficiency::Type::tritanopia,
+};
+}
+BOOST_AUTO_TEST_SUITE(transformationChain)
+BOOST_FIXTURE_TEST_CASE(invert, Initialize) {
+	checkChain([](Chain &chain) {
+		chain.add(std::make_unique<Invert>());
+	});
+}
+BOOST_FIXTURE_TEST_CASE(gammaModification, Initialize) {
+	for (auto value: { 0.45f, 1.0f, 2.2f }) {
+		BOOST_TEST_CONTEXT("gamma " << value) {
+			checkChain([value](Chain &chain) {
+				chain.add(std::make_unique<GammaModification>(value));
+			});
+		}
+	}
+}
+BOOST_FIXTURE_TEST_CASE(quantization, Initialize) {
+	for (auto clipTop: { false, true }) {
+		for (auto value: { 2.0f, 16.0f }) {
+			BOOST_TEST_CONTEXT("value " << value << ", clip top " << clipTop) {
+				checkChain([value, clipTop](Chain &chain) {
+					chain.add(makeQuantization(value, clipTop));
+				});
+			}
+		}
+	}
+}
+BOOST_FIXTURE_TEST_CASE(colorVisionDeficiency, Initialize) {
+	for (auto type: deficiencyTypes) {
+		for (auto strength: { 0.0f, 0.35f, 1.0f }) {
+			BOOST_TEST_CONTEXT("type " << static_cast<int>(type) << ", strength " << strength) {
+				checkChain([type, strength](Chain &chain) {
+					chain.add(std::make_unique<ColorVisionDeficiency>(type, strength));
+				});
+			}
+		}
+	}
+}
+BOOST_FIXTURE_TEST_CASE(mixedSpaces, Initialize) {
+	checkChain([](Chain &chain) {
+		chain.add(std::make_unique<Invert>());
+		chain.add(std::make_unique<GammaModification>(1.8f));
+		chain.add(std::make_unique<ColorVisionDeficiency>(ColorVisionDeficiency::Type::deuteranomaly, 0.6f));
+		chain.add(std::make_unique<Invert>());
+	});
+	checkChain([](Chain &chain) {
+		chain.add(std::make_unique<ColorVisionDeficiency>(ColorVisionDeficiency::Type::protanopia, 1.0f));
+		chain.add(std::make_unique<Invert>());
+		chain.add(std::make_unique<ColorVisionDeficiency>(ColorVisionDeficiency::Type::tritanomaly, 0.5f));
+		chain.add(std::make_unique<GammaModification>(0.7f));
+	});
+	checkChain([](Chain &chain) {
+		chain.add(makeQuantization(8, true));
+		chain.add(std::make_unique<GammaModification>(2.2f));
+		chain.add(std::make_unique<ColorVisionDeficiency>(ColorVisionDeficiency::Type::tritanopia, 1.0f));
+	});
+}
+BOOST_FIXTURE_TEST_CASE(disabledChain, Initialize) {
+	checkChain([](Chain &chain) {
+		chain.add(std::make_unique<Invert>());
+		chain.setEnabled(false);
+	});
+}
+BOOST_FIXTURE_TEST_CASE(singleTransformation, Initialize) {
+	auto input = randomColors(300, 7);
+	std::vector<Color> output(input.size());
+	ColorVisionDeficiency transformation(ColorVisionDeficiency::Type::protanomaly, 0.8f);
+	transformation.apply(common::Span<const Color>(input.data(), input.size()), common::Span<Color>(output.data(), output.size()));
+	Chain chain;
+	chain.add(std::make_unique<ColorVisionDeficiency>(ColorVisionDeficiency::Type::protanomaly, 0.8f));
+	for (size_t i = 0; i < input.size(); i++) {
+		Color expected;
+		chain.apply(&input[i], &expected);
+		BOOST_CHECK_MESSAGE(equal(output[i], expected), output[i] << " != " << expected);
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
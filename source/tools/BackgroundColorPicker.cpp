@@ -21,6 +21,7 @@
 #include "ColorObject.h"
 #include "GlobalState.h"
 #include "ColorSpaces.h"
+#include "ComponentText.h"
 #include "Converters.h"
 #include "I18N.h"
 #include "EventBus.h"
@@ -126,7 +127,7 @@ struct BackgroundColorPicker: public IEventHandler {
 			Color transformedColor;
 			gtk_color_component_get_transformed_color(GTK_COLOR_COMPONENT(colorComponent), transformedColor);
 			float alpha = gtk_color_component_get_alpha(GTK_COLOR_COMPONENT(colorComponent));
-			std::vector<std::string> values = toTexts(colorSpace->type, transformedColor, alpha, gs);
+			const auto &values = toTexts(colorSpace->type, transformedColor, alpha, gs);
 			const char *texts[5] = { 0 };
 			int j = 0;
 			for (auto &value: values) {
@@ -106,12 +106,7 @@ static void calc(ColorSpaceSamplerArgs *args, bool preview, size_t limit)
 		}
 	}
 	Color t;
-	common::Guard colorListGuard = colorList.changeGuard();
 	for (size_t i = 0; i < value_count; i++){
-		if (preview){
-			if (limit <= 0) return;
-			limit--;
-		}
 		switch (args->color_space){
 			case 0:
 				t = values[i];
@@ -140,7 +135,12 @@ static void calc(ColorSpaceSamplerArgs *args, bool preview, size_t limit)
 		if (args->linearization)
 			t.nonLinearRgbInplace();
 		t.normalizeRgbInplace();
-		ColorObject colorObject(t);
+		values[i] = t;
+	}
+	nameAssigner.prepare(common::Span<const Color>(values.data(), values.size()));
+	common::Guard colorListGuard = colorList.changeGuard();
+	for (const auto &value: values){
+		ColorObject colorObject(value);
 		nameAssigner.assign(colorObject);
 		colorList.add(colorObject);
 	}
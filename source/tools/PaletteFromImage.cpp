@@ -24,15 +24,34 @@
 #include "GlobalState.h"
 #include "ToolColorNaming.h"
 #include "I18N.h"
+#include "ImageRows.h"
 #include "dynv/Map.h"
-#include "math/OctreeColorQuantization.h"
-#include "common/Guard.h"
+#include "math/ColorHistogram.h"
+#include "math/ColorQuantizer.h"
+#include "math/ReductionTree.h"
+#include "common/Match.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
-#include <mutex>
+#include <vector>
 
+struct Algorithm {
+	const char *id;
+	const char *name;
+	math::QuantizerType type;
+};
+const Algorithm algorithms[] = {
+	{ "octree", N_("Octree"), math::QuantizerType::octree },
+	{ "median_cut", N_("Median cut"), math::QuantizerType::medianCut },
+	{ "k_means_linear_rgb", N_("K-means (linear RGB)"), math::QuantizerType::kMeansLinearRgb },
+	{ "k_means_lab", N_("K-means (Lab)"), math::QuantizerType::kMeansLab },
+};
 struct PaletteColorNameAssigner: public ToolColorNameAssigner {
 	PaletteColorNameAssigner(GlobalState &gs):
 		ToolColorNameAssigner(gs) {
@@ -53,115 +72,313 @@ protected:
 	std::string_view m_fileName;
 	int m_index;
 };
-struct PaletteFromImageArgs {
-	GtkWidget *fileBrowser, *rangeColors, *previewExpander;
-	std::string filename, previousFilename;
-	uint32_t numberOfColors;
-	math::OctreeColorQuantization octree;
-	common::Ref<ColorList> previewColorList;
-	dynv::Ref options;
-	GlobalState *gs;
-	static uint8_t toUint8(float value) {
-		return static_cast<uint8_t>(std::max(std::min(static_cast<int>(value * 256), 255), 0));
+// PNG and JPEG files are decoded row by row and added to the histogram in bands, so memory use does not depend on the image size and
+// histogram building overlaps with decoding.
+// Other files, interlaced PNG and CMYK JPEG files are decoded by GdkPixbufLoader into a full size pixbuf. Rows are added to the histogram
+// on a separate thread when the loader reports them. Images which are not reported row by row from top to bottom (interlaced, progressive,
+// animated or downscaled by the loader after decoding) are added after decoding finishes.
+struct ImageHistogramLoader {
+	static constexpr size_t chunkSize = 64 * 1024;
+	// Larger images are downscaled. Only loaders which scale while decoding use less memory, others decode at full size and scale when finished.
+	static constexpr double maxDecodedPixels = 64 * 1024 * 1024;
+	ImageHistogramLoader(math::ColorHistogram &histogram, int step):
+		m_histogram(histogram),
+		m_step(std::max(step, 1)) {
 	}
-	void processImage() {
-		previousFilename = filename;
-		octree.clear();
+	~ImageHistogramLoader() {
+		stopWorker();
+		if (m_pixbuf)
+			g_object_unref(m_pixbuf);
+	}
+	bool load(const std::string &filename) {
+		auto result = imageFileReadRows(filename.c_str(), m_step, [this](const uint8_t *data, int width, int height, int stride, int channels) {
+			m_histogram.addImage(data, width, height, stride, channels);
+		});
+		if (result)
+			return true;
+		if (result.error() != ErrorCode::unsupportedFormat)
+			std::cout << filename << ": " << result.error() << '\n';
+		m_histogram.clear();
+		return loadPixbuf(filename);
+	}
+private:
+	math::ColorHistogram &m_histogram;
+	int m_step;
+	GdkPixbuf *m_pixbuf = nullptr;
+	const uint8_t *m_pixels = nullptr;
+	int m_width = 0, m_height = 0, m_stride = 0, m_channels = 0;
+	bool m_sequential = true;
+	std::thread m_worker;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	int m_decodedRows = 0, m_processedRows = 0;
+	bool m_stop = false;
+	bool loadPixbuf(const std::string &filename) {
 		GError *error = nullptr;
-		GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(filename.c_str(), &error);
+		GFile *file = g_file_new_for_path(filename.c_str());
+		GFileInputStream *stream = g_file_read(file, nullptr, &error);
+		g_object_unref(file);
+		if (!stream)
+			return failed(error);
+		GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+		g_signal_connect(G_OBJECT(loader), "size-prepared", G_CALLBACK(onSizePrepared), this);
+		g_signal_connect(G_OBJECT(loader), "area-prepared", G_CALLBACK(onAreaPrepared), this);
+		g_signal_connect(G_OBJECT(loader), "area-updated", G_CALLBACK(onAreaUpdated), this);
+		std::vector<guchar> buffer(chunkSize);
+		bool result = true;
+		for (;;) {
+			gssize size = g_input_stream_read(G_INPUT_STREAM(stream), buffer.data(), buffer.size(), nullptr, &error);
+			if (size < 0 || (size > 0 && !gdk_pixbuf_loader_write(loader, buffer.data(), size, &error))) {
+				result = false;
+				break;
+			}
+			if (size == 0)
+				break;
+		}
+		g_object_unref(stream);
+		if (!gdk_pixbuf_loader_close(loader, result ? &error : nullptr))
+			result = false;
+		g_object_unref(loader);
+		stopWorker();
+		if (!result)
+			return failed(error);
+		if (!m_pixbuf)
+			return false;
+		if (!m_sequential) {
+			m_histogram.clear();
+			addRows(0, m_height);
+		} else if (m_decodedRows < m_height) {
+			addRows(m_decodedRows, m_height);
+		}
+		return true;
+	}
+	bool failed(GError *error) {
 		if (error) {
 			std::cout << error->message << '\n';
 			g_error_free(error);
-			return;
 		}
-		int channels = gdk_pixbuf_get_n_channels(pixbuf);
-		int width = gdk_pixbuf_get_width(pixbuf);
-		int height = gdk_pixbuf_get_height(pixbuf);
-		int stride = gdk_pixbuf_get_rowstride(pixbuf);
-		guchar *imageData = gdk_pixbuf_get_pixels(pixbuf);
-		if (width * height < (1 << 16) || std::max(1u, std::thread::hardware_concurrency()) == 1) {
-			guchar *dataPointer = imageData;
-			Color color;
-			for (int y = 0; y < height; y++) {
-				dataPointer = imageData + stride * y;
-				for (int x = 0; x < width; x++) {
-					if (channels == 1) {
-						color.xyz.x = color.xyz.y = color.xyz.z = dataPointer[0] / 255.0f;
-					} else {
-						color.xyz.x = dataPointer[0] / 255.0f;
-						color.xyz.y = dataPointer[1] / 255.0f;
-						color.xyz.z = dataPointer[2] / 255.0f;
-					}
-					color.alpha = 1.0f;
-					color.linearRgbInplace();
-					std::array<uint8_t, 3> position = { dataPointer[0], dataPointer[1], dataPointer[2] };
-					octree.add(color, position);
-					dataPointer += channels;
-				}
-			}
-		} else {
-			size_t threadCount = std::min(8u, std::thread::hardware_concurrency());
-			std::mutex octreeMutex;
-			std::vector<std::thread> threads(threadCount);
-			size_t index = 0;
-			for (auto &thread: threads) {
-				thread = std::thread([this, &octreeMutex, index, threadCount, imageData, channels, width, height, stride]() {
-					math::OctreeColorQuantization threadOctree;
-					guchar *dataPointer = imageData + stride * index;
-					Color color;
-					for (int y = 0; y < height; y += threadCount) {
-						dataPointer = imageData + stride * y;
-						for (int x = 0; x < width; x++) {
-							if (channels == 1) {
-								color.xyz.x = color.xyz.y = color.xyz.z = dataPointer[0] / 255.0f;
-							} else {
-								color.xyz.x = dataPointer[0] / 255.0f;
-								color.xyz.y = dataPointer[1] / 255.0f;
-								color.xyz.z = dataPointer[2] / 255.0f;
-							}
-							color.alpha = 1.0f;
-							color.linearRgbInplace();
-							std::array<uint8_t, 3> position = { dataPointer[0], dataPointer[1], dataPointer[2] };
-							threadOctree.add(color, position);
-							dataPointer += channels;
-						}
-					}
-					threadOctree.reduce(1000);
-					std::scoped_lock<std::mutex> lock(octreeMutex);
-					threadOctree.visit([this](const float sum[3], size_t pixels) {
-						Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
-						Color nonLinearColor = color.nonLinearRgb();
-						std::array<uint8_t, 3> position = { toUint8(nonLinearColor.red), toUint8(nonLinearColor.green), toUint8(nonLinearColor.blue) };
-						octree.add(color, pixels, position);
-					});
-				});
-				++index;
-			}
-			for (auto &thread: threads) {
-				thread.join();
+		return false;
+	}
+	void addRows(int begin, int end) {
+		// Subsampling grid is aligned to the whole image, not to the row range.
+		begin = (begin + m_step - 1) / m_step * m_step;
+		if (begin >= end)
+			return;
+		m_histogram.addImage(m_pixels + static_cast<ptrdiff_t>(m_stride) * begin, m_width, end - begin, m_stride, m_channels, m_step);
+	}
+	void work() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_condition.wait(lock, [this]() {
+				return m_stop || m_decodedRows > m_processedRows;
+			});
+			if (m_decodedRows > m_processedRows) {
+				int begin = m_processedRows, end = m_decodedRows;
+				m_processedRows = end;
+				lock.unlock();
+				addRows(begin, end);
+				lock.lock();
+			} else {
+				return;
 			}
 		}
-		g_object_unref(pixbuf);
-		octree.reduce(1000);
 	}
-	void update(bool preview) {
+	void stopWorker() {
+		if (!m_worker.joinable())
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_one();
+		m_worker.join();
+	}
+	static void onSizePrepared(GdkPixbufLoader *loader, gint width, gint height, ImageHistogramLoader *self) {
+		double pixels = static_cast<double>(width) * height;
+		if (pixels <= maxDecodedPixels)
+			return;
+		double scale = std::sqrt(maxDecodedPixels / pixels);
+		gdk_pixbuf_loader_set_size(loader, std::max(1, static_cast<int>(width * scale)), std::max(1, static_cast<int>(height * scale)));
+	}
+	static void onAreaPrepared(GdkPixbufLoader *loader, ImageHistogramLoader *self) {
+		if (self->m_pixbuf)
+			return;
+		self->m_pixbuf = GDK_PIXBUF(g_object_ref(gdk_pixbuf_loader_get_pixbuf(loader)));
+		self->m_pixels = gdk_pixbuf_get_pixels(self->m_pixbuf);
+		self->m_width = gdk_pixbuf_get_width(self->m_pixbuf);
+		self->m_height = gdk_pixbuf_get_height(self->m_pixbuf);
+		self->m_stride = gdk_pixbuf_get_rowstride(self->m_pixbuf);
+		self->m_channels = gdk_pixbuf_get_n_channels(self->m_pixbuf);
+		self->m_worker = std::thread(&ImageHistogramLoader::work, self);
+	}
+	static void onAreaUpdated(GdkPixbufLoader *loader, gint x, gint y, gint width, gint height, ImageHistogramLoader *self) {
+		if (!self->m_sequential || !self->m_pixbuf)
+			return;
+		// Rows can only be added once they are final, so any update which is not a continuation of already decoded rows disables streaming.
+		if (x != 0 || width != self->m_width || y != self->m_decodedRows) {
+			self->m_sequential = false;
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(self->m_mutex);
+			self->m_decodedRows = std::min(y + height, self->m_height);
+		}
+		self->m_condition.notify_one();
+	}
+};
+// Identifies palette quantized from a specific image histogram.
+struct PaletteKey {
+	uint64_t histogramVersion;
+	const Algorithm *algorithm;
+	uint32_t numberOfColors;
+	bool operator==(const PaletteKey &key) const {
+		return histogramVersion == key.histogramVersion && algorithm == key.algorithm && numberOfColors == key.numberOfColors;
+	}
+	bool operator!=(const PaletteKey &key) const {
+		return !(*this == key);
+	}
+};
+// Quantizes histograms on a separate thread, so that slow quantizers do not block the dialog. Only the latest request is kept.
+// Main loop is notified about finished palettes by an idle source calling onResult.
+struct QuantizationWorker {
+	QuantizationWorker(GSourceFunc onResult, gpointer data):
+		m_onResult(onResult),
+		m_data(data) {
+		m_thread = std::thread(&QuantizationWorker::run, this);
+	}
+	// Waits for running quantization to finish, its cost is bounded by the quantizers.
+	~QuantizationWorker() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_one();
+		m_thread.join();
+		if (m_sourceId)
+			g_source_remove(m_sourceId);
+	}
+	void request(const PaletteKey &key, std::shared_ptr<const math::ColorHistogram> histogram) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_request = key;
+			m_requestHistogram = std::move(histogram);
+		}
+		m_condition.notify_one();
+	}
+	bool takeResult(PaletteKey &key, std::vector<math::QuantizedColor> &palette) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_sourceId = 0;
+		if (!m_hasResult)
+			return false;
+		key = m_resultKey;
+		palette = std::move(m_result);
+		m_hasResult = false;
+		return true;
+	}
+private:
+	GSourceFunc m_onResult;
+	gpointer m_data;
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	PaletteKey m_request, m_resultKey;
+	std::shared_ptr<const math::ColorHistogram> m_requestHistogram;
+	std::vector<math::QuantizedColor> m_result;
+	bool m_hasResult = false, m_stop = false;
+	guint m_sourceId = 0;
+	void run() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_condition.wait(lock, [this]() {
+				return m_stop || m_requestHistogram;
+			});
+			if (m_stop)
+				return;
+			PaletteKey key = m_request;
+			auto histogram = std::move(m_requestHistogram);
+			lock.unlock();
+			auto palette = math::createQuantizer(key.algorithm->type)->quantize(*histogram, key.numberOfColors);
+			histogram.reset();
+			lock.lock();
+			m_resultKey = key;
+			m_result = std::move(palette);
+			m_hasResult = true;
+			if (!m_sourceId)
+				m_sourceId = g_idle_add(m_onResult, m_data);
+		}
+	}
+};
+struct PaletteFromImageArgs {
+	static const uint32_t maxColors = 1000;
+	GtkWidget *fileBrowser, *rangeColors, *rangeSubsampling, *algorithmCombo, *previewExpander;
+	std::string filename, previousFilename;
+	uint32_t numberOfColors, subsampling, previousSubsampling;
+	const Algorithm *algorithm;
+	std::shared_ptr<math::ColorHistogram> histogram;
+	uint64_t histogramVersion = 0;
+	math::ReductionTree reductionTree;
+	PaletteKey paletteKey { 0, nullptr, 0 };
+	std::vector<math::QuantizedColor> palette;
+	std::unique_ptr<QuantizationWorker> worker;
+	common::Ref<ColorList> previewColorList;
+	dynv::Ref options;
+	GlobalState *gs;
+	void processImage() {
+		previousFilename = filename;
+		previousSubsampling = subsampling;
+		histogramVersion++;
+		histogram = std::make_shared<math::ColorHistogram>();
+		if (!ImageHistogramLoader(*histogram, subsampling).load(filename))
+			histogram.reset();
+		// Octree quantization is fast, so the reduction tree is built once per image. It gives an approximate preview of any size
+		// immediately, while the selected quantizer produces the final palette on the worker thread.
+		if (histogram)
+			reductionTree = math::ReductionTree(math::OctreeQuantizer().quantize(*histogram, maxColors));
+		else
+			reductionTree = math::ReductionTree();
+	}
+	PaletteKey currentKey() const {
+		return PaletteKey { histogramVersion, algorithm, numberOfColors };
+	}
+	void addColors(ColorList &colorList, const std::vector<math::QuantizedColor> &quantizedColors) {
 		int index = 0;
 		gchar *name = g_path_get_basename(filename.c_str());
+		std::vector<Color> paletteColors;
+		paletteColors.reserve(quantizedColors.size());
+		for (const auto &quantizedColor: quantizedColors)
+			paletteColors.push_back(quantizedColor.color.nonLinearRgbFast());
 		PaletteColorNameAssigner nameAssigner(*gs);
-		if (!filename.empty() && previousFilename != filename)
-			processImage();
-		ColorList &colorList = preview ? *previewColorList : gs->colorList();
-		math::OctreeColorQuantization reducedOctree(octree);
-		reducedOctree.reduce(numberOfColors);
-		common::Guard colorListGuard = colorList.changeGuard();
-		reducedOctree.visit([&](const float sum[3], size_t pixels) {
-			Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
-			color.nonLinearRgbInplace();
+		nameAssigner.prepare(common::Span<const Color>(paletteColors.data(), paletteColors.size()));
+		ColorList colors;
+		for (const auto &color: paletteColors) {
 			ColorObject colorObject(color);
 			nameAssigner.assign(colorObject, name, index);
-			colorList.add(colorObject);
+			colors.add(colorObject);
 			index++;
-		});
+		}
+		g_free(name);
+		colorList.add(colors);
+	}
+	void update(bool preview) {
+		if (!filename.empty() && (previousFilename != filename || previousSubsampling != subsampling))
+			processImage();
+		if (!histogram)
+			return;
+		auto key = currentKey();
+		if (preview) {
+			if (paletteKey == key) {
+				addColors(*previewColorList, palette);
+				return;
+			}
+			addColors(*previewColorList, reductionTree.palette(numberOfColors));
+			worker->request(key, histogram);
+			return;
+		}
+		if (paletteKey != key) {
+			palette = math::createQuantizer(algorithm->type)->quantize(*histogram, numberOfColors);
+			paletteKey = key;
+		}
+		addColors(gs->colorList(), palette);
 	}
 	void getSettings() {
 		gchar *filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(fileBrowser));
@@ -172,9 +389,14 @@ struct PaletteFromImageArgs {
 			this->filename.clear();
 		}
 		numberOfColors = static_cast<int>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(rangeColors)));
+		subsampling = static_cast<int>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(rangeSubsampling)));
+		int algorithmIndex = gtk_combo_box_get_active(GTK_COMBO_BOX(algorithmCombo));
+		algorithm = &algorithms[algorithmIndex >= 0 && algorithmIndex < static_cast<int>(sizeof(algorithms) / sizeof(Algorithm)) ? algorithmIndex : 0];
 	}
 	void saveSettings() {
 		options->set("colors", static_cast<int32_t>(numberOfColors));
+		options->set("subsampling", static_cast<int32_t>(subsampling));
+		options->set("algorithm", algorithm->id);
 		gchar *currentFolder = gtk_file_chooser_get_current_folder(GTK_FILE_CHOOSER(fileBrowser));
 		if (currentFolder) {
 			options->set("current_folder", currentFolder);
@@ -191,6 +413,17 @@ struct PaletteFromImageArgs {
 		args->getSettings();
 		args->update(true);
 	}
+	static gboolean onQuantized(PaletteFromImageArgs *args) {
+		PaletteKey key { 0, nullptr, 0 };
+		std::vector<math::QuantizedColor> palette;
+		if (!args->worker->takeResult(key, palette) || key != args->currentKey())
+			return G_SOURCE_REMOVE;
+		args->paletteKey = key;
+		args->palette = std::move(palette);
+		args->previewColorList->removeAll();
+		args->addColors(*args->previewColorList, args->palette);
+		return G_SOURCE_REMOVE;
+	}
 	static void onDestroy(GtkWidget *widget, PaletteFromImageArgs *args) {
 		delete args;
 	}
@@ -217,6 +450,8 @@ struct PaletteFromImageArgs {
 void tools_palette_from_image_show(GtkWindow *parent, GlobalState *gs) {
 	PaletteFromImageArgs *args = new PaletteFromImageArgs;
 	args->previousFilename = "";
+	args->previousSubsampling = 0;
+	args->worker = std::make_unique<QuantizationWorker>(G_SOURCE_FUNC(PaletteFromImageArgs::onQuantized), args);
 	args->gs = gs;
 	args->options = args->gs->settings().getOrCreateMap("gpick.tools.palette_from_image");
 	GtkWidget *dialog = gtk_dialog_new_with_buttons(_("Palette from image"), parent, GtkDialogFlags(GTK_DIALOG_DESTROY_WITH_PARENT), GTK_STOCK_CLOSE, GTK_RESPONSE_CLOSE, GTK_STOCK_ADD, GTK_RESPONSE_APPLY, nullptr);
@@ -224,7 +459,7 @@ void tools_palette_from_image_show(GtkWindow *parent, GlobalState *gs) {
 		args->options->getInt32("window.height", -1));
 	gtk_dialog_set_alternative_button_order(GTK_DIALOG(dialog), GTK_RESPONSE_APPLY, GTK_RESPONSE_CLOSE, -1);
 
-	Grid grid(2, 3);
+	Grid grid(2, 5);
 	grid.addLabel(_("Image:"));
 	GtkWidget *widget;
 	args->fileBrowser = widget = grid.add(gtk_file_chooser_button_new(_("Image file"), GTK_FILE_CHOOSER_ACTION_OPEN), true);
@@ -271,9 +506,22 @@ void tools_palette_from_image_show(GtkWindow *parent, GlobalState *gs) {
 	if (formats)
 		g_slist_free(formats);
 	grid.addLabel(_("Colors:"));
-	args->rangeColors = widget = grid.add(gtk_spin_button_new_with_range(1, 1000, 1), true);
+	args->rangeColors = widget = grid.add(gtk_spin_button_new_with_range(1, PaletteFromImageArgs::maxColors, 1), true);
 	gtk_spin_button_set_value(GTK_SPIN_BUTTON(widget), args->options->getInt32("colors", 3));
 	g_signal_connect(G_OBJECT(widget), "value-changed", G_CALLBACK(PaletteFromImageArgs::onUpdate), args);
+	grid.addLabel(_("Algorithm:"));
+	args->algorithmCombo = widget = grid.add(gtk_combo_box_text_new(), true);
+	const Algorithm &selectedAlgorithm = common::matchById(algorithms, args->options->getString("algorithm", "octree"));
+	for (const auto &algorithm: algorithms) {
+		gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widget), _(algorithm.name));
+		if (&algorithm == &selectedAlgorithm)
+			gtk_combo_box_set_active(GTK_COMBO_BOX(widget), static_cast<int>(&algorithm - algorithms));
+	}
+	g_signal_connect(G_OBJECT(widget), "changed", G_CALLBACK(PaletteFromImageArgs::onUpdate), args);
+	grid.addLabel(_("Subsampling:"));
+	args->rangeSubsampling = widget = grid.add(gtk_spin_button_new_with_range(1, 16, 1), true);
+	gtk_spin_button_set_value(GTK_SPIN_BUTTON(widget), args->options->getInt32("subsampling", 1));
+	g_signal_connect(G_OBJECT(widget), "value-changed", G_CALLBACK(PaletteFromImageArgs::onUpdate), args);
 	args->previewExpander = grid.add(palette_list_preview_new(*gs, true, args->options->getBool("show_preview", true), args->previewColorList), true, 2, true);
 	gtk_widget_show_all(grid);
 	setDialogContent(dialog, grid);
@@ -26,7 +26,6 @@
 #include "uiListPalette.h"
 #include "uiUtilities.h"
 #include "parser/TextFile.h"
-#include "common/Guard.h"
 #include <sstream>
 #include <vector>
 using namespace std::string_literals;
@@ -197,13 +196,14 @@ bool TextParserDialog::parse(ColorList &colorList) {
 		return false;
 	}
 	m_index = 0;
-	common::Guard colorListGuard = colorList.changeGuard();
+	ColorList colors;
 	for (auto color: textParser.colors()) {
 		ColorObject colorObject(color);
 		ToolColorNameAssigner::assign(colorObject);
-		colorList.add(colorObject);
+		colors.add(colorObject);
 		m_index++;
 	}
+	colorList.add(colors);
 	return true;
 }
 void TextParserDialog::onChange(GtkWidget *widget, TextParserDialog *dialog) {
@@ -19,6 +19,7 @@
 #include "Chain.h"
 #include "Transformation.h"
 #include "Color.h"
+#include <algorithm>
 namespace transformation {
 Chain::Chain():
 	m_enabled(true) {
@@ -28,25 +29,30 @@ void Chain::apply(const Color *input, Color *output) {
 		*output = *input;
 		return;
 	}
-	Color tmp[2];
-	Color *tmp_p[3];
-	tmp[0] = *input;
-	tmp_p[0] = &tmp[0];
-	tmp_p[1] = &tmp[1];
-	for (auto &transformation: m_transformationChain) {
-		transformation->apply(tmp_p[0], tmp_p[1]);
-		tmp_p[2] = tmp_p[0];
-		tmp_p[0] = tmp_p[1];
-		tmp_p[1] = tmp_p[2];
+	Color colors[2] = { *input };
+	int current = 0;
+	for (auto *stage: m_stages) {
+		stage->apply(&colors[current], &colors[current ^ 1]);
+		current ^= 1;
 	}
-	*output = *tmp_p[0];
+	*output = colors[current];
+}
+void Chain::apply(common::Span<const Color> input, common::Span<Color> output) {
+	if (!m_enabled || m_stages.empty()) {
+		if (input.data() != output.data())
+			std::copy_n(input.data(), std::min(input.size(), output.size()), output.data());
+		return;
+	}
+	Transformation::applyStages(common::Span<Transformation *const>(m_stages.data(), m_stages.size()), input, output);
 }
 void Chain::add(std::unique_ptr<Transformation> transformation) {
+	m_stages.push_back(transformation.get());
 	m_transformationChain.push_back(std::move(transformation));
 }
 void Chain::remove(const Transformation *transformation) {
 	for (auto i = m_transformationChain.begin(), end = m_transformationChain.end(); i != end; i++) {
 		if (i->get() == transformation) {
+			m_stages.erase(m_stages.begin() + (i - m_transformationChain.begin()));
 			m_transformationChain.erase(i);
 			return;
 		}
@@ -54,6 +60,7 @@ void Chain::remove(const Transformation *transformation) {
 }
 void Chain::clear() {
 	m_transformationChain.clear();
+	m_stages.clear();
 }
 Chain::Transformations &Chain::getAll() {
 	return m_transformationChain;
@@ -18,6 +18,7 @@
 
 #ifndef GPICK_TRANSFORMATION_CHAIN_H_
 #define GPICK_TRANSFORMATION_CHAIN_H_
+#include "common/Span.h"
 #include <vector>
 #include <memory>
 
@@ -37,12 +38,18 @@ struct Chain {
 	*/
 	Chain();
 	/**
-	* Apply transformation chain to color.
+	* Apply transformation chain to color. Each transformation is applied to the single color, without batch color space conversions.
 	* @param[in] input Source color in RGB color space.
 	* @param[out] output Destination color in RGB color space.
 	*/
 	void apply(const Color *input, Color *output);
 	/**
+	* Apply transformation chain to colors. All stages are applied to one block of colors before moving to the next block.
+	* @param[in] input Source colors in RGB color space.
+	* @param[out] output Destination colors in RGB color space. Must have the same size as input, can be the same colors as input.
+	*/
+	void apply(common::Span<const Color> input, common::Span<Color> output);
+	/**
 	* Add transformation object into the list.
 	* @param[in] transformation Transformation object.
 	*/
@@ -68,6 +75,7 @@ struct Chain {
 	Transformations &getAll();
 private:
 	Transformations m_transformationChain;
+	std::vector<Transformation *> m_stages;
 	bool m_enabled;
 };
 }
@@ -17,12 +17,15 @@
  */
 
 #include "ColorVisionDeficiency.h"
+#include "ColorBatch.h"
 #include "dynv/Map.h"
 #include "math/Vector.h"
 #include "math/Matrix.h"
 #include "uiUtilities.h"
 #include "I18N.h"
 #include <gtk/gtk.h>
+#include <algorithm>
+#include <cmath>
 using namespace std;
 namespace transformation {
 static const char *transformationId = "color_vision_deficiency";
@@ -133,59 +136,137 @@ const math::Vector3d tritanopiaAbc[2] = {
 		rgbAnchor[0] * anchor[4] - rgbAnchor[1] * anchor[3],
 	},
 };
+// Dichromacy is simulated by replacing one cone response with a value on one of two half-planes. Half-plane is selected by ratio of two remaining cone responses.
+struct Dichromacy {
+	int replaced, numerator, denominator;
+	const math::Vector3d *abc;
+};
+const Dichromacy protanopia = { 0, 2, 1, protanopiaAbc };
+const Dichromacy deuteranopia = { 1, 2, 0, deuteranopiaAbc };
+const Dichromacy tritanopia = { 2, 1, 0, tritanopiaAbc };
+static int dichromacyPlane(const math::Vector3d &lms, const Dichromacy &dichromacy) {
+	return lms.data[dichromacy.numerator] / lms.data[dichromacy.denominator] < rgbAnchor[dichromacy.numerator] / rgbAnchor[dichromacy.denominator] ? 0 : 1;
+}
+static math::Vector3d simulateDichromacy(const math::Vector3d &vi, const Dichromacy &dichromacy, int plane, float strength) {
+	math::Vector3d lms = rgbToLms * vi;
+	const auto &abc = dichromacy.abc[plane];
+	int replaced = dichromacy.replaced, first = (replaced + 1) % 3, second = (replaced + 2) % 3;
+	lms.data[replaced] = -(abc.data[first] * lms.data[first] + abc.data[second] * lms.data[second]) / abc.data[replaced];
+	return math::mix(vi, lmsToRgb * lms, strength);
+}
+static const math::Matrix3d *anomalyMatrices(ColorVisionDeficiency::Type type) {
+	switch (type) {
+	case ColorVisionDeficiency::Type::protanomaly:
+		return protanomaly;
+	case ColorVisionDeficiency::Type::deuteranomaly:
+		return deuteranomaly;
+	case ColorVisionDeficiency::Type::tritanomaly:
+		return tritanomaly;
+	default:
+		return nullptr;
+	}
+}
+static const Dichromacy *dichromacy(ColorVisionDeficiency::Type type) {
+	switch (type) {
+	case ColorVisionDeficiency::Type::protanopia:
+		return &protanopia;
+	case ColorVisionDeficiency::Type::deuteranopia:
+		return &deuteranopia;
+	case ColorVisionDeficiency::Type::tritanopia:
+		return &tritanopia;
+	default:
+		return nullptr;
+	}
+}
 void ColorVisionDeficiency::apply(Color *input, Color *output) {
 	Color linearInput, linearOutput;
 	linearInput = input->linearRgb();
-	math::Vector3d vi, vo1, vo2;
+	math::Vector3d vi;
 	vi = linearInput.rgbVector<double>();
 	int index = static_cast<int>(std::floor(m_strength * 10));
 	int indexSecondary = std::min(index + 1, 10);
 	float interpolationFactor = (m_strength * 10) - index;
-	math::Vector3d lms;
-	switch (m_type) {
-	case Type::protanomaly:
-		linearOutput = vi * math::mix(protanomaly[index], protanomaly[indexSecondary], interpolationFactor);
-		break;
-	case Type::deuteranomaly:
-		linearOutput = vi * math::mix(deuteranomaly[index], deuteranomaly[indexSecondary], interpolationFactor);
-		break;
-	case Type::tritanomaly:
-		linearOutput = vi * math::mix(tritanomaly[index], tritanomaly[indexSecondary], interpolationFactor);
-		break;
-	case Type::protanopia:
-		lms = rgbToLms * vi;
-		if (lms.z / lms.y < rgbAnchor[2] / rgbAnchor[1]) {
-			lms.x = -(protanopiaAbc[0].y * lms.y + protanopiaAbc[0].z * lms.z) / protanopiaAbc[0].x;
-		} else {
-			lms.x = -(protanopiaAbc[1].y * lms.y + protanopiaAbc[1].z * lms.z) / protanopiaAbc[1].x;
-		}
-		linearOutput = math::mix(vi, lmsToRgb * lms, m_strength);
-		break;
-	case Type::deuteranopia:
-		lms = rgbToLms * vi;
-		if (lms.z / lms.x < rgbAnchor[2] / rgbAnchor[0]) {
-			lms.y = -(deuteranopiaAbc[0].x * lms.x + deuteranopiaAbc[0].z * lms.z) / deuteranopiaAbc[0].y;
-		} else {
-			lms.y = -(deuteranopiaAbc[1].x * lms.x + deuteranopiaAbc[1].z * lms.z) / deuteranopiaAbc[1].y;
-		}
-		linearOutput = math::mix(vi, lmsToRgb * lms, m_strength);
-		break;
-	case Type::tritanopia:
-		lms = rgbToLms * vi;
-		if (lms.y / lms.x < rgbAnchor[1] / rgbAnchor[0]) {
-			lms.z = -(tritanopiaAbc[0].x * lms.x + tritanopiaAbc[0].y * lms.y) / tritanopiaAbc[0].z;
-		} else {
-			lms.z = -(tritanopiaAbc[1].x * lms.x + tritanopiaAbc[1].y * lms.y) / tritanopiaAbc[1].z;
-		}
-		linearOutput = math::mix(vi, lmsToRgb * lms, m_strength);
-		break;
-	default:
+	if (auto matrices = anomalyMatrices(m_type)) {
+		linearOutput = vi * math::mix(matrices[index], matrices[indexSecondary], interpolationFactor);
+	} else if (auto simulated = dichromacy(m_type)) {
+		linearOutput = simulateDichromacy(vi, *simulated, dichromacyPlane(rgbToLms * vi, *simulated), m_strength);
+	} else {
 		*output = *input;
 		return;
 	}
 	*output = linearOutput.nonLinearRgbInplace().normalizeRgbInplace();
 	output->alpha = input->alpha;
 }
+Transformation::Space ColorVisionDeficiency::channelSpace() const {
+	return Space::linearRgb;
+}
+namespace {
+// Single precision linear map of linear RGB values, built by mapping each basis vector.
+struct LinearMap {
+	template<typename Callback>
+	LinearMap(Callback &&callback) {
+		for (int j = 0; j < 3; j++) {
+			math::Vector3d basis;
+			basis.data[j] = 1;
+			math::Vector3d column = callback(basis);
+			for (int i = 0; i < 3; i++)
+				values[i][j] = static_cast<float>(column.data[i]);
+		}
+	}
+	float apply(int row, float r, float g, float b) const {
+		return values[row][0] * r + values[row][1] * g + values[row][2] * b;
+	}
+	float values[3][3];
+};
+}
+// All simulations are linear maps, dichromacy simulation has one map for each half-plane. Maps are calculated once per call, so that the loops over channel values have no branches and are vectorized by compiler.
+void ColorVisionDeficiency::applyChannels(const color_batch::Channels &channels) {
+	float *r = channels.data[0], *g = channels.data[1], *b = channels.data[2];
+	const size_t size = channels.size;
+	int index = static_cast<int>(std::floor(m_strength * 10));
+	int indexSecondary = std::min(index + 1, 10);
+	float interpolationFactor = (m_strength * 10) - index;
+	if (auto matrices = anomalyMatrices(m_type)) {
+		math::Matrix3d matrix = math::mix(matrices[index], matrices[indexSecondary], interpolationFactor);
+		LinearMap map([&matrix](const math::Vector3d &vi) {
+			return vi * matrix;
+		});
+		for (size_t i = 0; i < size; i++) {
+			float red = map.apply(0, r[i], g[i], b[i]), green = map.apply(1, r[i], g[i], b[i]), blue = map.apply(2, r[i], g[i], b[i]);
+			r[i] = red, g[i] = green, b[i] = blue;
+		}
+	} else if (auto simulated = dichromacy(m_type)) {
+		float strength = m_strength;
+		const Dichromacy &dichromacy = *simulated;
+		LinearMap lms([](const math::Vector3d &vi) {
+			return rgbToLms * vi;
+		});
+		LinearMap planes[2] = {
+			LinearMap([&](const math::Vector3d &vi) {
+				return simulateDichromacy(vi, dichromacy, 0, strength);
+			}),
+			LinearMap([&](const math::Vector3d &vi) {
+				return simulateDichromacy(vi, dichromacy, 1, strength);
+			}),
+		};
+		float ratio = static_cast<float>(rgbAnchor[dichromacy.numerator] / rgbAnchor[dichromacy.denominator]);
+		for (size_t i = 0; i < size; i++) {
+			float numerator = lms.apply(dichromacy.numerator, r[i], g[i], b[i]), denominator = lms.apply(dichromacy.denominator, r[i], g[i], b[i]);
+			bool first = numerator / denominator < ratio;
+			float red = first ? planes[0].apply(0, r[i], g[i], b[i]) : planes[1].apply(0, r[i], g[i], b[i]);
+			float green = first ? planes[0].apply(1, r[i], g[i], b[i]) : planes[1].apply(1, r[i], g[i], b[i]);
+			float blue = first ? planes[0].apply(2, r[i], g[i], b[i]) : planes[1].apply(2, r[i], g[i], b[i]);
+			r[i] = red, g[i] = green, b[i] = blue;
+		}
+	} else {
+		return;
+	}
+	for (int j = 0; j < 3; j++) {
+		float *values = channels.data[j];
+		for (size_t i = 0; i < size; i++)
+			values[i] = std::clamp(values[i], 0.0f, 1.0f);
+	}
+}
 ColorVisionDeficiency::ColorVisionDeficiency():
 	Transformation(transformationId, getName()),
 	m_type(Type::protanomaly),
@@ -50,6 +50,7 @@ struct ColorVisionDeficiency: public Transformation {
 	ColorVisionDeficiency();
 	ColorVisionDeficiency(Type type, float strength);
 	virtual ~ColorVisionDeficiency() override;
+	using Transformation::apply;
 	virtual void serialize(dynv::Map &system) override;
 	virtual void deserialize(const dynv::Map &system) override;
 	virtual std::unique_ptr<IConfiguration> getConfiguration() override;
@@ -60,6 +61,8 @@ private:
 	static const char *m_deficiencyTypeStrings[];
 	static const size_t m_typeCount;
 	virtual void apply(Color *input, Color *output) override;
+	virtual Space channelSpace() const override;
+	virtual void applyChannels(const color_batch::Channels &channels) override;
 	static GtkWidget *createTypeList();
 	friend struct Configuration;
 };
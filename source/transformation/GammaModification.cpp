@@ -17,10 +17,12 @@
  */
 
 #include "GammaModification.h"
+#include "ColorBatch.h"
 #include "dynv/Map.h"
 #include "../uiUtilities.h"
 #include "../I18N.h"
 #include <gtk/gtk.h>
+#include <algorithm>
 #include <cmath>
 namespace transformation {
 static const char *transformationId = "gamma_modification";
@@ -39,6 +41,17 @@ void GammaModification::apply(Color *input, Color *output) {
 	*output = linear_output.nonLinearRgbInplace().normalizeRgbInplace();
 	output->alpha = input->alpha;
 }
+Transformation::Space GammaModification::channelSpace() const {
+	return Space::linearRgb;
+}
+// Clamping linear values gives the same result as clamping after conversion back into RGB, as both ends of [0, 1] range are kept.
+void GammaModification::applyChannels(const color_batch::Channels &channels) {
+	for (int j = 0; j < 3; j++) {
+		float *values = channels.data[j];
+		for (size_t i = 0; i < channels.size; i++)
+			values[i] = std::clamp(std::pow(values[i], value), 0.0f, 1.0f);
+	}
+}
 GammaModification::GammaModification():
 	Transformation(transformationId, getName()) {
 	value = 1;
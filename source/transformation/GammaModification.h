@@ -36,12 +36,15 @@ struct GammaModification: public Transformation {
 	GammaModification();
 	GammaModification(float value);
 	virtual ~GammaModification() override;
+	using Transformation::apply;
 	virtual void serialize(dynv::Map &system) override;
 	virtual void deserialize(const dynv::Map &system) override;
 	virtual std::unique_ptr<IConfiguration> getConfiguration() override;
 private:
 	float value;
 	virtual void apply(Color *input, Color *output) override;
+	virtual Space channelSpace() const override;
+	virtual void applyChannels(const color_batch::Channels &channels) override;
 	friend struct Configuration;
 };
 }
@@ -17,6 +17,7 @@
  */
 
 #include "Invert.h"
+#include "ColorBatch.h"
 namespace transformation {
 void Invert::apply(Color *input, Color *output) {
 	output->rgb.red = 1 - input->rgb.red;
@@ -24,6 +25,13 @@ void Invert::apply(Color *input, Color *output) {
 	output->rgb.blue = 1 - input->rgb.blue;
 	output->alpha = input->alpha;
 }
+void Invert::applyChannels(const color_batch::Channels &channels) {
+	for (int j = 0; j < 3; j++) {
+		float *values = channels.data[j];
+		for (size_t i = 0; i < channels.size; i++)
+			values[i] = 1 - values[i];
+	}
+}
 Invert::Invert():
 	Transformation("invert", "Invert") {
 }
@@ -23,8 +23,10 @@ namespace transformation {
 struct Invert: public Transformation {
 	Invert();
 	virtual ~Invert();
+	using Transformation::apply;
 protected:
 	virtual void apply(Color *input, Color *output);
+	virtual void applyChannels(const color_batch::Channels &channels) override;
 };
 }
 #endif /* GPICK_TRANSFORMATION_INVERT_H_ */
@@ -18,11 +18,14 @@
  */
 
 #include "Quantization.h"
+#include "ColorBatch.h"
 #include "dynv/Map.h"
 #include "uiUtilities.h"
 #include "I18N.h"
 #include <gtk/gtk.h>
 #include <boost/math/special_functions/round.hpp>
+#include <algorithm>
+#include <cmath>
 namespace transformation {
 static const char *transformationId = "quantization";
 const char *Quantization::getId() {
@@ -45,13 +48,32 @@ void Quantization::apply(Color *input, Color *output) {
 	}
 	output->alpha = input->alpha;
 }
+void Quantization::applyChannels(const color_batch::Channels &channels) {
+	if (clip_top) {
+		float maxIntensity = (value - 1) / value;
+		for (int j = 0; j < 3; j++) {
+			float *values = channels.data[j];
+			for (size_t i = 0; i < channels.size; i++)
+				values[i] = std::min(maxIntensity, std::round(values[i] * value) / value);
+		}
+	} else {
+		float actualMax = value - 1;
+		for (int j = 0; j < 3; j++) {
+			float *values = channels.data[j];
+			for (size_t i = 0; i < channels.size; i++)
+				values[i] = std::round(values[i] * actualMax) / actualMax;
+		}
+	}
+}
 Quantization::Quantization():
 	Transformation(transformationId, getName()) {
 	value = 16;
+	clip_top = false;
 }
 Quantization::Quantization(float value_):
 	Transformation(transformationId, getName()) {
 	value = value_;
+	clip_top = false;
 }
 Quantization::~Quantization() {
 }
@@ -37,6 +37,7 @@ struct Quantization: public Transformation {
 	Quantization();
 	Quantization(float value);
 	virtual ~Quantization() override;
+	using Transformation::apply;
 	virtual void serialize(dynv::Map &system) override;
 	virtual void deserialize(const dynv::Map &system) override;
 	virtual std::unique_ptr<IConfiguration> getConfiguration() override;
@@ -44,6 +45,7 @@ private:
 	float value;
 	bool clip_top;
 	virtual void apply(Color *input, Color *output) override;
+	virtual void applyChannels(const color_batch::Channels &channels) override;
 	friend struct Configuration;
 };
 }
@@ -17,7 +17,10 @@
  */
 
 #include "Transformation.h"
+#include "ColorBatch.h"
 #include "dynv/Map.h"
+#include <algorithm>
+#include <stdexcept>
 namespace transformation {
 Transformation::Transformation(const char *name_, const char *readable_name_) {
 	name = name_;
@@ -28,6 +31,53 @@ Transformation::~Transformation() {
 void Transformation::apply(Color *input, Color *output) {
 	*output = *input;
 }
+Transformation::Space Transformation::channelSpace() const {
+	return Space::rgb;
+}
+void Transformation::applyChannels(const color_batch::Channels &channels) {
+	for (size_t i = 0; i < channels.size; i++) {
+		Color input(channels.data[0][i], channels.data[1][i], channels.data[2][i], 1.0f), output;
+		apply(&input, &output);
+		channels.data[0][i] = output.rgb.red;
+		channels.data[1][i] = output.rgb.green;
+		channels.data[2][i] = output.rgb.blue;
+	}
+}
+// Blocks are small enough for channel buffers to stay in cache while all stages run over them.
+const size_t BlockSize = 256;
+void Transformation::applyStages(common::Span<Transformation *const> stages, common::Span<const Color> input, common::Span<Color> output) {
+	if (input.size() != output.size())
+		throw std::invalid_argument("input and output color count does not match");
+	alignas(32) float buffers[3][BlockSize];
+	for (size_t offset = 0; offset < input.size(); offset += BlockSize) {
+		size_t size = std::min(BlockSize, input.size() - offset);
+		common::Span<const Color> inputBlock(input.data() + offset, size);
+		common::Span<Color> outputBlock(output.data() + offset, size);
+		color_batch::Channels channels(buffers[0], buffers[1], buffers[2], size);
+		color_batch::split(inputBlock, channels);
+		for (size_t i = 0; i < size; i++)
+			outputBlock[i].alpha = inputBlock[i].alpha;
+		Space space = Space::rgb;
+		for (auto *stage: stages) {
+			Space stageSpace = stage->channelSpace();
+			if (stageSpace != space) {
+				if (stageSpace == Space::linearRgb)
+					color_batch::linearRgb(channels);
+				else
+					color_batch::nonLinearRgb(channels);
+				space = stageSpace;
+			}
+			stage->applyChannels(channels);
+		}
+		if (space == Space::linearRgb)
+			color_batch::nonLinearRgb(channels);
+		color_batch::join(channels, outputBlock);
+	}
+}
+void Transformation::apply(common::Span<const Color> input, common::Span<Color> output) {
+	Transformation *stage = this;
+	applyStages(common::Span<Transformation *const>(&stage, 1), input, output);
+}
 std::string Transformation::getName() const {
 	return name;
 }
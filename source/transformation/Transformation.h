@@ -20,10 +20,14 @@
 #define GPICK_TRANSFORMATION_TRANSFORMATION_H_
 #include "Color.h"
 #include "dynv/MapFwd.h"
+#include "common/Span.h"
 #include <string>
 #include <memory>
 
 typedef struct _GtkWidget GtkWidget;
+namespace color_batch {
+struct Channels;
+}
 /** \file source/transformation/Transformation.h
  * \brief Color transformation struct.
  */
@@ -41,6 +45,13 @@ struct IConfiguration {
  * \brief Transformation object structure.
  */
 struct Transformation {
+	/** \enum Space
+	 * \brief Color space of channel values passed to batch transformation.
+	 */
+	enum class Space {
+		rgb,
+		linearRgb,
+	};
 	protected:
 		std::string name; /**< System name */
 		std::string readable_name; /**< Human readable name */
@@ -51,6 +62,26 @@ struct Transformation {
 		 * @param[out] output Destination color in RGB color space.
 		 */
 		virtual void apply(Color *input, Color *output);
+
+		/**
+		 * Get color space in which batch transformation expects and returns channel values.
+		 * @return Color space.
+		 */
+		virtual Space channelSpace() const;
+
+		/**
+		 * Apply transformation to channel buffers in place. Default implementation applies single color transformation to each color.
+		 * @param[in,out] channels Red, green and blue channel buffers in color space returned by channelSpace().
+		 */
+		virtual void applyChannels(const color_batch::Channels &channels);
+
+		/**
+		 * Apply transformation stages to colors in fixed size blocks. Each block is converted between color spaces only when consecutive stages use different spaces.
+		 * @param[in] stages Transformation objects in application order.
+		 * @param[in] input Source colors in RGB color space.
+		 * @param[out] output Destination colors in RGB color space.
+		 */
+		static void applyStages(common::Span<Transformation *const> stages, common::Span<const Color> input, common::Span<Color> output);
 	public:
 		/**
 		 * Transformation object constructor.
@@ -64,6 +95,13 @@ struct Transformation {
 		 */
 		virtual ~Transformation();
 
+		/**
+		 * Apply transformation to colors.
+		 * @param[in] input Source colors in RGB color space.
+		 * @param[out] output Destination colors in RGB color space. Must have the same size as input, can be the same colors as input.
+		 */
+		void apply(common::Span<const Color> input, common::Span<Color> output);
+
 		/**
 		 * Serialize settings into configuration system.
 		 * @param[in,out] dynv Configuration system.
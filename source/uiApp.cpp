@@ -101,6 +101,7 @@ struct AppArgs
 	StartupOptions startupOptions;
 	dynv::Ref options;
 	GlobalState *gs;
+	std::unique_ptr<AutoSave> autoSave;
 	string current_filename;
 	bool current_filename_set;
 	bool imported;
@@ -410,6 +411,22 @@ int app_load_file(AppArgs *args, const std::string &filename, bool autoload)
 	return result;
 }
 
+int app_load_autosave(AppArgs *args)
+{
+	args->autoSave = std::make_unique<AutoSave>(*args->gs);
+	ColorList colorList;
+	if (!args->autoSave->restore(colorList))
+		return -1;
+	auto &destination = args->gs->colorList();
+	common::Guard colorListGuard = destination.changeGuard();
+	destination.removeAll();
+	destination.add(colorList);
+	args->current_filename_set = false;
+	args->imported = false;
+	app_update_program_name(args);
+	return 0;
+}
+
 int app_parse_geometry(AppArgs *args, const char *geometry)
 {
 	gtk_window_parse_geometry(GTK_WINDOW(args->window), geometry);
@@ -1135,9 +1152,18 @@ static void palette_popup_menu_clear_names(GtkWidget *widget, AppArgs *args) {
 static void palette_popup_menu_auto_name(GtkWidget *widget, AppArgs *args) {
 	auto *colorNames = args->gs->getColorNames();
 	bool imprecisionPostfix = args->gs->settings().getBool("gpick.color_names.imprecision_postfix", false);
-	palette_list_foreach(args->paletteWidget, true, [imprecisionPostfix, colorNames](ColorObject *colorObject) {
-		Color color = colorObject->getColor();
-		colorObject->setName(color_names_get(colorNames, &color, imprecisionPostfix));
+	ColorList selected;
+	palette_list_get_selected(args->paletteWidget, selected);
+	std::vector<Color> colors;
+	colors.reserve(selected.size());
+	for (auto *colorObject: selected)
+		colors.push_back(colorObject->getColor());
+	std::vector<std::string> names;
+	color_names_get(colorNames, common::Span<const Color>(colors.data(), colors.size()), imprecisionPostfix, names);
+	size_t index = 0;
+	palette_list_foreach(args->paletteWidget, true, [&names, &index](ColorObject *colorObject) {
+		if (index < names.size())
+			colorObject->setName(names[index++]);
 		return Update::name;
 	});
 }
@@ -1744,9 +1770,7 @@ static void app_release(AppArgs *args) {
 	args->colorSourceIndex.clear();
 	floating_picker_free(args->floatingPicker);
 	if (!args->startupOptions.single_color_pick_mode){
-		if (app_is_autoload_enabled(args)){
-			autoSave(args->gs->colorList());
-		}
+		args->autoSave.reset();
 		args->gs->colorList().removeAll();
 	}
 }
@@ -1831,6 +1855,11 @@ int app_run(AppArgs *args)
 		}
 		if (args->startupOptions.floating_picker_mode)
 			floating_picker_activate(args->floatingPicker, false, false, args->startupOptions.converter_name.c_str());
+		if (app_is_autoload_enabled(args)){
+			if (!args->autoSave)
+				args->autoSave = std::make_unique<AutoSave>(*args->gs);
+			args->autoSave->start();
+		}
 		gtk_main();
 		app_save_recent_file_list(args);
 		args->dbus_control.unownName();
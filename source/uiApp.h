@@ -34,6 +34,7 @@ struct StartupOptions {
 void app_initialize();
 AppArgs* app_create_main(const StartupOptions &options, int &return_value);
 int app_load_file(AppArgs *args, const std::string &filename, bool autoload = false);
+int app_load_autosave(AppArgs *args);
 int app_run(AppArgs *args);
 int app_parse_geometry(AppArgs *args, const char *geometry);
 bool app_is_autoload_enabled(AppArgs *args);
@@ -28,6 +28,7 @@
 #include "gtk/ColorWidget.h"
 #include "ColorObject.h"
 #include "ColorSpaces.h"
+#include "ComponentText.h"
 #include "color_names/ColorNames.h"
 #include "common/SetOnScopeEnd.h"
 #include <string>
@@ -50,7 +51,7 @@ static void updateComponentText(DialogInputArgs *args, GtkColorComponent *compon
 	Color transformedColor;
 	gtk_color_component_get_transformed_color(component, transformedColor);
 	float alpha = gtk_color_component_get_alpha(component);
-	std::vector<std::string> values = toTexts(gtk_color_component_get_color_space(component), transformedColor, alpha, args->gs);
+	const auto &values = toTexts(gtk_color_component_get_color_space(component), transformedColor, alpha, args->gs);
 	const char *texts[5] = { 0 };
 	int j = 0;
 	for (auto &value: values) {
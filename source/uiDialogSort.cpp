@@ -23,16 +23,15 @@
 #include "ColorList.h"
 #include "ColorObject.h"
 #include "Channels.h"
+#include "ChannelKeys.h"
 #include "ColorSpaces.h"
 #include "dynv/Map.h"
 #include "GlobalState.h"
 #include "I18N.h"
 #include "common/Match.h"
 #include "common/Format.h"
-#include "common/Unused.h"
-#include "math/BinaryTreeQuantization.h"
-#include <tuple>
-#include <algorithm>
+#include "math/MultiKeySort.h"
+#include <vector>
 namespace {
 static float toGrayscale(const Color &color) {
 	Color r = color.linearRgb();
@@ -47,10 +46,13 @@ struct SortDialog: public DialogBase {
 	ColorList &selectedColors, &sortedColors;
 	std::vector<const ChannelDescription *> sortChannelsInComboBox, groupChannelsInComboBox;
 	const ChannelDescription *groupChannel, *sortChannel;
+	ChannelKeys channelKeys;
+	math::MultiKeySort sorter;
 	SortDialog(ColorList &selectedColors, ColorList &sortedColors, GlobalState &gs, GtkWindow *parent):
 		DialogBase(gs, "gpick.group_and_sort", _("Group and sort"), parent),
 		selectedColors(selectedColors),
-		sortedColors(sortedColors) {
+		sortedColors(sortedColors),
+		channelKeys(selectedColors) {
 		groupChannel = &common::matchById(channels(), options->getString("group_type", "rgb_red"), [](std::string_view id) -> const ChannelDescription & {
 			if (id.empty() || id == "none")
 				return channelNone;
@@ -149,54 +151,17 @@ struct SortDialog: public DialogBase {
 			enableGroupInputs(groupChannel != &channelNone);
 		}
 		ColorList &colorList = preview ? *previewColorList : sortedColors;
-		using ColorWithProperties = std::tuple<float, float, ColorObject *>;
-		std::vector<ColorWithProperties> colors;
-		colors.reserve(selectedColors.size());
-		if (maxGroups == 1 || groupChannel == &channelNone) {
-			auto sortConvertTo = sortChannel->useConvertTo() ? nullptr : colorSpace(sortChannel->colorSpace).convertTo;
-			for (auto *colorObject: selectedColors) {
-				Color color = colorObject->getColor();
-				float sortValue = sortConvertTo ? (std::invoke(sortConvertTo, color).data[sortChannel->index] - sortChannel->min) / (sortChannel->max - sortChannel->min) : sortChannel->convertTo(color);
-				colors.emplace_back(0, sortValue, colorObject);
-			}
-			std::stable_sort(colors.begin(), colors.end(), [reverse](const ColorWithProperties &a, const ColorWithProperties &b) -> bool {
-				float aSort, bSort;
-				std::tie(std::ignore, aSort, std::ignore) = a;
-				std::tie(std::ignore, bSort, std::ignore) = b;
-				return (aSort < bSort) ^ reverse;
-			});
-		} else {
-			math::BinaryTreeQuantization<float> tree;
-			auto groupConvertTo = groupChannel->useConvertTo() ? nullptr : colorSpace(groupChannel->colorSpace).convertTo;
-			for (auto *colorObject: selectedColors) {
-				Color color = colorObject->getColor();
-				float value = groupConvertTo ? (std::invoke(groupConvertTo, color).data[groupChannel->index] - groupChannel->min) / (groupChannel->max - groupChannel->min) : groupChannel->convertTo(color);
-				tree.add(value);
-			}
-			tree.reduce(maxGroups);
-			tree.reduceByMinDistance(groupSensitivity / 100.0f);
-			auto sortConvertTo = sortChannel->useConvertTo() ? nullptr : colorSpace(sortChannel->colorSpace).convertTo;
-			for (auto *colorObject: selectedColors) {
-				Color color = colorObject->getColor();
-				float groupValue = tree.find(groupConvertTo ? (std::invoke(groupConvertTo, color).data[groupChannel->index] - groupChannel->min) / (groupChannel->max - groupChannel->min) : groupChannel->convertTo(color));
-				float sortValue = sortConvertTo ? (std::invoke(sortConvertTo, color).data[sortChannel->index] - sortChannel->min) / (sortChannel->max - sortChannel->min) : sortChannel->convertTo(color);
-				colors.emplace_back(groupValue, sortValue, colorObject);
-			}
-			std::stable_sort(colors.begin(), colors.end(), [reverse, reverseGroups](const ColorWithProperties &a, const ColorWithProperties &b) -> bool {
-				float aGroup, aSort, bGroup, bSort;
-				std::tie(aGroup, aSort, std::ignore) = a;
-				std::tie(bGroup, bSort, std::ignore) = b;
-				if (aGroup != bGroup) {
-					return (aGroup < bGroup) ^ reverseGroups;
-				}
-				return (aSort < bSort) ^ reverse;
-			});
-		}
-		common::Guard colorListGuard = colorList.changeGuard();
-		for (auto [group, sort, colorObject]: colors) {
-			common::maybeUnused(group, sort);
-			colorList.add(colorObject);
-		}
+		std::vector<math::MultiKeySort::Key> keys;
+		if (maxGroups > 1 && groupChannel != &channelNone)
+			keys.push_back({ channelKeys.get(*groupChannel), reverseGroups, static_cast<size_t>(maxGroups), groupSensitivity / 100.0f });
+		keys.push_back({ channelKeys.get(*sortChannel), reverse });
+		auto order = sorter.sort(common::Span<const math::MultiKeySort::Key>(keys.data(), keys.size()));
+		std::vector<ColorObject *> colors;
+		colors.reserve(order.size());
+		auto selected = selectedColors.begin();
+		for (auto index: order)
+			colors.push_back(selected[index]);
+		colorList.add(colors);
 	}
 };
 }
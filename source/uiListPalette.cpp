@@ -18,6 +18,7 @@
 
 #include "uiListPalette.h"
 #include "gtk/ColorCell.h"
+#include "gtk/ColorListModel.h"
 #include "ColorObject.h"
 #include "ColorList.h"
 #include "IColorSource.h"
@@ -57,8 +58,7 @@ enum struct Type {
 struct ListPaletteArgs;
 static void foreachSelectedItem(GtkTreeView *treeView, std::function<bool(ColorObject *)> callback);
 static void foreachItem(GtkTreeView *treeView, std::function<bool(ColorObject *)> callback);
-static void updateAll(GtkTreeView *treeView, GlobalState &gs);
-static void set(GtkListStore* store, GtkTreeIter *iter, ColorObject* colorObject, ListPaletteArgs* args);
+static void updateAll(GtkTreeView *treeView);
 const int scrollEdgeSize = 15; //SCROLL_EDGE_SIZE from gtktreeview.c
 struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public IDroppableColorsUI, public IDraggableColorUI, public IEventHandler, public IPalette {
 	GtkWidget *treeview;
@@ -102,11 +102,16 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 	virtual ~ListPaletteArgs() {
 		gs.eventBus().unsubscribe(*this);
 	}
+	CustomColorListModel *newModel() {
+		return custom_color_list_model_new([this](ColorObject &colorObject) {
+			return gs.converters().serialize(colorObject, Converters::Type::colorList);
+		});
+	}
 	void buildPalette() {
 		treeview = gtk_tree_view_new();
 		gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(treeview), true);
 		gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(treeview), true);
-		auto store = gtk_list_store_new (3, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_STRING);
+		auto store = newModel();
 		g_object_set_data_full(G_OBJECT(store), "arguments", this, nullptr);
 		auto col = gtk_tree_view_column_new();
 		gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
@@ -163,7 +168,7 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 		treeview = gtk_tree_view_new();
 		gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(treeview), 0);
 		gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(treeview), true);
-		auto store = gtk_list_store_new(3, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_STRING);
+		auto store = newModel();
 		auto col = gtk_tree_view_column_new();
 		gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
 		gtk_tree_view_column_set_resizable(col, 0);
@@ -287,41 +292,22 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 	virtual void setColorsAt(const std::vector<ColorObject> &colorObjects, int x, int y) override {
 		droppedColors.clear();
 		removeScrollTimeout();
-		auto model = gtk_tree_view_get_model(GTK_TREE_VIEW(treeview));
-		std::optional<GtkTreeIter> insertIterator;
+		auto model = CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(treeview)));
 		GtkTreePath* path;
 		GtkTreeViewDropPosition pos;
 		size_t position;
-		bool before = false;
 		if (getPathAt(GTK_TREE_VIEW(treeview), x, y, path, pos)) {
-			GtkTreeIter iter;
-			gtk_tree_model_get_iter(model, &iter, path);
 			position = gtk_tree_path_get_indices(path)[0];
 			gtk_tree_path_free(path);
-			insertIterator = iter;
-			if (pos == GTK_TREE_VIEW_DROP_AFTER || pos == GTK_TREE_VIEW_DROP_INTO_OR_AFTER) {
+			if (pos == GTK_TREE_VIEW_DROP_AFTER || pos == GTK_TREE_VIEW_DROP_INTO_OR_AFTER)
 				position += 1;
-			} else {
-				before = true;
-			}
 		} else {
-			position = gtk_tree_model_iter_n_children(model, nullptr);
+			position = custom_color_list_model_size(model);
 		}
 		dropGuard.emplace(colorList.changeGuard());
 		for (auto &colorObject: colorObjects) {
-			GtkTreeIter iter;
-			if (insertIterator) {
-				if (before) {
-					gtk_list_store_insert_before(GTK_LIST_STORE(model), &iter, &*insertIterator);
-				} else {
-					gtk_list_store_insert_after(GTK_LIST_STORE(model), &iter, &*insertIterator);
-					insertIterator = iter;
-				}
-			} else {
-				gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-			}
 			auto newColorObject = colorObject.copy();
-			set(GTK_LIST_STORE(model), &iter, newColorObject.pointer(), this);
+			custom_color_list_model_insert(model, position, newColorObject.pointer());
 			droppedColors.emplace(newColorObject.pointer());
 			colorList.add(newColorObject.pointer(), position);
 			++position;
@@ -466,17 +452,14 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 			return;
 		}
 		if (move) {
-			GtkListStore *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(treeview)));;
+			auto model = CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(treeview)));
 			GtkTreeIter iter;
-			gboolean valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
-			ColorObject *colorObject;
+			gboolean valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(model), &iter);
 			while (valid) {
-				gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &colorObject, -1);
-				if (draggingColors.count(colorObject) != 0) {
-					valid = gtk_list_store_remove(GTK_LIST_STORE(store), &iter);
-					colorObject->release();
+				if (draggingColors.count(custom_color_list_model_get(model, &iter)) != 0) {
+					valid = custom_color_list_model_remove(model, &iter);
 				}else{
-					valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
+					valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(model), &iter);
 				}
 			}
 			colorList.remove([&](ColorObject *colorObject) {
@@ -568,7 +551,7 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 		switch (eventType) {
 		case EventType::optionsUpdate:
 		case EventType::convertersUpdate:
-			updateAll(GTK_TREE_VIEW(treeview), gs);
+			updateAll(GTK_TREE_VIEW(treeview));
 			break;
 		case EventType::displayFiltersUpdate:
 		case EventType::colorDictionaryUpdate:
@@ -610,6 +593,12 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_remove_entry(treeview, colorObject, !colorList.blocked());
 	}
+	virtual void addRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		palette_list_add_entries(treeview, colorObjects, !colorList.blocked());
+	}
+	virtual void removeRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		palette_list_remove_entries(treeview, colorObjects, !colorList.blocked());
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 		palette_list_remove_selected_entries(treeview, !colorList.blocked());
 	}
@@ -641,13 +630,11 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 		GtkTreeIter iter;
 		GtkTreeModel *model = GTK_TREE_MODEL(userData);
 		ListPaletteArgs *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(model), "arguments"));
-		gtk_tree_model_get_iter_from_string(model, &iter, path);
-		gtk_list_store_set(GTK_LIST_STORE(model), &iter,
-				2, new_text,
-				-1);
-		ColorObject *colorObject;
-		gtk_tree_model_get(model, &iter, 0, &colorObject, -1);
+		if (!gtk_tree_model_get_iter_from_string(model, &iter, path))
+			return;
+		ColorObject *colorObject = custom_color_list_model_get(CUSTOM_COLOR_LIST_MODEL(model), &iter);
 		colorObject->setName(new_text);
+		custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, true);
 		args->onChange();
 	}
 	static void onPreviewActivate(GtkTreeView *treeView, GtkTreePath *path, GtkTreeViewColumn *column, ListPaletteArgs *args) {
@@ -712,21 +699,13 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 	static gboolean onSearchEqual(GtkTreeModel *model, gint, const gchar *key, GtkTreeIter *iter, gpointer) {
 		gchar *code, *name;
 		gtk_tree_model_get(model, iter, 1, &code, 2, &name, -1);
-		return !(contains(code, key) || contains(name, key));
+		bool found = contains(code, key) || contains(name, key);
+		g_free(code);
+		g_free(name);
+		return !found;
 	}
 	ColorObject colorObject;
 };
-static void set(GtkListStore *store, GtkTreeIter *iter, ColorObject *colorObject, ListPaletteArgs *args) {
-	std::string text = args->gs.converters().serialize(*colorObject, Converters::Type::colorList);
-	gtk_list_store_set(store, iter, 0, colorObject->reference(), 1, text.c_str(), 2, colorObject->getName().c_str(), -1);
-}
-static void setName(GtkListStore *store, GtkTreeIter *iter, ColorObject *colorObject) {
-	gtk_list_store_set(store, iter, 2, colorObject->getName().c_str(), -1);
-}
-static void setAll(GtkListStore *store, GtkTreeIter *iter, ColorObject *colorObject, ListPaletteArgs *args) {
-	std::string text = args->gs.converters().serialize(*colorObject, Converters::Type::colorList);
-	gtk_list_store_set(store, iter, 1, text.c_str(), 2, colorObject->getName().c_str(), -1);
-}
 static void foreachItem(GtkTreeView *treeView, std::function<bool(ColorObject *)> callback) {
 	auto model = gtk_tree_view_get_model(treeView);
 	GtkTreeIter iter;
@@ -739,17 +718,10 @@ static void foreachItem(GtkTreeView *treeView, std::function<bool(ColorObject *)
 		valid = gtk_tree_model_iter_next(model, &iter);
 	}
 }
-static void updateAll(GtkTreeView *treeView, GlobalState &gs) {
-	auto model = gtk_tree_view_get_model(treeView);
-	GtkTreeIter iter;
-	auto valid = gtk_tree_model_get_iter_first(model, &iter);
-	while (valid) {
-		ColorObject *colorObject;
-		gtk_tree_model_get(model, &iter, 0, &colorObject, -1);
-		std::string text = gs.converters().serialize(*colorObject, Converters::Type::colorList);
-		gtk_list_store_set(GTK_LIST_STORE(model), &iter, 1, text.c_str(), -1);
-		valid = gtk_tree_model_iter_next(model, &iter);
-	}
+static void updateAll(GtkTreeView *treeView) {
+	// Color texts are formatted again only for rows which get drawn.
+	custom_color_list_model_invalidate(CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(treeView)));
+	gtk_widget_queue_draw(GTK_WIDGET(treeView));
 }
 static void foreachSelectedItem(GtkTreeView *treeView, std::function<bool(ColorObject *)> callback) {
 	auto model = gtk_tree_view_get_model(treeView);
@@ -806,16 +778,7 @@ GtkWidget* palette_list_preview_new(GlobalState &gs, bool expander, bool expande
 
 void palette_list_remove_all_entries(GtkWidget* widget, bool allowUpdate) {
 	ListPaletteArgs* args = (ListPaletteArgs*)g_object_get_data(G_OBJECT(widget), "arguments");
-	GtkListStore *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(widget)));
-	GtkTreeIter iter;
-	gboolean valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
-	while (valid) {
-		ColorObject *colorObject;
-		gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &colorObject, -1);
-		colorObject->release();
-		valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
-	}
-	gtk_list_store_clear(GTK_LIST_STORE(store));
+	custom_color_list_model_clear(CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(widget))));
 	if (allowUpdate) {
 		args->updateCounts();
 		args->onChange();
@@ -831,28 +794,15 @@ void palette_list_remove_selected_entries(GtkWidget* widget, bool allowUpdate) {
 	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
 	auto model = gtk_tree_view_get_model(GTK_TREE_VIEW(widget));
 	auto selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(widget));
-	GList *list = gtk_tree_selection_get_selected_rows(selection, nullptr), *referenceList = nullptr;
-	GList *i = list;
-	while (i) {
-		referenceList = g_list_prepend(referenceList, gtk_tree_row_reference_new(model, reinterpret_cast<GtkTreePath *>(i->data)));
-		i = g_list_next(i);
-	}
-	i = referenceList;
+	GList *list = gtk_tree_selection_get_selected_rows(selection, nullptr);
+	// Selected rows are sorted, so removing them from the last one keeps paths of remaining rows valid.
+	GList *i = g_list_last(list);
 	while (i) {
-		GtkTreePath *path = gtk_tree_row_reference_get_path(reinterpret_cast<GtkTreeRowReference *>(i->data));
-		if (path) {
-			GtkTreeIter iter;
-			gtk_tree_model_get_iter(model, &iter, path);
-			gtk_tree_path_free(path);
-			ColorObject *colorObject;
-			gtk_tree_model_get(model, &iter, 0, &colorObject, -1);
-			colorObject->release();
-			gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
-		}
-		i = g_list_next(i);
+		GtkTreeIter iter;
+		if (gtk_tree_model_get_iter(model, &iter, reinterpret_cast<GtkTreePath *>(i->data)))
+			custom_color_list_model_remove(CUSTOM_COLOR_LIST_MODEL(model), &iter);
+		i = g_list_previous(i);
 	}
-	g_list_foreach(referenceList, (GFunc)gtk_tree_row_reference_free, nullptr);
-	g_list_free(referenceList);
 	g_list_foreach(list, (GFunc)gtk_tree_path_free, nullptr);
 	g_list_free(list);
 	if (allowUpdate) {
@@ -863,11 +813,25 @@ void palette_list_remove_selected_entries(GtkWidget* widget, bool allowUpdate) {
 void palette_list_add_entry(GtkWidget* widget, ColorObject* colorObject, bool allowUpdate)
 {
 	ListPaletteArgs* args = (ListPaletteArgs*)g_object_get_data(G_OBJECT(widget), "arguments");
-	GtkTreeIter iter1;
-	GtkListStore *store;
-	store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(widget)));
-	gtk_list_store_append(store, &iter1);
-	set(store, &iter1, colorObject, args);
+	custom_color_list_model_append(CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(widget))), colorObject);
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
+	}
+}
+void palette_list_add_entries(GtkWidget* widget, common::Span<ColorObject *const> colorObjects, bool allowUpdate) {
+	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
+	auto model = CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(widget)));
+	custom_color_list_model_insert_range(model, custom_color_list_model_size(model), colorObjects);
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
+	}
+}
+void palette_list_remove_entries(GtkWidget* widget, common::Span<ColorObject *const> colorObjects, bool allowUpdate) {
+	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
+	if (custom_color_list_model_remove_objects(CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(widget))), colorObjects) == 0)
+		return;
 	if (allowUpdate) {
 		args->updateCounts();
 		args->onChange();
@@ -876,26 +840,13 @@ void palette_list_add_entry(GtkWidget* widget, ColorObject* colorObject, bool al
 int palette_list_remove_entry(GtkWidget* widget, ColorObject* r_color_object, bool allowUpdate)
 {
 	ListPaletteArgs* args = (ListPaletteArgs*)g_object_get_data(G_OBJECT(widget), "arguments");
-	GtkTreeIter iter;
-	GtkListStore *store;
-	gboolean valid;
-	store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(widget)));
-	valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
-	ColorObject* colorObject;
-	while (valid){
-		gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &colorObject, -1);
-		if (colorObject == r_color_object){
-			valid = gtk_list_store_remove(GTK_LIST_STORE(store), &iter);
-			colorObject->release();
-			if (allowUpdate) {
-				args->updateCounts();
-				args->onChange();
-			}
-			return 0;
-		}
-		valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
+	if (!custom_color_list_model_remove_object(CUSTOM_COLOR_LIST_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(widget))), r_color_object))
+		return -1;
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
 	}
-	return -1;
+	return 0;
 }
 ColorObject *palette_list_get_first_selected(GtkWidget *widget) {
 	GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(widget));
@@ -924,10 +875,7 @@ void palette_list_update_first_selected(GtkWidget *widget, bool onlyName, bool a
 		GtkTreeIter iter;
 		gtk_tree_model_get_iter(model, &iter, reinterpret_cast<GtkTreePath*>(i->data));
 		gtk_tree_model_get(model, &iter, 0, &colorObject, -1);
-		if (onlyName)
-			setName(GTK_LIST_STORE(model), &iter, colorObject);
-		else
-			setAll(GTK_LIST_STORE(model), &iter, colorObject, args);
+		custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, onlyName);
 		changed = true;
 	}
 	g_list_foreach(list, (GFunc)gtk_tree_path_free, nullptr);
@@ -962,23 +910,22 @@ void forEach(GtkWidget *widget, bool selected, Callback &&callback, bool allowUp
 				ColorObject *newColorObject = colorObject;
 				auto result = callback(&newColorObject);
 				if (newColorObject != colorObject) {
-					set(GTK_LIST_STORE(model), &iter, newColorObject, args);
+					custom_color_list_model_set(CUSTOM_COLOR_LIST_MODEL(model), &iter, newColorObject);
 					changed = true;
-					colorObject->release();
 				} else if (result == Update::name) {
-					setName(GTK_LIST_STORE(model), &iter, colorObject);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, true);
 					changed = true;
 				} else if (result == Update::row) {
-					setAll(GTK_LIST_STORE(model), &iter, colorObject, args);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, false);
 					changed = true;
 				}
 			} else {
 				auto result = callback(colorObject);
 				if (result == Update::name) {
-					setName(GTK_LIST_STORE(model), &iter, colorObject);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, true);
 					changed = true;
 				} else if (result == Update::row) {
-					setAll(GTK_LIST_STORE(model), &iter, colorObject, args);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, false);
 					changed = true;
 				}
 			}
@@ -996,23 +943,23 @@ void forEach(GtkWidget *widget, bool selected, Callback &&callback, bool allowUp
 				colorObject->reference();
 				auto result = callback(&newColorObject);
 				if (newColorObject != colorObject) {
-					set(GTK_LIST_STORE(model), &iter, newColorObject, args);
+					custom_color_list_model_set(CUSTOM_COLOR_LIST_MODEL(model), &iter, newColorObject);
 					changed = true;
 				} else if (result == Update::name) {
-					setName(GTK_LIST_STORE(model), &iter, colorObject);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, true);
 					changed = true;
 				} else if (result == Update::row) {
-					setAll(GTK_LIST_STORE(model), &iter, colorObject, args);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, false);
 					changed = true;
 				}
 				colorObject->release();
 			} else {
 				auto result = callback(colorObject);
 				if (result == Update::name) {
-					setName(GTK_LIST_STORE(model), &iter, colorObject);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, true);
 					changed = true;
 				} else if (result == Update::row) {
-					setAll(GTK_LIST_STORE(model), &iter, colorObject, args);
+					custom_color_list_model_update(CUSTOM_COLOR_LIST_MODEL(model), &iter, false);
 					changed = true;
 				}
 			}
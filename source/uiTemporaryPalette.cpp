@@ -102,6 +102,12 @@ struct TemporaryPalette: public IPalette {
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_remove_entry(palette, colorObject, !colorList.blocked());
 	}
+	virtual void addRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		palette_list_add_entries(palette, colorObjects, !colorList.blocked());
+	}
+	virtual void removeRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects) override {
+		palette_list_remove_entries(palette, colorObjects, !colorList.blocked());
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 		palette_list_remove_selected_entries(palette, !colorList.blocked());
 	}